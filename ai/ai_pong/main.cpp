@@ -13,6 +13,7 @@ struct ProgramSetup {
 
   int width{};
   int height{};
+  bool fast_forward{};
 };
 
 ProgramSetup process_args(const int argc, const char *const argv[]) {
@@ -20,6 +21,7 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
   desc.add_options()("help", "This help message");
   desc.add_options()("width", boost::program_options::value<int>()->default_value(1024), "Width of the window");
   desc.add_options()("height", boost::program_options::value<int>()->default_value(1024), "Height of the window");
+  desc.add_options()("fast-forward", "Step the games as fast as possible instead of in real time");
 
   boost::program_options::variables_map vm;
   boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
@@ -30,7 +32,7 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
     return {true};
   }
 
-  return {false, vm["width"].as<int>(), vm["height"].as<int>()};
+  return {false, vm["width"].as<int>(), vm["height"].as<int>(), vm.count("fast-forward") > 0};
 }
 
 int main(int argc, char *argv[]) {
@@ -41,7 +43,7 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  auto scene = std::make_unique<ai::PongScene>();
+  auto scene = std::make_unique<ai::PongScene>(program_setup.fast_forward);
   scene->init(program_setup.width, program_setup.height, "AI: Pong");
   return scene->exec();
 }
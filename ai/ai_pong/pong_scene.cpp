@@ -13,9 +13,13 @@ constexpr auto paddle_speed = 0.0005f;
 
 constexpr auto ball_radius = 0.01f;
 constexpr auto ball_speed = 0.0005f;
+
+constexpr auto tick_rate = 240.0;
+constexpr auto fast_forward_steps = std::uint32_t{64};
 } // namespace
 
-PongScene::PongScene() {
+PongScene::PongScene(const bool fast_forward)
+    : fast_forward_{fast_forward} {
   for (auto &neural_network : neural_networks_) {
     neural_network = std::make_unique<NeuralNetwork>(5, std::vector<std::size_t>{4, 4, 1});
     neural_network->init_random(0.0f, 1.0f);
@@ -26,7 +30,6 @@ void PongScene::loop(const gp::misc::Event &event) {
   switch (event.type()) {
   case gp::misc::Event::Type::Init:
     initialize(event.init().width, event.init().height);
-    last_timestamp_ms_ = event.timestamp();
     break;
   case gp::misc::Event::Type::Quit:
     finalize();
@@ -34,18 +37,23 @@ void PongScene::loop(const gp::misc::Event &event) {
   case gp::misc::Event::Type::Resize:
     resize(event.resize().width, event.resize().height);
     break;
-  case gp::misc::Event::Type::Redraw: {
-    const auto time_elapsed_ms = event.timestamp() - last_timestamp_ms_;
-    animate(time_elapsed_ms);
-    last_timestamp_ms_ = event.timestamp();
+  case gp::misc::Event::Type::Redraw:
     redraw();
-  } break;
+    break;
   default:
     break;
   }
 }
 
-void PongScene::initialize(const int width, const int height) { resize(width, height); }
+void PongScene::initialize(const int width, const int height) {
+  if (fast_forward_) {
+    set_fixed_timestep(tick_rate, fast_forward_steps);
+    fixed_timestep().set_realtime(false);
+  } else {
+    set_fixed_timestep(tick_rate);
+  }
+  resize(width, height);
+}
 
 void PongScene::finalize() {}
 
@@ -54,13 +62,17 @@ void PongScene::resize(const int width, const int height) {
   height_ = static_cast<float>(height);
 }
 
-void PongScene::animate(const std::uint64_t time_elapsed_ms) {
+void PongScene::step(const float tick_ms) {
+  for (auto &game_state : game_states_) {
+    game_state.prev_paddle_position = game_state.paddle_position;
+  }
+
   if (keyboard_state()->is_down(gp::misc::Event::ScanCode::Left) !=
       keyboard_state()->is_down(gp::misc::Event::ScanCode::Right)) {
     if (keyboard_state()->is_down(gp::misc::Event::ScanCode::Left)) {
-      game_states_[0].paddle_position -= paddle_speed * time_elapsed_ms;
+      game_states_[0].paddle_position -= paddle_speed * tick_ms;
     } else {
-      game_states_[0].paddle_position += paddle_speed * time_elapsed_ms;
+      game_states_[0].paddle_position += paddle_speed * tick_ms;
     }
     game_states_[0].paddle_position = glm::clamp(game_states_[0].paddle_position, 0.0f, 1.0f);
   }
@@ -77,15 +89,15 @@ void PongScene::animate(const std::uint64_t time_elapsed_ms) {
 
     const auto output = neural_network->get_output();
     if (output[0] > 0.5f) {
-      game_state.paddle_position -= paddle_speed * time_elapsed_ms;
+      game_state.paddle_position -= paddle_speed * tick_ms;
     } else if (output[0] < 0.5f) {
-      game_state.paddle_position += paddle_speed * time_elapsed_ms;
+      game_state.paddle_position += paddle_speed * tick_ms;
     }
     game_state.paddle_position = glm::clamp(game_state.paddle_position, 0.0f, 1.0f);
     game_state.prev_ball_position = game_state.ball_position;
 
     game_state.ball_angle = glm::normalize(game_state.ball_angle);
-    game_state.ball_position += game_state.ball_angle * static_cast<float>(game_state.ball_speed * time_elapsed_ms);
+    game_state.ball_position += game_state.ball_angle * game_state.ball_speed * tick_ms;
     if (game_state.ball_position.x < 0.0f || game_state.ball_position.x > 1.0f) {
       game_state.ball_angle.x = -game_state.ball_angle.x;
       if (game_state.ball_position.x < 0.0f) {
@@ -130,11 +142,15 @@ void PongScene::redraw() {
     score_label_pos.y += 20;
   }
 
+  // The games are a fraction of a tick ahead of their last step, drawn between their last two.
+  const auto alpha = interpolation_alpha();
+
   r().set_color(255, 255, 255, static_cast<int>(255.0f / number_per_generation + 0.5f));
   for (std::size_t i = 0; i < number_per_generation; i++) {
+    const auto ball_position = glm::mix(game_states_[i].prev_ball_position, game_states_[i].ball_position, alpha);
     const auto ball_rect = SDL_FRect{
-        width_ * game_states_[i].ball_position.x - width_ * ball_radius,
-        height_ * game_states_[i].ball_position.y - height_ * ball_radius,
+        width_ * ball_position.x - width_ * ball_radius,
+        height_ * ball_position.y - height_ * ball_radius,
         width_ * ball_radius * 2.0f,
         height_ * ball_radius * 2.0f,
     };
@@ -142,8 +158,10 @@ void PongScene::redraw() {
   }
 
   for (std::size_t i = 0; i < number_per_generation; i++) {
+    const auto paddle_position =
+        glm::mix(game_states_[i].prev_paddle_position, game_states_[i].paddle_position, alpha);
     const auto paddle_rect = SDL_FRect{
-        width_ * game_states_[i].paddle_position - width_ * paddle_width / 2.0f,
+        width_ * paddle_position - width_ * paddle_width / 2.0f,
         height_ - height_ * paddle_height,
         width_ * paddle_width,
         height_ * paddle_height,
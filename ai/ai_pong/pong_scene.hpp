@@ -11,12 +11,16 @@
 namespace ai {
 class PongScene : public gp::sdl::Scene2D {
 public:
-  PongScene();
+  /**
+   * @param fast_forward Steps the games as fast as possible instead of in real time, to train faster.
+   */
+  explicit PongScene(const bool fast_forward = false);
 
 private:
   struct GameState {
     int score{0};
     float paddle_position{0.5f};
+    float prev_paddle_position{0.5f};
     glm::vec2 ball_position{0.5f, 0.5f};
     glm::vec2 prev_ball_position{0.5f, 0.5f};
     glm::vec2 ball_angle{0.4f, -0.5f};
@@ -26,14 +30,14 @@ private:
   constexpr static std::size_t number_per_generation{25};
 
   void loop(const gp::misc::Event &event) override;
+  void step(const float tick_ms) override;
 
   void initialize(const int width, const int height);
   void finalize();
   void resize(const int width, const int height);
-  void animate(const std::uint64_t time_elapsed_ms);
   void redraw();
 
-  std::uint64_t last_timestamp_ms_{};
+  const bool fast_forward_{};
   float width_{};
   float height_{};
 
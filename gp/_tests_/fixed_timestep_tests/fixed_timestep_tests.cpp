@@ -0,0 +1,47 @@
+#include <gp/misc/fixed_timestep.hpp>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+using gp::misc::FixedTimestep;
+using namespace std::chrono_literals;
+
+TEST(FixedTimestep, Advance_AccumulatesPartialTicks) {
+  FixedTimestep fixed_timestep{100.0};
+
+  EXPECT_EQ(fixed_timestep.advance(4ms), 0u);
+  EXPECT_FLOAT_EQ(fixed_timestep.alpha(), 0.4f);
+  EXPECT_EQ(fixed_timestep.advance(7ms), 1u);
+  EXPECT_FLOAT_EQ(fixed_timestep.alpha(), 0.1f);
+  EXPECT_EQ(fixed_timestep.advance(29ms), 3u);
+  EXPECT_FLOAT_EQ(fixed_timestep.alpha(), 0.0f);
+  EXPECT_EQ(fixed_timestep.steps(), 4u);
+  EXPECT_FLOAT_EQ(fixed_timestep.tick_ms(), 10.0f);
+}
+
+TEST(FixedTimestep, Advance_BeyondMaxSteps_DropsWholeTicks) {
+  FixedTimestep fixed_timestep{100.0, 4};
+
+  EXPECT_EQ(fixed_timestep.advance(1005ms), 4u);
+  EXPECT_EQ(fixed_timestep.dropped(), 96 * 10ms);
+  EXPECT_FLOAT_EQ(fixed_timestep.alpha(), 0.5f);
+  EXPECT_EQ(fixed_timestep.advance(5ms), 1u);
+}
+
+TEST(FixedTimestep, Advance_NotRealtime_RunsMaxStepsRegardlessOfTime) {
+  FixedTimestep fixed_timestep{60.0, 16};
+  fixed_timestep.set_realtime(false);
+
+  EXPECT_EQ(fixed_timestep.advance(0ms), 16u);
+  EXPECT_EQ(fixed_timestep.advance(1s), 16u);
+  EXPECT_FLOAT_EQ(fixed_timestep.alpha(), 0.0f);
+  EXPECT_EQ(fixed_timestep.steps(), 32u);
+}
+
+TEST(FixedTimestep, Construct_NonPositiveRateOrSteps_Throws) {
+  EXPECT_THROW(FixedTimestep{0.0}, std::runtime_error);
+  EXPECT_THROW(FixedTimestep(60.0, 0), std::runtime_error);
+}
+} // namespace
@@ -0,0 +1,110 @@
+#include <gp/misc/profiler.hpp>
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+
+namespace {
+using gp::misc::Profiler;
+using namespace std::chrono_literals;
+
+Profiler::Zone make_zone(const char *name, const std::chrono::microseconds duration, const std::uint32_t thread = 0) {
+  const auto begin = Profiler::Clock::now();
+  return {name, thread, 0, begin, begin + duration};
+}
+
+TEST(Profiler, EndFrame_RingFull_DropsOldestFrame) {
+  Profiler profiler{2};
+  profiler.record(make_zone("first", 1us));
+  profiler.end_frame();
+  profiler.record(make_zone("second", 1us));
+  profiler.end_frame();
+  profiler.record(make_zone("third", 1us));
+  profiler.end_frame();
+
+  const auto frames = profiler.frames();
+  ASSERT_EQ(frames.size(), 2u);
+  ASSERT_EQ(frames[0].zones.size(), 1u);
+  EXPECT_STREQ(frames[0].zones[0].name, "second");
+  EXPECT_STREQ(frames[1].zones[0].name, "third");
+  EXPECT_LE(frames[0].end, frames[1].begin);
+}
+
+TEST(Profiler, TopZones_SumsByName_MostExpensiveFirst) {
+  Profiler profiler{};
+  profiler.record(make_zone("cheap", 10us));
+  profiler.record(make_zone("expensive", 300us));
+  profiler.record(make_zone("cheap", 10us));
+  profiler.end_frame();
+  profiler.record(make_zone("expensive", 100us));
+  profiler.end_frame();
+
+  const auto top = profiler.top_zones(1);
+  ASSERT_EQ(top.size(), 1u);
+  EXPECT_EQ(top[0].name, "expensive");
+  EXPECT_EQ(top[0].total, 400us);
+  EXPECT_EQ(top[0].count, 2u);
+  EXPECT_EQ(top[0].average, 200us);
+}
+
+TEST(Profiler, Disabled_EndFrame_KeepsNoFrames) {
+  Profiler profiler{};
+  profiler.set_enabled(false);
+  profiler.end_frame();
+
+  EXPECT_TRUE(profiler.frames().empty());
+}
+
+TEST(Profiler, Record_WithoutEndFrame_DropsBeyondMaxFrameZones) {
+  Profiler profiler{};
+  for (std::size_t i = 0; i < Profiler::MAX_FRAME_ZONES + 3; ++i) {
+    profiler.record(make_zone("zone", 1us));
+  }
+  profiler.end_frame();
+
+  EXPECT_EQ(profiler.frames().back().zones.size(), Profiler::MAX_FRAME_ZONES);
+  EXPECT_EQ(profiler.dropped(), 3u);
+}
+
+TEST(ProfileZone, Nested_RecordsDepthAndThread) {
+  auto &profiler = gp::misc::profiler();
+  profiler.end_frame();
+  {
+    const gp::misc::ProfileZone outer{"outer"};
+    std::thread([] { const gp::misc::ProfileZone worker{"worker"}; }).join();
+    const gp::misc::ProfileZone inner{"inner"};
+  }
+  profiler.end_frame();
+
+  const auto zones = profiler.frames().back().zones;
+  ASSERT_EQ(zones.size(), 3u);
+  EXPECT_STREQ(zones[0].name, "worker");
+  EXPECT_EQ(zones[0].depth, 0u);
+  EXPECT_NE(zones[0].thread, Profiler::thread_index());
+  EXPECT_STREQ(zones[1].name, "inner");
+  EXPECT_EQ(zones[1].depth, 1u);
+  EXPECT_STREQ(zones[2].name, "outer");
+  EXPECT_EQ(zones[2].depth, 0u);
+  EXPECT_EQ(zones[2].thread, Profiler::thread_index());
+  EXPECT_LE(zones[2].begin, zones[1].begin);
+  EXPECT_GE(zones[2].end, zones[1].end);
+}
+
+TEST(Profiler, ChromeTrace_HasThreadNamesFramesAndZones) {
+  Profiler profiler{};
+  profiler.set_thread_name("main");
+  profiler.record(make_zone("zone", 1500us, Profiler::thread_index()));
+  profiler.end_frame();
+
+  const auto trace = profiler.chrome_trace();
+  const auto &events = trace["traceEvents"];
+  ASSERT_EQ(events.size(), 3u);
+  EXPECT_EQ(events[0]["ph"], "M");
+  EXPECT_EQ(events[0]["args"]["name"], "main");
+  EXPECT_EQ(events[1]["name"], "frame");
+  EXPECT_EQ(events[2]["name"], "zone");
+  EXPECT_EQ(events[2]["ph"], "X");
+  EXPECT_EQ(events[2]["tid"], Profiler::thread_index());
+  EXPECT_DOUBLE_EQ(events[2]["dur"].get<double>(), 1500.0);
+}
+} // namespace
@@ -1,5 +1,7 @@
 #include "buffer_object.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <stdexcept>
 
 namespace gp::gl {
@@ -11,7 +13,7 @@ BufferObject::BufferObject(const GLenum target)
   }
 }
 
-BufferObject::~BufferObject() { glDeleteBuffers(1, &id_); }
+BufferObject::~BufferObject() { state_cache().delete_buffers(1, &id_); }
 
 BufferObject::BufferObject(BufferObject &&other) noexcept
     : id_{other.id_}
@@ -21,7 +23,7 @@ BufferObject::BufferObject(BufferObject &&other) noexcept
 
 BufferObject &BufferObject::operator=(BufferObject &&other) noexcept {
   if (this != &other) {
-    glDeleteBuffers(1, &id_);
+    state_cache().delete_buffers(1, &id_);
     id_ = other.id_;
     target_ = other.target_;
     other.id_ = 0;
@@ -33,14 +35,22 @@ GLuint BufferObject::id() const { return id_; }
 
 GLenum BufferObject::target() const { return target_; }
 
-void BufferObject::bind() const { glBindBuffer(target(), id()); }
+void BufferObject::bind() const { state_cache().bind_buffer(target(), id()); }
 
-void BufferObject::unbind() const { glBindBuffer(target(), 0); }
+void BufferObject::unbind() const { state_cache().bind_buffer(target(), 0); }
 
 void BufferObject::set_data(const GLsizeiptr size, const void *data, const GLenum usage) const {
   glBufferData(target(), size, data, usage);
 }
 
+void BufferObject::set_storage(const GLsizeiptr size, const void *data, const GLbitfield flags) const {
+#ifndef __EMSCRIPTEN__
+  glBufferStorage(target(), size, data, flags);
+#else
+  throw std::runtime_error("glBufferStorage is not available in Emscripten");
+#endif
+}
+
 void BufferObject::set_sub_data(const GLintptr offset, const GLsizeiptr size, const void *data) const {
   glBufferSubData(target(), offset, size, data);
 }
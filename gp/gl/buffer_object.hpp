@@ -54,6 +54,14 @@ public:
    */
   void set_data(const GLsizeiptr size, const void *data, const GLenum usage) const;
 
+  /**
+   * @brief Allocates immutable storage for the buffer object.
+   * @param size The size of the storage in bytes.
+   * @param data A pointer to the initial data, or nullptr.
+   * @param flags The intended usage of the storage, e.g. GL_MAP_PERSISTENT_BIT.
+   */
+  void set_storage(const GLsizeiptr size, const void *data, const GLbitfield flags) const;
+
   /**
    * @brief Sets a portion of the data of the buffer object.
    * @param offset The offset in bytes.
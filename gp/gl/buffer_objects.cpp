@@ -1,5 +1,7 @@
 #include "buffer_objects.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <algorithm>
 #include <stdexcept>
 #include <utility>
@@ -14,7 +16,7 @@ BufferObjects::BufferObjects(const std::size_t n, const GLenum target)
   }
 }
 
-BufferObjects::~BufferObjects() { glDeleteBuffers(static_cast<GLsizei>(ids_.size()), ids_.data()); }
+BufferObjects::~BufferObjects() { state_cache().delete_buffers(static_cast<GLsizei>(ids_.size()), ids_.data()); }
 
 BufferObjects::BufferObjects(BufferObjects &&other) noexcept
     : ids_(std::move(other.ids_))
@@ -22,7 +24,7 @@ BufferObjects::BufferObjects(BufferObjects &&other) noexcept
 
 BufferObjects &BufferObjects::operator=(BufferObjects &&other) noexcept {
   if (this != &other) {
-    glDeleteBuffers(static_cast<GLsizei>(ids_.size()), ids_.data());
+    state_cache().delete_buffers(static_cast<GLsizei>(ids_.size()), ids_.data());
     ids_ = std::move(other.ids_);
     target_ = other.target_;
   }
@@ -33,9 +35,9 @@ GLuint BufferObjects::id(const std::size_t index) const { return ids_[index]; }
 
 GLenum BufferObjects::target() const { return target_; }
 
-void BufferObjects::bind(const std::size_t index) const { glBindBuffer(target(), id(index)); }
+void BufferObjects::bind(const std::size_t index) const { state_cache().bind_buffer(target(), id(index)); }
 
-void BufferObjects::unbind() const { glBindBuffer(target(), 0); }
+void BufferObjects::unbind() const { state_cache().bind_buffer(target(), 0); }
 
 void BufferObjects::set_data(const GLsizeiptr size, const void *data, const GLenum usage) const {
   glBufferData(target(), size, data, usage);
@@ -0,0 +1,51 @@
+#include "framebuffer_object.hpp"
+
+#include <stdexcept>
+
+namespace gp::gl {
+FramebufferObject::FramebufferObject(const GLenum target)
+    : target_(target) {
+  glGenFramebuffers(1, &id_);
+  if (id() == 0) {
+    throw std::runtime_error("Failed to generate framebuffer object");
+  }
+}
+
+FramebufferObject::~FramebufferObject() { glDeleteFramebuffers(1, &id_); }
+
+FramebufferObject::FramebufferObject(FramebufferObject &&other) noexcept
+    : id_{other.id_}
+    , target_{other.target_} {
+  other.id_ = 0;
+}
+
+FramebufferObject &FramebufferObject::operator=(FramebufferObject &&other) noexcept {
+  if (this != &other) {
+    glDeleteFramebuffers(1, &id_);
+    id_ = other.id_;
+    target_ = other.target_;
+    other.id_ = 0;
+  }
+  return *this;
+}
+
+GLuint FramebufferObject::id() const { return id_; }
+
+GLenum FramebufferObject::target() const { return target_; }
+
+void FramebufferObject::bind() const { glBindFramebuffer(target(), id()); }
+
+void FramebufferObject::unbind() const { glBindFramebuffer(target(), 0); }
+
+void FramebufferObject::attach_renderbuffer(const GLenum attachment, const RenderbufferObject &renderbuffer) const {
+  glFramebufferRenderbuffer(target(), attachment, GL_RENDERBUFFER, renderbuffer.id());
+}
+
+void FramebufferObject::attach_texture_2d(const GLenum attachment,
+                                          const TextureObject &texture,
+                                          const GLint level) const {
+  glFramebufferTexture2D(target(), attachment, texture.target(), texture.id(), level);
+}
+
+GLenum FramebufferObject::status() const { return glCheckFramebufferStatus(target()); }
+} // namespace gp::gl
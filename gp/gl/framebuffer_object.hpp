@@ -0,0 +1,76 @@
+#pragma once
+
+#include <gp/gl/gl.hpp>
+#include <gp/gl/renderbuffer_object.hpp>
+#include <gp/gl/texture_object.hpp>
+
+namespace gp::gl {
+/**
+ * @brief Represents a framebuffer object in OpenGL.
+ */
+class FramebufferObject {
+public:
+  /**
+   * @brief Constructs a FramebufferObject with the specified target.
+   * @param target The target of the framebuffer object (GL_FRAMEBUFFER, GL_READ_FRAMEBUFFER or GL_DRAW_FRAMEBUFFER).
+   */
+  explicit FramebufferObject(const GLenum target = GL_FRAMEBUFFER);
+
+  /**
+   * @brief Destructor for FramebufferObject.
+   */
+  ~FramebufferObject();
+
+  FramebufferObject(const FramebufferObject &) = delete;
+  FramebufferObject &operator=(const FramebufferObject &) = delete;
+  FramebufferObject(FramebufferObject &&other) noexcept;
+  FramebufferObject &operator=(FramebufferObject &&other) noexcept;
+
+  /**
+   * @brief Returns the ID of the framebuffer object.
+   * @return The ID of the framebuffer object.
+   */
+  GLuint id() const;
+
+  /**
+   * @brief Returns the target of the framebuffer object.
+   * @return The target of the framebuffer object.
+   */
+  GLenum target() const;
+
+  /**
+   * @brief Binds the framebuffer object.
+   */
+  void bind() const;
+
+  /**
+   * @brief Binds the default framebuffer to the target.
+   */
+  void unbind() const;
+
+  /**
+   * @brief Attaches a renderbuffer to the bound framebuffer object.
+   * @param attachment The attachment point, e.g. GL_COLOR_ATTACHMENT0 or GL_DEPTH_STENCIL_ATTACHMENT.
+   * @param renderbuffer The renderbuffer to attach.
+   */
+  void attach_renderbuffer(const GLenum attachment, const RenderbufferObject &renderbuffer) const;
+
+  /**
+   * @brief Attaches a level of a 2D texture to the bound framebuffer object.
+   * @param attachment The attachment point, e.g. GL_COLOR_ATTACHMENT0.
+   * @param texture The texture to attach.
+   * @param level The mipmap level to attach.
+   */
+  void attach_texture_2d(const GLenum attachment, const TextureObject &texture, const GLint level = 0) const;
+
+  /**
+   * @brief Returns the completeness status of the bound framebuffer object.
+   * @return GL_FRAMEBUFFER_COMPLETE if the framebuffer object can be rendered to.
+   */
+  GLenum status() const;
+
+private:
+  GLuint id_{};
+  GLenum target_{};
+};
+} // namespace gp::gl
@@ -0,0 +1,91 @@
+#include "gpu_timer.hpp"
+
+#include <stdexcept>
+
+namespace gp::gl {
+GpuTimer::GpuTimer(const std::size_t ring_size)
+    : available_(available())
+    , slots_(ring_size) {
+  if (ring_size == 0) {
+    throw std::runtime_error("GPU timer ring size must be positive");
+  }
+#ifndef __EMSCRIPTEN__
+  if (!available_) {
+    return;
+  }
+  queries_.resize(ring_size * 2);
+  glGenQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  for (std::size_t i = 0; i < slots_.size(); ++i) {
+    slots_[i].begin_query = queries_[i * 2];
+    slots_[i].end_query = queries_[i * 2 + 1];
+  }
+#endif
+}
+
+GpuTimer::~GpuTimer() {
+  if (!queries_.empty()) {
+    glDeleteQueries(static_cast<GLsizei>(queries_.size()), queries_.data());
+  }
+}
+
+bool GpuTimer::available() {
+#ifndef __EMSCRIPTEN__
+  // Loaded for GL 3.3 contexts or with ARB_timer_query.
+  return glQueryCounter != nullptr;
+#else
+  return false;
+#endif
+}
+
+void GpuTimer::begin() {
+#ifndef __EMSCRIPTEN__
+  if (!available_ || measuring_) {
+    return;
+  }
+  if (slots_[head_].pending) {
+    ++dropped_;
+    return;
+  }
+  glQueryCounter(slots_[head_].begin_query, GL_TIMESTAMP);
+  measuring_ = true;
+#endif
+}
+
+void GpuTimer::end() {
+#ifndef __EMSCRIPTEN__
+  if (!measuring_) {
+    return;
+  }
+  glQueryCounter(slots_[head_].end_query, GL_TIMESTAMP);
+  slots_[head_].pending = true;
+  head_ = (head_ + 1) % slots_.size();
+  measuring_ = false;
+#endif
+}
+
+std::optional<std::chrono::nanoseconds> GpuTimer::poll() {
+#ifndef __EMSCRIPTEN__
+  auto &slot = slots_[tail_];
+  if (!slot.pending) {
+    return std::nullopt;
+  }
+  // The end timestamp is written after the begin one.
+  auto result_available = GLint{GL_FALSE};
+  glGetQueryObjectiv(slot.end_query, GL_QUERY_RESULT_AVAILABLE, &result_available);
+  if (result_available == GL_FALSE) {
+    return std::nullopt;
+  }
+  auto begin_ns = GLuint64{0};
+  auto end_ns = GLuint64{0};
+  glGetQueryObjectui64v(slot.begin_query, GL_QUERY_RESULT, &begin_ns);
+  glGetQueryObjectui64v(slot.end_query, GL_QUERY_RESULT, &end_ns);
+  slot.pending = false;
+  tail_ = (tail_ + 1) % slots_.size();
+  return std::chrono::nanoseconds{end_ns > begin_ns ? end_ns - begin_ns : 0};
+#else
+  return std::nullopt;
+#endif
+}
+
+std::uint64_t GpuTimer::dropped() const { return dropped_; }
+} // namespace gp::gl
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <gp/gl/gl.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace gp::gl {
+/**
+ * @brief Measures the GPU time of a span of GL commands without waiting for the GPU.
+ *
+ * begin() and end() place GL_TIMESTAMP queries around the commands, their difference is the GPU time from the first
+ * command starting to the last one finishing. Timestamps rather than one GL_TIME_ELAPSED query, only one of those can
+ * be active at a time, timers could not overlap or nest.
+ *
+ * A result is available a frame or two after end(). The queries of the pending measurements are kept in a ring and
+ * poll() only returns results the GPU already has. A measurement begun while the ring is full of pending ones is
+ * dropped, so a slow GPU costs samples instead of a stall.
+ *
+ * Timer queries need GL 3.3 or ARB_timer_query, GL ES has none, there available() is false and the calls do nothing.
+ */
+class GpuTimer {
+public:
+  static constexpr auto DEFAULT_RING_SIZE = std::size_t{4};
+
+  /**
+   * @brief Constructs a GpuTimer.
+   * @param ring_size The number of measurements which can be pending at a time.
+   */
+  explicit GpuTimer(const std::size_t ring_size = DEFAULT_RING_SIZE);
+
+  /**
+   * @brief Destructor for GpuTimer.
+   */
+  ~GpuTimer();
+
+  GpuTimer(const GpuTimer &) = delete;
+  GpuTimer &operator=(const GpuTimer &) = delete;
+  GpuTimer(GpuTimer &&other) noexcept = delete;
+  GpuTimer &operator=(GpuTimer &&other) noexcept = delete;
+
+  /**
+   * @brief Returns true if the context supports timer queries.
+   * @return True if timer queries are available.
+   */
+  static bool available();
+
+  /**
+   * @brief Starts a measurement before the commands to time.
+   */
+  void begin();
+
+  /**
+   * @brief Ends the measurement after the commands to time.
+   */
+  void end();
+
+  /**
+   * @brief Returns the oldest measurement the GPU has finished, in the order of the measurements.
+   * @return The GPU time, or nothing if no measurement is ready.
+   */
+  std::optional<std::chrono::nanoseconds> poll();
+
+  /**
+   * @brief Returns the number of measurements dropped because the ring was full.
+   * @return The number of dropped measurements.
+   */
+  std::uint64_t dropped() const;
+
+private:
+  struct Slot {
+    GLuint begin_query{};
+    GLuint end_query{};
+    bool pending{};
+  };
+
+  const bool available_{};
+  std::vector<GLuint> queries_{};
+  std::vector<Slot> slots_{};
+  /**
+   * Next slot to measure into and oldest pending slot.
+   */
+  std::size_t head_{};
+  std::size_t tail_{};
+  bool measuring_{};
+  std::uint64_t dropped_{};
+};
+} // namespace gp::gl
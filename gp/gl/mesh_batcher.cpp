@@ -0,0 +1,151 @@
+#include "mesh_batcher.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <limits>
+#include <stdexcept>
+
+namespace gp::gl {
+namespace {
+#ifndef __EMSCRIPTEN__
+/**
+ * Layout of an indirect draw command of glMultiDrawElementsIndirect.
+ */
+struct DrawElementsIndirectCommand {
+  GLuint count{};
+  GLuint instance_count{};
+  GLuint first_index{};
+  GLint base_vertex{};
+  GLuint base_instance{};
+};
+#endif
+
+bool multi_draw_indirect_available() {
+#ifndef __EMSCRIPTEN__
+  // Loaded for GL 4.3 contexts, which also have base instances.
+  return glMultiDrawElementsIndirect != nullptr;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+MeshBatcher::MeshBatcher(const bool indirect)
+    : indirect_(indirect && multi_draw_indirect_available()) {}
+
+std::size_t MeshBatcher::add(const std::span<const glm::vec3> vertices,
+                             const std::span<const glm::vec3> normals,
+                             const std::span<const std::uint32_t> indices,
+                             const glm::vec4 &color) {
+  if (uploaded_) {
+    throw std::runtime_error("Meshes cannot be added to an uploaded batch");
+  }
+  if (normals.size() != vertices.size()) {
+    throw std::runtime_error("Mesh normals do not match its vertices");
+  }
+  if (vertices_.size() + vertices.size() > std::numeric_limits<std::uint32_t>::max()) {
+    throw std::runtime_error("Mesh batch exceeds 32-bit indices");
+  }
+
+  const auto base_vertex = static_cast<std::uint32_t>(vertices_.size());
+  draws_.push_back({static_cast<GLuint>(indices.size()), static_cast<GLuint>(indices_.size())});
+  vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+  normals_.insert(normals_.end(), normals.begin(), normals.end());
+  // Rebased here rather than by a base vertex, GL ES 3.0 has no glDrawElementsBaseVertex.
+  for (const auto index : indices) {
+    indices_.push_back(base_vertex + index);
+  }
+  colors_.push_back(color);
+  return draws_.size() - 1;
+}
+
+void MeshBatcher::upload() {
+  if (uploaded_) {
+    return;
+  }
+  uploaded_ = true;
+
+  vao_.bind();
+
+  vertex_buffer_ = std::make_unique<BufferObject>(GL_ARRAY_BUFFER);
+  vertex_buffer_->bind();
+  vertex_buffer_->set_data(vertices_.size() * sizeof(vertices_[0]), vertices_.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(POSITION_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+  glEnableVertexAttribArray(POSITION_LOCATION);
+
+  normal_buffer_ = std::make_unique<BufferObject>(GL_ARRAY_BUFFER);
+  normal_buffer_->bind();
+  normal_buffer_->set_data(normals_.size() * sizeof(normals_[0]), normals_.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(NORMAL_LOCATION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+  glEnableVertexAttribArray(NORMAL_LOCATION);
+
+  index_buffer_ = std::make_unique<BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
+  index_buffer_->bind();
+  index_buffer_->set_data(indices_.size() * sizeof(indices_[0]), indices_.data(), GL_STATIC_DRAW);
+
+#ifndef __EMSCRIPTEN__
+  if (indirect_) {
+    // One color per instance, each command draws the single instance its base instance points at.
+    color_buffer_ = std::make_unique<BufferObject>(GL_ARRAY_BUFFER);
+    color_buffer_->bind();
+    color_buffer_->set_data(colors_.size() * sizeof(colors_[0]), colors_.data(), GL_STATIC_DRAW);
+    glVertexAttribPointer(COLOR_LOCATION, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribDivisor(COLOR_LOCATION, 1);
+    glEnableVertexAttribArray(COLOR_LOCATION);
+
+    auto commands = std::vector<DrawElementsIndirectCommand>{};
+    commands.reserve(draws_.size());
+    for (std::size_t i = 0; i < draws_.size(); ++i) {
+      commands.push_back({draws_[i].count, 1, draws_[i].first_index, 0, static_cast<GLuint>(i)});
+    }
+    indirect_buffer_ = std::make_unique<BufferObject>(GL_DRAW_INDIRECT_BUFFER);
+    indirect_buffer_->bind();
+    indirect_buffer_->set_data(commands.size() * sizeof(commands[0]), commands.data(), GL_STATIC_DRAW);
+    indirect_buffer_->unbind();
+  }
+#endif
+
+  vao_.unbind();
+
+  vertices_ = {};
+  normals_ = {};
+  indices_ = {};
+  if (indirect_) {
+    colors_ = {};
+  }
+}
+
+void MeshBatcher::draw() const {
+  if (!uploaded_ || draws_.empty()) {
+    return;
+  }
+
+  vao_.bind();
+#ifndef __EMSCRIPTEN__
+  if (indirect_) {
+    indirect_buffer_->bind();
+    glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(draws_.size()), 0);
+    return;
+  }
+#endif
+  // The color attribute array is disabled, the attribute's current value applies to the whole draw.
+  for (std::size_t i = 0; i < draws_.size(); ++i) {
+    glVertexAttrib4fv(COLOR_LOCATION, glm::value_ptr(colors_[i]));
+    glDrawElements(GL_TRIANGLES,
+                   static_cast<GLsizei>(draws_[i].count),
+                   GL_UNSIGNED_INT,
+                   reinterpret_cast<const void *>(draws_[i].first_index * sizeof(std::uint32_t)));
+  }
+}
+
+bool MeshBatcher::indirect() const { return indirect_; }
+
+std::size_t MeshBatcher::size() const { return draws_.size(); }
+
+std::size_t MeshBatcher::draw_calls() const {
+  if (draws_.empty()) {
+    return 0;
+  }
+  return indirect_ ? 1 : draws_.size();
+}
+} // namespace gp::gl
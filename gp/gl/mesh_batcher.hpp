@@ -0,0 +1,107 @@
+#pragma once
+
+#include <gp/gl/buffer_object.hpp>
+#include <gp/gl/gl.hpp>
+#include <gp/gl/vertex_array_object.hpp>
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+namespace gp::gl {
+/**
+ * @brief Packs static meshes into shared buffers to draw them with as few draw calls as possible.
+ *
+ * All meshes share one vertex array object with one position, normal and index buffer, the indices are rebased to
+ * the packed vertices. Every mesh is a draw with its own color.
+ *
+ * With glMultiDrawElementsIndirect (GL 4.3) all draws are a single call. The colors are an instanced vertex attribute
+ * and every indirect command's base instance is its draw index, so the shader reads the draw's color without
+ * gl_DrawID or storage buffers, which GLSL 330 and GL ES lack. Without it (GL ES, macOS) every draw is a
+ * glDrawElements from the shared buffers with the color set as a constant vertex attribute, which still saves the
+ * vertex array and uniform changes between the draws.
+ *
+ * The shader reads the position at POSITION_LOCATION, the normal at NORMAL_LOCATION and the color at COLOR_LOCATION.
+ */
+class MeshBatcher {
+public:
+  static constexpr auto POSITION_LOCATION = GLuint{0};
+  static constexpr auto NORMAL_LOCATION = GLuint{1};
+  static constexpr auto COLOR_LOCATION = GLuint{2};
+
+  /**
+   * @brief Constructs an empty MeshBatcher.
+   * @param indirect False forces a draw call per mesh even where multi-draw-indirect is available.
+   */
+  explicit MeshBatcher(const bool indirect = true);
+
+  /**
+   * @brief Adds a mesh, to be called before upload().
+   * @param vertices The positions of the mesh.
+   * @param normals The normals, one per position.
+   * @param indices The triangle list, indexing the mesh's own positions.
+   * @param color The color of the mesh.
+   * @return The draw index of the mesh.
+   * @throw std::runtime_error If the batch is uploaded already, the normals do not match the positions or the packed
+   * vertices exceed 32-bit indices.
+   */
+  std::size_t add(std::span<const glm::vec3> vertices,
+                  std::span<const glm::vec3> normals,
+                  std::span<const std::uint32_t> indices,
+                  const glm::vec4 &color);
+
+  /**
+   * @brief Uploads the added meshes and releases their CPU copies.
+   */
+  void upload();
+
+  /**
+   * @brief Draws all meshes with the currently used shader program.
+   */
+  void draw() const;
+
+  /**
+   * @brief Returns true if draw() is a single multi-draw-indirect call.
+   * @return True if multi-draw-indirect is used.
+   */
+  bool indirect() const;
+
+  /**
+   * @brief Returns the number of meshes.
+   * @return The number of meshes.
+   */
+  std::size_t size() const;
+
+  /**
+   * @brief Returns the number of GL draw calls a draw() issues.
+   * @return The number of draw calls.
+   */
+  std::size_t draw_calls() const;
+
+private:
+  struct Draw {
+    GLuint count{};
+    GLuint first_index{};
+  };
+
+  bool indirect_{};
+  bool uploaded_{};
+
+  std::vector<glm::vec3> vertices_{};
+  std::vector<glm::vec3> normals_{};
+  std::vector<std::uint32_t> indices_{};
+  std::vector<glm::vec4> colors_{};
+  std::vector<Draw> draws_{};
+
+  VertexArrayObject vao_{};
+  std::unique_ptr<BufferObject> vertex_buffer_{};
+  std::unique_ptr<BufferObject> normal_buffer_{};
+  std::unique_ptr<BufferObject> index_buffer_{};
+  std::unique_ptr<BufferObject> color_buffer_{};
+  std::unique_ptr<BufferObject> indirect_buffer_{};
+};
+} // namespace gp::gl
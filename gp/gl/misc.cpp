@@ -3,21 +3,213 @@
 #include <gp/gl/shader.hpp>
 #include <gp/utils/utils.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <vector>
+
 namespace gp::gl {
+namespace {
+using Clock = std::chrono::steady_clock;
+
+struct ProgramBinaryHeader {
+  std::array<char, 4> magic{'G', 'P', 'P', 'B'};
+  std::uint32_t version{1};
+  std::uint64_t key{};
+  std::uint32_t format{};
+  std::uint32_t size{};
+};
+
+/**
+ * The platform's per-user cache directory, empty if the environment does not tell it.
+ */
+std::string default_cache_directory() {
+  const auto variable = [](const char *name) {
+    const auto *value = std::getenv(name);
+    return std::filesystem::path{value != nullptr ? value : ""};
+  };
+#ifdef _WIN32
+  const auto base = variable("LOCALAPPDATA");
+#else
+  auto base = variable("XDG_CACHE_HOME");
+  if (base.empty() && !variable("HOME").empty()) {
+    base = variable("HOME") / ".cache";
+  }
+#endif
+  return base.empty() ? std::string{} : (base / "gp" / "shader_cache").string();
+}
+
+std::mutex cache_mutex{};
+std::string cache_directory{default_cache_directory()};
+ShaderProgramStats stats{};
+
+void record(const Clock::time_point start, const bool binary_cache_hit) {
+  const auto lock_guard = std::lock_guard(cache_mutex);
+  ++stats.programs;
+  stats.binary_cache_hits += binary_cache_hit ? 1 : 0;
+  stats.creation_time += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+#ifndef __EMSCRIPTEN__
+std::optional<std::filesystem::path> program_binary_directory() {
+  auto directory = std::string{};
+  {
+    const auto lock_guard = std::lock_guard(cache_mutex);
+    directory = cache_directory;
+  }
+  auto formats_num = GLint{0};
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats_num);
+  if (directory.empty() || formats_num == 0) {
+    return std::nullopt;
+  }
+  return std::filesystem::path{directory};
+}
+
+/**
+ * The cache directory is shared by all executables, which use the same relative program names for different
+ * sources. The key in the file name keeps their binaries apart, the program name only makes it readable.
+ */
+std::filesystem::path program_binary_path(const std::filesystem::path &directory,
+                                          const std::string &program_name,
+                                          const std::uint64_t key) {
+  auto file_name = program_name;
+  std::ranges::replace_if(file_name, [](const char c) { return c == '/' || c == '\\' || c == ':'; }, '_');
+  auto key_hex = std::array<char, 17>{};
+  std::snprintf(key_hex.data(), key_hex.size(), "%016llx", static_cast<unsigned long long>(key));
+  return directory / (file_name + "_" + key_hex.data() + ".bin");
+}
+
+/**
+ * A binary only fits the driver which produced it, vendor, renderer and version tell a driver update.
+ */
+std::uint64_t program_binary_key(const std::string &vertex_shader_code, const std::string &fragment_shader_code) {
+  auto key = utils::fnv1a(vertex_shader_code);
+  key = utils::fnv1a(std::string_view{"\0", 1}, key);
+  key = utils::fnv1a(fragment_shader_code, key);
+  for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+    const auto *value = reinterpret_cast<const char *>(glGetString(name));
+    key = utils::fnv1a(std::string_view{"\0", 1}, key);
+    key = utils::fnv1a(value != nullptr ? value : "", key);
+  }
+  return key;
+}
+
+std::unique_ptr<ShaderProgram> load_program_binary(const std::filesystem::path &path, const std::uint64_t key) {
+  auto error_code = std::error_code{};
+  const auto file_size = std::filesystem::file_size(path, error_code);
+  if (error_code || file_size < sizeof(ProgramBinaryHeader)) {
+    return nullptr;
+  }
+  auto file = std::ifstream{path, std::ios::binary};
+  auto header = ProgramBinaryHeader{};
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.magic != ProgramBinaryHeader{}.magic ||
+      header.version != ProgramBinaryHeader{}.version || header.key != key) {
+    return nullptr;
+  }
+  // A truncated or corrupt file must not make the size field allocate, it is compiled again instead.
+  if (header.size != file_size - sizeof(header)) {
+    return nullptr;
+  }
+  auto binary = std::vector<std::uint8_t>(header.size);
+  if (!file.read(reinterpret_cast<char *>(binary.data()), static_cast<std::streamsize>(binary.size()))) {
+    return nullptr;
+  }
+  auto shader_program = std::make_unique<ShaderProgram>();
+  if (!shader_program->load_binary(header.format, binary)) {
+    return nullptr;
+  }
+  return shader_program;
+}
+
+void store_program_binary(const std::filesystem::path &path, const std::uint64_t key, const ShaderProgram &program) {
+  auto format = GLenum{};
+  const auto binary = program.binary(format);
+  if (binary.empty()) {
+    return;
+  }
+  auto error_code = std::error_code{};
+  std::filesystem::create_directories(path.parent_path(), error_code);
+  auto header = ProgramBinaryHeader{};
+  header.key = key;
+  header.format = format;
+  header.size = static_cast<std::uint32_t>(binary.size());
+  // Written aside under a name of its own and renamed, concurrently starting processes neither read half a binary nor
+  // write into each other's.
+  auto temp_path = path;
+  temp_path += "." + std::to_string(std::random_device{}()) + ".tmp";
+  auto file = std::ofstream{temp_path, std::ios::binary | std::ios::trunc};
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(binary.data()), static_cast<std::streamsize>(binary.size()));
+  file.close();
+  if (!file) {
+    std::filesystem::remove(temp_path, error_code);
+    return;
+  }
+  std::filesystem::rename(temp_path, path, error_code);
+  if (error_code) {
+    std::filesystem::remove(temp_path, error_code);
+  }
+}
+#endif
+} // namespace
+
 std::unique_ptr<ShaderProgram> create_shader_program(const std::string &program_name) {
+  const auto start = Clock::now();
   const auto vertex_shader_code = gp::utils::load_txt_file(program_name + ".vs");
   const auto fragment_shader_code = gp::utils::load_txt_file(program_name + ".fs");
 
+#ifndef __EMSCRIPTEN__
+  const auto binary_directory = program_binary_directory();
+  auto cache_path = std::optional<std::filesystem::path>{};
+  auto key = std::uint64_t{0};
+  if (binary_directory) {
+    key = program_binary_key(vertex_shader_code, fragment_shader_code);
+    cache_path = program_binary_path(*binary_directory, program_name, key);
+    if (auto shader_program = load_program_binary(*cache_path, key)) {
+      record(start, true);
+      return shader_program;
+    }
+  }
+#endif
+
   const auto vertex_shader = std::make_unique<Shader>(GL_VERTEX_SHADER, vertex_shader_code);
   const auto fragment_shader = std::make_unique<Shader>(GL_FRAGMENT_SHADER, fragment_shader_code);
 
   auto shader_program = std::make_unique<ShaderProgram>();
   shader_program->attach_shader(vertex_shader->id());
   shader_program->attach_shader(fragment_shader->id());
+#ifndef __EMSCRIPTEN__
+  if (cache_path) {
+    shader_program->set_binary_retrievable();
+  }
+#endif
   shader_program->link();
   shader_program->detach_shader(vertex_shader->id());
   shader_program->detach_shader(fragment_shader->id());
 
+#ifndef __EMSCRIPTEN__
+  if (cache_path) {
+    store_program_binary(*cache_path, key, *shader_program);
+  }
+#endif
+
+  record(start, false);
   return shader_program;
 }
+
+void set_program_binary_cache_directory(const std::string &directory) {
+  const auto lock_guard = std::lock_guard(cache_mutex);
+  cache_directory = directory;
+}
+
+ShaderProgramStats shader_program_stats() {
+  const auto lock_guard = std::lock_guard(cache_mutex);
+  return stats;
+}
 } // namespace gp::gl
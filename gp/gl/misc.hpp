@@ -2,10 +2,27 @@
 
 #include <gp/gl/shader_program.hpp>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace gp::gl {
+/**
+ * @brief Cumulative cost of create_shader_program(), a startup-time metric of the scenes.
+ */
+struct ShaderProgramStats {
+  std::uint64_t programs{};
+  /**
+   * Programs loaded from the program binary cache instead of being compiled and linked.
+   */
+  std::uint64_t binary_cache_hits{};
+  /**
+   * Loading the sources and compiling and linking them, or loading the cached binary.
+   */
+  std::chrono::microseconds creation_time{};
+};
+
 /**
  * @brief Creates a shader program by loading vertex and fragment shader code from a file.
  *
@@ -13,9 +30,32 @@ namespace gp::gl {
  * files indicated by the program_name parameter. The program_name parameter is a quasi filepath
  * without extensions (without .vs and .fs), as these extensions are added later to open the exact files.
  *
+ * Linked programs are kept as driver binaries in the program binary cache directory, keyed on the sources and the
+ * driver's vendor, renderer and version. A later run with the same sources and driver loads the binary instead of
+ * compiling, anything else compiles and caches a binary of its own. The key is part of the file name, executables
+ * with different sources under the same program name do not overwrite each other's binaries. Not available in
+ * Emscripten.
+ *
  * @param program_name The name of the shader program without extensions (e.g., "shader_program").
  * @return A unique pointer to the created shader program.
  * @throw std::runtime_error In case of errors during compilation or linking of the shader program.
  */
 std::unique_ptr<ShaderProgram> create_shader_program(const std::string &program_name);
+
+/**
+ * @brief Sets the directory of the program binary cache, a relative one is relative to the working directory.
+ *
+ * Defaults to the per-user cache directory, "gp/shader_cache" in $XDG_CACHE_HOME, ~/.cache or %LOCALAPPDATA%, and is
+ * created on the first store. Without any of them the cache is disabled. Failing to read or write the cache only costs
+ * the compile.
+ *
+ * @param directory The cache directory, empty disables the cache.
+ */
+void set_program_binary_cache_directory(const std::string &directory);
+
+/**
+ * @brief Returns the cost of the shader programs created so far.
+ * @return The stats of create_shader_program().
+ */
+ShaderProgramStats shader_program_stats();
 } // namespace gp::gl
@@ -0,0 +1,38 @@
+#include "renderbuffer_object.hpp"
+
+#include <stdexcept>
+
+namespace gp::gl {
+RenderbufferObject::RenderbufferObject() {
+  glGenRenderbuffers(1, &id_);
+  if (id() == 0) {
+    throw std::runtime_error("Failed to generate renderbuffer object");
+  }
+}
+
+RenderbufferObject::~RenderbufferObject() { glDeleteRenderbuffers(1, &id_); }
+
+RenderbufferObject::RenderbufferObject(RenderbufferObject &&other) noexcept
+    : id_{other.id_} {
+  other.id_ = 0;
+}
+
+RenderbufferObject &RenderbufferObject::operator=(RenderbufferObject &&other) noexcept {
+  if (this != &other) {
+    glDeleteRenderbuffers(1, &id_);
+    id_ = other.id_;
+    other.id_ = 0;
+  }
+  return *this;
+}
+
+GLuint RenderbufferObject::id() const { return id_; }
+
+void RenderbufferObject::bind() const { glBindRenderbuffer(GL_RENDERBUFFER, id()); }
+
+void RenderbufferObject::unbind() const { glBindRenderbuffer(GL_RENDERBUFFER, 0); }
+
+void RenderbufferObject::set_storage(const GLenum internal_format, const GLsizei width, const GLsizei height) const {
+  glRenderbufferStorage(GL_RENDERBUFFER, internal_format, width, height);
+}
+} // namespace gp::gl
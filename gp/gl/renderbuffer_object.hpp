@@ -0,0 +1,53 @@
+#pragma once
+
+#include <gp/gl/gl.hpp>
+
+namespace gp::gl {
+/**
+ * @brief Represents a renderbuffer object in OpenGL.
+ */
+class RenderbufferObject {
+public:
+  /**
+   * @brief Constructs a RenderbufferObject.
+   */
+  RenderbufferObject();
+
+  /**
+   * @brief Destructor for RenderbufferObject.
+   */
+  ~RenderbufferObject();
+
+  RenderbufferObject(const RenderbufferObject &) = delete;
+  RenderbufferObject &operator=(const RenderbufferObject &) = delete;
+  RenderbufferObject(RenderbufferObject &&other) noexcept;
+  RenderbufferObject &operator=(RenderbufferObject &&other) noexcept;
+
+  /**
+   * @brief Returns the ID of the renderbuffer object.
+   * @return The ID of the renderbuffer object.
+   */
+  GLuint id() const;
+
+  /**
+   * @brief Binds the renderbuffer object.
+   */
+  void bind() const;
+
+  /**
+   * @brief Unbinds the renderbuffer object.
+   */
+  void unbind() const;
+
+  /**
+   * @brief Allocates the storage of the renderbuffer object, which has to be bound.
+   * @param internal_format The internal format of the storage, e.g. GL_RGBA8 or GL_DEPTH24_STENCIL8.
+   * @param width The width of the storage in pixels.
+   * @param height The height of the storage in pixels.
+   */
+  void set_storage(const GLenum internal_format, const GLsizei width, const GLsizei height) const;
+
+private:
+  GLuint id_{};
+};
+} // namespace gp::gl
@@ -1,8 +1,11 @@
 #include "shader_program.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <glm/gtc/type_ptr.hpp>
 
 #include <stdexcept>
+#include <string>
 #include <utility>
 
 namespace gp::gl {
@@ -13,7 +16,7 @@ ShaderProgram::ShaderProgram() {
   }
 }
 
-ShaderProgram::~ShaderProgram() { glDeleteProgram(id()); }
+ShaderProgram::~ShaderProgram() { state_cache().delete_program(id()); }
 
 ShaderProgram::ShaderProgram(ShaderProgram &&other) noexcept
     : id_{other.id_}
@@ -23,7 +26,7 @@ ShaderProgram::ShaderProgram(ShaderProgram &&other) noexcept
 
 ShaderProgram &ShaderProgram::operator=(ShaderProgram &&other) noexcept {
   if (this != &other) {
-    glDeleteProgram(id());
+    state_cache().delete_program(id());
     id_ = other.id_;
     uniform_locations_ = std::move(other.uniform_locations_);
     other.id_ = 0;
@@ -33,7 +36,7 @@ ShaderProgram &ShaderProgram::operator=(ShaderProgram &&other) noexcept {
 
 GLuint ShaderProgram::id() const { return id_; }
 
-void ShaderProgram::use() const { glUseProgram(id()); }
+void ShaderProgram::use() const { state_cache().use_program(id()); }
 
 void ShaderProgram::attach_shader(const GLuint shader) const { glAttachShader(id(), shader); }
 
@@ -44,24 +47,89 @@ void ShaderProgram::link() const {
   check_link_status();
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const GLint value) {
-  glUniform1i(uniform_location(name), value);
+void ShaderProgram::set_binary_retrievable() const {
+#ifndef __EMSCRIPTEN__
+  glProgramParameteri(id(), GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#else
+  throw std::runtime_error("Program binaries are not available in Emscripten");
+#endif
+}
+
+std::vector<std::uint8_t> ShaderProgram::binary(GLenum &format) const {
+#ifndef __EMSCRIPTEN__
+  auto length = GLint{0};
+  glGetProgramiv(id(), GL_PROGRAM_BINARY_LENGTH, &length);
+  auto result = std::vector<std::uint8_t>(static_cast<std::size_t>(length));
+  if (length > 0) {
+    auto written = GLsizei{0};
+    glGetProgramBinary(id(), length, &written, &format, result.data());
+    result.resize(static_cast<std::size_t>(written));
+  }
+  return result;
+#else
+  throw std::runtime_error("Program binaries are not available in Emscripten");
+#endif
+}
+
+bool ShaderProgram::load_binary(const GLenum format, const std::vector<std::uint8_t> &binary) const {
+#ifndef __EMSCRIPTEN__
+  glProgramBinary(id(), format, binary.data(), static_cast<GLsizei>(binary.size()));
+  auto success = GLint{GL_FALSE};
+  glGetProgramiv(id(), GL_LINK_STATUS, &success);
+  return success == GL_TRUE;
+#else
+  throw std::runtime_error("Program binaries are not available in Emscripten");
+#endif
+}
+
+UniformHandle ShaderProgram::uniform_handle(const UniformName &name) { return {uniform_location(name)}; }
+
+void ShaderProgram::bind_uniform_block(const UniformName &name, const GLuint binding) const {
+  const auto index = glGetUniformBlockIndex(id(), name.name().data());
+  if (index == GL_INVALID_INDEX) {
+    throw std::runtime_error("Uniform block " + std::string{name.name()} + " not found");
+  }
+  glUniformBlockBinding(id(), index, binding);
+}
+
+void ShaderProgram::set_uniform(const UniformName &name, const GLint value) {
+  set_uniform(uniform_handle(name), value);
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const GLfloat value) {
-  glUniform1f(uniform_location(name), value);
+void ShaderProgram::set_uniform(const UniformName &name, const GLfloat value) {
+  set_uniform(uniform_handle(name), value);
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const glm::vec3 &value) {
-  glUniform3fv(uniform_location(name), 1, glm::value_ptr(value));
+void ShaderProgram::set_uniform(const UniformName &name, const glm::vec3 &value) {
+  set_uniform(uniform_handle(name), value);
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const glm::vec4 &value) {
-  glUniform4fv(uniform_location(name), 1, glm::value_ptr(value));
+void ShaderProgram::set_uniform(const UniformName &name, const glm::vec4 &value) {
+  set_uniform(uniform_handle(name), value);
 }
 
-void ShaderProgram::set_uniform(const std::string &name, const glm::mat4 &value) {
-  glUniformMatrix4fv(uniform_location(name), 1, GL_FALSE, glm::value_ptr(value));
+void ShaderProgram::set_uniform(const UniformName &name, const glm::mat4 &value) {
+  set_uniform(uniform_handle(name), value);
+}
+
+void ShaderProgram::set_uniform(const UniformHandle handle, const GLint value) const {
+  glUniform1i(handle.location, value);
+}
+
+void ShaderProgram::set_uniform(const UniformHandle handle, const GLfloat value) const {
+  glUniform1f(handle.location, value);
+}
+
+void ShaderProgram::set_uniform(const UniformHandle handle, const glm::vec3 &value) const {
+  glUniform3fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set_uniform(const UniformHandle handle, const glm::vec4 &value) const {
+  glUniform4fv(handle.location, 1, glm::value_ptr(value));
+}
+
+void ShaderProgram::set_uniform(const UniformHandle handle, const glm::mat4 &value) const {
+  glUniformMatrix4fv(handle.location, 1, GL_FALSE, glm::value_ptr(value));
 }
 
 void ShaderProgram::check_link_status() const {
@@ -76,17 +144,15 @@ void ShaderProgram::check_link_status() const {
   }
 }
 
-GLint ShaderProgram::uniform_location(const std::string &name) {
-  check_uniform_location(name);
-  return uniform_locations_.at(name);
-}
-
-void ShaderProgram::check_uniform_location(const std::string &name) {
-  if (uniform_locations_.count(name) == 0) {
-    uniform_locations_[name] = glGetUniformLocation(id(), name.c_str());
-    if (uniform_locations_[name] == -1) {
-      throw std::runtime_error("Uniform " + name + " not found");
-    }
+GLint ShaderProgram::uniform_location(const UniformName &name) {
+  if (const auto it = uniform_locations_.find(name.hash()); it != uniform_locations_.end()) {
+    return it->second;
+  }
+  const auto location = glGetUniformLocation(id(), name.name().data());
+  if (location == -1) {
+    throw std::runtime_error("Uniform " + std::string{name.name()} + " not found");
   }
+  uniform_locations_.emplace(name.hash(), location);
+  return location;
 }
 } // namespace gp::gl
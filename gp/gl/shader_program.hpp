@@ -1,13 +1,61 @@
 #pragma once
 
 #include <gp/gl/gl.hpp>
+#include <gp/utils/utils.hpp>
 
 #include <glm/glm.hpp>
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <unordered_map>
+#include <vector>
 
 namespace gp::gl {
+/**
+ * @brief Name of a uniform variable together with its 64-bit FNV-1a hash.
+ *
+ * Built from a string literal, the hash is computed at compile time, so looking up a cached location allocates nothing
+ * and hashes nothing at run time. Names from a std::string are hashed on construction and must outlive the object.
+ */
+class UniformName {
+public:
+  template<std::size_t N>
+  consteval UniformName(const char (&name)[N])
+      : name_{name, N - 1}
+      , hash_{utils::fnv1a(name_)} {}
+
+  UniformName(const std::string &name)
+      : name_{name}
+      , hash_{utils::fnv1a(name_)} {}
+
+  /**
+   * @brief Get the name, null-terminated.
+   * @return The name of the uniform variable.
+   */
+  constexpr std::string_view name() const { return name_; }
+
+  /**
+   * @brief Get the FNV-1a hash of the name.
+   * @return The hash of the name.
+   */
+  constexpr std::uint64_t hash() const { return hash_; }
+
+private:
+  std::string_view name_;
+  std::uint64_t hash_;
+};
+
+/**
+ * @brief Resolved location of a uniform variable in a shader program.
+ *
+ * Obtained once from ShaderProgram::uniform_handle(), setting a uniform through it is a plain glUniform* call.
+ */
+struct UniformHandle {
+  GLint location{-1};
+};
+
 /**
  * @brief Represents a shader program in OpenGL.
  *
@@ -59,40 +107,112 @@ public:
    */
   void link() const;
 
+  /**
+   * @brief Ask the driver to keep the binary of the next link retrievable by binary().
+   */
+  void set_binary_retrievable() const;
+
+  /**
+   * @brief Get the binary of the linked shader program.
+   * @param format Receives the driver-specific format of the binary.
+   * @return The binary, empty if the driver does not provide one.
+   */
+  std::vector<std::uint8_t> binary(GLenum &format) const;
+
+  /**
+   * @brief Load a binary obtained by binary() instead of linking the shader program.
+   * @param format The format of the binary.
+   * @param binary The binary.
+   * @return False if the driver rejected the binary, e.g. after a driver update. The shader program then has to be
+   * linked from its sources.
+   */
+  bool load_binary(const GLenum format, const std::vector<std::uint8_t> &binary) const;
+
+  /**
+   * @brief Resolve the location of a uniform variable, for setting it without a lookup.
+   * @param name The name of the uniform variable.
+   * @return The handle of the uniform variable.
+   * @throw std::runtime_error If the uniform variable is not found.
+   */
+  UniformHandle uniform_handle(const UniformName &name);
+
+  /**
+   * @brief Bind a uniform block of the shader program to a uniform buffer binding point.
+   * @param name The name of the uniform block.
+   * @param binding The binding point, as passed to UniformBuffer.
+   * @throw std::runtime_error If the uniform block is not found.
+   */
+  void bind_uniform_block(const UniformName &name, const GLuint binding) const;
+
   /**
    * @brief Set an integer uniform value in the shader program.
    * @param name The name of the uniform variable.
    * @param value The value to set.
    */
-  void set_uniform(const std::string &name, const GLint value);
+  void set_uniform(const UniformName &name, const GLint value);
 
   /**
    * @brief Set a floating-point uniform value in the shader program.
    * @param name The name of the uniform variable.
    * @param value The value to set.
    */
-  void set_uniform(const std::string &name, const GLfloat value);
+  void set_uniform(const UniformName &name, const GLfloat value);
 
   /**
    * @brief Set a vector uniform value in the shader program.
    * @param name The name of the uniform variable.
    * @param value The value to set.
    */
-  void set_uniform(const std::string &name, const glm::vec3 &value);
+  void set_uniform(const UniformName &name, const glm::vec3 &value);
 
   /**
    * @brief Set a vector uniform value in the shader program.
    * @param name The name of the uniform variable.
    * @param value The value to set.
    */
-  void set_uniform(const std::string &name, const glm::vec4 &value);
+  void set_uniform(const UniformName &name, const glm::vec4 &value);
 
   /**
    * @brief Set a matrix uniform value in the shader program.
    * @param name The name of the uniform variable.
    * @param value The value to set.
    */
-  void set_uniform(const std::string &name, const glm::mat4 &value);
+  void set_uniform(const UniformName &name, const glm::mat4 &value);
+
+  /**
+   * @brief Set an integer uniform value in the shader program.
+   * @param handle The handle of the uniform variable.
+   * @param value The value to set.
+   */
+  void set_uniform(const UniformHandle handle, const GLint value) const;
+
+  /**
+   * @brief Set a floating-point uniform value in the shader program.
+   * @param handle The handle of the uniform variable.
+   * @param value The value to set.
+   */
+  void set_uniform(const UniformHandle handle, const GLfloat value) const;
+
+  /**
+   * @brief Set a vector uniform value in the shader program.
+   * @param handle The handle of the uniform variable.
+   * @param value The value to set.
+   */
+  void set_uniform(const UniformHandle handle, const glm::vec3 &value) const;
+
+  /**
+   * @brief Set a vector uniform value in the shader program.
+   * @param handle The handle of the uniform variable.
+   * @param value The value to set.
+   */
+  void set_uniform(const UniformHandle handle, const glm::vec4 &value) const;
+
+  /**
+   * @brief Set a matrix uniform value in the shader program.
+   * @param handle The handle of the uniform variable.
+   * @param value The value to set.
+   */
+  void set_uniform(const UniformHandle handle, const glm::mat4 &value) const;
 
 private:
   /**
@@ -105,15 +225,16 @@ private:
    * @param name The name of the uniform variable.
    * @return The location of the uniform variable.
    */
-  GLint uniform_location(const std::string &name);
+  GLint uniform_location(const UniformName &name);
 
   /**
-   * @brief Check the location of a uniform variable in the shader program.
-   * @param name The name of the uniform variable.
+   * @brief Identity hash, the keys are FNV-1a hashes already.
    */
-  void check_uniform_location(const std::string &name);
+  struct UniformNameHash {
+    std::size_t operator()(const std::uint64_t hash) const noexcept { return static_cast<std::size_t>(hash); }
+  };
 
   GLuint id_{};
-  std::unordered_map<std::string, GLint> uniform_locations_{};
+  std::unordered_map<std::uint64_t, GLint, UniformNameHash> uniform_locations_{};
 };
 } // namespace gp::gl
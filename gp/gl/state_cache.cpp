@@ -0,0 +1,121 @@
+#include "state_cache.hpp"
+
+#include <cstddef>
+#include <span>
+
+namespace gp::gl {
+void StateCache::bind_buffer(const GLenum target, const GLuint id) {
+  const auto it = buffers_.find(target);
+  if (record(it != buffers_.end() && it->second == id)) {
+    glBindBuffer(target, id);
+    buffers_[target] = id;
+  }
+}
+
+void StateCache::buffer_bound(const GLenum target, const GLuint id) { buffers_[target] = id; }
+
+void StateCache::active_texture(const GLenum unit) {
+  if (record(active_texture_ == unit)) {
+    glActiveTexture(unit);
+    active_texture_ = unit;
+  }
+}
+
+void StateCache::bind_texture(const GLenum target, const GLuint id) {
+  if (!active_texture_) {
+    // Texture bindings are per unit, one query makes them trackable again.
+    auto unit = GLint{0};
+    glGetIntegerv(GL_ACTIVE_TEXTURE, &unit);
+    active_texture_ = static_cast<GLenum>(unit);
+  }
+  const auto key = texture_key(*active_texture_, target);
+  const auto it = textures_.find(key);
+  if (record(it != textures_.end() && it->second == id)) {
+    glBindTexture(target, id);
+    textures_[key] = id;
+  }
+}
+
+void StateCache::bind_vertex_array(const GLuint id) {
+  if (record(vertex_array_ == id)) {
+    glBindVertexArray(id);
+    vertex_array_ = id;
+    buffers_.erase(GL_ELEMENT_ARRAY_BUFFER);
+  }
+}
+
+void StateCache::use_program(const GLuint id) {
+  if (record(program_ == id)) {
+    glUseProgram(id);
+    program_ = id;
+  }
+}
+
+void StateCache::delete_buffers(const GLsizei n, const GLuint *ids) {
+  glDeleteBuffers(n, ids);
+  for (const auto id : std::span{ids, static_cast<std::size_t>(n)}) {
+    // Deleted objects are unbound from every target, their names are free for new objects.
+    std::erase_if(buffers_, [id](const auto &binding) { return binding.second == id && id != 0; });
+  }
+}
+
+void StateCache::delete_textures(const GLsizei n, const GLuint *ids) {
+  glDeleteTextures(n, ids);
+  for (const auto id : std::span{ids, static_cast<std::size_t>(n)}) {
+    std::erase_if(textures_, [id](const auto &binding) { return binding.second == id && id != 0; });
+  }
+}
+
+void StateCache::delete_vertex_arrays(const GLsizei n, const GLuint *ids) {
+  glDeleteVertexArrays(n, ids);
+  for (const auto id : std::span{ids, static_cast<std::size_t>(n)}) {
+    if (id != 0 && vertex_array_ == id) {
+      vertex_array_.reset();
+      buffers_.erase(GL_ELEMENT_ARRAY_BUFFER);
+    }
+  }
+}
+
+void StateCache::delete_program(const GLuint id) {
+  glDeleteProgram(id);
+  if (id != 0 && program_ == id) {
+    program_.reset();
+  }
+}
+
+void StateCache::invalidate() {
+  buffers_.clear();
+  active_texture_.reset();
+  textures_.clear();
+  vertex_array_.reset();
+  program_.reset();
+}
+
+void StateCache::set_enabled(const bool enabled) { enabled_ = enabled; }
+
+void StateCache::end_frame() {
+  last_frame_stats_ = frame_stats_;
+  frame_stats_ = {};
+}
+
+const StateCache::Stats &StateCache::frame_stats() const { return frame_stats_; }
+
+const StateCache::Stats &StateCache::last_frame_stats() const { return last_frame_stats_; }
+
+bool StateCache::record(const bool redundant) {
+  ++frame_stats_.calls;
+  if (redundant) {
+    ++frame_stats_.calls_redundant;
+  }
+  return !redundant || !enabled_;
+}
+
+std::uint64_t StateCache::texture_key(const GLenum unit, const GLenum target) {
+  return (static_cast<std::uint64_t>(unit) << 32) | target;
+}
+
+StateCache &state_cache() {
+  thread_local auto cache = StateCache{};
+  return cache;
+}
+} // namespace gp::gl
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <gp/gl/gl.hpp>
+
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+namespace gp::gl {
+/**
+ * @brief Shadows the GL binding state to skip binds which would not change anything.
+ *
+ * Buffer, texture, vertex array and program bindings of the gp::gl objects go through the cache. A call whose
+ * binding is already current is dropped, every other one is issued and remembered. State the cache has not seen yet,
+ * or which changed behind its back, is unknown and the next call for it is always issued.
+ *
+ * The cache assumes one GL context per thread, as the scenes use them. It is reset when a context is made current;
+ * code binding objects with raw GL calls has to call invalidate() afterwards.
+ *
+ * Besides, it counts the bind calls of the current frame, end_frame() closes a frame.
+ */
+class StateCache {
+public:
+  /**
+   * @brief Bind calls of a frame.
+   */
+  struct Stats {
+    /**
+     * Calls made to the cache.
+     */
+    std::uint64_t calls{};
+    /**
+     * Calls whose binding was current already, dropped unless skipping is disabled.
+     */
+    std::uint64_t calls_redundant{};
+  };
+
+  /**
+   * @brief Binds a buffer object to a target, e.g. glBindBuffer.
+   * @param target The target.
+   * @param id The buffer object, or 0 to unbind.
+   */
+  void bind_buffer(const GLenum target, const GLuint id);
+
+  /**
+   * @brief Records a binding made by glBindBufferBase or glBindBufferRange, which also bind the generic target.
+   * @param target The target.
+   * @param id The buffer object.
+   */
+  void buffer_bound(const GLenum target, const GLuint id);
+
+  /**
+   * @brief Selects the active texture unit, e.g. glActiveTexture.
+   * @param unit The texture unit, e.g. GL_TEXTURE0.
+   */
+  void active_texture(const GLenum unit);
+
+  /**
+   * @brief Binds a texture object to a target of the active texture unit, e.g. glBindTexture.
+   * @param target The target.
+   * @param id The texture object, or 0 to unbind.
+   */
+  void bind_texture(const GLenum target, const GLuint id);
+
+  /**
+   * @brief Binds a vertex array object, e.g. glBindVertexArray.
+   *
+   * The element array buffer binding is part of the vertex array object, it becomes unknown.
+   *
+   * @param id The vertex array object, or 0 to unbind.
+   */
+  void bind_vertex_array(const GLuint id);
+
+  /**
+   * @brief Installs a program object, e.g. glUseProgram.
+   * @param id The program object, or 0 to uninstall.
+   */
+  void use_program(const GLuint id);
+
+  /**
+   * @brief Deletes buffer objects and forgets their bindings, GL reuses the names of deleted objects.
+   * @param n The number of buffer objects.
+   * @param ids The buffer objects, 0 is ignored.
+   */
+  void delete_buffers(const GLsizei n, const GLuint *ids);
+
+  /**
+   * @brief Deletes texture objects and forgets their bindings.
+   * @param n The number of texture objects.
+   * @param ids The texture objects, 0 is ignored.
+   */
+  void delete_textures(const GLsizei n, const GLuint *ids);
+
+  /**
+   * @brief Deletes vertex array objects and forgets their bindings.
+   * @param n The number of vertex array objects.
+   * @param ids The vertex array objects, 0 is ignored.
+   */
+  void delete_vertex_arrays(const GLsizei n, const GLuint *ids);
+
+  /**
+   * @brief Deletes a program object and forgets it if it is installed.
+   * @param id The program object, 0 is ignored.
+   */
+  void delete_program(const GLuint id);
+
+  /**
+   * @brief Makes all state unknown, e.g. after another context was made current or after raw GL binds.
+   */
+  void invalidate();
+
+  /**
+   * @brief Enables or disables skipping, disabled every call is issued and redundant ones are only counted.
+   * @param enabled True to skip redundant calls, the default.
+   */
+  void set_enabled(const bool enabled);
+
+  /**
+   * @brief Closes the current frame, its counts become last_frame_stats().
+   */
+  void end_frame();
+
+  /**
+   * @brief Returns the counts of the frame in progress.
+   * @return The counts since the last end_frame().
+   */
+  const Stats &frame_stats() const;
+
+  /**
+   * @brief Returns the counts of the last completed frame.
+   * @return The counts between the last two end_frame() calls.
+   */
+  const Stats &last_frame_stats() const;
+
+private:
+  /**
+   * Counts a call and returns true if it has to be issued.
+   */
+  bool record(const bool redundant);
+
+  static std::uint64_t texture_key(const GLenum unit, const GLenum target);
+
+  bool enabled_{true};
+
+  std::unordered_map<GLenum, GLuint> buffers_{};
+  std::optional<GLenum> active_texture_{};
+  /**
+   * Keyed on the texture unit and the target.
+   */
+  std::unordered_map<std::uint64_t, GLuint> textures_{};
+  std::optional<GLuint> vertex_array_{};
+  std::optional<GLuint> program_{};
+
+  Stats frame_stats_{};
+  Stats last_frame_stats_{};
+};
+
+/**
+ * @brief Returns the state cache of the calling thread's GL context.
+ * @return The state cache.
+ */
+StateCache &state_cache();
+} // namespace gp::gl
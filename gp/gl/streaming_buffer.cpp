@@ -0,0 +1,173 @@
+#include "streaming_buffer.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+
+namespace gp::gl {
+namespace {
+// Waits in slices, drivers may clamp long timeouts.
+constexpr auto SYNC_WAIT_TIMEOUT_NS = GLuint64{100'000'000};
+
+bool buffer_storage_available() {
+#ifndef __EMSCRIPTEN__
+  // Loaded for GL 4.4 contexts or with ARB_buffer_storage.
+  return glBufferStorage != nullptr;
+#else
+  return false;
+#endif
+}
+} // namespace
+
+StreamingBuffer::Sync::Sync(GLsync sync)
+    : sync{sync} {}
+
+StreamingBuffer::Sync::~Sync() { glDeleteSync(sync); }
+
+void StreamingBuffer::Sync::wait() const {
+  while (true) {
+    const auto result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, SYNC_WAIT_TIMEOUT_NS);
+    if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+      return;
+    }
+    if (result == GL_WAIT_FAILED) {
+      throw std::runtime_error("Failed to wait for a streaming buffer fence");
+    }
+  }
+}
+
+StreamingBuffer::StreamingBuffer(const GLenum target,
+                                 const GLsizeiptr capacity,
+                                 const Access access,
+                                 const bool persistent)
+    : buffer_object_(target)
+    , capacity_(capacity)
+    , access_(access)
+    , persistent_(persistent && buffer_storage_available()) {
+  if (capacity_ <= 0) {
+    throw std::runtime_error("Streaming buffer capacity must be positive");
+  }
+
+  buffer_object_.bind();
+  if (persistent_) {
+    const auto map_flags = static_cast<GLbitfield>(access_ == Access::Write ? GL_MAP_WRITE_BIT : GL_MAP_READ_BIT) |
+                           GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    // Readbacks are read by the CPU, a hint to keep the storage in system memory.
+    buffer_object_.set_storage(capacity_, nullptr, map_flags | (access_ == Access::Read ? GL_CLIENT_STORAGE_BIT : 0));
+    mapped_ = buffer_object_.map_range(0, capacity_, map_flags);
+    if (mapped_ == nullptr) {
+      buffer_object_.unbind();
+      throw std::runtime_error("Failed to map streaming buffer persistently");
+    }
+  } else {
+    buffer_object_.set_data(capacity_, nullptr, access_ == Access::Write ? GL_STREAM_DRAW : GL_STREAM_READ);
+  }
+  buffer_object_.unbind();
+}
+
+StreamingBuffer::~StreamingBuffer() {
+  if (mapped_ != nullptr) {
+    unmap();
+  }
+}
+
+bool StreamingBuffer::persistent() const { return persistent_; }
+
+GLsizeiptr StreamingBuffer::capacity() const { return capacity_; }
+
+void StreamingBuffer::bind() const { buffer_object_.bind(); }
+
+void StreamingBuffer::unbind() const { buffer_object_.unbind(); }
+
+StreamingBuffer::Allocation StreamingBuffer::allocate(const GLsizeiptr size, const GLsizeiptr alignment) {
+  if (size <= 0 || size > capacity_ || alignment <= 0) {
+    throw std::runtime_error("Invalid streaming buffer allocation size");
+  }
+
+  auto offset = aligned(head_, alignment);
+  if (offset + size > capacity_) {
+    offset = 0;
+  }
+  const auto end = offset + size;
+  const auto overlaps = [offset, end](const Region &region) { return region.begin < end && offset < region.end; };
+  if (std::ranges::any_of(unfenced_, overlaps)) {
+    throw std::runtime_error("Streaming buffer allocations between two fences exceed its capacity");
+  }
+  // Regions are fenced in ring order, the oldest one is the first to become free.
+  while (std::ranges::any_of(fenced_, overlaps)) {
+    fenced_.front().sync->wait();
+    fenced_.pop_front();
+  }
+  head_ = end;
+  unfenced_.push_back({offset, end, nullptr});
+
+  auto allocation = Allocation{offset, size, nullptr};
+  if (access_ == Access::Write) {
+    constexpr auto map_access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    allocation.data = persistent_ ? static_cast<void *>(static_cast<std::byte *>(mapped_) + offset)
+                                  : map(offset, size, map_access);
+  }
+  return allocation;
+}
+
+void StreamingBuffer::commit(Allocation &allocation) {
+  if (access_ != Access::Write || allocation.data == nullptr) {
+    return;
+  }
+  // Coherent persistent writes are visible to commands issued from now on.
+  if (!persistent_) {
+    unmap();
+  }
+  allocation.data = nullptr;
+}
+
+void StreamingBuffer::fence() {
+  if (unfenced_.empty()) {
+    return;
+  }
+  const auto sync = std::make_shared<Sync>(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+  for (auto &region : unfenced_) {
+    region.sync = sync;
+    fenced_.emplace_back(std::move(region));
+  }
+  unfenced_.clear();
+}
+
+const void *StreamingBuffer::read(Allocation &allocation) {
+  const auto region =
+      std::ranges::find_if(fenced_, [&allocation](const Region &region) { return region.begin == allocation.offset; });
+  if (access_ != Access::Read || region == fenced_.end()) {
+    throw std::runtime_error("Streaming buffer region read before it was fenced");
+  }
+  region->sync->wait();
+  allocation.data = persistent_ ? static_cast<void *>(static_cast<std::byte *>(mapped_) + allocation.offset)
+                                : map(allocation.offset, allocation.size, GL_MAP_READ_BIT);
+  return allocation.data;
+}
+
+void StreamingBuffer::release(Allocation &allocation) {
+  if (access_ != Access::Read || allocation.data == nullptr) {
+    return;
+  }
+  if (!persistent_) {
+    unmap();
+  }
+  allocation.data = nullptr;
+}
+
+void *StreamingBuffer::map(const GLintptr offset, const GLsizeiptr size, const GLbitfield access) const {
+  buffer_object_.bind();
+  auto *data = buffer_object_.map_range(offset, size, access);
+  buffer_object_.unbind();
+  if (data == nullptr) {
+    throw std::runtime_error("Failed to map streaming buffer range");
+  }
+  return data;
+}
+
+void StreamingBuffer::unmap() const {
+  buffer_object_.bind();
+  buffer_object_.unmap();
+  buffer_object_.unbind();
+}
+} // namespace gp::gl
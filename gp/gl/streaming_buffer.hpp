@@ -0,0 +1,178 @@
+#pragma once
+
+#include <gp/gl/buffer_object.hpp>
+#include <gp/gl/gl.hpp>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace gp::gl {
+/**
+ * @brief Ring buffer for data streamed between CPU and GPU every frame, e.g. pixel uploads, readbacks or vertices.
+ *
+ * The buffer is sub-allocated front to back and wraps around. A region is reused only after the fence placed behind
+ * the GL commands that accessed it has signaled, so neither side ever waits for the other while the ring holds more
+ * than one frame in flight.
+ *
+ * With glBufferStorage (GL 4.4 or ARB_buffer_storage) the whole buffer stays mapped persistently and coherently, an
+ * allocation is a plain pointer into it. Without it, each allocation maps its range with glMapBufferRange: writes
+ * unsynchronized with the range invalidated, the fences already keep the GPU off the range. Reads map the range once
+ * its fence signaled. Only one range can be mapped at a time then, so an allocation has to be committed or released
+ * before the next one is allocated or read.
+ *
+ * The buffer is not bound after any of the calls.
+ */
+class StreamingBuffer {
+public:
+  enum class Access {
+    /**
+     * The CPU writes, the GPU reads, e.g. GL_PIXEL_UNPACK_BUFFER or GL_ARRAY_BUFFER.
+     */
+    Write,
+    /**
+     * The GPU writes, the CPU reads, e.g. GL_PIXEL_PACK_BUFFER.
+     */
+    Read
+  };
+
+  /**
+   * @brief A region of the buffer.
+   */
+  struct Allocation {
+    /**
+     * Offset in the buffer, to pass to GL calls as the pointer argument while the buffer is bound.
+     */
+    GLintptr offset{};
+    GLsizeiptr size{};
+    /**
+     * CPU pointer to the region, for Access::Write valid until commit(), for Access::Read null until read().
+     */
+    void *data{};
+  };
+
+  /**
+   * @brief Default alignment of allocations, covers vertex, pixel and uniform buffer offsets.
+   */
+  static constexpr auto DEFAULT_ALIGNMENT = GLsizeiptr{256};
+
+  /**
+   * @brief Rounds a size up to an alignment, e.g. to size the ring for a number of allocations.
+   * @param size The size in bytes.
+   * @param alignment The alignment in bytes.
+   * @return The aligned size in bytes.
+   */
+  static constexpr GLsizeiptr aligned(const GLsizeiptr size, const GLsizeiptr alignment = DEFAULT_ALIGNMENT) {
+    return (size + alignment - 1) / alignment * alignment;
+  }
+
+  /**
+   * @brief Constructs a StreamingBuffer.
+   * @param target The target of the buffer object.
+   * @param capacity The size of the ring in bytes, has to hold everything allocated between two fence() calls.
+   * @param access Which side writes to the buffer.
+   * @param persistent False forces mapping per allocation even where persistent mapping is available.
+   */
+  StreamingBuffer(const GLenum target, const GLsizeiptr capacity, const Access access, const bool persistent = true);
+
+  /**
+   * @brief Destructor for StreamingBuffer.
+   */
+  ~StreamingBuffer();
+
+  StreamingBuffer(const StreamingBuffer &) = delete;
+  StreamingBuffer &operator=(const StreamingBuffer &) = delete;
+  StreamingBuffer(StreamingBuffer &&other) noexcept = delete;
+  StreamingBuffer &operator=(StreamingBuffer &&other) noexcept = delete;
+
+  /**
+   * @brief Returns true if the buffer is mapped persistently.
+   * @return True if the buffer is mapped persistently.
+   */
+  bool persistent() const;
+
+  /**
+   * @brief Returns the size of the ring.
+   * @return The size of the ring in bytes.
+   */
+  GLsizeiptr capacity() const;
+
+  /**
+   * @brief Binds the buffer object to its target.
+   */
+  void bind() const;
+
+  /**
+   * @brief Unbinds the buffer object.
+   */
+  void unbind() const;
+
+  /**
+   * @brief Allocates a region, waiting for the GPU to be done with it if it is still in use.
+   * @param size The size of the region in bytes.
+   * @param alignment The alignment of the region's offset in bytes.
+   * @return The region, for Access::Write mapped for writing.
+   * @throw std::runtime_error If the region does not fit into the ring, or overlaps a region not fenced yet.
+   */
+  Allocation allocate(const GLsizeiptr size, const GLsizeiptr alignment = DEFAULT_ALIGNMENT);
+
+  /**
+   * @brief Ends writing to a region of an Access::Write buffer, has to be called before GL reads from it.
+   * @param allocation The region.
+   */
+  void commit(Allocation &allocation);
+
+  /**
+   * @brief Fences the regions allocated since the last call, to be called after the GL commands accessing them.
+   */
+  void fence();
+
+  /**
+   * @brief Waits until the GPU finished writing to a region of an Access::Read buffer and maps it.
+   * @param allocation The region, must be fenced.
+   * @return A pointer to the data of the region, valid until release().
+   * @throw std::runtime_error If the region is not fenced.
+   */
+  const void *read(Allocation &allocation);
+
+  /**
+   * @brief Ends reading from a region of an Access::Read buffer.
+   * @param allocation The region.
+   */
+  void release(Allocation &allocation);
+
+private:
+  /**
+   * Deletes the sync object with the last region fenced by it.
+   */
+  struct Sync {
+    explicit Sync(GLsync sync);
+    ~Sync();
+    Sync(const Sync &) = delete;
+    Sync &operator=(const Sync &) = delete;
+
+    void wait() const;
+
+    GLsync sync{};
+  };
+
+  struct Region {
+    GLintptr begin{};
+    GLintptr end{};
+    std::shared_ptr<Sync> sync{};
+  };
+
+  void *map(const GLintptr offset, const GLsizeiptr size, const GLbitfield access) const;
+  void unmap() const;
+
+  BufferObject buffer_object_;
+  const GLsizeiptr capacity_;
+  const Access access_;
+  bool persistent_{};
+  void *mapped_{};
+
+  GLintptr head_{};
+  std::vector<Region> unfenced_{};
+  std::deque<Region> fenced_{};
+};
+} // namespace gp::gl
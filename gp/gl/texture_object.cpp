@@ -1,8 +1,28 @@
 #include "texture_object.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
 namespace gp::gl {
+namespace {
+/**
+ * Copies the data into the ring and calls upload with its offset in the bound unpack buffer.
+ */
+template<typename Upload>
+void stream(StreamingBuffer &upload_buffer, const void *data, const GLsizeiptr size, Upload &&upload) {
+  auto allocation = upload_buffer.allocate(size);
+  std::memcpy(allocation.data, data, static_cast<std::size_t>(size));
+  upload_buffer.commit(allocation);
+  upload_buffer.bind();
+  upload(reinterpret_cast<const void *>(allocation.offset));
+  upload_buffer.unbind();
+  upload_buffer.fence();
+}
+} // namespace
+
 TextureObject::TextureObject(const GLenum target)
     : target_(target) {
   glGenTextures(1, &id_);
@@ -11,7 +31,7 @@ TextureObject::TextureObject(const GLenum target)
   }
 }
 
-TextureObject::~TextureObject() { glDeleteTextures(1, &id_); }
+TextureObject::~TextureObject() { state_cache().delete_textures(1, &id_); }
 
 TextureObject::TextureObject(TextureObject &&other) noexcept
     : id_{other.id_}
@@ -21,7 +41,7 @@ TextureObject::TextureObject(TextureObject &&other) noexcept
 
 TextureObject &TextureObject::operator=(TextureObject &&other) noexcept {
   if (this != &other) {
-    glDeleteTextures(1, &id_);
+    state_cache().delete_textures(1, &id_);
     id_ = other.id_;
     target_ = other.target_;
     other.id_ = 0;
@@ -33,9 +53,9 @@ GLuint TextureObject::id() const { return id_; }
 
 GLenum TextureObject::target() const { return target_; }
 
-void TextureObject::bind() const { glBindTexture(target(), id()); }
+void TextureObject::bind() const { state_cache().bind_texture(target(), id()); }
 
-void TextureObject::unbind() const { glBindTexture(target(), 0); }
+void TextureObject::unbind() const { state_cache().bind_texture(target(), 0); }
 
 void TextureObject::set_image(const GLint level,
                               const GLint internal_format,
@@ -48,6 +68,21 @@ void TextureObject::set_image(const GLint level,
   glTexImage2D(target(), level, internal_format, width, height, border, format, type, data);
 }
 
+void TextureObject::set_storage(const GLsizei levels,
+                                const GLenum internal_format,
+                                const GLsizei width,
+                                const GLsizei height) const {
+  glTexStorage2D(target(), levels, internal_format, width, height);
+}
+
+void TextureObject::set_storage(const GLsizei levels,
+                                const GLenum internal_format,
+                                const GLsizei width,
+                                const GLsizei height,
+                                const GLsizei depth) const {
+  glTexStorage3D(target(), levels, internal_format, width, height, depth);
+}
+
 void TextureObject::set_sub_image(const GLint level,
                                   const GLint xoffset,
                                   const GLint yoffset,
@@ -59,6 +94,61 @@ void TextureObject::set_sub_image(const GLint level,
   glTexSubImage2D(target(), level, xoffset, yoffset, width, height, format, type, data);
 }
 
+void TextureObject::set_sub_image(const GLint level,
+                                  const GLint x_offset,
+                                  const GLint y_offset,
+                                  const GLint z_offset,
+                                  const GLsizei width,
+                                  const GLsizei height,
+                                  const GLsizei depth,
+                                  const GLenum format,
+                                  const GLenum type,
+                                  const void *data) const {
+  glTexSubImage3D(target(), level, x_offset, y_offset, z_offset, width, height, depth, format, type, data);
+}
+
+void TextureObject::stream_sub_image(StreamingBuffer &upload_buffer,
+                                     const GLint level,
+                                     const GLint x_offset,
+                                     const GLint y_offset,
+                                     const GLsizei width,
+                                     const GLsizei height,
+                                     const GLenum format,
+                                     const GLenum type,
+                                     const void *data,
+                                     const GLsizeiptr size) const {
+  stream(upload_buffer, data, size, [&](const void *offset) {
+    set_sub_image(level, x_offset, y_offset, width, height, format, type, offset);
+  });
+}
+
+void TextureObject::stream_sub_image(StreamingBuffer &upload_buffer,
+                                     const GLint level,
+                                     const GLint x_offset,
+                                     const GLint y_offset,
+                                     const GLint z_offset,
+                                     const GLsizei width,
+                                     const GLsizei height,
+                                     const GLsizei depth,
+                                     const GLenum format,
+                                     const GLenum type,
+                                     const void *data,
+                                     const GLsizeiptr size) const {
+  stream(upload_buffer, data, size, [&](const void *offset) {
+    set_sub_image(level, x_offset, y_offset, z_offset, width, height, depth, format, type, offset);
+  });
+}
+
+void TextureObject::generate_mipmap() const { glGenerateMipmap(target()); }
+
+GLsizei TextureObject::mip_levels(const GLsizei width, const GLsizei height) {
+  auto levels = GLsizei{1};
+  for (auto size = std::max(width, height); size > 1; size /= 2) {
+    ++levels;
+  }
+  return levels;
+}
+
 void TextureObject::set_parameter(const GLenum pname, const GLfloat param) const {
   glTexParameterf(target(), pname, param);
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <gp/gl/gl.hpp>
+#include <gp/gl/streaming_buffer.hpp>
 
 #include <cstddef>
 
@@ -68,6 +69,33 @@ public:
                  const GLenum type,
                  const void *data) const;
 
+  /**
+   * @brief Allocates immutable storage for all levels of a 2D texture, e.g. GL_TEXTURE_2D.
+   *
+   * The size and format cannot change afterwards, set_image() fails, the content is set with set_sub_image(). Drivers
+   * can place immutable textures once and skip the completeness checks of mutable ones on every draw.
+   *
+   * @param levels The number of levels, e.g. mip_levels() for a full mipmap chain.
+   * @param internal_format The sized internal format, e.g. GL_RGBA8.
+   * @param width The width of the texture.
+   * @param height The height of the texture.
+   */
+  void set_storage(const GLsizei levels, const GLenum internal_format, const GLsizei width, const GLsizei height) const;
+
+  /**
+   * @brief Allocates immutable storage for all levels of a 3D texture or a texture array, e.g. GL_TEXTURE_2D_ARRAY.
+   * @param levels The number of levels.
+   * @param internal_format The sized internal format, e.g. GL_RGBA8.
+   * @param width The width of the texture.
+   * @param height The height of the texture.
+   * @param depth The depth of the texture, the number of layers of an array.
+   */
+  void set_storage(const GLsizei levels,
+                   const GLenum internal_format,
+                   const GLsizei width,
+                   const GLsizei height,
+                   const GLsizei depth) const;
+
   /**
    * @brief Sets the data of a portion of the texture object.
    * @param level The level-of-detail number.
@@ -88,6 +116,99 @@ public:
                      const GLenum type,
                      const void *data) const;
 
+  /**
+   * @brief Sets the data of a portion of a 3D texture or of layers of a texture array.
+   * @param level The level-of-detail number.
+   * @param x_offset The x offset of the sub-region.
+   * @param y_offset The y offset of the sub-region.
+   * @param z_offset The z offset of the sub-region, the first layer of an array.
+   * @param width The width of the sub-region.
+   * @param height The height of the sub-region.
+   * @param depth The depth of the sub-region, the number of layers of an array.
+   * @param format The format of the pixel data.
+   * @param type The data type of the pixel data.
+   * @param data A pointer to the image data in memory.
+   */
+  void set_sub_image(const GLint level,
+                     const GLint x_offset,
+                     const GLint y_offset,
+                     const GLint z_offset,
+                     const GLsizei width,
+                     const GLsizei height,
+                     const GLsizei depth,
+                     const GLenum format,
+                     const GLenum type,
+                     const void *data) const;
+
+  /**
+   * @brief Uploads a portion of the texture object through a pixel unpack buffer, without waiting for the GPU.
+   *
+   * The data is copied into a region of the ring and the texture is updated from there, the GPU copies it while the
+   * CPU goes on. The region is fenced right away and reused once the copy is done.
+   *
+   * @param upload_buffer A GL_PIXEL_UNPACK_BUFFER ring with StreamingBuffer::Access::Write.
+   * @param level The level-of-detail number.
+   * @param x_offset The x offset of the sub-region.
+   * @param y_offset The y offset of the sub-region.
+   * @param width The width of the sub-region.
+   * @param height The height of the sub-region.
+   * @param format The format of the pixel data.
+   * @param type The data type of the pixel data.
+   * @param data A pointer to the image data in memory.
+   * @param size The size of the image data in bytes.
+   */
+  void stream_sub_image(StreamingBuffer &upload_buffer,
+                        const GLint level,
+                        const GLint x_offset,
+                        const GLint y_offset,
+                        const GLsizei width,
+                        const GLsizei height,
+                        const GLenum format,
+                        const GLenum type,
+                        const void *data,
+                        const GLsizeiptr size) const;
+
+  /**
+   * @brief Uploads a portion of a 3D texture or layers of a texture array through a pixel unpack buffer.
+   * @param upload_buffer A GL_PIXEL_UNPACK_BUFFER ring with StreamingBuffer::Access::Write.
+   * @param level The level-of-detail number.
+   * @param x_offset The x offset of the sub-region.
+   * @param y_offset The y offset of the sub-region.
+   * @param z_offset The z offset of the sub-region, the first layer of an array.
+   * @param width The width of the sub-region.
+   * @param height The height of the sub-region.
+   * @param depth The depth of the sub-region, the number of layers of an array.
+   * @param format The format of the pixel data.
+   * @param type The data type of the pixel data.
+   * @param data A pointer to the image data in memory.
+   * @param size The size of the image data in bytes.
+   */
+  void stream_sub_image(StreamingBuffer &upload_buffer,
+                        const GLint level,
+                        const GLint x_offset,
+                        const GLint y_offset,
+                        const GLint z_offset,
+                        const GLsizei width,
+                        const GLsizei height,
+                        const GLsizei depth,
+                        const GLenum format,
+                        const GLenum type,
+                        const void *data,
+                        const GLsizeiptr size) const;
+
+  /**
+   * @brief Generates the levels below level 0 from it.
+   */
+  void generate_mipmap() const;
+
+  /**
+   * @brief Returns the number of levels of a full mipmap chain.
+   * @param width The width of level 0.
+   * @param height The height of level 0.
+   * @return The number of levels down to 1x1.
+   */
+  static GLsizei mip_levels(const GLsizei width, const GLsizei height);
+
   /**
    * @brief Retrieves a portion of the data from the texture object.
    * @param level The level-of-detail number.
@@ -1,5 +1,7 @@
 #include "texture_objects.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <algorithm>
 #include <stdexcept>
 #include <utility>
@@ -14,7 +16,7 @@ TextureObjects::TextureObjects(const std::size_t n, const GLenum target)
   }
 }
 
-TextureObjects::~TextureObjects() { glDeleteTextures(static_cast<GLsizei>(ids_.size()), ids_.data()); }
+TextureObjects::~TextureObjects() { state_cache().delete_textures(static_cast<GLsizei>(ids_.size()), ids_.data()); }
 
 TextureObjects::TextureObjects(TextureObjects &&other) noexcept
     : ids_(std::move(other.ids_))
@@ -22,7 +24,7 @@ TextureObjects::TextureObjects(TextureObjects &&other) noexcept
 
 TextureObjects &TextureObjects::operator=(TextureObjects &&other) noexcept {
   if (this != &other) {
-    glDeleteTextures(static_cast<GLsizei>(ids_.size()), ids_.data());
+    state_cache().delete_textures(static_cast<GLsizei>(ids_.size()), ids_.data());
     ids_ = std::move(other.ids_);
     target_ = other.target_;
   }
@@ -33,9 +35,9 @@ GLuint TextureObjects::id(const std::size_t index) const { return ids_[index]; }
 
 GLenum TextureObjects::target() const { return target_; }
 
-void TextureObjects::bind(const std::size_t index) const { glBindTexture(target(), id(index)); }
+void TextureObjects::bind(const std::size_t index) const { state_cache().bind_texture(target(), id(index)); }
 
-void TextureObjects::unbind() const { glBindTexture(target(), 0); }
+void TextureObjects::unbind() const { state_cache().bind_texture(target(), 0); }
 
 void TextureObjects::set_image(const GLint level,
                                const GLint internal_format,
@@ -0,0 +1,43 @@
+#include "uniform_buffer.hpp"
+
+#include <gp/gl/state_cache.hpp>
+
+#include <stdexcept>
+
+namespace gp::gl {
+UniformBuffer::UniformBuffer(const GLsizeiptr size, const GLuint binding)
+    : buffer_object_(GL_UNIFORM_BUFFER)
+    , size_(size)
+    , binding_(binding) {
+  if (size_ <= 0) {
+    throw std::runtime_error("Uniform buffer size must be positive");
+  }
+  buffer_object_.bind();
+  buffer_object_.set_data(size_, nullptr, GL_DYNAMIC_DRAW);
+  buffer_object_.unbind();
+  bind_base();
+}
+
+GLuint UniformBuffer::id() const { return buffer_object_.id(); }
+
+GLuint UniformBuffer::binding() const { return binding_; }
+
+GLsizeiptr UniformBuffer::size() const { return size_; }
+
+void UniformBuffer::bind_base() const {
+  glBindBufferBase(GL_UNIFORM_BUFFER, binding(), id());
+  state_cache().buffer_bound(GL_UNIFORM_BUFFER, id());
+}
+
+void UniformBuffer::set_data(const void *data, const GLsizeiptr size, const GLintptr offset) const {
+  if (offset < 0 || offset + size > size_) {
+    throw std::runtime_error("Uniform buffer update out of range");
+  }
+  buffer_object_.bind();
+  if (offset == 0 && size == size_) {
+    buffer_object_.set_data(size_, nullptr, GL_DYNAMIC_DRAW);
+  }
+  buffer_object_.set_sub_data(offset, size, data);
+  buffer_object_.unbind();
+}
+} // namespace gp::gl
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <gp/gl/buffer_object.hpp>
+#include <gp/gl/gl.hpp>
+
+namespace gp::gl {
+/**
+ * @brief Represents a uniform buffer object in OpenGL.
+ *
+ * Holds the values of a uniform block, e.g. the per-frame matrices shared by several draws or programs, so they are
+ * uploaded with one call instead of one glUniform* call per variable. The buffer stays bound to its binding point,
+ * programs use it after ShaderProgram::bind_uniform_block() with the same binding point. The layout of the data has to
+ * follow the block's std140 layout.
+ */
+class UniformBuffer {
+public:
+  /**
+   * @brief Constructs a UniformBuffer and binds it to a binding point.
+   * @param size The size of the uniform block in bytes.
+   * @param binding The binding point.
+   */
+  UniformBuffer(const GLsizeiptr size, const GLuint binding);
+
+  /**
+   * @brief Returns the ID of the buffer object.
+   * @return The ID of the buffer object.
+   */
+  GLuint id() const;
+
+  /**
+   * @brief Returns the binding point of the buffer.
+   * @return The binding point of the buffer.
+   */
+  GLuint binding() const;
+
+  /**
+   * @brief Returns the size of the buffer.
+   * @return The size of the buffer in bytes.
+   */
+  GLsizeiptr size() const;
+
+  /**
+   * @brief Binds the buffer to its binding point again, after another buffer took it over.
+   */
+  void bind_base() const;
+
+  /**
+   * @brief Sets the data of the uniform block.
+   *
+   * Replacing the whole block orphans the previous storage, so the upload does not wait for draws still reading it.
+   *
+   * @param data A pointer to the data.
+   * @param size The size of the data in bytes.
+   * @param offset The offset in bytes.
+   */
+  void set_data(const void *data, const GLsizeiptr size, const GLintptr offset = 0) const;
+
+  /**
+   * @brief Sets the whole data of the uniform block.
+   * @param data A struct laid out like the uniform block.
+   */
+  template<typename T>
+  void set_data(const T &data) const {
+    set_data(&data, static_cast<GLsizeiptr>(sizeof(T)));
+  }
+
+private:
+  BufferObject buffer_object_;
+  GLsizeiptr size_{};
+  GLuint binding_{};
+};
+} // namespace gp::gl
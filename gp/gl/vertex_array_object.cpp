@@ -1,5 +1,7 @@
 #include "vertex_array_object.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <stdexcept>
 
 namespace gp::gl {
@@ -10,7 +12,7 @@ VertexArrayObject::VertexArrayObject() {
   }
 }
 
-VertexArrayObject::~VertexArrayObject() { glDeleteVertexArrays(1, &id_); }
+VertexArrayObject::~VertexArrayObject() { state_cache().delete_vertex_arrays(1, &id_); }
 
 VertexArrayObject::VertexArrayObject(VertexArrayObject &&other) noexcept
     : id_{other.id_} {
@@ -19,7 +21,7 @@ VertexArrayObject::VertexArrayObject(VertexArrayObject &&other) noexcept
 
 VertexArrayObject &VertexArrayObject::operator=(VertexArrayObject &&other) noexcept {
   if (this != &other) {
-    glDeleteVertexArrays(1, &id_);
+    state_cache().delete_vertex_arrays(1, &id_);
     id_ = other.id_;
     other.id_ = 0;
   }
@@ -28,7 +30,7 @@ VertexArrayObject &VertexArrayObject::operator=(VertexArrayObject &&other) noexc
 
 GLuint VertexArrayObject::id() const { return id_; }
 
-void VertexArrayObject::bind() const { glBindVertexArray(id()); }
+void VertexArrayObject::bind() const { state_cache().bind_vertex_array(id()); }
 
-void VertexArrayObject::unbind() { glBindVertexArray(0); }
+void VertexArrayObject::unbind() { state_cache().bind_vertex_array(0); }
 } // namespace gp::gl
@@ -1,5 +1,7 @@
 #include "vertex_array_objects.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <algorithm>
 #include <stdexcept>
 #include <utility>
@@ -13,14 +15,16 @@ VertexArrayObjects::VertexArrayObjects(const std::size_t n)
   }
 }
 
-VertexArrayObjects::~VertexArrayObjects() { glDeleteVertexArrays(static_cast<GLsizei>(ids_.size()), ids_.data()); }
+VertexArrayObjects::~VertexArrayObjects() {
+  state_cache().delete_vertex_arrays(static_cast<GLsizei>(ids_.size()), ids_.data());
+}
 
 VertexArrayObjects::VertexArrayObjects(VertexArrayObjects &&other) noexcept
     : ids_(std::move(other.ids_)) {}
 
 VertexArrayObjects &VertexArrayObjects::operator=(VertexArrayObjects &&other) noexcept {
   if (this != &other) {
-    glDeleteVertexArrays(static_cast<GLsizei>(ids_.size()), ids_.data());
+    state_cache().delete_vertex_arrays(static_cast<GLsizei>(ids_.size()), ids_.data());
     ids_ = std::move(other.ids_);
   }
   return *this;
@@ -28,7 +32,7 @@ VertexArrayObjects &VertexArrayObjects::operator=(VertexArrayObjects &&other) no
 
 GLuint VertexArrayObjects::id(const std::size_t index) const { return ids_[index]; }
 
-void VertexArrayObjects::bind(const std::size_t index) const { glBindVertexArray(id(index)); }
+void VertexArrayObjects::bind(const std::size_t index) const { state_cache().bind_vertex_array(id(index)); }
 
-void VertexArrayObjects::unbind() { glBindVertexArray(0); }
+void VertexArrayObjects::unbind() { state_cache().bind_vertex_array(0); }
 } // namespace gp::gl
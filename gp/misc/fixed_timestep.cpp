@@ -0,0 +1,68 @@
+#include "fixed_timestep.hpp"
+
+#include <stdexcept>
+
+namespace gp::misc {
+FixedTimestep::FixedTimestep(const double tick_rate, const std::uint32_t max_steps) {
+  set_tick_rate(tick_rate);
+  set_max_steps(max_steps);
+}
+
+void FixedTimestep::set_tick_rate(const double tick_rate) {
+  if (!(tick_rate > 0.0)) {
+    throw std::runtime_error("Fixed timestep tick rate must be positive");
+  }
+  tick_ = std::chrono::duration_cast<Duration>(std::chrono::duration<double>{1.0 / tick_rate});
+  if (tick_ <= Duration::zero()) {
+    throw std::runtime_error("Fixed timestep tick rate is too high");
+  }
+  accumulator_ = {};
+}
+
+void FixedTimestep::set_max_steps(const std::uint32_t max_steps) {
+  if (max_steps == 0) {
+    throw std::runtime_error("Fixed timestep maximum steps must be positive");
+  }
+  max_steps_ = max_steps;
+}
+
+void FixedTimestep::set_realtime(const bool realtime) {
+  realtime_ = realtime;
+  accumulator_ = {};
+}
+
+bool FixedTimestep::realtime() const { return realtime_; }
+
+FixedTimestep::Duration FixedTimestep::tick() const { return tick_; }
+
+float FixedTimestep::tick_ms() const { return std::chrono::duration<float, std::milli>(tick_).count(); }
+
+std::uint32_t FixedTimestep::advance(const Duration elapsed) {
+  if (!realtime_) {
+    steps_ += max_steps_;
+    return max_steps_;
+  }
+
+  if (elapsed > Duration::zero()) {
+    accumulator_ += elapsed;
+  }
+  auto steps = static_cast<std::uint64_t>(accumulator_ / tick_);
+  accumulator_ %= tick_;
+  if (steps > max_steps_) {
+    dropped_ += tick_ * static_cast<Duration::rep>(steps - max_steps_);
+    steps = max_steps_;
+  }
+  steps_ += steps;
+  return static_cast<std::uint32_t>(steps);
+}
+
+float FixedTimestep::alpha() const {
+  return static_cast<float>(static_cast<double>(accumulator_.count()) / static_cast<double>(tick_.count()));
+}
+
+std::uint64_t FixedTimestep::steps() const { return steps_; }
+
+FixedTimestep::Duration FixedTimestep::dropped() const { return dropped_; }
+
+void FixedTimestep::reset() { accumulator_ = {}; }
+} // namespace gp::misc
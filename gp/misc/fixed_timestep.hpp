@@ -0,0 +1,84 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace gp::misc {
+/**
+ * @brief Turns elapsed frame time into a whole number of fixed simulation steps.
+ *
+ * The elapsed time accumulates and every full tick of it is a step, the remainder carries over to the next frame and
+ * alpha() is its fraction of a tick, to render the state interpolated between the last two steps. At most max_steps
+ * run per advance(), whole ticks beyond them are dropped so a slow frame cannot make the next one slower still.
+ *
+ * Not in real time, every advance() runs max_steps regardless of the elapsed time, so headless runs step as fast as
+ * they can.
+ */
+class FixedTimestep {
+public:
+  using Duration = std::chrono::nanoseconds;
+
+  static constexpr auto DEFAULT_MAX_STEPS = std::uint32_t{8};
+
+  /**
+   * @param tick_rate Steps per simulated second.
+   * @param max_steps Steps per advance() at most.
+   * @throw std::runtime_error If the tick rate or the maximum steps are not positive.
+   */
+  explicit FixedTimestep(const double tick_rate, const std::uint32_t max_steps = DEFAULT_MAX_STEPS);
+
+  /**
+   * @throw std::runtime_error If the tick rate is not positive.
+   */
+  void set_tick_rate(const double tick_rate);
+
+  /**
+   * @throw std::runtime_error If the maximum steps are not positive.
+   */
+  void set_max_steps(const std::uint32_t max_steps);
+
+  /**
+   * In real time by default.
+   */
+  void set_realtime(const bool realtime);
+  bool realtime() const;
+
+  Duration tick() const;
+  float tick_ms() const;
+
+  /**
+   * Accumulates the elapsed time.
+   *
+   * @return The number of steps to run.
+   */
+  std::uint32_t advance(const Duration elapsed);
+
+  /**
+   * The accumulated time short of the next step as a fraction of a tick, in [0, 1).
+   */
+  float alpha() const;
+
+  /**
+   * The number of steps advance() returned.
+   */
+  std::uint64_t steps() const;
+
+  /**
+   * The elapsed time dropped for exceeding the maximum steps.
+   */
+  Duration dropped() const;
+
+  /**
+   * Discards the accumulated time, e.g. after a pause.
+   */
+  void reset();
+
+private:
+  Duration tick_{};
+  std::uint32_t max_steps_{};
+  bool realtime_{true};
+  Duration accumulator_{};
+  std::uint64_t steps_{};
+  Duration dropped_{};
+};
+} // namespace gp::misc
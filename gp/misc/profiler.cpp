@@ -0,0 +1,192 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+namespace gp::misc {
+namespace {
+/**
+ * Nesting depth of the zones open on the calling thread.
+ */
+thread_local auto zone_depth = std::uint32_t{0};
+
+double to_us(const Profiler::Clock::duration duration) {
+  return std::chrono::duration<double, std::micro>(duration).count();
+}
+} // namespace
+
+Profiler::Profiler(const std::size_t frames)
+    : capacity_(frames)
+    , epoch_(Clock::now())
+    , frame_begin_(epoch_) {
+  if (frames == 0) {
+    throw std::runtime_error("Profiler frame ring size must be positive");
+  }
+}
+
+void Profiler::set_enabled(const bool enabled) noexcept { enabled_.store(enabled, std::memory_order_relaxed); }
+
+bool Profiler::enabled() const noexcept { return enabled_.load(std::memory_order_relaxed); }
+
+void Profiler::record(const Zone &zone) {
+  const auto lock_guard = std::lock_guard(mutex_);
+  if (pending_.size() == MAX_FRAME_ZONES) {
+    ++dropped_;
+    return;
+  }
+  pending_.push_back(zone);
+}
+
+std::uint64_t Profiler::dropped() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  return dropped_;
+}
+
+void Profiler::set_thread_name(const std::string &name) {
+  const auto thread = thread_index();
+  const auto lock_guard = std::lock_guard(mutex_);
+  thread_names_[thread] = name;
+}
+
+void Profiler::end_frame() {
+  if (!enabled()) {
+    return;
+  }
+  const auto now = Clock::now();
+  const auto lock_guard = std::lock_guard(mutex_);
+  if (frames_.size() == capacity_) {
+    frames_.pop_front();
+  }
+  frames_.push_back(Frame{frame_begin_, now, std::move(pending_)});
+  pending_ = {};
+  frame_begin_ = now;
+}
+
+std::vector<Profiler::Frame> Profiler::frames() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  return {frames_.begin(), frames_.end()};
+}
+
+std::vector<std::chrono::microseconds> Profiler::frame_times() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  auto times = std::vector<std::chrono::microseconds>{};
+  times.reserve(frames_.size());
+  for (const auto &frame : frames_) {
+    times.push_back(std::chrono::duration_cast<std::chrono::microseconds>(frame.end - frame.begin));
+  }
+  return times;
+}
+
+std::vector<Profiler::ZoneStats> Profiler::top_zones(const std::size_t count) const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  auto by_name = std::unordered_map<std::string, ZoneStats>{};
+  for (const auto &frame : frames_) {
+    for (const auto &zone : frame.zones) {
+      auto &stats = by_name[zone.name];
+      stats.total += std::chrono::duration_cast<std::chrono::microseconds>(zone.end - zone.begin);
+      ++stats.count;
+    }
+  }
+
+  auto top = std::vector<ZoneStats>{};
+  top.reserve(by_name.size());
+  for (auto &[name, stats] : by_name) {
+    stats.name = name;
+    stats.average = stats.total / static_cast<std::int64_t>(frames_.size());
+    top.push_back(std::move(stats));
+  }
+  std::sort(top.begin(), top.end(), [](const ZoneStats &a, const ZoneStats &b) {
+    return a.total != b.total ? a.total > b.total : a.name < b.name;
+  });
+  if (top.size() > count) {
+    top.resize(count);
+  }
+  return top;
+}
+
+nlohmann::json Profiler::chrome_trace() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  const auto complete_event = [this](const char *name,
+                                     const char *category,
+                                     const Clock::time_point begin,
+                                     const Clock::time_point end,
+                                     const std::int64_t thread) {
+    auto event = nlohmann::json::object();
+    event["name"] = name;
+    event["cat"] = category;
+    event["ph"] = "X";
+    event["ts"] = to_us(begin - epoch_);
+    event["dur"] = to_us(end - begin);
+    event["pid"] = 0;
+    event["tid"] = thread;
+    return event;
+  };
+
+  auto events = nlohmann::json::array();
+  for (const auto &[thread, name] : thread_names_) {
+    auto event = nlohmann::json::object();
+    event["name"] = "thread_name";
+    event["ph"] = "M";
+    event["pid"] = 0;
+    event["tid"] = thread;
+    event["args"]["name"] = name;
+    events.push_back(std::move(event));
+  }
+  for (const auto &frame : frames_) {
+    // Frames on a track of their own, above the threads.
+    events.push_back(complete_event("frame", "frame", frame.begin, frame.end, -1));
+    for (const auto &zone : frame.zones) {
+      events.push_back(complete_event(zone.name, "zone", zone.begin, zone.end, zone.thread));
+    }
+  }
+
+  auto trace = nlohmann::json::object();
+  trace["traceEvents"] = std::move(events);
+  trace["displayTimeUnit"] = "ms";
+  return trace;
+}
+
+void Profiler::write_chrome_trace(const std::string &filename) const {
+  auto file = std::ofstream(filename);
+  if (!file) {
+    throw std::runtime_error("Could not open trace file: " + filename);
+  }
+  file << chrome_trace().dump();
+  if (!file) {
+    throw std::runtime_error("Could not write trace file: " + filename);
+  }
+}
+
+std::uint32_t Profiler::thread_index() {
+  static auto next_index = std::atomic<std::uint32_t>{0};
+  thread_local const auto index = next_index.fetch_add(1, std::memory_order_relaxed);
+  return index;
+}
+
+Profiler &profiler() {
+  static auto instance = Profiler{};
+  return instance;
+}
+
+ProfileZone::ProfileZone(const char *name)
+    : name_(name)
+    , active_(profiler().enabled()) {
+  if (!active_) {
+    return;
+  }
+  depth_ = zone_depth++;
+  begin_ = Profiler::Clock::now();
+}
+
+ProfileZone::~ProfileZone() {
+  if (!active_) {
+    return;
+  }
+  const auto end = Profiler::Clock::now();
+  --zone_depth;
+  profiler().record({name_, Profiler::thread_index(), depth_, begin_, end});
+}
+} // namespace gp::misc
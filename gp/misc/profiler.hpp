@@ -0,0 +1,181 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gp::misc {
+/**
+ * @brief Collects the CPU time of named zones per frame, from any thread.
+ *
+ * Zones are scopes marked with GP_PROFILE_ZONE, each records its begin and end, its thread and its nesting depth on
+ * that thread. The zones ended between two end_frame() calls make up a frame, the last frames are kept in a ring for
+ * the overlay's frame-time graph and top zones, and for export as Chrome trace events (chrome://tracing, Perfetto).
+ *
+ * Recording takes a lock shared by all threads, cheap enough for zones of some microseconds and up, not for tight
+ * loops. GP_PROFILE_ZONE compiles to nothing unless GP_PROFILER is defined (the CMake option of the same name).
+ */
+class Profiler {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Zone {
+    /**
+     * Must outlive the profiler, zones are named by string literals.
+     */
+    const char *name{};
+    std::uint32_t thread{};
+    /**
+     * 0 for zones not nested in another zone of the same thread.
+     */
+    std::uint32_t depth{};
+    Clock::time_point begin{};
+    Clock::time_point end{};
+  };
+
+  struct Frame {
+    Clock::time_point begin{};
+    Clock::time_point end{};
+    std::vector<Zone> zones{};
+  };
+
+  /**
+   * Zones of the same name summed up over the frames in the ring.
+   */
+  struct ZoneStats {
+    std::string name{};
+    std::chrono::microseconds total{};
+    std::uint64_t count{};
+    /**
+     * Per frame in the ring.
+     */
+    std::chrono::microseconds average{};
+  };
+
+  static constexpr auto DEFAULT_FRAMES = std::size_t{240};
+  /**
+   * Zones recorded beyond this many in one frame are dropped, bounding programs which never call end_frame().
+   */
+  static constexpr auto MAX_FRAME_ZONES = std::size_t{65536};
+
+  /**
+   * @param frames The number of frames the ring keeps.
+   */
+  explicit Profiler(const std::size_t frames = DEFAULT_FRAMES);
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  /**
+   * Disabled, zones are not recorded and end_frame() does nothing. Enabled by default.
+   */
+  void set_enabled(const bool enabled) noexcept;
+  bool enabled() const noexcept;
+
+  /**
+   * Called by ProfileZone.
+   */
+  void record(const Zone &zone);
+
+  /**
+   * The number of zones dropped for exceeding MAX_FRAME_ZONES.
+   */
+  std::uint64_t dropped() const;
+
+  /**
+   * Names the calling thread in the trace export.
+   */
+  void set_thread_name(const std::string &name);
+
+  /**
+   * Closes the current frame, usually called once per Redraw by the scene.
+   */
+  void end_frame();
+
+  /**
+   * The frames in the ring, oldest first.
+   */
+  std::vector<Frame> frames() const;
+
+  /**
+   * The durations of the frames in the ring, oldest first.
+   */
+  std::vector<std::chrono::microseconds> frame_times() const;
+
+  /**
+   * The zones taking the most time over the frames in the ring, most expensive first.
+   */
+  std::vector<ZoneStats> top_zones(const std::size_t count) const;
+
+  /**
+   * The frames in the ring as Chrome trace events, timestamps relative to the profiler's construction.
+   */
+  nlohmann::json chrome_trace() const;
+
+  /**
+   * @throw std::runtime_error If the file cannot be written.
+   */
+  void write_chrome_trace(const std::string &filename) const;
+
+  /**
+   * Small sequential id of the calling thread, assigned on first use.
+   */
+  static std::uint32_t thread_index();
+
+private:
+  const std::size_t capacity_;
+  const Clock::time_point epoch_;
+  std::atomic<bool> enabled_{true};
+
+  mutable std::mutex mutex_{};
+  std::vector<Zone> pending_{};
+  std::uint64_t dropped_{};
+  Clock::time_point frame_begin_{};
+  std::deque<Frame> frames_{};
+  std::unordered_map<std::uint32_t, std::string> thread_names_{};
+};
+
+/**
+ * The process-wide profiler the scenes and GP_PROFILE_ZONE use.
+ */
+Profiler &profiler();
+
+/**
+ * Records a zone of profiler() from construction to destruction.
+ */
+class ProfileZone {
+public:
+  explicit ProfileZone(const char *name);
+  ~ProfileZone();
+
+  ProfileZone(const ProfileZone &) = delete;
+  ProfileZone &operator=(const ProfileZone &) = delete;
+  ProfileZone(ProfileZone &&) = delete;
+  ProfileZone &operator=(ProfileZone &&) = delete;
+
+private:
+  const char *name_{};
+  bool active_{};
+  std::uint32_t depth_{};
+  Profiler::Clock::time_point begin_{};
+};
+} // namespace gp::misc
+
+#ifdef GP_PROFILER
+# define GP_PROFILE_CONCAT_IMPL(a, b) a##b
+# define GP_PROFILE_CONCAT(a, b) GP_PROFILE_CONCAT_IMPL(a, b)
+/**
+ * Profiles the rest of the enclosing scope as a zone named by a string literal.
+ */
+# define GP_PROFILE_ZONE(name) const ::gp::misc::ProfileZone GP_PROFILE_CONCAT(gp_profile_zone_, __LINE__){name}
+#else
+# define GP_PROFILE_ZONE(name)
+#endif
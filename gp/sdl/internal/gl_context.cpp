@@ -1,5 +1,7 @@
 #include "gl_context.hpp"
 
+#include <gp/gl/state_cache.hpp>
+
 #include <stdexcept>
 
 namespace gp::sdl::internal {
@@ -24,6 +26,8 @@ void GLContext::make_current() const {
   if (!SDL_GL_MakeCurrent(win_->wnd(), gl_ctx())) {
     throw std::runtime_error{std::string{"SDL_GL_MakeCurrent error:"} + SDL_GetError()};
   }
+  // The cached bindings belong to the context current before.
+  gl::state_cache().invalidate();
 }
 
 SDL_GLContext GLContext::gl_ctx() const { return gl_ctx_; }
@@ -10,14 +10,23 @@
 #endif
 
 namespace gp::sdl::internal {
-SDLContext::SDLContext() {
+SDLContext::SDLContext(const char *video_driver) {
   if (context_created_) {
     throw std::runtime_error{"SDL context already created"};
   }
+  if (video_driver) {
+    SDL_SetHint(SDL_HINT_VIDEO_DRIVER, video_driver);
+  }
   if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
     throw std::runtime_error{std::string{"SDL_Init error:"} + SDL_GetError()};
   }
   context_created_ = true;
+
+  wake_event_type_ = SDL_RegisterEvents(1);
+  if (wake_event_type_ == 0) {
+    wake_event_type_ = SDL_EVENT_USER;
+  }
+  set_target_frame_rate(DEFAULT_FRAME_RATE);
 }
 
 SDLContext::~SDLContext() {
@@ -33,7 +42,7 @@ void SDLContext::withdraw_window_event_callback(const std::uint32_t wnd_id) { wi
 
 std::uint64_t SDLContext::timestamp() const { return SDL_GetTicks(); }
 
-int SDLContext::exec() const {
+int SDLContext::exec() {
   {
     misc::Event event(misc::Event::Type::Init, timestamp());
     for (const auto &[wnd_id, callback] : window_event_callbacks_) {
@@ -62,6 +71,21 @@ void SDLContext::request_close() {
   SDL_PushEvent(&quit_event);
 }
 
+void SDLContext::set_loop_mode(const LoopMode loop_mode) { loop_mode_ = loop_mode; }
+
+void SDLContext::set_target_frame_rate(const double frame_rate) {
+  frame_interval_ns_ = frame_rate > 0.0 ? static_cast<std::uint64_t>(SDL_NS_PER_SECOND / frame_rate) : 0;
+}
+
+void SDLContext::request_redraw() {
+  if (redraw_requested_.exchange(true)) {
+    return;
+  }
+  SDL_Event wake_event{};
+  wake_event.type = wake_event_type_;
+  SDL_PushEvent(&wake_event);
+}
+
 #ifdef __EMSCRIPTEN__
 void SDLContext::emscripten_main_loop(void *arg) {
   auto *context = static_cast<SDLContext *>(arg);
@@ -73,10 +97,11 @@ void SDLContext::emscripten_main_loop(void *arg) {
 }
 #endif
 
-int SDLContext::exec_loop(bool &quit_flag) const {
+int SDLContext::exec_loop(bool &quit_flag) {
   int return_code = 0;
   SDL_Event sdl_event;
 
+  wait_for_events();
   while (SDL_PollEvent(&sdl_event)) {
     switch (sdl_event.type) {
     case SDL_EVENT_QUIT: {
@@ -91,7 +116,11 @@ int SDLContext::exec_loop(bool &quit_flag) const {
       event.resize().width = sdl_event.window.data1;
       event.resize().height = sdl_event.window.data2;
       forward_event_to_window(wnd_id, event);
+      redraw_requested_ = true;
     } break;
+    case SDL_EVENT_WINDOW_EXPOSED:
+      redraw_requested_ = true;
+      break;
     case SDL_EVENT_MOUSE_BUTTON_DOWN:
     case SDL_EVENT_MOUSE_BUTTON_UP: {
       const auto wnd_id = sdl_event.button.windowID;
@@ -179,12 +208,52 @@ int SDLContext::exec_loop(bool &quit_flag) const {
     }
   }
 
-  const misc::Event redraw_event(misc::Event::Type::Redraw, timestamp());
-  forward_event_to_all_windows(redraw_event);
+  if (redraw_due()) {
+    const misc::Event redraw_event(misc::Event::Type::Redraw, timestamp());
+    forward_event_to_all_windows(redraw_event);
+  }
 
   return return_code;
 }
 
+void SDLContext::wait_for_events() const {
+  // The browser calls the main loop once per animation frame, it must not block there.
+#ifndef __EMSCRIPTEN__
+  if (loop_mode_ == LoopMode::Continuous) {
+    return;
+  }
+  if (loop_mode_ == LoopMode::OnDemand && !redraw_requested_) {
+    SDL_WaitEvent(nullptr);
+    return;
+  }
+  const auto now = SDL_GetTicksNS();
+  if (now < next_frame_ns_) {
+    // Rounded down, the last fraction of a millisecond is polled.
+    SDL_WaitEventTimeout(nullptr, static_cast<Sint32>((next_frame_ns_ - now) / SDL_NS_PER_MS));
+  }
+#endif
+}
+
+bool SDLContext::redraw_due() {
+  if (loop_mode_ == LoopMode::OnDemand && !redraw_requested_) {
+    return false;
+  }
+  if (loop_mode_ != LoopMode::Continuous) {
+    const auto now = SDL_GetTicksNS();
+    if (now < next_frame_ns_) {
+      return false;
+    }
+    // Keeps the cadence after a late frame, restarts it after a stall or an idle period.
+    next_frame_ns_ += frame_interval_ns_;
+    if (next_frame_ns_ <= now) {
+      next_frame_ns_ = now + frame_interval_ns_;
+    }
+  }
+  // Cleared before the Redraw, a scene animating in the on-demand mode requests the next one while drawing.
+  redraw_requested_ = false;
+  return true;
+}
+
 void SDLContext::forward_event_to_window(const std::uint32_t wnd_id, const misc::Event &event) const {
   const auto it = window_event_callbacks_.find(wnd_id);
   if (it != window_event_callbacks_.end()) {
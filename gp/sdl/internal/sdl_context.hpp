@@ -2,6 +2,8 @@
 
 #include <gp/misc/event.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <unordered_map>
 
@@ -10,7 +12,22 @@ using SDLWindowEventCallback = std::function<void(const misc::Event &)>;
 
 class SDLContext {
 public:
-  SDLContext();
+  /**
+   * How exec() schedules the Redraw events.
+   */
+  enum class LoopMode {
+    Continuous, /**< Redraws as often as possible, polling the events in between */
+    Paced,      /**< Redraws at the target frame rate, waiting for events in between */
+    OnDemand    /**< Redraws when requested, at most at the target frame rate, otherwise waits for events */
+  };
+
+  static constexpr auto DEFAULT_FRAME_RATE = 60.0;
+
+  /**
+   * @param video_driver SDL video driver to use instead of the platform default, e.g. "offscreen" to render through
+   * EGL pbuffers without a display server.
+   */
+  explicit SDLContext(const char *video_driver = nullptr);
   ~SDLContext();
 
   SDLContext(SDLContext &&) = delete;
@@ -26,19 +43,49 @@ public:
    * @return The number of milliseconds since the SDL context was created.
    */
   std::uint64_t timestamp() const;
-  int exec() const;
+  int exec();
   void request_close();
+  /**
+   * Continuous by default, the paced and on-demand modes leave the CPU idle while there is nothing to draw.
+   */
+  void set_loop_mode(const LoopMode loop_mode);
+  /**
+   * @param frame_rate Redraws per second of the paced and on-demand modes, 0 does not limit them.
+   */
+  void set_target_frame_rate(const double frame_rate);
+  /**
+   * Requests a Redraw in the on-demand mode, waking the loop if it waits for events. May be called from any thread.
+   * Resizing or exposing a window requests one as well.
+   */
+  void request_redraw();
 
 private:
 #ifdef __EMSCRIPTEN__
   static void emscripten_main_loop(void *arg);
 #endif
-  int exec_loop(bool &quit_flag) const;
+  int exec_loop(bool &quit_flag);
+  /**
+   * Blocks until an event arrives or the next Redraw is due, doesn't block in the continuous mode.
+   */
+  void wait_for_events() const;
+  bool redraw_due();
   void forward_event_to_window(const std::uint32_t wnd_id, const misc::Event &event) const;
   void forward_event_to_all_windows(const misc::Event &event) const;
 
   std::unordered_map<std::uint32_t, SDLWindowEventCallback> window_event_callbacks_{};
 
+  LoopMode loop_mode_{LoopMode::Continuous};
+  std::uint64_t frame_interval_ns_{};
+  std::uint64_t next_frame_ns_{};
+  /**
+   * Set initially, the first frame is drawn in every mode.
+   */
+  std::atomic<bool> redraw_requested_{true};
+  /**
+   * Pushed by request_redraw() to wake the loop.
+   */
+  std::uint32_t wake_event_type_{};
+
 #ifdef __EMSCRIPTEN__
   int return_code_{0};
 #endif
@@ -0,0 +1,140 @@
+#include "profiler_overlay.hpp"
+
+#include <gp/sdl/sdl.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace gp::sdl {
+namespace {
+constexpr auto graph_ms = 50.0f;
+constexpr auto graph_h = 100.0f;
+constexpr auto max_bar_w = 2.0f;
+constexpr auto ch = 8; // SDL_DEBUG_TEXT_FONT_CHARACTER_SIZE
+constexpr auto line_h = ch + 4;
+constexpr auto padding = 6;
+constexpr auto max_chars = 40;
+
+float to_ms(const std::chrono::microseconds duration) { return static_cast<float>(duration.count()) / 1000.0f; }
+
+std::vector<std::string> report_lines() {
+  const auto frame_times = misc::profiler().frame_times();
+  auto lines = std::vector<std::string>{};
+  if (frame_times.empty()) {
+    lines.push_back("no frames profiled");
+    return lines;
+  }
+
+  auto total = std::chrono::microseconds{};
+  auto max = std::chrono::microseconds{};
+  for (const auto time : frame_times) {
+    total += time;
+    max = std::max(max, time);
+  }
+  const auto average = total / static_cast<std::int64_t>(frame_times.size());
+  char line[max_chars + 1];
+  std::snprintf(line, sizeof(line), "frame avg %6.2f ms  max %6.2f ms", to_ms(average), to_ms(max));
+  lines.emplace_back(line);
+  for (const auto &zone : misc::profiler().top_zones(ProfilerOverlay::TOP_ZONES)) {
+    // Average time and calls per frame.
+    std::snprintf(line,
+                  sizeof(line),
+                  "%-22.22s %7.3f ms %4.1fx",
+                  zone.name.c_str(),
+                  to_ms(zone.average),
+                  static_cast<double>(zone.count) / static_cast<double>(frame_times.size()));
+    lines.emplace_back(line);
+  }
+  return lines;
+}
+} // namespace
+
+void ProfilerOverlay::handle_event(const misc::Event &event) {
+  if (event.type() != misc::Event::Type::Key || event.key().action != misc::Event::Action::Pressed) {
+    return;
+  }
+  if (event.key().scan_code == TOGGLE_KEY) {
+    visible_ = !visible_;
+  } else if (event.key().scan_code == EXPORT_KEY) {
+    try {
+      misc::profiler().write_chrome_trace(TRACE_FILENAME);
+      printf("Profiler trace written to %s\n", TRACE_FILENAME);
+    } catch (const std::runtime_error &e) {
+      printf("Profiler trace export failed: %s\n", e.what());
+    }
+  }
+}
+
+bool ProfilerOverlay::visible() const { return visible_; }
+
+void ProfilerOverlay::draw(const Renderer &r, const int width, const int height) const {
+  if (!visible_) {
+    return;
+  }
+  const auto sdl_r = r.sdl_renderer();
+  const auto frame_times = misc::profiler().frame_times();
+  const auto lines = report_lines();
+
+  const auto bar_w =
+      std::clamp(static_cast<float>(width - padding * 4) / misc::Profiler::DEFAULT_FRAMES, 1.0f, max_bar_w);
+  const auto graph_w = std::max(bar_w * misc::Profiler::DEFAULT_FRAMES, static_cast<float>(max_chars * ch));
+  const auto bg_w = graph_w + padding * 2;
+  const auto bg_h = std::min(graph_h + padding * 3 + static_cast<float>(lines.size() * line_h),
+                             static_cast<float>(height - padding * 2));
+  const auto bg_x = static_cast<float>(padding);
+  const auto bg_y = static_cast<float>(padding);
+
+  SDL_SetRenderDrawBlendMode(sdl_r, SDL_BLENDMODE_BLEND);
+  SDL_SetRenderDrawColor(sdl_r, 0, 0, 0, 180);
+  const SDL_FRect bg{bg_x, bg_y, bg_w, bg_h};
+  SDL_RenderFillRect(sdl_r, &bg);
+
+  // Newest frame on the right, the graph scrolls to the left.
+  const auto graph_x = bg_x + padding;
+  const auto graph_bottom = bg_y + padding + graph_h;
+  auto bars = std::vector<SDL_FRect>{};
+  bars.reserve(frame_times.size());
+  auto x = graph_x + graph_w - bar_w * static_cast<float>(frame_times.size());
+  for (const auto time : frame_times) {
+    const auto h = std::min(to_ms(time) / graph_ms, 1.0f) * graph_h;
+    bars.push_back({x, graph_bottom - h, std::max(bar_w - 1.0f, 1.0f), h});
+    x += bar_w;
+  }
+  SDL_SetRenderDrawColor(sdl_r, 90, 200, 90, 255);
+  SDL_RenderFillRects(sdl_r, bars.data(), static_cast<int>(bars.size()));
+
+  SDL_SetRenderDrawColor(sdl_r, 220, 220, 80, 160);
+  for (const auto ms : {1000.0f / 60.0f, 1000.0f / 30.0f}) {
+    const auto y = graph_bottom - ms / graph_ms * graph_h;
+    SDL_RenderLine(sdl_r, graph_x, y, graph_x + graph_w, y);
+  }
+  SDL_SetRenderDrawBlendMode(sdl_r, SDL_BLENDMODE_NONE);
+
+  SDL_SetRenderDrawColor(sdl_r, 220, 220, 220, 255);
+  auto ty = graph_bottom + padding;
+  for (const auto &line : lines) {
+    if (ty + ch > bg_y + bg_h) {
+      break;
+    }
+    SDL_RenderDebugText(sdl_r, graph_x, ty, line.c_str());
+    ty += line_h;
+  }
+}
+
+void ProfilerOverlay::report() {
+  if (!visible_) {
+    return;
+  }
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_report_ < std::chrono::seconds{1}) {
+    return;
+  }
+  last_report_ = now;
+  for (const auto &line : report_lines()) {
+    printf("%s\n", line.c_str());
+  }
+}
+} // namespace gp::sdl
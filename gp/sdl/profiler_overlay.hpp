@@ -0,0 +1,40 @@
+#pragma once
+
+#include <gp/misc/event.hpp>
+#include <gp/misc/profiler.hpp>
+#include <gp/sdl/renderer.hpp>
+
+#include <chrono>
+#include <cstddef>
+
+namespace gp::sdl {
+/**
+ * @brief Shows misc::profiler() in a scene, toggled with F3, and exports its trace with F4.
+ *
+ * draw() renders the frame times in the ring as a rolling bar graph, with lines at 60 and 30 frames per second, and
+ * the zones taking the most time below it. Scenes without an SDL renderer print the same report to the console with
+ * report() instead, once a second while the overlay is shown.
+ */
+class ProfilerOverlay {
+public:
+  static constexpr auto TOGGLE_KEY = misc::Event::ScanCode::F3;
+  static constexpr auto EXPORT_KEY = misc::Event::ScanCode::F4;
+  static constexpr auto TRACE_FILENAME = "profile_trace.json";
+  static constexpr auto TOP_ZONES = std::size_t{8};
+
+  /**
+   * Toggles the overlay or exports the trace on a press of their keys.
+   */
+  void handle_event(const misc::Event &event);
+
+  bool visible() const;
+
+  void draw(const Renderer &r, const int width, const int height) const;
+
+  void report();
+
+private:
+  bool visible_{};
+  std::chrono::steady_clock::time_point last_report_{};
+};
+} // namespace gp::sdl
@@ -10,6 +10,7 @@
 #include <iterator>
 #include <memory>
 #include <stdexcept>
+#include <utility>
 
 namespace gp::sdl {
 namespace {
@@ -40,7 +41,14 @@ Renderer::~Renderer() = default;
 
 void Renderer::clear() const { SDL_RenderClear(r_->r()); }
 
-void Renderer::present() const { SDL_RenderPresent(r_->r()); }
+void Renderer::present() const {
+  if (present_callback_) {
+    present_callback_();
+  }
+  SDL_RenderPresent(r_->r());
+}
+
+void Renderer::set_present_callback(std::function<void()> callback) { present_callback_ = std::move(callback); }
 
 void Renderer::set_color(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b) const {
   set_color(glm::uvec4{r, g, b, 255u});
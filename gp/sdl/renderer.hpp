@@ -7,6 +7,7 @@
 #include <glm/vec3.hpp>
 #include <glm/vec4.hpp>
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -20,6 +21,10 @@ public:
   void clear() const;
 
   void present() const;
+  /**
+   * Sets a callback present() calls before showing the frame, to draw on top of the scene.
+   */
+  void set_present_callback(std::function<void()> callback);
 
   void set_color(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b) const;
   void set_color(const std::uint8_t r, const std::uint8_t g, const std::uint8_t b, const std::uint8_t a) const;
@@ -63,5 +68,6 @@ public:
 
 private:
   std::unique_ptr<internal::SDLRenderer> r_;
+  std::function<void()> present_callback_{};
 };
 } // namespace gp::sdl
@@ -2,6 +2,8 @@
 
 #include <gp/sdl/internal/sdl_renderer.hpp>
 
+#include <stdexcept>
+
 namespace gp::sdl {
 Scene2D::Scene2D(std::shared_ptr<internal::SDLContext> ctx)
     : ctx_{ctx ? ctx : std::make_shared<internal::SDLContext>()} {}
@@ -16,6 +18,9 @@ void Scene2D::init(const int width, const int height, const std::string &title)
 
   auto r = std::make_unique<internal::SDLRenderer>(*wnd_);
   r_ = std::make_shared<Renderer>(std::move(r));
+#ifdef GP_PROFILER
+  r_->set_present_callback([this] { profiler_overlay_.draw(*r_, width_, height_); });
+#endif
 
   width_ = width;
   height_ = height;
@@ -33,6 +38,29 @@ std::uint64_t Scene2D::timestamp() const { return ctx_->timestamp(); }
 
 void Scene2D::request_close() { ctx_->request_close(); }
 
+void Scene2D::set_loop_mode(const internal::SDLContext::LoopMode loop_mode, const double frame_rate) {
+  ctx_->set_loop_mode(loop_mode);
+  ctx_->set_target_frame_rate(frame_rate);
+}
+
+void Scene2D::request_redraw() { ctx_->request_redraw(); }
+
+void Scene2D::step(const float) {}
+
+void Scene2D::set_fixed_timestep(const double tick_rate, const std::uint32_t max_steps) {
+  fixed_timestep_.emplace(tick_rate, max_steps);
+  last_step_time_ = std::chrono::steady_clock::now();
+}
+
+misc::FixedTimestep &Scene2D::fixed_timestep() {
+  if (!fixed_timestep_) {
+    throw std::runtime_error("Fixed timestep is not set");
+  }
+  return *fixed_timestep_;
+}
+
+float Scene2D::interpolation_alpha() const { return fixed_timestep_ ? fixed_timestep_->alpha() : 1.0f; }
+
 std::shared_ptr<const Renderer> Scene2D::renderer() const { return r_; }
 
 const Renderer &Scene2D::r() const { return *r_; }
@@ -40,10 +68,41 @@ const Renderer &Scene2D::r() const { return *r_; }
 std::shared_ptr<misc::KeyboardState> Scene2D::keyboard_state() const { return wnd_->keyboard_state(); }
 
 void Scene2D::window_event_callback(const misc::Event &event) {
-  loop(event);
+#ifdef GP_PROFILER
+  profiler_overlay_.handle_event(event);
+#endif
+  if (event.type() == misc::Event::Type::Redraw) {
+    redraw(event);
+  } else {
+    loop(event);
+  }
   if (event.type() == misc::Event::Type::Resize) {
     width_ = event.resize().width;
     height_ = event.resize().height;
   }
 }
+
+void Scene2D::redraw(const misc::Event &event) {
+  {
+    GP_PROFILE_ZONE("Scene2D::redraw");
+    run_fixed_steps();
+    loop(event);
+  }
+#ifdef GP_PROFILER
+  misc::profiler().end_frame();
+#endif
+}
+
+void Scene2D::run_fixed_steps() {
+  if (!fixed_timestep_) {
+    return;
+  }
+  GP_PROFILE_ZONE("Scene2D::step");
+  const auto now = std::chrono::steady_clock::now();
+  const auto steps = fixed_timestep_->advance(now - last_step_time_);
+  last_step_time_ = now;
+  for (std::uint32_t i = 0; i < steps; ++i) {
+    step(fixed_timestep_->tick_ms());
+  }
+}
 } // namespace gp::sdl
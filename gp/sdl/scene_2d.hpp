@@ -1,12 +1,16 @@
 #pragma once
 
 #include <gp/misc/event.hpp>
+#include <gp/misc/fixed_timestep.hpp>
 #include <gp/misc/keyboard_state.hpp>
 #include <gp/sdl/internal/sdl_context.hpp>
 #include <gp/sdl/internal/sdl_window.hpp>
+#include <gp/sdl/profiler_overlay.hpp>
 #include <gp/sdl/renderer.hpp>
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <string>
 
 namespace gp::sdl {
@@ -25,18 +29,49 @@ public:
 
 protected:
   virtual void loop(const misc::Event &event) = 0;
+  /**
+   * Called for every tick of the fixed timestep before a Redraw, once set_fixed_timestep() enabled it.
+   */
+  virtual void step(const float tick_ms);
 
   int width() const;
   int height() const;
 
   std::uint64_t timestamp() const;
   void request_close();
+  /**
+   * Sets how the context schedules the Redraw events, e.g. to leave the CPU idle while the scene does not change.
+   */
+  void set_loop_mode(const internal::SDLContext::LoopMode loop_mode,
+                     const double frame_rate = internal::SDLContext::DEFAULT_FRAME_RATE);
+  /**
+   * Requests a Redraw in the on-demand loop mode, may be called from any thread.
+   */
+  void request_redraw();
+  /**
+   * Runs step() at a fixed tick rate decoupled from the frame rate, see misc::FixedTimestep.
+   */
+  void set_fixed_timestep(const double tick_rate,
+                          const std::uint32_t max_steps = misc::FixedTimestep::DEFAULT_MAX_STEPS);
+  /**
+   * @throw std::runtime_error If set_fixed_timestep() was not called.
+   */
+  misc::FixedTimestep &fixed_timestep();
+  /**
+   * The fraction of a tick the Redraw is past the last step, 1 without a fixed timestep.
+   */
+  float interpolation_alpha() const;
   std::shared_ptr<const Renderer> renderer() const;
   const Renderer &r() const;
   std::shared_ptr<misc::KeyboardState> keyboard_state() const;
 
 private:
   void window_event_callback(const misc::Event &event);
+  /**
+   * Runs the due fixed steps and calls loop() with a Redraw event as a profiled zone, then closes the profiler's frame.
+   */
+  void redraw(const misc::Event &event);
+  void run_fixed_steps();
 
   int width_{};
   int height_{};
@@ -45,5 +80,12 @@ private:
   std::shared_ptr<internal::SDLContext> ctx_;
   std::unique_ptr<internal::SDLWindow> wnd_;
   std::shared_ptr<Renderer> r_;
+
+  std::optional<misc::FixedTimestep> fixed_timestep_{};
+  std::chrono::steady_clock::time_point last_step_time_{};
+
+#ifdef GP_PROFILER
+  ProfilerOverlay profiler_overlay_{};
+#endif
 };
 } // namespace gp::sdl
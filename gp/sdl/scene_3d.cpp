@@ -1,8 +1,11 @@
 #include "scene_3d.hpp"
 
 #include <gp/gl/gl.hpp>
+#include <gp/gl/state_cache.hpp>
 
+#include <array>
 #include <stdexcept>
+#include <utility>
 
 namespace gp::sdl {
 Scene3D::Scene3D(std::shared_ptr<internal::SDLContext> ctx)
@@ -25,12 +28,10 @@ void Scene3D::init(const int width, const int height, const std::string &title,
   }
 
   set_gl_hints();
-  wnd_ = std::make_shared<internal::SDLWindow>(ctx_,
-                                               width,
-                                               height,
-                                               title,
-                                               internal::SDLWindow::default_window_flags | SDL_WINDOW_OPENGL);
-  gl_ctx_ = std::make_unique<internal::GLContext>(wnd_);
+  const auto window_flags = internal::SDLWindow::default_window_flags | SDL_WINDOW_OPENGL |
+                            (hidden_window_ ? SDL_WINDOW_HIDDEN : SDL_WindowFlags{0});
+  wnd_ = std::make_shared<internal::SDLWindow>(ctx_, width, height, title, window_flags);
+  gl_ctx_ = create_gl_context();
 
   platform_gl_init();
 
@@ -55,10 +56,38 @@ int Scene3D::height() const { return height_; }
 
 std::uint64_t Scene3D::timestamp() const { return ctx_->timestamp(); }
 
-void Scene3D::swap_buffers() const { SDL_GL_SwapWindow(wnd_->wnd()); }
+void Scene3D::swap_buffers() const {
+  SDL_GL_SwapWindow(wnd_->wnd());
+  gl::state_cache().end_frame();
+}
+
+void Scene3D::set_hidden_window(const bool hidden_window) { hidden_window_ = hidden_window; }
 
 void Scene3D::request_close() { ctx_->request_close(); }
 
+void Scene3D::set_loop_mode(const internal::SDLContext::LoopMode loop_mode, const double frame_rate) {
+  ctx_->set_loop_mode(loop_mode);
+  ctx_->set_target_frame_rate(frame_rate);
+}
+
+void Scene3D::request_redraw() { ctx_->request_redraw(); }
+
+void Scene3D::step(const float) {}
+
+void Scene3D::set_fixed_timestep(const double tick_rate, const std::uint32_t max_steps) {
+  fixed_timestep_.emplace(tick_rate, max_steps);
+  last_step_time_ = std::chrono::steady_clock::now();
+}
+
+misc::FixedTimestep &Scene3D::fixed_timestep() {
+  if (!fixed_timestep_) {
+    throw std::runtime_error("Fixed timestep is not set");
+  }
+  return *fixed_timestep_;
+}
+
+float Scene3D::interpolation_alpha() const { return fixed_timestep_ ? fixed_timestep_->alpha() : 1.0f; }
+
 std::shared_ptr<misc::KeyboardState> Scene3D::keyboard_state() const { return wnd_->keyboard_state(); }
 
 void Scene3D::set_gl_hints() {
@@ -85,6 +114,24 @@ void Scene3D::set_gl_hints() {
 #endif
 }
 
+std::unique_ptr<internal::GLContext> Scene3D::create_gl_context() const {
+#if defined(__APPLE__) || defined(__EMSCRIPTEN__)
+  return std::make_unique<internal::GLContext>(wnd_);
+#else
+  // Software rasterizers such as Mesa llvmpipe may not offer 4.6, the shaders only require 3.3.
+  constexpr auto fallback_versions = std::array{std::pair{4, 5}, std::pair{3, 3}};
+  for (const auto &[major, minor] : fallback_versions) {
+    try {
+      return std::make_unique<internal::GLContext>(wnd_);
+    } catch (const std::runtime_error &) {
+      SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, major);
+      SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, minor);
+    }
+  }
+  return std::make_unique<internal::GLContext>(wnd_);
+#endif
+}
+
 void Scene3D::platform_gl_init() {
 #ifndef __EMSCRIPTEN__
   if (gladLoadGLLoader(reinterpret_cast<GLADloadproc>(SDL_GL_GetProcAddress)) == 0) {
@@ -94,10 +141,42 @@ void Scene3D::platform_gl_init() {
 }
 
 void Scene3D::window_event_callback(const misc::Event &event) {
-  loop(event);
+#ifdef GP_PROFILER
+  profiler_overlay_.handle_event(event);
+#endif
+  if (event.type() == misc::Event::Type::Redraw) {
+    redraw(event);
+  } else {
+    loop(event);
+  }
   if (event.type() == misc::Event::Type::Resize) {
     width_ = event.resize().width;
     height_ = event.resize().height;
   }
 }
+
+void Scene3D::redraw(const misc::Event &event) {
+  {
+    GP_PROFILE_ZONE("Scene3D::redraw");
+    run_fixed_steps();
+    loop(event);
+  }
+#ifdef GP_PROFILER
+  misc::profiler().end_frame();
+  profiler_overlay_.report();
+#endif
+}
+
+void Scene3D::run_fixed_steps() {
+  if (!fixed_timestep_) {
+    return;
+  }
+  GP_PROFILE_ZONE("Scene3D::step");
+  const auto now = std::chrono::steady_clock::now();
+  const auto steps = fixed_timestep_->advance(now - last_step_time_);
+  last_step_time_ = now;
+  for (std::uint32_t i = 0; i < steps; ++i) {
+    step(fixed_timestep_->tick_ms());
+  }
+}
 } // namespace gp::sdl
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <gp/misc/event.hpp>
+#include <gp/misc/fixed_timestep.hpp>
 #include <gp/misc/keyboard_state.hpp>
 #include <gp/sdl/internal/gl_context.hpp>
 #include <gp/sdl/internal/sdl_context.hpp>
 #include <gp/sdl/internal/sdl_window.hpp>
+#include <gp/sdl/profiler_overlay.hpp>
 
+#include <chrono>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 
 namespace gp::sdl {
@@ -21,28 +25,75 @@ public:
 
 protected:
   virtual void loop(const misc::Event &event) = 0;
+  /**
+   * Called for every tick of the fixed timestep before a Redraw, once set_fixed_timestep() enabled it.
+   */
+  virtual void step(const float tick_ms);
 
   int width() const;
   int height() const;
 
   std::uint64_t timestamp() const;
+  /**
+   * Presents the frame and closes it in gl::state_cache(), scenes without a window call end_frame() themselves.
+   */
   void swap_buffers() const;
+  /**
+   * Creates the window hidden, for scenes which only render offscreen. Has to be called before the window is created.
+   */
+  void set_hidden_window(const bool hidden_window);
   void request_close();
+  /**
+   * Sets how the context schedules the Redraw events, e.g. to leave the CPU idle while the scene does not change.
+   */
+  void set_loop_mode(const internal::SDLContext::LoopMode loop_mode,
+                     const double frame_rate = internal::SDLContext::DEFAULT_FRAME_RATE);
+  /**
+   * Requests a Redraw in the on-demand loop mode, may be called from any thread.
+   */
+  void request_redraw();
+  /**
+   * Runs step() at a fixed tick rate decoupled from the frame rate, see misc::FixedTimestep.
+   */
+  void set_fixed_timestep(const double tick_rate,
+                          const std::uint32_t max_steps = misc::FixedTimestep::DEFAULT_MAX_STEPS);
+  /**
+   * @throw std::runtime_error If set_fixed_timestep() was not called.
+   */
+  misc::FixedTimestep &fixed_timestep();
+  /**
+   * The fraction of a tick the Redraw is past the last step, 1 without a fixed timestep.
+   */
+  float interpolation_alpha() const;
   std::shared_ptr<misc::KeyboardState> keyboard_state() const;
 
 private:
   void set_gl_hints();
+  std::unique_ptr<internal::GLContext> create_gl_context() const;
   void platform_gl_init();
   void window_event_callback(const misc::Event &event);
+  /**
+   * Runs the due fixed steps and calls loop() with a Redraw event as a profiled zone, then closes the profiler's frame.
+   */
+  void redraw(const misc::Event &event);
+  void run_fixed_steps();
 
   int width_{};
   int height_{};
   std::string title_{};
+  bool hidden_window_{};
 
   std::shared_ptr<internal::SDLContext> ctx_;
   std::shared_ptr<internal::SDLWindow> wnd_;
   std::unique_ptr<internal::GLContext> gl_ctx_;
 
+  std::optional<misc::FixedTimestep> fixed_timestep_{};
+  std::chrono::steady_clock::time_point last_step_time_{};
+
+#ifdef GP_PROFILER
+  ProfilerOverlay profiler_overlay_{};
+#endif
+
   std::mutex init_mutex_{};
   std::condition_variable init_cv_{};
   bool init_done_{};
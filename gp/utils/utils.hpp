@@ -3,10 +3,24 @@
 #include <SDL3/SDL.h>
 #include <glm/vec2.hpp>
 
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace gp::utils {
+/**
+ * 64-bit FNV-1a hash, `seed` continues the hash of preceding data.
+ */
+constexpr std::uint64_t fnv1a(const std::string_view data, const std::uint64_t seed = 14695981039346656037ull) {
+  auto result = seed;
+  for (const auto c : data) {
+    result ^= static_cast<std::uint8_t>(c);
+    result *= std::uint64_t{1099511628211ull};
+  }
+  return result;
+}
+
 std::vector<std::string> split_by(const std::string &src, const std::string &delimiter);
 std::string generate_random_string(std::size_t length);
 std::string load_txt_file(const std::string &filename);
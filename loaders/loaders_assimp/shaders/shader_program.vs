@@ -1,9 +1,11 @@
 layout(location = 0) in vec4 vertex;
 layout(location = 1) in vec4 normal;
 
+layout(std140) uniform Camera {
+  mat4 viewport;
+  mat4 camera_rot;
+};
 uniform vec4 color;
-uniform mat4 viewport;
-uniform mat4 camera_rot;
 
 out vec4 frag_color;
 
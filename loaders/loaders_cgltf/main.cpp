@@ -14,6 +14,7 @@ struct ProgramSetup {
   std::string filename{};
   int width{};
   int height{};
+  bool per_mesh_draws{};
 };
 
 ProgramSetup process_args(const int argc, const char *const argv[]) {
@@ -24,6 +25,7 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
                      "Model file name");
   desc.add_options()("width", boost::program_options::value<int>()->default_value(1024), "Width of the frame buffer");
   desc.add_options()("height", boost::program_options::value<int>()->default_value(768), "Height of the frame buffer");
+  desc.add_options()("per-mesh-draws", "Draw every mesh separately instead of batched, for comparison");
 
   boost::program_options::variables_map vm;
   boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
@@ -34,7 +36,11 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
     return {true};
   }
 
-  return {false, vm["filename"].as<std::string>(), vm["width"].as<int>(), vm["height"].as<int>()};
+  return {false,
+          vm["filename"].as<std::string>(),
+          vm["width"].as<int>(),
+          vm["height"].as<int>(),
+          vm.count("per-mesh-draws") > 0};
 }
 
 int main(int argc, char *argv[]) {
@@ -46,7 +52,7 @@ int main(int argc, char *argv[]) {
   }
 
   auto model = std::make_shared<const loaders::Model>(program_setup.filename);
-  auto model_scene = std::make_unique<loaders::ModelScene>(model);
+  auto model_scene = std::make_unique<loaders::ModelScene>(model, !program_setup.per_mesh_draws);
   model_scene->init(program_setup.width, program_setup.height, "loaders_cgltf");
   return model_scene->exec();
 }
@@ -1,13 +1,32 @@
 #include "model_scene.hpp"
 
 #include <gp/gl/misc.hpp>
+#include <gp/gl/state_cache.hpp>
+#include <gp/misc/profiler.hpp>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <chrono>
+#include <cstdio>
+
 namespace loaders {
-ModelScene::ModelScene(std::shared_ptr<const Model> model)
-    : model_{model} {}
+namespace {
+constexpr auto CAMERA_BINDING = GLuint{0};
+constexpr auto FRAME_REPORT_INTERVAL = std::chrono::seconds{5};
+
+/**
+ * std140 layout of the shader's Camera block.
+ */
+struct CameraBlock {
+  glm::mat4 viewport;
+  glm::mat4 camera_rot;
+};
+} // namespace
+
+ModelScene::ModelScene(std::shared_ptr<const Model> model, const bool batched)
+    : model_{model}
+    , batched_{batched} {}
 
 void ModelScene::loop(const gp::misc::Event &event) {
   switch (event.type()) {
@@ -70,12 +89,35 @@ void ModelScene::initialize(const int width, const int height) {
 
   resize(width, height);
 
-  upload_data();
-  shader_program_ = gp::gl::create_shader_program("shaders/shader_program");
+  if (batched_) {
+    upload_batch();
+    shader_program_ = gp::gl::create_shader_program("shaders/batched");
+  } else {
+    upload_data();
+    shader_program_ = gp::gl::create_shader_program("shaders/shader_program");
+    color_uniform_ = shader_program_->uniform_handle("color");
+  }
+  shader_program_->bind_uniform_block("Camera", CAMERA_BINDING);
+  camera_buffer_ = std::make_unique<gp::gl::UniformBuffer>(sizeof(CameraBlock), CAMERA_BINDING);
+  gpu_timer_ = std::make_unique<gp::gl::GpuTimer>();
+
+  const auto shader_program_stats = gp::gl::shader_program_stats();
+  printf("Shader programs: %llu created in %.2f ms, %llu from the binary cache\n",
+         static_cast<unsigned long long>(shader_program_stats.programs),
+         static_cast<double>(shader_program_stats.creation_time.count()) / 1000.0,
+         static_cast<unsigned long long>(shader_program_stats.binary_cache_hits));
 }
 
 void ModelScene::finalize() {
+  const auto &gl_stats = gp::gl::state_cache().last_frame_stats();
+  printf("GL binds in the last frame: %llu, %llu redundant skipped\n",
+         static_cast<unsigned long long>(gl_stats.calls),
+         static_cast<unsigned long long>(gl_stats.calls_redundant));
+
+  gpu_timer_.reset();
+  camera_buffer_.reset();
   shader_program_.reset();
+  mesh_batcher_.reset();
   sizes_.clear();
   colors_.clear();
   indices_buffers_.reset();
@@ -102,25 +144,83 @@ void ModelScene::animate(const std::uint64_t timestamp) {
 }
 
 void ModelScene::redraw() {
+  GP_PROFILE_ZONE("ModelScene::redraw");
+  const auto redraw_start = std::chrono::steady_clock::now();
+  gpu_timer_->begin();
+
   auto camera_rot_mat = glm::rotate(glm::mat4(1.0f), glm::radians(camera_rot_.x), glm::vec3(1.0f, 0.0f, 0.0f));
   camera_rot_mat = glm::rotate(camera_rot_mat, glm::radians(camera_rot_.y), glm::vec3(0.0f, 1.0f, 0.0f));
   camera_rot_mat = glm::rotate(camera_rot_mat, glm::radians(camera_rot_.z), glm::vec3(0.0f, 0.0f, 1.0f));
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+  const auto view = glm::lookAt(camera_pos_, glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
+  camera_buffer_->set_data(CameraBlock{projection_ * view, camera_rot_mat});
+
   shader_program_->use();
-  shader_program_->set_uniform("camera_rot", camera_rot_mat);
 
-  const auto view = glm::lookAt(camera_pos_, glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
-  const auto viewport_mat = projection_ * view;
-  shader_program_->set_uniform("viewport", viewport_mat);
+  if (mesh_batcher_) {
+    mesh_batcher_->draw();
+    draw_calls_ += mesh_batcher_->draw_calls();
+  } else {
+    for (std::size_t i = 0; i < number_of_meshes_; i++) {
+      vaos_->bind(i);
+      shader_program_->set_uniform(color_uniform_, colors_[i]);
 
-  for (std::size_t i = 0; i < number_of_meshes_; i++) {
-    vaos_->bind(i);
-    shader_program_->set_uniform("color", colors_[i]);
+      glDrawElements(GL_TRIANGLES, sizes_[i], GL_UNSIGNED_INT, 0);
+    }
+    draw_calls_ += number_of_meshes_;
+  }
 
-    glDrawElements(GL_TRIANGLES, sizes_[i], GL_UNSIGNED_INT, 0);
+  gpu_timer_->end();
+  redraw_time_ += std::chrono::steady_clock::now() - redraw_start;
+  ++redraw_frames_;
+  while (const auto gpu_time = gpu_timer_->poll()) {
+    redraw_gpu_time_ += *gpu_time;
+    ++redraw_gpu_frames_;
+  }
+  report_frame_stats();
+}
+
+void ModelScene::report_frame_stats() {
+  const auto now = std::chrono::steady_clock::now();
+  if (last_frame_report_ == std::chrono::steady_clock::time_point{}) {
+    last_frame_report_ = now;
+  }
+  if (now - last_frame_report_ < FRAME_REPORT_INTERVAL || redraw_frames_ == 0) {
+    return;
+  }
+
+  // Submission cost on the CPU is the point of batching, the GPU work is about the same either way.
+  const auto frames = static_cast<double>(redraw_frames_);
+  printf("%s: %.1f fps, redraw %.3f ms CPU",
+         batched_ ? (mesh_batcher_->indirect() ? "Multi-draw-indirect batch" : "Batch") : "Per mesh",
+         frames / std::chrono::duration<double>(now - last_frame_report_).count(),
+         std::chrono::duration<double, std::milli>(redraw_time_).count() / frames);
+  if (redraw_gpu_frames_ > 0) {
+    printf(" / %.3f ms GPU",
+           std::chrono::duration<double, std::milli>(redraw_gpu_time_).count() /
+               static_cast<double>(redraw_gpu_frames_));
+  }
+  printf(", %.0f draw calls per frame\n", static_cast<double>(draw_calls_) / frames);
+
+  last_frame_report_ = now;
+  redraw_time_ = {};
+  redraw_frames_ = 0;
+  redraw_gpu_time_ = {};
+  redraw_gpu_frames_ = 0;
+  draw_calls_ = 0;
+}
+
+void ModelScene::upload_batch() {
+  number_of_meshes_ = model_->size();
+
+  mesh_batcher_ = std::make_unique<gp::gl::MeshBatcher>();
+  for (std::size_t i = 0; i < number_of_meshes_; i++) {
+    const auto [vertices, normals, indices, color] = model_->get(i);
+    mesh_batcher_->add(vertices, normals, indices, color);
   }
+  mesh_batcher_->upload();
 }
 
 void ModelScene::upload_data() {
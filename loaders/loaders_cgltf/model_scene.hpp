@@ -4,20 +4,27 @@
 
 #include <gp/gl/buffer_objects.hpp>
 #include <gp/gl/gl.hpp>
+#include <gp/gl/gpu_timer.hpp>
+#include <gp/gl/mesh_batcher.hpp>
 #include <gp/gl/shader_program.hpp>
+#include <gp/gl/uniform_buffer.hpp>
 #include <gp/gl/vertex_array_objects.hpp>
 #include <gp/misc/event.hpp>
 #include <gp/sdl/scene_3d.hpp>
 
 #include <glm/glm.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
 
 namespace loaders {
 class ModelScene : public gp::sdl::Scene3D {
 public:
-  explicit ModelScene(std::shared_ptr<const Model> model);
+  /**
+   * @param batched False draws every mesh with its own vertex array and draw call, to compare against the batch.
+   */
+  explicit ModelScene(std::shared_ptr<const Model> model, const bool batched = true);
 
 private:
   void loop(const gp::misc::Event &event) override;
@@ -27,10 +34,13 @@ private:
   void resize(const int width, const int height);
   void animate(const std::uint64_t timestamp);
   void redraw();
+  void report_frame_stats();
 
   void upload_data();
+  void upload_batch();
 
   std::shared_ptr<const Model> model_{};
+  const bool batched_{};
 
   std::uint64_t last_timestamp_ms_{};
 
@@ -46,7 +56,25 @@ private:
   std::unique_ptr<gp::gl::BufferObjects> indices_buffers_{};
   std::vector<glm::vec4> colors_{};
   std::vector<GLsizei> sizes_{};
+  std::unique_ptr<gp::gl::MeshBatcher> mesh_batcher_{};
 
   std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
+  /**
+   * The per-frame matrices of the shader's Camera block, uploaded with one call.
+   */
+  std::unique_ptr<gp::gl::UniformBuffer> camera_buffer_{};
+  gp::gl::UniformHandle color_uniform_{};
+
+  /**
+   * CPU and GPU time of redraw() and its draw calls since the last report. GPU times arrive a few frames late and are
+   * missing where timer queries are not available.
+   */
+  std::unique_ptr<gp::gl::GpuTimer> gpu_timer_{};
+  std::chrono::steady_clock::duration redraw_time_{};
+  std::uint64_t redraw_frames_{};
+  std::chrono::nanoseconds redraw_gpu_time_{};
+  std::uint64_t redraw_gpu_frames_{};
+  std::uint64_t draw_calls_{};
+  std::chrono::steady_clock::time_point last_frame_report_{};
 };
 } // namespace loaders
@@ -0,0 +1,327 @@
+#include "streaming_common/constants.hpp"
+#include "streaming_common/decoder.hpp"
+#include "streaming_common/encoder.hpp"
+#include "streaming_common/frame_data.hpp"
+#include "streaming_common/stream_replayer.hpp"
+#include "streaming_common/video_stream_info.hpp"
+
+#include <gp/ffmpeg/misc.hpp>
+#include <gp/utils/utils.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct ProgramSetup {
+  bool exit{};
+
+  int width{};
+  int height{};
+  std::uint16_t fps{};
+  int frames{};
+  std::vector<std::string> codecs{};
+  std::vector<std::int64_t> bitrates_kbps{};
+  std::string replay{};
+  bool realtime{};
+};
+
+/**
+ * Result of a single encode/decode round trip of one codec at one bitrate.
+ */
+struct BenchmarkResult {
+  std::string encoder_name{};
+  double bitrate_kbps{};
+  double psnr_db{};
+  double encode_us{};
+  double decode_us{};
+  int decoded_frames{};
+};
+
+ProgramSetup process_args(const int argc, const char *const argv[]) {
+  boost::program_options::options_description desc("Options");
+  desc.add_options()("help", "This help message");
+  desc.add_options()("width", boost::program_options::value<int>()->default_value(1280), "Width of the frames");
+  desc.add_options()("height", boost::program_options::value<int>()->default_value(720), "Height of the frames");
+  desc.add_options()("fps",
+                     boost::program_options::value<std::uint16_t>()->default_value(60u),
+                     "Number of frames per second");
+  desc.add_options()("frames",
+                     boost::program_options::value<int>()->default_value(300),
+                     "Number of frames encoded per run");
+  desc.add_options()("codecs",
+                     boost::program_options::value<std::string>()->default_value("h264,hevc,av1,vp9"),
+                     "Comma separated list of codec names");
+  desc.add_options()("bitrates",
+                     boost::program_options::value<std::string>()->default_value("1000,2000,4000,8000"),
+                     "Comma separated list of target bitrates in kbit/s");
+  desc.add_options()("replay",
+                     boost::program_options::value<std::string>()->default_value(""),
+                     "Decode a stream recording instead of synthetic frames");
+  desc.add_options()("realtime", "Replay the recording at its original timing instead of as fast as possible");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+  boost::program_options::notify(vm);
+
+  if (vm.count("help") != 0U) {
+    desc.print(std::cout);
+    return {true};
+  }
+
+  std::vector<std::int64_t> bitrates_kbps{};
+  for (const auto &bitrate : gp::utils::split_by(vm["bitrates"].as<std::string>(), ",")) {
+    bitrates_kbps.push_back(std::stoll(bitrate));
+  }
+
+  return {false,
+          vm["width"].as<int>(),
+          vm["height"].as<int>(),
+          vm["fps"].as<std::uint16_t>(),
+          vm["frames"].as<int>(),
+          gp::utils::split_by(vm["codecs"].as<std::string>(), ","),
+          bitrates_kbps,
+          vm["replay"].as<std::string>(),
+          vm.count("realtime") != 0U};
+}
+
+/**
+ * Fills the RGBA frame with a scrolling gradient and a moving square, so that both smooth areas and sharp edges are
+ * in motion.
+ */
+void generate_frame(streaming::FrameData &frame, const int width, const int height, const int index) {
+  const auto square_size = height / 4;
+  const auto square_x = (index * 7) % (width - square_size);
+  const auto square_y = (index * 3) % (height - square_size);
+  for (int y = 0; y < height; ++y) {
+    for (int x = 0; x < width; ++x) {
+      auto *pixel = &frame[(static_cast<std::size_t>(y) * width + x) * streaming::CHANNELS_NUM];
+      const auto in_square = x >= square_x && x < square_x + square_size && y >= square_y && y < square_y + square_size;
+      pixel[0] = in_square ? 255u : static_cast<std::uint8_t>(x + index);
+      pixel[1] = in_square ? 32u : static_cast<std::uint8_t>(y * 2 - index);
+      pixel[2] = in_square ? 32u : static_cast<std::uint8_t>((x + y) / 2);
+      pixel[3] = 255u;
+    }
+  }
+}
+
+/**
+ * PSNR of the RGB channels. The encoder treats its input as a bottom-up GL framebuffer and flips it, so source rows
+ * are compared against mirrored decoded rows.
+ */
+double psnr(const streaming::FrameData &source,
+            const streaming::FrameData &decoded,
+            const int width,
+            const int height) {
+  double squared_error{};
+  for (int y = 0; y < height; ++y) {
+    const auto *src_row = &source[static_cast<std::size_t>(y) * width * streaming::CHANNELS_NUM];
+    const auto *dec_row = &decoded[static_cast<std::size_t>(height - 1 - y) * width * streaming::CHANNELS_NUM];
+    for (int i = 0; i < width * static_cast<int>(streaming::CHANNELS_NUM); ++i) {
+      if (i % streaming::CHANNELS_NUM == 3) {
+        continue;
+      }
+      const auto diff = static_cast<double>(src_row[i]) - static_cast<double>(dec_row[i]);
+      squared_error += diff * diff;
+    }
+  }
+  const auto mse = squared_error / (static_cast<double>(width) * height * 3.0);
+  return mse == 0.0 ? 99.0 : 10.0 * std::log10(255.0 * 255.0 / mse);
+}
+
+BenchmarkResult run(const streaming::VideoStreamInfo &video_stream_info,
+                    const std::int64_t bitrate_kbps,
+                    const int frames) {
+  using Clock = std::chrono::steady_clock;
+  const auto width = video_stream_info.width;
+  const auto height = video_stream_info.height;
+
+  BenchmarkResult result{};
+  std::vector<streaming::FrameData> packets{};
+  std::size_t total_bytes{};
+  {
+    auto encoder = std::make_unique<streaming::Encoder>(video_stream_info, bitrate_kbps * 1000);
+    result.encoder_name = encoder->encoder_name();
+    encoder->set_video_stream_callback(
+        [&packets, &total_bytes](const std::byte *data, const std::size_t size, const bool /*eof*/) {
+          if (size > 0) {
+            packets.emplace_back(reinterpret_cast<const std::uint8_t *>(data),
+                                 reinterpret_cast<const std::uint8_t *>(data + size));
+            total_bytes += size;
+          }
+        });
+
+    auto video_frame = encoder->video_frame();
+    Clock::duration encode_time{};
+    for (int i = 0; i < frames; ++i) {
+      generate_frame(*video_frame, width, height, i);
+      const auto t0 = Clock::now();
+      encoder->encode();
+      encode_time += Clock::now() - t0;
+    }
+    result.encode_us = std::chrono::duration<double, std::micro>(encode_time).count() / frames;
+    // Destroying the encoder flushes it, delivering any delayed packets.
+  }
+  result.bitrate_kbps = static_cast<double>(total_bytes) * 8.0 * video_stream_info.fps / frames / 1000.0;
+
+  streaming::Decoder decoder{};
+  decoder.init(video_stream_info);
+  streaming::FrameData source(static_cast<std::size_t>(width) * height * streaming::CHANNELS_NUM);
+  Clock::duration decode_time{};
+  double psnr_sum{};
+  std::size_t next_packet{};
+  for (auto done = false; !done;) {
+    const auto t0 = Clock::now();
+    const auto status = decoder.decode();
+    decode_time += Clock::now() - t0;
+
+    switch (status.code) {
+    case streaming::Decoder::Status::Code::OK:
+      generate_frame(source, width, height, result.decoded_frames++);
+      psnr_sum += psnr(source, *decoder.rgb_frame(), width, height);
+      break;
+    case streaming::Decoder::Status::Code::RETRY:
+      break;
+    case streaming::Decoder::Status::Code::NODATA:
+      // Feed one packet at a time, as it would arrive over the network.
+      if (next_packet < packets.size()) {
+        decoder.incoming_data(reinterpret_cast<const std::byte *>(packets[next_packet].data()),
+                              packets[next_packet].size());
+        ++next_packet;
+      } else {
+        decoder.signal_eof();
+      }
+      break;
+    case streaming::Decoder::Status::Code::EOS:
+    case streaming::Decoder::Status::Code::ERROR:
+      done = true;
+      break;
+    }
+  }
+
+  if (result.decoded_frames > 0) {
+    result.psnr_db = psnr_sum / result.decoded_frames;
+    result.decode_us = std::chrono::duration<double, std::micro>(decode_time).count() / result.decoded_frames;
+  }
+  return result;
+}
+
+/**
+ * Decodes a recording made by StreamRecorder, e.g. from a streamer session, and reports decode throughput.
+ */
+void replay(const std::string &path, const bool realtime) {
+  using Clock = std::chrono::steady_clock;
+
+  streaming::StreamReplayer replayer{path};
+  const auto &video_stream_info = replayer.video_stream_info();
+  printf("%s: %dx%d@%u %s, %zu packets\n",
+         path.c_str(),
+         video_stream_info.width,
+         video_stream_info.height,
+         video_stream_info.fps,
+         video_stream_info.codec_name.c_str(),
+         replayer.packets().size());
+
+  streaming::Decoder decoder{};
+  decoder.init(video_stream_info);
+  replayer.start(realtime);
+
+  Clock::duration decode_time{};
+  int decoded_frames{};
+  const auto t_start = Clock::now();
+  for (auto done = false; !done;) {
+    const auto t0 = Clock::now();
+    const auto status = decoder.decode();
+    decode_time += Clock::now() - t0;
+
+    switch (status.code) {
+    case streaming::Decoder::Status::Code::OK:
+      ++decoded_frames;
+      break;
+    case streaming::Decoder::Status::Code::RETRY:
+      break;
+    case streaming::Decoder::Status::Code::NODATA:
+      if (replayer.feed(decoder) == 0u) {
+        // Realtime replay - the next packet is not due yet.
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+      }
+      break;
+    case streaming::Decoder::Status::Code::EOS:
+    case streaming::Decoder::Status::Code::ERROR:
+      done = true;
+      break;
+    }
+  }
+  const auto wall_time = std::chrono::duration<double>(Clock::now() - t_start).count();
+
+  printf("decoded %d frames in %.3f s: %.1f fps, %.0f us per frame in decoder\n",
+         decoded_frames,
+         wall_time,
+         decoded_frames / wall_time,
+         decoded_frames > 0 ? std::chrono::duration<double, std::micro>(decode_time).count() / decoded_frames : 0.0);
+}
+
+int main(int argc, char *argv[]) {
+  gp::utils::set_working_directory();
+
+  const auto program_setup = process_args(argc, argv);
+  if (program_setup.exit) {
+    return 1;
+  }
+
+  if (!program_setup.replay.empty()) {
+    replay(program_setup.replay, program_setup.realtime);
+    return 0;
+  }
+
+  printf("%dx%d@%u, %d frames per run\n",
+         program_setup.width,
+         program_setup.height,
+         program_setup.fps,
+         program_setup.frames);
+  printf("%-6s %-18s %10s %10s %9s %11s %11s %8s\n",
+         "codec",
+         "encoder",
+         "target",
+         "actual",
+         "psnr",
+         "encode",
+         "decode",
+         "frames");
+
+  for (const auto &codec_name : program_setup.codecs) {
+    const auto codec_id = gp::ffmpeg::codec_name_to_id(codec_name);
+    const auto video_stream_info = streaming::VideoStreamInfo{program_setup.width,
+                                                              program_setup.height,
+                                                              program_setup.fps,
+                                                              codec_id,
+                                                              avcodec_get_name(codec_id)};
+    for (const auto bitrate_kbps : program_setup.bitrates_kbps) {
+      try {
+        const auto result = run(video_stream_info, bitrate_kbps, program_setup.frames);
+        printf("%-6s %-18s %5lld kbps %5.0f kbps %6.2f dB %8.0f us %8.0f us %8d\n",
+               codec_name.c_str(),
+               result.encoder_name.c_str(),
+               static_cast<long long>(bitrate_kbps),
+               result.bitrate_kbps,
+               result.psnr_db,
+               result.encode_us,
+               result.decode_us,
+               result.decoded_frames);
+      } catch (const std::runtime_error &e) {
+        printf("%-6s skipped: %s\n", codec_name.c_str(), e.what());
+        break;
+      }
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,87 @@
+#include "audio_decoder.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace streaming {
+AudioDecoder::AudioDecoder() {
+  codec_ = avcodec_find_decoder_by_name("libopus");
+  if (codec_ == nullptr) {
+    codec_ = avcodec_find_decoder(AV_CODEC_ID_OPUS);
+  }
+  if (codec_ == nullptr) {
+    throw std::runtime_error{"avcodec_find_decoder failed: no Opus decoder"};
+  }
+  context_.reset(avcodec_alloc_context3(codec_));
+  packet_.reset(av_packet_alloc());
+  frame_.reset(av_frame_alloc());
+  if (!context_) {
+    throw std::runtime_error{"avcodec_alloc_context3 failed"};
+  }
+  if (!packet_ || !frame_) {
+    throw std::runtime_error{"av_packet_alloc or av_frame_alloc failed"};
+  }
+
+  context_->sample_rate = AUDIO_SAMPLE_RATE;
+  context_->request_sample_fmt = AV_SAMPLE_FMT_FLT;
+  av_channel_layout_default(&context_->ch_layout, AUDIO_CHANNELS_NUM);
+
+  if (avcodec_open2(context_.get(), codec_, nullptr) < 0) {
+    throw std::runtime_error{"avcodec_open2 failed"};
+  }
+}
+
+const std::vector<float> &AudioDecoder::decode(const std::byte *data, const std::size_t size) {
+#ifdef STREAMING_PIPELINE_STATS
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+#endif
+
+  samples_.clear();
+  packet_buffer_.resize(size + AV_INPUT_BUFFER_PADDING_SIZE);
+  std::memcpy(packet_buffer_.data(), data, size);
+  std::fill(packet_buffer_.begin() + static_cast<std::ptrdiff_t>(size), packet_buffer_.end(), std::uint8_t{0});
+  packet_->data = packet_buffer_.data();
+  packet_->size = static_cast<int>(size);
+
+  if (avcodec_send_packet(context_.get(), packet_.get()) >= 0) {
+    while (avcodec_receive_frame(context_.get(), frame_.get()) >= 0) {
+      append_samples();
+      av_frame_unref(frame_.get());
+    }
+  }
+  packet_->data = nullptr;
+  packet_->size = 0;
+
+#ifdef STREAMING_PIPELINE_STATS
+  last_decode_time_ = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
+#endif
+  return samples_;
+}
+
+void AudioDecoder::append_samples() {
+  const auto channels = frame_->ch_layout.nb_channels;
+  const auto samples = frame_->nb_samples;
+  const auto offset = samples_.size();
+  samples_.resize(offset + static_cast<std::size_t>(samples) * AUDIO_CHANNELS_NUM);
+  auto *out = samples_.data() + offset;
+
+  // The native decoder only outputs planar samples, libopus honours the request for interleaved ones. A mono stream
+  // is duplicated to both output channels, surplus channels are ignored.
+  const auto planar = frame_->format == AV_SAMPLE_FMT_FLTP;
+  if (!planar && frame_->format != AV_SAMPLE_FMT_FLT) {
+    throw std::runtime_error{"Unexpected Opus decoder sample format"};
+  }
+  for (int sample = 0; sample < samples; ++sample) {
+    for (int channel = 0; channel < AUDIO_CHANNELS_NUM; ++channel) {
+      const auto source_channel = std::min(channel, channels - 1);
+      out[sample * AUDIO_CHANNELS_NUM + channel] =
+          planar ? reinterpret_cast<const float *>(frame_->extended_data[source_channel])[sample]
+                 : reinterpret_cast<const float *>(frame_->extended_data[0])[sample * channels + source_channel];
+    }
+  }
+}
+} // namespace streaming
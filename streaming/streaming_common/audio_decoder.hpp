@@ -0,0 +1,61 @@
+#pragma once
+
+#include <gp/ffmpeg/ffmpeg.hpp>
+
+#ifdef STREAMING_PIPELINE_STATS
+# include <chrono>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace streaming {
+/**
+ * Decodes the Opus packets of an AudioEncoder into interleaved float PCM at AUDIO_SAMPLE_RATE with
+ * AUDIO_CHANNELS_NUM channels.
+ */
+class AudioDecoder {
+public:
+  /**
+   * Prefers libopus and falls back to FFmpeg's native Opus decoder.
+   *
+   * @throw std::runtime_error if no Opus decoder is available.
+   */
+  AudioDecoder();
+  AudioDecoder(const AudioDecoder &) = delete;
+  AudioDecoder &operator=(const AudioDecoder &) = delete;
+  AudioDecoder(AudioDecoder &&other) noexcept = delete;
+  AudioDecoder &operator=(AudioDecoder &&other) noexcept = delete;
+
+  ~AudioDecoder() = default;
+
+  /**
+   * Decodes one packet, a corrupt packet yields no samples.
+   *
+   * @return Interleaved samples, valid until the next call.
+   */
+  const std::vector<float> &decode(const std::byte *data, const std::size_t size);
+
+#ifdef STREAMING_PIPELINE_STATS
+  std::chrono::microseconds last_decode_time() const noexcept { return last_decode_time_; }
+#endif
+
+private:
+  void append_samples();
+
+  const AVCodec *codec_{};
+  gp::ffmpeg::UniqueAVCodecContext context_{};
+  gp::ffmpeg::UniqueAVPacket packet_{};
+  gp::ffmpeg::UniqueAVFrame frame_{};
+
+  /**
+   * The packet followed by AV_INPUT_BUFFER_PADDING_SIZE zero bytes, as the decoder may read past its end.
+   */
+  std::vector<std::uint8_t> packet_buffer_{};
+  std::vector<float> samples_{};
+
+#ifdef STREAMING_PIPELINE_STATS
+  std::chrono::microseconds last_decode_time_{};
+#endif
+};
+} // namespace streaming
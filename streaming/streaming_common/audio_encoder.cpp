@@ -0,0 +1,94 @@
+#include "audio_encoder.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace streaming {
+AudioEncoder::AudioEncoder() {
+  // FFmpeg's native Opus encoder is experimental and CELT-only, the low-delay configuration needs libopus.
+  codec_ = avcodec_find_encoder_by_name("libopus");
+  if (codec_ == nullptr) {
+    throw std::runtime_error{"avcodec_find_encoder_by_name failed: FFmpeg is built without libopus"};
+  }
+  context_.reset(avcodec_alloc_context3(codec_));
+  packet_.reset(av_packet_alloc());
+  frame_.reset(av_frame_alloc());
+  if (!context_) {
+    throw std::runtime_error{"avcodec_alloc_context3 failed"};
+  }
+  if (!packet_ || !frame_) {
+    throw std::runtime_error{"av_packet_alloc or av_frame_alloc failed"};
+  }
+
+  context_->bit_rate = AUDIO_BITRATE;
+  context_->sample_rate = AUDIO_SAMPLE_RATE;
+  context_->sample_fmt = AV_SAMPLE_FMT_FLT;
+  context_->time_base = {1, AUDIO_SAMPLE_RATE};
+  av_channel_layout_default(&context_->ch_layout, AUDIO_CHANNELS_NUM);
+  // Frame duration in milliseconds; "lowdelay" switches off the speech layer's lookahead.
+  av_opt_set(context_->priv_data, "frame_duration", std::to_string(AUDIO_FRAME_DURATION.count()).c_str(), 0);
+  av_opt_set(context_->priv_data, "application", "lowdelay", 0);
+
+  if (avcodec_open2(context_.get(), codec_, nullptr) < 0) {
+    throw std::runtime_error{"avcodec_open2 failed"};
+  }
+
+  frame_->format = context_->sample_fmt;
+  frame_->sample_rate = context_->sample_rate;
+  frame_->nb_samples = AUDIO_FRAME_SAMPLES;
+  frame_->pts = 0;
+  if (av_channel_layout_copy(&frame_->ch_layout, &context_->ch_layout) < 0 ||
+      av_frame_get_buffer(frame_.get(), 0) < 0) {
+    throw std::runtime_error{"av_frame_get_buffer failed"};
+  }
+}
+
+void AudioEncoder::set_audio_stream_callback(
+    std::function<void(const std::byte *data, const std::size_t size)> audio_stream_callback) {
+  audio_stream_callback_ = std::move(audio_stream_callback);
+}
+
+void AudioEncoder::encode(const float *samples) {
+#ifdef STREAMING_PIPELINE_STATS
+  using Clock = std::chrono::steady_clock;
+  const auto t0 = Clock::now();
+#endif
+
+  if (av_frame_make_writable(frame_.get()) < 0) {
+    throw std::runtime_error{"av_frame_make_writable failed"};
+  }
+  std::memcpy(frame_->data[0], samples, sizeof(float) * AUDIO_FRAME_SAMPLES * AUDIO_CHANNELS_NUM);
+
+  const auto send_result = avcodec_send_frame(context_.get(), frame_.get());
+  if (send_result < 0) {
+    char errbuf[AV_ERROR_MAX_STRING_SIZE]{};
+    av_strerror(send_result, errbuf, sizeof(errbuf));
+    throw std::runtime_error{std::string{"avcodec_send_frame failed: "} + errbuf};
+  }
+  frame_->pts += AUDIO_FRAME_SAMPLES;
+
+  for (;;) {
+    const auto rc = avcodec_receive_packet(context_.get(), packet_.get());
+    if (rc == AVERROR(EAGAIN) || rc == AVERROR_EOF) {
+      break;
+    }
+    if (rc < 0) {
+      char errbuf[AV_ERROR_MAX_STRING_SIZE]{};
+      av_strerror(rc, errbuf, sizeof(errbuf));
+      throw std::runtime_error{std::string{"avcodec_receive_packet failed: "} + errbuf};
+    }
+    if (audio_stream_callback_) {
+      audio_stream_callback_(reinterpret_cast<const std::byte *>(packet_->data),
+                             static_cast<std::size_t>(packet_->size));
+    }
+    av_packet_unref(packet_.get());
+  }
+
+#ifdef STREAMING_PIPELINE_STATS
+  last_encode_time_ = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
+#endif
+}
+} // namespace streaming
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <gp/ffmpeg/ffmpeg.hpp>
+
+#ifdef STREAMING_PIPELINE_STATS
+# include <chrono>
+#endif
+#include <cstddef>
+#include <functional>
+
+namespace streaming {
+/**
+ * Encodes interleaved float PCM at AUDIO_SAMPLE_RATE with AUDIO_CHANNELS_NUM channels into Opus packets of
+ * AUDIO_FRAME_DURATION each, configured for low delay.
+ */
+class AudioEncoder {
+public:
+  /**
+   * @throw std::runtime_error if FFmpeg was built without libopus.
+   */
+  AudioEncoder();
+  AudioEncoder(const AudioEncoder &) = delete;
+  AudioEncoder &operator=(const AudioEncoder &) = delete;
+  AudioEncoder(AudioEncoder &&other) noexcept = delete;
+  AudioEncoder &operator=(AudioEncoder &&other) noexcept = delete;
+
+  ~AudioEncoder() = default;
+
+  void set_audio_stream_callback(
+      std::function<void(const std::byte *data, const std::size_t size)> audio_stream_callback);
+  /**
+   * Encodes one frame of AUDIO_FRAME_SAMPLES interleaved samples per channel.
+   */
+  void encode(const float *samples);
+
+#ifdef STREAMING_PIPELINE_STATS
+  std::chrono::microseconds last_encode_time() const noexcept { return last_encode_time_; }
+#endif
+
+private:
+  const AVCodec *codec_{};
+  gp::ffmpeg::UniqueAVCodecContext context_{};
+  gp::ffmpeg::UniqueAVPacket packet_{};
+  gp::ffmpeg::UniqueAVFrame frame_{};
+
+  std::function<void(const std::byte *data, const std::size_t size)> audio_stream_callback_{};
+
+#ifdef STREAMING_PIPELINE_STATS
+  std::chrono::microseconds last_encode_time_{};
+#endif
+};
+} // namespace streaming
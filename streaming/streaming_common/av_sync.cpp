@@ -0,0 +1,38 @@
+#include "av_sync.hpp"
+
+namespace streaming {
+namespace {
+constexpr auto LATENCY_SMOOTHING = 1.0 / 16.0;
+
+/**
+ * Local time minus the streamer timestamp, the wrap-around of the unsigned difference yields the signed one.
+ */
+std::int64_t latency_us(const std::uint64_t timestamp_us, const AvSync::Clock::time_point local) {
+  const auto local_us = static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(local.time_since_epoch()).count());
+  return static_cast<std::int64_t>(local_us - timestamp_us);
+}
+} // namespace
+
+void AvSync::video_presented(const std::uint64_t timestamp_us, const Clock::time_point now) {
+  const auto latency = static_cast<double>(latency_us(timestamp_us, now));
+  const auto lock_guard = std::lock_guard(mutex_);
+  video_latency_us_ =
+      video_latency_us_ ? *video_latency_us_ + (latency - *video_latency_us_) * LATENCY_SMOOTHING : latency;
+}
+
+std::optional<std::chrono::microseconds> AvSync::audio_skew(const std::uint64_t timestamp_us,
+                                                            const Clock::time_point play_at) const {
+  const auto audio_latency = latency_us(timestamp_us, play_at);
+  const auto lock_guard = std::lock_guard(mutex_);
+  if (!video_latency_us_) {
+    return std::nullopt;
+  }
+  return std::chrono::microseconds{audio_latency - static_cast<std::int64_t>(*video_latency_us_)};
+}
+
+void AvSync::reset() {
+  const auto lock_guard = std::lock_guard(mutex_);
+  video_latency_us_.reset();
+}
+} // namespace streaming
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace streaming {
+/**
+ * Keeps audio in step with the presented video.
+ *
+ * Both streams carry the streamer's steady clock at the time the encoded packet was handed to the streamer. The
+ * latency of a stream, the local time a packet is presented minus its timestamp, thus includes the same unknown
+ * offset between the two clocks for audio and video, and their difference is the skew heard and seen. The video
+ * latency includes decoding and the jitter buffer's playout delay, the audio follows it.
+ *
+ * Thread-safe, video is presented on the render thread while audio packets arrive on the receiver's.
+ */
+class AvSync {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * The frame of the packet stamped `timestamp_us` is shown at `now`.
+   */
+  void video_presented(const std::uint64_t timestamp_us, const Clock::time_point now = Clock::now());
+  /**
+   * How much later than the video the audio packet stamped `timestamp_us` is heard when its playback starts at
+   * `play_at`, negative if it would be heard early.
+   *
+   * @return Nothing until the first video frame was presented.
+   */
+  std::optional<std::chrono::microseconds> audio_skew(const std::uint64_t timestamp_us,
+                                                      const Clock::time_point play_at) const;
+  /**
+   * Forgets the video latency, e.g. when a new stream starts.
+   */
+  void reset();
+
+private:
+  mutable std::mutex mutex_{};
+  /**
+   * Smoothed, the frame-to-frame variation is the video's own jitter, which audio should not follow.
+   */
+  std::optional<double> video_latency_us_{};
+};
+} // namespace streaming
@@ -0,0 +1,87 @@
+#include "codec_presets.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace streaming {
+namespace {
+std::vector<CodecPreset> make_codec_presets() {
+  // All software encoders are configured for one-in-one-out operation: no B-frames, no lookahead and no frame
+  // threading, so every frame sent to the encoder produces its packet immediately.
+  return {
+      {.codec_id = AV_CODEC_ID_H264,
+       .packetized = false,
+       .encoders = {{.name = "h264_videotoolbox", .options = {{"realtime", "1"}}},
+                    {.name = "libx264", .options = {{"preset", "ultrafast"}, {"tune", "zerolatency"}}}},
+       .decoders = {{.name = "h264"}}},
+      {.codec_id = AV_CODEC_ID_HEVC,
+       .packetized = false,
+       .encoders = {{.name = "hevc_videotoolbox", .options = {{"realtime", "1"}}},
+                    {.name = "libx265", .options = {{"preset", "ultrafast"}, {"tune", "zerolatency"}}}},
+       .decoders = {{.name = "hevc"}}},
+      // The vcpkg FFmpeg port has no SVT-AV1 feature, libsvtav1 is only used with an FFmpeg built without libaom.
+      {.codec_id = AV_CODEC_ID_AV1,
+       .packetized = true,
+       .encoders = {{.name = "libaom-av1",
+                     .options = {{"usage", "realtime"}, {"cpu-used", "8"}, {"lag-in-frames", "0"}, {"row-mt", "1"}}},
+                    {.name = "libsvtav1", .options = {{"preset", "12"}, {"svtav1-params", "pred-struct=1"}}}},
+       .decoders = {{.name = "libdav1d", .options = {{"max_frame_delay", "1"}}}, {.name = "libaom-av1"}}},
+      {.codec_id = AV_CODEC_ID_VP9,
+       .packetized = true,
+       .encoders = {{.name = "libvpx-vp9",
+                     .options = {{"deadline", "realtime"},
+                                 {"cpu-used", "8"},
+                                 {"lag-in-frames", "0"},
+                                 {"row-mt", "1"}}}},
+       .decoders = {{.name = "vp9"}, {.name = "libvpx-vp9"}}},
+      {.codec_id = AV_CODEC_ID_MPEG4,
+       .packetized = false,
+       .encoders = {{.name = "mpeg4"}},
+       .decoders = {{.name = "mpeg4"}}},
+  };
+}
+} // namespace
+
+const std::vector<CodecPreset> &codec_presets() {
+  static const auto presets = make_codec_presets();
+  return presets;
+}
+
+const CodecPreset &codec_preset(const AVCodecID codec_id) {
+  const auto &presets = codec_presets();
+  const auto it = std::find_if(presets.begin(), presets.end(), [codec_id](const auto &preset) {
+    return preset.codec_id == codec_id;
+  });
+  if (it == presets.end()) {
+    throw std::runtime_error{std::string{"Unsupported codec: "} + avcodec_get_name(codec_id)};
+  }
+  return *it;
+}
+
+std::vector<std::string> decodable_codec_names() {
+  std::vector<std::string> names{};
+  for (const auto &preset : codec_presets()) {
+    const auto has_decoder =
+        avcodec_find_decoder(preset.codec_id) != nullptr ||
+        std::any_of(preset.decoders.begin(), preset.decoders.end(), [](const auto &implementation) {
+          return avcodec_find_decoder_by_name(implementation.name.c_str()) != nullptr;
+        });
+    if (has_decoder) {
+      names.emplace_back(avcodec_get_name(preset.codec_id));
+    }
+  }
+  return names;
+}
+
+void apply_codec_options(AVCodecContext *context, const CodecImplementation &implementation) {
+  for (const auto &option : implementation.options) {
+    if (av_opt_set(context->priv_data, option.name.c_str(), option.value.c_str(), 0) < 0) {
+      printf("Codec '%s' ignored option %s=%s\n",
+             implementation.name.c_str(),
+             option.name.c_str(),
+             option.value.c_str());
+    }
+  }
+}
+} // namespace streaming
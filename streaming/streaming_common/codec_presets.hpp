@@ -0,0 +1,67 @@
+#pragma once
+
+#include <gp/ffmpeg/ffmpeg.hpp>
+
+#include <string>
+#include <vector>
+
+namespace streaming {
+/**
+ * A single `AVOption` applied to the codec's private context before it is opened.
+ */
+struct CodecOption {
+  std::string name{};
+  std::string value{};
+};
+
+/**
+ * An FFmpeg encoder or decoder implementation together with the options which put it into its lowest-latency mode.
+ */
+struct CodecImplementation {
+  std::string name{};
+  std::vector<CodecOption> options{};
+};
+
+/**
+ * Describes how a codec is handled in the streaming pipeline.
+ */
+struct CodecPreset {
+  AVCodecID codec_id{AV_CODEC_ID_NONE};
+  /**
+   * True if the bitstream has no start codes (VP9, AV1) and therefore cannot be split by an `AVCodecParser` - packet
+   * boundaries produced by the encoder have to be preserved all the way to the decoder.
+   */
+  bool packetized{};
+  /**
+   * Encoder implementations in order of preference (hardware first, then software).
+   */
+  std::vector<CodecImplementation> encoders{};
+  /**
+   * Decoder implementations in order of preference, the default FFmpeg decoder for the codec id is used as a fallback.
+   */
+  std::vector<CodecImplementation> decoders{};
+};
+
+/**
+ * Returns the preset for the given codec.
+ *
+ * @throw std::runtime_error if the codec is not supported by the streaming pipeline.
+ */
+const CodecPreset &codec_preset(const AVCodecID codec_id);
+
+/**
+ * Returns all codecs supported by the streaming pipeline.
+ */
+const std::vector<CodecPreset> &codec_presets();
+
+/**
+ * Returns the names of the supported codecs for which FFmpeg has a decoder, e.g. to advertise them to the session
+ * broker.
+ */
+std::vector<std::string> decodable_codec_names();
+
+/**
+ * Applies the options of the implementation to the codec's private context, unknown options are ignored.
+ */
+void apply_codec_options(AVCodecContext *context, const CodecImplementation &implementation);
+} // namespace streaming
@@ -0,0 +1,73 @@
+#include "congestion_controller.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace streaming {
+namespace {
+constexpr auto DECREASE_FACTOR = 0.7;
+// A second decrease within this interval belongs to the same episode, e.g. a keyframe followed by a regular frame.
+constexpr auto MIN_DECREASE_INTERVAL = std::chrono::milliseconds{500};
+// The target grows by 1/INCREASE_STEPS of the maximum per interval without congestion, a full recovery from the
+// minimum takes about 15 s.
+constexpr auto INCREASE_INTERVAL = std::chrono::seconds{1};
+constexpr auto INCREASE_STEPS = std::int64_t{16};
+} // namespace
+
+CongestionController::CongestionController(const std::int64_t max_bit_rate, const std::int64_t min_bit_rate)
+    : max_bit_rate_(max_bit_rate)
+    , min_bit_rate_(min_bit_rate > 0 ? min_bit_rate : max_bit_rate / 8)
+    , bit_rate_(max_bit_rate) {
+  if (max_bit_rate_ <= 0 || min_bit_rate_ > max_bit_rate_) {
+    throw std::runtime_error{"Invalid congestion controller bit rate range"};
+  }
+}
+
+std::optional<std::int64_t> CongestionController::on_sent(const std::size_t buffered_amount,
+                                                          const Clock::time_point now) {
+  const auto lock_guard = std::lock_guard(mutex_);
+
+  if (buffered_amount > SEND_BUFFER_HIGH_WATERMARK) {
+    if (congested_.exchange(true, std::memory_order_acq_rel)) {
+      return std::nullopt;
+    }
+    ++stats_.congestion_events;
+    if (now - last_change_ < MIN_DECREASE_INTERVAL || bit_rate_ == min_bit_rate_) {
+      return std::nullopt;
+    }
+    bit_rate_ = std::max(min_bit_rate_, static_cast<std::int64_t>(static_cast<double>(bit_rate_) * DECREASE_FACTOR));
+    last_change_ = now;
+    ++stats_.bit_rate_decreases;
+    return bit_rate_;
+  }
+
+  // Only a nearly empty buffer shows there is room for more, anything in between holds the rate.
+  if (congested() || buffered_amount > SEND_BUFFER_LOW_WATERMARK || bit_rate_ == max_bit_rate_ ||
+      now - last_change_ < INCREASE_INTERVAL) {
+    return std::nullopt;
+  }
+  bit_rate_ = std::min(max_bit_rate_, bit_rate_ + max_bit_rate_ / INCREASE_STEPS);
+  last_change_ = now;
+  ++stats_.bit_rate_increases;
+  return bit_rate_;
+}
+
+void CongestionController::on_drained() noexcept { congested_.store(false, std::memory_order_release); }
+
+void CongestionController::reset() {
+  const auto lock_guard = std::lock_guard(mutex_);
+  congested_.store(false, std::memory_order_release);
+  bit_rate_ = max_bit_rate_;
+  last_change_ = {};
+}
+
+std::int64_t CongestionController::bit_rate() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  return bit_rate_;
+}
+
+CongestionController::Stats CongestionController::stats() const {
+  const auto lock_guard = std::lock_guard(mutex_);
+  return stats_;
+}
+} // namespace streaming
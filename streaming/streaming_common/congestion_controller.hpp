@@ -0,0 +1,71 @@
+#pragma once
+
+#include "streaming_common/constants.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+
+namespace streaming {
+/**
+ * Sender-side congestion control on the send buffer of a data channel.
+ *
+ * The amount libdatachannel still has queued after a send shows a link which does not keep up within a frame, long
+ * before the receiver's ACKs report a growing lag. Above SEND_BUFFER_HIGH_WATERMARK the channel counts as congested
+ * until the buffer drains below SEND_BUFFER_LOW_WATERMARK, and the target bit rate follows AIMD: a multiplicative
+ * decrease per congestion episode, an additive increase per quiet interval.
+ *
+ * Thread-safe, sends and the buffered-amount-low notification usually arrive on different threads.
+ */
+class CongestionController {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Stats {
+    std::uint64_t congestion_events{};
+    std::uint64_t bit_rate_decreases{};
+    std::uint64_t bit_rate_increases{};
+  };
+
+  /**
+   * @param max_bit_rate Bit rate the encoder was opened with, the target never exceeds it.
+   * @param min_bit_rate Lower bound of the target, 0 selects an eighth of `max_bit_rate`.
+   */
+  explicit CongestionController(const std::int64_t max_bit_rate = ENCODE_BITRATE, const std::int64_t min_bit_rate = 0);
+
+  /**
+   * Updates the state with the amount buffered after a send.
+   *
+   * @return The new target bit rate if it changed.
+   */
+  std::optional<std::int64_t> on_sent(const std::size_t buffered_amount, const Clock::time_point now = Clock::now());
+  /**
+   * The buffered amount fell to SEND_BUFFER_LOW_WATERMARK, ends the congestion episode.
+   */
+  void on_drained() noexcept;
+  /**
+   * Forgets the state of the previous connection, the target goes back to the maximum.
+   */
+  void reset();
+
+  /**
+   * True while frames should not be encoded, encoded frames cannot be dropped without breaking the ones predicted from
+   * them.
+   */
+  bool congested() const noexcept { return congested_.load(std::memory_order_acquire); }
+  std::int64_t bit_rate() const;
+  Stats stats() const;
+
+private:
+  const std::int64_t max_bit_rate_;
+  const std::int64_t min_bit_rate_;
+  std::atomic<bool> congested_{false};
+  mutable std::mutex mutex_{};
+  std::int64_t bit_rate_;
+  Clock::time_point last_change_{};
+  Stats stats_{};
+};
+} // namespace streaming
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 
@@ -21,19 +22,46 @@ constexpr auto BITRATE_Mbits_8 = BITRATE_Mbits_1 * 8;
 
 constexpr auto ENCODE_BITRATE = BITRATE_Mbits_4;
 
+// Opus audio: 48 kHz stereo in 10 ms frames, the shortest frame the speech (SILK) layer supports - 2.5 and 5 ms frames
+// are music-only (CELT) and need more bits for the same quality.
+constexpr auto AUDIO_SAMPLE_RATE = 48000;
+constexpr auto AUDIO_CHANNELS_NUM = 2;
+constexpr auto AUDIO_FRAME_DURATION = std::chrono::milliseconds{10};
+constexpr auto AUDIO_FRAME_SAMPLES = static_cast<int>(AUDIO_SAMPLE_RATE * AUDIO_FRAME_DURATION.count() / 1000);
+constexpr auto AUDIO_BITRATE = 64000;
+
 constexpr auto CHANNELS_NUM = int{4};
 constexpr auto MAX_MESSAGE_SIZE = 1024u * 1024u; // 1MB
 constexpr auto STREAMER_ID = "streamer";
 constexpr auto RECEIVER_ID = "receiver";
 constexpr auto DATA_CHANNEL_ID = "video-channel";
 
-// Feedback ACK: receiver sends one ACK message every ACK_INTERVAL received DataChannel packets.
+// Feedback ACK: receiver sends one ACK message every ACK_INTERVAL video packets delivered complete to the decoder. A
+// packet counts once however many fragments or FEC shards it was sent as.
 constexpr auto ACK_INTERVAL = std::size_t{10};
 
-// Lag thresholds (in DataChannel packets) for encoder throttling on the streamer side.
-// Each encoded frame produces one packet, so packet lag approximates frame lag in normal operation.
+// Payload bytes per fragment of a large packet on the reliable channel. Together with the headers a fragment stays
+// within a single SCTP packet at the 1280 byte path MTU libdatachannel assumes, so the receiver gets each fragment as
+// soon as its datagram arrives instead of waiting for SCTP to reassemble the whole packet.
+constexpr auto FRAGMENT_SIZE = std::size_t{1100};
+
+// Payload bytes per FEC shard, sized like fragments so losing one UDP datagram costs exactly one shard.
+constexpr auto FEC_SHARD_SIZE = FRAGMENT_SIZE;
+
+// Send buffer watermarks of the data channel in bytes. Above the high one the link does not keep up and frames are
+// skipped before encoding until the buffer drains below the low one, see CongestionController. 128 KiB queue about
+// 250 ms at ENCODE_BITRATE.
+constexpr auto SEND_BUFFER_HIGH_WATERMARK = std::size_t{128 * 1024};
+constexpr auto SEND_BUFFER_LOW_WATERMARK = std::size_t{32 * 1024};
+
+// Lag thresholds (in encoded frames) for encoder throttling on the streamer side: the frame number of the last sent
+// packet minus the acknowledged one. Packets are split into fragments or FEC shards on the wire but acknowledged whole.
 // Above LAG_THROTTLE_HEAVY: encode every 4th frame.
 // Above LAG_THROTTLE_LIGHT: encode every 2nd frame.
 constexpr auto LAG_THROTTLE_LIGHT = std::uint64_t{10};
 constexpr auto LAG_THROTTLE_HEAVY = std::uint64_t{30};
+
+// Streamers report their load (average encode time) to the signaling server at most this often, the session broker
+// assigns receivers to the compatible streamer of the lowest encode time.
+constexpr auto LOAD_REPORT_INTERVAL = std::chrono::seconds{1};
 } // namespace streaming
@@ -1,11 +1,16 @@
 #include "decoder.hpp"
 
+#include "streaming_common/codec_presets.hpp"
 #include "streaming_common/constants.hpp"
 
 #include <libyuv.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
+#include <limits>
 #include <stdexcept>
+#include <string>
 
 namespace streaming {
 void Decoder::init(const VideoStreamInfo &video_stream_info) {
@@ -14,9 +19,25 @@ void Decoder::init(const VideoStreamInfo &video_stream_info) {
   }
 
   rgb_frame_ = std::make_shared<FrameData>(video_stream_info.width * video_stream_info.height * CHANNELS_NUM);
-  codec_ = avcodec_find_decoder(video_stream_info.codec_id);
+  width_ = video_stream_info.width;
+  height_ = video_stream_info.height;
+  const auto &preset = codec_preset(video_stream_info.codec_id);
+  packetized_ = preset.packetized;
+
+  const CodecImplementation *implementation{};
+  for (const auto &candidate : preset.decoders) {
+    codec_ = avcodec_find_decoder_by_name(candidate.name.c_str());
+    if (codec_) {
+      implementation = &candidate;
+      break;
+    }
+  }
+  if (!codec_) {
+    codec_ = avcodec_find_decoder(video_stream_info.codec_id);
+  }
   context_.reset(codec_ ? avcodec_alloc_context3(codec_) : nullptr);
-  parser_.reset(codec_ ? av_parser_init(codec_->id) : nullptr);
+  // Packetized streams arrive with packet boundaries intact, so they bypass the parser.
+  parser_.reset(codec_ && !packetized_ ? av_parser_init(codec_->id) : nullptr);
   packet_.reset(av_packet_alloc());
   if (codec_ == nullptr) {
     throw std::runtime_error{"avcodec_find_decoder failed"};
@@ -24,7 +45,7 @@ void Decoder::init(const VideoStreamInfo &video_stream_info) {
   if (!context_) {
     throw std::runtime_error{"avcodec_alloc_context3 failed"};
   }
-  if (!parser_) {
+  if (!packetized_ && !parser_) {
     throw std::runtime_error{"av_parser_init failed"};
   }
   if (!packet_) {
@@ -39,6 +60,9 @@ void Decoder::init(const VideoStreamInfo &video_stream_info) {
   // Output frames immediately without reordering; safe because the encoder
   // uses max_b_frames=0 so there are no B-frames to reorder.
   context_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+  if (implementation) {
+    apply_codec_options(context_.get(), *implementation);
+  }
 
   if (avcodec_open2(context_.get(), codec_, nullptr) < 0) {
     throw std::runtime_error{"avcodec_open2 failed"};
@@ -53,6 +77,9 @@ void Decoder::init(const VideoStreamInfo &video_stream_info) {
   {
     buffer_.clear();
     buffer_read_offset_ = 0;
+    timestamp_spans_.clear();
+    stream_size_ = 0;
+    packets_.clear();
     signaled_eof_ = false;
   }
 }
@@ -113,7 +140,10 @@ Decoder::Status Decoder::decode() {
     }
     upload_timing_fresh_ = false;
 #endif
-    return {Status::Code::OK, static_cast<int>(context_->frame_num)};
+    // The decoders run without reordering, each frame carries the pts of the packet it was decoded from.
+    const auto timestamp_us = frame_->pts != AV_NOPTS_VALUE && frame_->pts > 0 ? static_cast<std::uint64_t>(frame_->pts)
+                                                                               : std::uint64_t{0};
+    return {Status::Code::OK, static_cast<int>(context_->frame_num), timestamp_us};
   } else {
 #ifdef STREAMING_PIPELINE_STATS
     using Clock = std::chrono::steady_clock;
@@ -136,7 +166,10 @@ Decoder::Status Decoder::decode() {
   }
 }
 
-bool Decoder::incoming_data(const std::byte *data, const std::size_t size, const bool async) {
+bool Decoder::incoming_data(const std::byte *data,
+                            const std::size_t size,
+                            const bool async,
+                            const std::uint64_t timestamp_us) {
   if (!async && !rgb_frame_) {
     throw std::runtime_error{"Decoder is not initialized"};
   }
@@ -146,10 +179,31 @@ bool Decoder::incoming_data(const std::byte *data, const std::size_t size, const
   }
 
   if (async) {
-    fill_async_buffer(data, size);
+    fill_async_buffer(data, size, timestamp_us);
     return true;
   }
 
+  if (packetized_) {
+    // Each call carries exactly one encoded packet; an empty one only marks the end of the stream.
+    if (size > 0) {
+      auto &packet = packets_.emplace_back();
+      packet.timestamp_us = timestamp_us;
+      packet.data.reserve(size + NULL_PADDING.size());
+      packet.data.insert(packet.data.end(),
+                         reinterpret_cast<const std::uint8_t *>(data),
+                         reinterpret_cast<const std::uint8_t *>(data + size));
+      packet.data.insert(packet.data.end(), NULL_PADDING.begin(), NULL_PADDING.end());
+    }
+    return true;
+  }
+
+  stream_size_ += static_cast<std::int64_t>(size);
+  if (!timestamp_spans_.empty() && timestamp_spans_.back().timestamp_us == timestamp_us) {
+    timestamp_spans_.back().end = stream_size_;
+  } else if (size > 0) {
+    timestamp_spans_.push_back({stream_size_, timestamp_us});
+  }
+
   if (buffer_.empty()) {
     buffer_.reserve(size + NULL_PADDING.size());
   } else {
@@ -160,7 +214,7 @@ bool Decoder::incoming_data(const std::byte *data, const std::size_t size, const
     if (buffer_.size() >= NULL_PADDING.size()) {
       buffer_.erase(buffer_.end() - NULL_PADDING.size(), buffer_.end());
     }
-    buffer_.reserve(buffer_.size() + size + NULL_PADDING.size());
+    // No exact reserve() here - letting the vector grow geometrically keeps bulk feeding of many packets linear.
   }
 
   buffer_.insert(buffer_.end(),
@@ -174,6 +228,10 @@ bool Decoder::incoming_data(const std::byte *data, const std::size_t size, const
 void Decoder::signal_eof() { signaled_eof_ = true; }
 
 bool Decoder::upload() {
+  if (packetized_) {
+    return upload_packet();
+  }
+
   for (;;) {
     consume_async_buffer();
     const auto eof = buffer_.empty() && signaled_eof_;
@@ -182,12 +240,14 @@ bool Decoder::upload() {
     }
 
     const auto size = buffer_.empty() ? 0u : (buffer_.size() - buffer_read_offset_ - NULL_PADDING.size());
+    // The parser takes an int, larger buffers are parsed over several rounds.
+    const auto parse_size = std::min(size, static_cast<std::size_t>(std::numeric_limits<int>::max()));
     auto result = av_parser_parse2(parser_.get(),
                                    context_.get(),
                                    &packet_->data,
                                    &packet_->size,
                                    buffer_.data() + buffer_read_offset_,
-                                   static_cast<int>(size),
+                                   static_cast<int>(parse_size),
                                    AV_NOPTS_VALUE,
                                    AV_NOPTS_VALUE,
                                    0);
@@ -195,6 +255,9 @@ bool Decoder::upload() {
     auto used = result;
 
     if (packet_->size != 0) {
+      // The parser buffers internally, the offset it reports is the only reliable start of the packet.
+      const auto timestamp_us = stream_timestamp(parser_->frame_offset);
+      packet_->pts = timestamp_us != 0 ? static_cast<std::int64_t>(timestamp_us) : AV_NOPTS_VALUE;
       result = avcodec_send_packet(context_.get(), packet_.get());
       if (result == 0) {
         reduce_buffer(used);
@@ -236,18 +299,60 @@ bool Decoder::upload() {
   }
 
   if (signaled_eof_) {
-    auto result = avcodec_send_packet(context_.get(), nullptr);
-    if (result == 0 || result == AVERROR_EOF) {
-      packet_sent_ = true;
-      return true;
-    } else {
-      throw std::runtime_error("avcodec_send_packet EOF failed");
-    }
+    return send_flush_packet();
   }
 
   return false;
 }
 
+bool Decoder::upload_packet() {
+  consume_async_buffer();
+
+  if (packets_.empty()) {
+    return signaled_eof_ && send_flush_packet();
+  }
+
+  auto &packet = packets_.front();
+  packet_->data = packet.data.data();
+  packet_->size = static_cast<int>(packet.data.size() - NULL_PADDING.size());
+  packet_->pts = packet.timestamp_us != 0 ? static_cast<std::int64_t>(packet.timestamp_us) : AV_NOPTS_VALUE;
+  // The packet is not reference counted, so the decoder copies the data and the buffer can be released right away.
+  const auto result = avcodec_send_packet(context_.get(), packet_.get());
+  packet_->data = nullptr;
+  packet_->size = 0;
+  packet_->pts = AV_NOPTS_VALUE;
+
+  if (result == AVERROR(EAGAIN)) {
+    // Decoder output is full - keep the packet and receive frames first.
+    packet_sent_ = true;
+    return true;
+  }
+  packets_.pop_front();
+  if (result == 0) {
+    packet_sent_ = true;
+    return true;
+  }
+  if (result == AVERROR_INVALIDDATA) {
+    printf("AVERROR_INVALIDDATA: invalid data found when processing input\n");
+    return false;
+  }
+  if (result == AVERROR_EOF) {
+    printf("AVERROR_EOF: the decoder has been flushed, and no new packets can be sent to it\n");
+    return false;
+  }
+  throw std::runtime_error("avcodec_send_packet filed with error: " + std::to_string(result));
+}
+
+bool Decoder::send_flush_packet() {
+  auto result = avcodec_send_packet(context_.get(), nullptr);
+  if (result == 0 || result == AVERROR_EOF) {
+    packet_sent_ = true;
+    return true;
+  } else {
+    throw std::runtime_error("avcodec_send_packet EOF failed");
+  }
+}
+
 void Decoder::reduce_buffer(int n) {
   if (buffer_.empty()) {
     return;
@@ -261,33 +366,69 @@ void Decoder::reduce_buffer(int n) {
 }
 
 void Decoder::yuv_to_rgb() {
+  const std::uint8_t *planes[3] = {frame_->data[0], frame_->data[1], frame_->data[2]};
+  int strides[3] = {frame_->linesize[0], frame_->linesize[1], frame_->linesize[2]};
+
+  // A simulcast streamer switches resolution at keyframes, frames of another layer are scaled to the stream's size.
+  if (frame_->width != width_ || frame_->height != height_) {
+    const auto chroma_width = (width_ + 1) / 2;
+    const auto chroma_height = (height_ + 1) / 2;
+    scaled_planes_[0].resize(static_cast<std::size_t>(width_) * height_);
+    scaled_planes_[1].resize(static_cast<std::size_t>(chroma_width) * chroma_height);
+    scaled_planes_[2].resize(static_cast<std::size_t>(chroma_width) * chroma_height);
+    libyuv::I420Scale(planes[0],
+                      strides[0],
+                      planes[1],
+                      strides[1],
+                      planes[2],
+                      strides[2],
+                      frame_->width,
+                      frame_->height,
+                      scaled_planes_[0].data(),
+                      width_,
+                      scaled_planes_[1].data(),
+                      chroma_width,
+                      scaled_planes_[2].data(),
+                      chroma_width,
+                      width_,
+                      height_,
+                      libyuv::kFilterBilinear);
+    for (std::size_t plane = 0; plane < scaled_planes_.size(); ++plane) {
+      planes[plane] = scaled_planes_[plane].data();
+    }
+    strides[0] = width_;
+    strides[1] = chroma_width;
+    strides[2] = chroma_width;
+  }
+
   // YUV420P (I420) → RGBA via libyuv.
   // libyuv uses 32-bit integer naming on little-endian: "ABGR" means bytes in
   // memory are [R, G, B, A] — exactly what GL_RGBA expects.
   auto *dst = reinterpret_cast<std::uint8_t *>(rgb_frame_->data());
-  const int dst_stride = context_->width * CHANNELS_NUM;
-  libyuv::I420ToABGR(frame_->data[0],
-                     frame_->linesize[0],
-                     frame_->data[1],
-                     frame_->linesize[1],
-                     frame_->data[2],
-                     frame_->linesize[2],
+  const int dst_stride = width_ * CHANNELS_NUM;
+  libyuv::I420ToABGR(planes[0],
+                     strides[0],
+                     planes[1],
+                     strides[1],
+                     planes[2],
+                     strides[2],
                      dst,
                      dst_stride,
-                     context_->width,
-                     context_->height);
+                     width_,
+                     height_);
 }
 
-void Decoder::fill_async_buffer(const std::byte *data, const std::size_t size) {
+void Decoder::fill_async_buffer(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us) {
   const auto lock = std::lock_guard{async_buffer_mutex_};
 
-  async_buffer_.insert(async_buffer_.end(),
-                       reinterpret_cast<const std::uint8_t *>(data),
-                       reinterpret_cast<const std::uint8_t *>(data + size));
+  // Chunks are kept separate: async data may arrive before init() determines whether the stream is packetized.
+  async_buffer_.push_back({.data = std::vector<std::uint8_t>(reinterpret_cast<const std::uint8_t *>(data),
+                                                             reinterpret_cast<const std::uint8_t *>(data + size)),
+                           .timestamp_us = timestamp_us});
 }
 
 void Decoder::consume_async_buffer() {
-  std::vector<std::uint8_t> local;
+  std::vector<Chunk> local;
   {
     const auto lock = std::lock_guard{async_buffer_mutex_};
     if (async_buffer_.empty()) {
@@ -295,6 +436,16 @@ void Decoder::consume_async_buffer() {
     }
     local.swap(async_buffer_);
   }
-  incoming_data(reinterpret_cast<const std::byte *>(local.data()), local.size());
+  for (const auto &chunk : local) {
+    incoming_data(reinterpret_cast<const std::byte *>(chunk.data.data()), chunk.data.size(), false, chunk.timestamp_us);
+  }
+}
+
+std::uint64_t Decoder::stream_timestamp(const std::int64_t offset) {
+  // Packets leave the parser in stream order, spans which end before this one starts are done with.
+  while (!timestamp_spans_.empty() && timestamp_spans_.front().end <= offset) {
+    timestamp_spans_.pop_front();
+  }
+  return timestamp_spans_.empty() ? 0 : timestamp_spans_.front().timestamp_us;
 }
 } // namespace streaming
@@ -12,6 +12,7 @@
 #endif
 #include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -40,6 +41,11 @@ public:
      * meaningless.
      */
     int frame_num;
+    /**
+     * Streamer timestamp of the packet the frame was decoded from, as passed to incoming_data(). 0 if unknown or
+     * decoding was not successful.
+     */
+    std::uint64_t timestamp_us{};
   };
 
 #ifdef STREAMING_PIPELINE_STATS
@@ -59,6 +65,9 @@ public:
   Decoder(Decoder &&other) noexcept = delete;
   Decoder &operator=(Decoder &&other) noexcept = delete;
 
+  /**
+   * Opens the decoder for `video_stream_info.codec_id` using the low-latency preset from @ref codec_preset().
+   */
   void init(const VideoStreamInfo &video_stream_info);
 
   std::shared_ptr<FrameData> rgb_frame();
@@ -72,25 +81,61 @@ public:
    */
   [[nodiscard]] Status decode();
   /**
-   * Upload stream data to the intermediate buffer.
+   * Upload stream data to the intermediate buffer. For packetized codecs (VP9, AV1) every call must carry exactly one
+   * encoded packet, as produced by the Encoder callback.
    *
+   * @param timestamp_us Streamer timestamp of the packet the data belongs to, 0 if unknown. Passed through the decoder
+   *                     as the packet's pts and reported with the decoded frame, so a packet which yields no frame
+   *                     cannot shift the timestamps of the following ones.
    * @return
    *      true:   data successfully uploaded
    *      false:  data not uploaded - in EOF state, data must be temporarily stored elsewhere
    */
-  bool incoming_data(const std::byte *data, const std::size_t size, const bool async = false);
+  bool incoming_data(const std::byte *data,
+                     const std::size_t size,
+                     const bool async = false,
+                     const std::uint64_t timestamp_us = 0);
   void signal_eof();
 
 private:
+  /**
+   * Stream data together with the streamer timestamp of its packet.
+   */
+  struct Chunk {
+    std::vector<std::uint8_t> data{};
+    std::uint64_t timestamp_us{};
+  };
+
+  /**
+   * Bytes of a byte stream up to `end`, counted from the start of the stream, which belong to packets of the same
+   * timestamp.
+   */
+  struct TimestampSpan {
+    std::int64_t end{};
+    std::uint64_t timestamp_us{};
+  };
+
   [[nodiscard]] bool upload();
+  [[nodiscard]] bool upload_packet();
+  [[nodiscard]] bool send_flush_packet();
   void reduce_buffer(int n);
   void yuv_to_rgb();
-  void fill_async_buffer(const std::byte *data, const std::size_t size);
+  void fill_async_buffer(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us);
   void consume_async_buffer();
+  /**
+   * @return timestamp of the byte stream data at `offset`, spans before it are released.
+   */
+  std::uint64_t stream_timestamp(const std::int64_t offset);
 
   static constexpr std::array<std::uint8_t, AV_INPUT_BUFFER_PADDING_SIZE> NULL_PADDING{};
 
   std::shared_ptr<FrameData> rgb_frame_{};
+  /**
+   * Size of the stream and of the RGB frame, decoded frames may differ from it after a simulcast layer switch.
+   */
+  int width_{};
+  int height_{};
+  std::array<std::vector<std::uint8_t>, 3> scaled_planes_{};
 
   const AVCodec *codec_{};
   gp::ffmpeg::UniqueAVCodecContext context_{};
@@ -100,8 +145,19 @@ private:
 
   std::vector<std::uint8_t> buffer_{};
   std::size_t buffer_read_offset_{0};
+  /**
+   * The parser reports where in the stream a packet starts, these spans tell its timestamp.
+   */
+  std::deque<TimestampSpan> timestamp_spans_{};
+  std::int64_t stream_size_{0};
+
+  /**
+   * Queue of whole packets for packetized codecs, each followed by padding.
+   */
+  std::deque<Chunk> packets_{};
+  bool packetized_{false};
 
-  std::vector<std::uint8_t> async_buffer_{};
+  std::vector<Chunk> async_buffer_{};
   std::mutex async_buffer_mutex_{};
 
 #ifdef STREAMING_PIPELINE_STATS
@@ -1,22 +1,36 @@
 #include "encoder.hpp"
 
+#include "streaming_common/codec_presets.hpp"
 #include "streaming_common/constants.hpp"
 
+#include <gp/misc/profiler.hpp>
+
 #include <libyuv.h>
 
+#include <algorithm>
 #include <array>
 #include <chrono>
 #include <stdexcept>
 #include <string>
-#include <string_view>
 
 namespace streaming {
-Encoder::Encoder(const VideoStreamInfo &video_stream_info)
+Encoder::Encoder(const VideoStreamInfo &video_stream_info, const std::int64_t bit_rate)
     : video_frame_{std::make_shared<FrameData>(video_stream_info.width * video_stream_info.height * CHANNELS_NUM)} {
-  // Prefer hardware VideoToolbox encoder; fall back to software libx264
-  codec_ = avcodec_find_encoder_by_name("h264_videotoolbox");
+  const auto &preset = codec_preset(video_stream_info.codec_id);
+  packetized_ = preset.packetized;
+
+  // Take the first available implementation from the preset (hardware encoders are listed first); if none of them is
+  // compiled into FFmpeg fall back to whatever encoder FFmpeg registers for the codec id, without extra options.
+  const CodecImplementation *implementation{};
+  for (const auto &candidate : preset.encoders) {
+    codec_ = avcodec_find_encoder_by_name(candidate.name.c_str());
+    if (codec_) {
+      implementation = &candidate;
+      break;
+    }
+  }
   if (!codec_) {
-    codec_ = avcodec_find_encoder(AV_CODEC_ID_H264);
+    codec_ = avcodec_find_encoder(video_stream_info.codec_id);
   }
   context_.reset(codec_ ? avcodec_alloc_context3(codec_) : nullptr);
   packet_.reset(av_packet_alloc());
@@ -31,7 +45,7 @@ Encoder::Encoder(const VideoStreamInfo &video_stream_info)
     throw std::runtime_error{"av_packet_alloc failed"};
   }
 
-  context_->bit_rate = ENCODE_BITRATE;
+  context_->bit_rate = bit_rate;
   context_->width = video_stream_info.width;
   context_->height = video_stream_info.height;
   context_->time_base = {1, video_stream_info.fps};
@@ -41,12 +55,9 @@ Encoder::Encoder(const VideoStreamInfo &video_stream_info)
   context_->pix_fmt = AV_PIX_FMT_YUV420P;
   context_->thread_count = 1;
 
-  if (std::string_view{codec_->name} == "h264_videotoolbox") {
+  if (implementation) {
     // Minimise internal frame buffering so input events are reflected without delay.
-    av_opt_set_int(context_->priv_data, "realtime", 1, 0);
-  } else {
-    av_opt_set(context_->priv_data, "preset", "ultrafast", 0);
-    av_opt_set(context_->priv_data, "tune", "zerolatency", 0);
+    apply_codec_options(context_.get(), *implementation);
   }
 
   if (avcodec_open2(context_.get(), codec_, nullptr) < 0) {
@@ -78,6 +89,8 @@ Encoder::~Encoder() {
 
 std::shared_ptr<FrameData> Encoder::video_frame() { return video_frame_; }
 
+const char *Encoder::encoder_name() const { return codec_->name; }
+
 VideoStreamInfo Encoder::video_stream_info() const {
   return {context_->width,
           context_->height,
@@ -86,12 +99,17 @@ VideoStreamInfo Encoder::video_stream_info() const {
           std::string{avcodec_get_name(codec_->id)}};
 }
 
+void Encoder::set_bit_rate(const std::int64_t bit_rate) { context_->bit_rate = bit_rate; }
+
+std::int64_t Encoder::bit_rate() const { return context_->bit_rate; }
+
 void Encoder::set_video_stream_callback(
     std::function<void(const std::byte *data, const std::size_t size, const bool eof)> video_stream_callback) {
   video_stream_callback_ = video_stream_callback;
 }
 
 void Encoder::encode() {
+  GP_PROFILE_ZONE("Encoder::encode");
   if (av_frame_make_writable(frame_.get()) < 0) {
     throw std::runtime_error{"av_frame_make_writable failed"};
   }
@@ -104,6 +122,7 @@ void Encoder::encode() {
 #ifdef STREAMING_PIPELINE_STATS
   const auto t1 = Clock::now();
 #endif
+  frame_->pict_type = keyframe_requested_.exchange(false) ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_NONE;
   encode_frame(frame_.get());
 #ifdef STREAMING_PIPELINE_STATS
   const auto t2 = Clock::now();
@@ -133,9 +152,14 @@ void Encoder::encode_frame(AVFrame *frame) {
       if (rc == AVERROR(EAGAIN)) {
         drained = true;
       } else if (rc == AVERROR_EOF) {
+        keyframe_packet_ = false;
+        packet_frame_num_ = next_packet_frame_num_++;
         if (video_stream_callback_) {
+          // Packetized codecs have no start codes, so an end code would be decoded as a (corrupt) packet.
           static constexpr std::array<uint8_t, 4> endcode{0, 0, 1, 0xb7};
-          video_stream_callback_(reinterpret_cast<const std::byte *>(endcode.data()), sizeof(endcode), true);
+          video_stream_callback_(reinterpret_cast<const std::byte *>(endcode.data()),
+                                 packetized_ ? 0u : sizeof(endcode),
+                                 true);
         }
         av_packet_unref(packet_.get());
         return;
@@ -144,6 +168,12 @@ void Encoder::encode_frame(AVFrame *frame) {
         av_strerror(rc, errbuf, sizeof(errbuf));
         throw std::runtime_error{std::string{"avcodec_receive_packet failed: "} + errbuf};
       } else {
+        keyframe_packet_ = (packet_->flags & AV_PKT_FLAG_KEY) != 0;
+        // The pts counts encode() calls and, without B-frames, increases; frames rate control drops leave gaps.
+        const auto pts = packet_->pts != AV_NOPTS_VALUE && packet_->pts >= 0 ? static_cast<std::uint64_t>(packet_->pts)
+                                                                              : next_packet_frame_num_;
+        packet_frame_num_ = std::max(pts, next_packet_frame_num_);
+        next_packet_frame_num_ = packet_frame_num_ + 1;
         if (video_stream_callback_) {
           video_stream_callback_(reinterpret_cast<const std::byte *>(packet_->data),
                                  static_cast<std::size_t>(packet_->size),
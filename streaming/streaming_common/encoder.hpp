@@ -1,13 +1,16 @@
 #pragma once
 
+#include "streaming_common/constants.hpp"
 #include "streaming_common/frame_data.hpp"
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/ffmpeg/ffmpeg.hpp>
 
+#include <atomic>
 #ifdef STREAMING_PIPELINE_STATS
 # include <chrono>
 #endif
+#include <cstdint>
 #include <functional>
 #include <memory>
 
@@ -21,7 +24,12 @@ public:
   };
 #endif
 
-  explicit Encoder(const VideoStreamInfo &video_stream_info);
+  /**
+   * Opens the encoder for `video_stream_info.codec_id` using the low-latency preset from @ref codec_preset().
+   *
+   * @throw std::runtime_error if the codec is not supported or no encoder implementation is available.
+   */
+  explicit Encoder(const VideoStreamInfo &video_stream_info, const std::int64_t bit_rate = ENCODE_BITRATE);
   Encoder(const Encoder &) = delete;
   Encoder &operator=(const Encoder &) = delete;
   Encoder(Encoder &&other) noexcept = delete;
@@ -31,11 +39,37 @@ public:
 
   std::shared_ptr<FrameData> video_frame();
   VideoStreamInfo video_stream_info() const;
+  /**
+   * Name of the FFmpeg encoder implementation in use, e.g. "libx264".
+   */
+  const char *encoder_name() const;
 
 #ifdef STREAMING_PIPELINE_STATS
   const Timings &last_timings() const noexcept { return last_timings_; }
 #endif
 
+  /**
+   * Changes the target bit rate of the rate control. Implementations which reconfigure on the fly (libx264) apply it
+   * with the next frame, the others keep the rate they were opened with. Must not be called while encode() runs.
+   */
+  void set_bit_rate(const std::int64_t bit_rate);
+  std::int64_t bit_rate() const;
+
+  /**
+   * The next encoded frame becomes a keyframe, e.g. for a receiver which switches to this stream. May be called from
+   * any thread.
+   */
+  void request_keyframe() noexcept { keyframe_requested_.store(true); }
+  /**
+   * True while the video stream callback is called with the packet of a keyframe.
+   */
+  bool keyframe_packet() const noexcept { return keyframe_packet_; }
+  /**
+   * Number of the frame whose packet the video stream callback is called with, the encode() call it came from counted
+   * from 0. Strictly increasing, the end of stream packet comes after the last frame.
+   */
+  std::uint64_t packet_frame_num() const noexcept { return packet_frame_num_; }
+
   void set_video_stream_callback(
       std::function<void(const std::byte *data, const std::size_t size, const bool eof)> video_stream_callback);
   void encode();
@@ -53,8 +87,14 @@ private:
 #endif
 
   const AVCodec *codec_{};
+  bool packetized_{};
   gp::ffmpeg::UniqueAVCodecContext context_{};
   gp::ffmpeg::UniqueAVPacket packet_{};
   gp::ffmpeg::UniqueAVFrame frame_{};
+
+  std::atomic<bool> keyframe_requested_{false};
+  bool keyframe_packet_{false};
+  std::uint64_t packet_frame_num_{};
+  std::uint64_t next_packet_frame_num_{};
 };
 } // namespace streaming
@@ -0,0 +1,246 @@
+#include "fec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace streaming {
+namespace {
+constexpr auto HEADERS_SIZE = STREAM_PACKAGE_HEADER_SIZE + FEC_SHARD_HEADER_SIZE;
+
+// Incomplete packets kept around at most, a few frames of reordering is all an unordered channel should produce.
+constexpr auto MAX_PENDING_PACKETS = std::size_t{64};
+} // namespace
+
+FecPacketizer::FecPacketizer(const std::size_t group_size, const std::size_t shard_size)
+    : group_size_(group_size)
+    , shard_size_(shard_size) {
+  if (group_size_ > std::numeric_limits<std::uint8_t>::max()) {
+    throw std::runtime_error{"FEC group size must not exceed 255"};
+  }
+  if (shard_size_ == 0) {
+    throw std::runtime_error{"FEC shard size must not be 0"};
+  }
+}
+
+void FecPacketizer::packetize(const StreamPackageHeader &header,
+                              const std::byte *data,
+                              const std::size_t size,
+                              const std::function<void(const std::byte *message, const std::size_t size)> &send) {
+  const auto data_shards = std::max<std::size_t>((size + shard_size_ - 1) / shard_size_, 1);
+  if (size > std::numeric_limits<std::uint32_t>::max() || data_shards > std::numeric_limits<std::uint16_t>::max()) {
+    throw std::runtime_error{"Packet too large for FEC: " + std::to_string(size) + " bytes"};
+  }
+
+  auto layout = FecShardHeader{static_cast<std::uint32_t>(size),
+                               0,
+                               static_cast<std::uint16_t>(data_shards),
+                               static_cast<std::uint8_t>(group_size_),
+                               false};
+  const auto shard_size = layout.shard_size();
+  auto fec_header = header;
+  fec_header.fec = true;
+  const auto package_header = fec_header.serialize();
+
+  message_.resize(HEADERS_SIZE + shard_size);
+  parity_.resize(shard_size);
+  std::memcpy(message_.data(), package_header.data(), STREAM_PACKAGE_HEADER_SIZE);
+
+  const auto send_shard = [&](const std::byte *payload, const std::size_t payload_size) {
+    const auto shard_header = layout.serialize();
+    std::memcpy(message_.data() + STREAM_PACKAGE_HEADER_SIZE, shard_header.data(), FEC_SHARD_HEADER_SIZE);
+    if (payload_size > 0) {
+      std::memcpy(message_.data() + HEADERS_SIZE, payload, payload_size);
+    }
+    send(message_.data(), HEADERS_SIZE + payload_size);
+  };
+
+  for (std::size_t index = 0; index < data_shards; ++index) {
+    const auto offset = index * shard_size;
+    const auto payload_size = std::min(shard_size, size - offset);
+    layout.index = static_cast<std::uint16_t>(index);
+    layout.parity = false;
+    send_shard(data + offset, payload_size);
+
+    if (group_size_ == 0) {
+      continue;
+    }
+    const auto group_offset = index % group_size_;
+    if (group_offset == 0) {
+      std::fill(parity_.begin(), parity_.end(), std::byte{0});
+    }
+    for (std::size_t i = 0; i < payload_size; ++i) {
+      parity_[i] ^= data[offset + i];
+    }
+    if (group_offset == group_size_ - 1 || index == data_shards - 1) {
+      layout.index = static_cast<std::uint16_t>(index / group_size_);
+      layout.parity = true;
+      send_shard(parity_.data(), shard_size);
+    }
+  }
+}
+
+FecReassembler::FecReassembler(PacketCallback packet_callback)
+    : packet_callback_(std::move(packet_callback)) {}
+
+void FecReassembler::push(const std::byte *message, const std::size_t size) {
+  if (size < HEADERS_SIZE) {
+    ++stats_.shards_malformed;
+    return;
+  }
+
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(message);
+  const auto header = StreamPackageHeader::deserialize(bytes);
+  const auto shard = FecShardHeader::deserialize(bytes + STREAM_PACKAGE_HEADER_SIZE);
+  const auto *payload = message + HEADERS_SIZE;
+  const auto payload_size = size - HEADERS_SIZE;
+
+  const auto valid = header.fec && shard.data_shards > 0 &&
+                     (shard.parity ? shard.group_size > 0 && shard.index < groups_num(shard) &&
+                                         payload_size == shard.shard_size()
+                                   : shard.index < shard.data_shards &&
+                                         payload_size == data_shard_size(shard, shard.index));
+  if (!valid) {
+    ++stats_.shards_malformed;
+    return;
+  }
+  ++stats_.shards_received;
+
+  // Late shard of a packet that was already delivered or given up on.
+  if (last_finished_ && header.frame_num <= *last_finished_) {
+    return;
+  }
+
+  auto it = packets_.find(header.frame_num);
+  if (it == packets_.end()) {
+    it = packets_.emplace(header.frame_num, Packet{}).first;
+    auto &packet = it->second;
+    packet.layout = shard;
+    packet.header = header;
+    packet.data.resize(shard.packet_size);
+    packet.received.assign(shard.data_shards, false);
+    packet.parity.resize(groups_num(shard));
+  } else if (const auto &layout = it->second.layout; layout.packet_size != shard.packet_size ||
+                                                     layout.data_shards != shard.data_shards ||
+                                                     layout.group_size != shard.group_size) {
+    ++stats_.shards_malformed;
+    return;
+  }
+
+  auto &packet = it->second;
+  if (shard.parity) {
+    auto &parity = packet.parity[shard.index];
+    if (parity) {
+      return;
+    }
+    parity.emplace(payload, payload + payload_size);
+    rebuild_group(packet, shard.index);
+  } else {
+    if (packet.received[shard.index]) {
+      return;
+    }
+    if (payload_size > 0) {
+      std::memcpy(packet.data.data() + shard.index * shard.shard_size(), payload, payload_size);
+    }
+    packet.received[shard.index] = true;
+    ++packet.received_num;
+    if (shard.group_size > 0) {
+      rebuild_group(packet, shard.index / shard.group_size);
+    }
+  }
+
+  if (packet.received_num == packet.layout.data_shards) {
+    deliver(header.frame_num);
+  } else if (packets_.size() > MAX_PENDING_PACKETS) {
+    give_up(packets_.begin());
+  }
+}
+
+std::size_t FecReassembler::groups_num(const FecShardHeader &layout) noexcept {
+  return layout.group_size > 0 ? (std::size_t{layout.data_shards} + layout.group_size - 1) / layout.group_size : 0;
+}
+
+std::size_t FecReassembler::data_shard_size(const FecShardHeader &layout, const std::size_t index) noexcept {
+  const auto shard_size = layout.shard_size();
+  const auto offset = index * shard_size;
+  return offset < layout.packet_size ? std::min(shard_size, layout.packet_size - offset) : 0;
+}
+
+void FecReassembler::rebuild_group(Packet &packet, const std::size_t group) {
+  const auto &parity = packet.parity[group];
+  if (!parity) {
+    return;
+  }
+
+  const auto first = group * packet.layout.group_size;
+  const auto last = std::min(first + packet.layout.group_size, std::size_t{packet.layout.data_shards});
+  auto missing = std::optional<std::size_t>{};
+  for (auto index = first; index < last; ++index) {
+    if (!packet.received[index]) {
+      if (missing) {
+        return;
+      }
+      missing = index;
+    }
+  }
+  if (!missing) {
+    return;
+  }
+
+  // XOR of the parity and every other shard of the group, only as many bytes as the missing shard holds.
+  const auto shard_size = packet.layout.shard_size();
+  const auto missing_size = data_shard_size(packet.layout, *missing);
+  auto *target = packet.data.data() + *missing * shard_size;
+  std::memcpy(target, parity->data(), missing_size);
+  for (auto index = first; index < last; ++index) {
+    if (index == *missing) {
+      continue;
+    }
+    const auto *source = packet.data.data() + index * shard_size;
+    const auto size = std::min(missing_size, data_shard_size(packet.layout, index));
+    for (std::size_t i = 0; i < size; ++i) {
+      target[i] ^= source[i];
+    }
+  }
+
+  packet.received[*missing] = true;
+  ++packet.received_num;
+  packet.rebuilt = true;
+  ++stats_.shards_rebuilt;
+}
+
+void FecReassembler::deliver(const std::uint64_t frame_num) {
+  while (packets_.begin()->first < frame_num) {
+    give_up(packets_.begin());
+  }
+
+  auto node = packets_.extract(frame_num);
+  const auto &packet = node.mapped();
+  ++stats_.packets_delivered;
+  if (packet.rebuilt) {
+    ++stats_.packets_recovered;
+  }
+  finish(frame_num);
+
+  if (packet_callback_) {
+    packet_callback_(packet.header, packet.data.data(), packet.data.size());
+  }
+}
+
+void FecReassembler::give_up(const std::map<std::uint64_t, Packet>::iterator it) {
+  const auto &packet = it->second;
+  ++stats_.packets_lost;
+  stats_.shards_missing += packet.layout.data_shards - packet.received_num;
+  finish(it->first);
+  packets_.erase(it);
+}
+
+void FecReassembler::finish(const std::uint64_t frame_num) {
+  // Packets in between never got a single shard through.
+  if (last_finished_) {
+    stats_.packets_lost += frame_num - *last_finished_ - 1;
+  }
+  last_finished_ = frame_num;
+}
+} // namespace streaming
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "streaming_common/constants.hpp"
+#include "streaming_common/stream_package_header.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <optional>
+#include <vector>
+
+namespace streaming {
+
+// Wire format (10 bytes, little-endian), follows a StreamPackageHeader with the fec flag set:
+//   [0..3] packet_size  — uint32, size of the whole encoded packet
+//   [4..5] index        — uint16, data shard index, or group index of a parity shard
+//   [6..7] data_shards  — uint16, number of data shards the packet is split into
+//   [8]    group_size   — uint8, number of consecutive data shards protected by one parity shard, 0 = no parity
+//   [9]    flags        — bit 0 = parity
+constexpr auto FEC_SHARD_HEADER_SIZE = std::size_t{10};
+
+struct FecShardHeader {
+  std::uint32_t packet_size{};
+  std::uint16_t index{};
+  std::uint16_t data_shards{};
+  std::uint8_t group_size{};
+  bool parity{};
+
+  /**
+   * Payload size of every data shard but the last, the packet is split evenly.
+   */
+  [[nodiscard]] std::size_t shard_size() const noexcept {
+    return data_shards > 0 ? (std::size_t{packet_size} + data_shards - 1) / data_shards : 0;
+  }
+
+  [[nodiscard]] std::array<std::uint8_t, FEC_SHARD_HEADER_SIZE> serialize() const noexcept {
+    std::array<std::uint8_t, FEC_SHARD_HEADER_SIZE> buf{};
+    buf[0] = static_cast<std::uint8_t>(packet_size >> 0);
+    buf[1] = static_cast<std::uint8_t>(packet_size >> 8);
+    buf[2] = static_cast<std::uint8_t>(packet_size >> 16);
+    buf[3] = static_cast<std::uint8_t>(packet_size >> 24);
+    buf[4] = static_cast<std::uint8_t>(index >> 0);
+    buf[5] = static_cast<std::uint8_t>(index >> 8);
+    buf[6] = static_cast<std::uint8_t>(data_shards >> 0);
+    buf[7] = static_cast<std::uint8_t>(data_shards >> 8);
+    buf[8] = group_size;
+    buf[9] = parity ? std::uint8_t{1} : std::uint8_t{0};
+    return buf;
+  }
+
+  static FecShardHeader deserialize(const std::uint8_t *buf) noexcept {
+    FecShardHeader h{};
+    h.packet_size = (static_cast<std::uint32_t>(buf[0]) << 0) | (static_cast<std::uint32_t>(buf[1]) << 8) |
+                    (static_cast<std::uint32_t>(buf[2]) << 16) | (static_cast<std::uint32_t>(buf[3]) << 24);
+    h.index = static_cast<std::uint16_t>(buf[4] | (buf[5] << 8));
+    h.data_shards = static_cast<std::uint16_t>(buf[6] | (buf[7] << 8));
+    h.group_size = buf[8];
+    h.parity = (buf[9] & 0x01u) != 0u;
+    return h;
+  }
+};
+
+/**
+ * Splits encoded packets into shards for an unordered channel without retransmissions, and adds one XOR parity shard
+ * per group of `group_size` data shards. Any single lost shard of a group is rebuilt by the FecReassembler without
+ * waiting for a retransmission; two losses in one group lose the packet.
+ */
+class FecPacketizer {
+public:
+  /**
+   * @param group_size Data shards per parity shard, 0 sends the data shards unprotected.
+   * @param shard_size Maximum payload bytes per shard.
+   */
+  explicit FecPacketizer(const std::size_t group_size, const std::size_t shard_size = FEC_SHARD_SIZE);
+
+  /**
+   * Calls `send` with each message of the packet, every group's parity shard directly follows its data shards. Each
+   * message carries `header` with the fec flag set.
+   */
+  void packetize(const StreamPackageHeader &header,
+                 const std::byte *data,
+                 const std::size_t size,
+                 const std::function<void(const std::byte *message, const std::size_t size)> &send);
+
+  std::size_t group_size() const noexcept { return group_size_; }
+
+private:
+  const std::size_t group_size_;
+  const std::size_t shard_size_;
+  std::vector<std::byte> message_{};
+  std::vector<std::byte> parity_{};
+};
+
+/**
+ * Reassembles packets from FecPacketizer shards arriving in any order, rebuilding lost shards from parity.
+ *
+ * Packets are delivered as soon as they are complete. Older packets still incomplete at that point are given up on
+ * and counted as lost - a late packet is of no use to a low-latency decoder, and waiting for it is exactly the
+ * head-of-line blocking the unordered channel avoids.
+ */
+class FecReassembler {
+public:
+  struct Stats {
+    std::uint64_t packets_delivered{};
+    /**
+     * Delivered packets that needed at least one shard rebuilt from parity.
+     */
+    std::uint64_t packets_recovered{};
+    std::uint64_t packets_lost{};
+    std::uint64_t shards_received{};
+    std::uint64_t shards_rebuilt{};
+    /**
+     * Data shards of lost packets that neither arrived nor could be rebuilt.
+     */
+    std::uint64_t shards_missing{};
+    std::uint64_t shards_malformed{};
+  };
+
+  using PacketCallback =
+      std::function<void(const StreamPackageHeader &header, const std::byte *data, const std::size_t size)>;
+
+  explicit FecReassembler(PacketCallback packet_callback);
+
+  /**
+   * Takes one message of the channel, including its StreamPackageHeader.
+   */
+  void push(const std::byte *message, const std::size_t size);
+
+  const Stats &stats() const noexcept { return stats_; }
+
+private:
+  struct Packet {
+    FecShardHeader layout{};
+    StreamPackageHeader header{};
+    std::vector<std::byte> data{};
+    std::vector<bool> received{};
+    std::vector<std::optional<std::vector<std::byte>>> parity{};
+    std::size_t received_num{};
+    bool rebuilt{};
+  };
+
+  static std::size_t groups_num(const FecShardHeader &layout) noexcept;
+  static std::size_t data_shard_size(const FecShardHeader &layout, const std::size_t index) noexcept;
+
+  void rebuild_group(Packet &packet, const std::size_t group);
+  void deliver(const std::uint64_t frame_num);
+  void give_up(const std::map<std::uint64_t, Packet>::iterator it);
+  void finish(const std::uint64_t frame_num);
+
+  PacketCallback packet_callback_;
+  std::map<std::uint64_t, Packet> packets_{};
+  /**
+   * Newest packet delivered or given up on, shards of older packets are ignored.
+   */
+  std::optional<std::uint64_t> last_finished_{};
+  Stats stats_{};
+};
+} // namespace streaming
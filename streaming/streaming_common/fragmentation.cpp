@@ -0,0 +1,137 @@
+#include "fragmentation.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace streaming {
+namespace {
+constexpr auto HEADERS_SIZE = STREAM_PACKAGE_HEADER_SIZE + FRAGMENT_HEADER_SIZE;
+} // namespace
+
+Fragmenter::Fragmenter(const std::size_t fragment_size)
+    : fragment_size_(fragment_size) {
+  if (fragment_size_ == 0) {
+    throw std::runtime_error{"Fragment size must not be 0"};
+  }
+}
+
+void Fragmenter::fragment(const StreamPackageHeader &header,
+                          const std::byte *data,
+                          const std::size_t size,
+                          const std::function<void(const std::byte *message, const std::size_t size)> &send) {
+  if (size <= fragment_size_) {
+    const auto package_header = header.serialize();
+    message_.resize(STREAM_PACKAGE_HEADER_SIZE + size);
+    std::memcpy(message_.data(), package_header.data(), STREAM_PACKAGE_HEADER_SIZE);
+    if (size > 0) {
+      std::memcpy(message_.data() + STREAM_PACKAGE_HEADER_SIZE, data, size);
+    }
+    send(message_.data(), message_.size());
+    return;
+  }
+
+  const auto count = (size + fragment_size_ - 1) / fragment_size_;
+  if (count > std::numeric_limits<std::uint16_t>::max()) {
+    throw std::runtime_error{"Packet too large to fragment: " + std::to_string(size) + " bytes"};
+  }
+
+  auto fragment_package_header = header;
+  fragment_package_header.fragment = true;
+  const auto package_header = fragment_package_header.serialize();
+  message_.resize(HEADERS_SIZE + fragment_size_);
+  std::memcpy(message_.data(), package_header.data(), STREAM_PACKAGE_HEADER_SIZE);
+
+  auto fragment_header = FragmentHeader{0, static_cast<std::uint16_t>(count)};
+  for (std::size_t index = 0; index < count; ++index) {
+    const auto offset = index * fragment_size_;
+    const auto payload_size = std::min(fragment_size_, size - offset);
+    fragment_header.index = static_cast<std::uint16_t>(index);
+    const auto serialized = fragment_header.serialize();
+    std::memcpy(message_.data() + STREAM_PACKAGE_HEADER_SIZE, serialized.data(), FRAGMENT_HEADER_SIZE);
+    std::memcpy(message_.data() + HEADERS_SIZE, data + offset, payload_size);
+    send(message_.data(), HEADERS_SIZE + payload_size);
+  }
+}
+
+FragmentReassembler::FragmentReassembler(const bool progressive, DataCallback data_callback)
+    : progressive_(progressive)
+    , data_callback_(std::move(data_callback)) {}
+
+void FragmentReassembler::push(const std::byte *message, const std::size_t size) {
+  if (size < STREAM_PACKAGE_HEADER_SIZE) {
+    ++stats_.fragments_malformed;
+    return;
+  }
+
+  const auto *bytes = reinterpret_cast<const std::uint8_t *>(message);
+  const auto header = StreamPackageHeader::deserialize(bytes);
+
+  if (!header.fragment) {
+    // A whole packet while another one is still incomplete means the rest of that one is not coming.
+    drop();
+    ++stats_.packets_delivered;
+    if (data_callback_) {
+      data_callback_(header, message + STREAM_PACKAGE_HEADER_SIZE, size - STREAM_PACKAGE_HEADER_SIZE, true);
+    }
+    return;
+  }
+
+  if (size < HEADERS_SIZE) {
+    ++stats_.fragments_malformed;
+    return;
+  }
+  const auto fragment = FragmentHeader::deserialize(bytes + STREAM_PACKAGE_HEADER_SIZE);
+  if (fragment.index >= fragment.count) {
+    ++stats_.fragments_malformed;
+    return;
+  }
+  ++stats_.fragments_received;
+
+  const auto continues = packet_ && packet_->frame_num == header.frame_num && packet_->count == fragment.count &&
+                         packet_->next_index == fragment.index;
+  if (!continues) {
+    drop();
+    // Joining a packet halfway, e.g. right after a reconnect, its first fragments are gone for good.
+    if (fragment.index != 0) {
+      return;
+    }
+    packet_.emplace();
+    packet_->frame_num = header.frame_num;
+    packet_->count = fragment.count;
+  }
+
+  const auto *payload = message + HEADERS_SIZE;
+  const auto payload_size = size - HEADERS_SIZE;
+  const auto last = fragment.index == fragment.count - 1;
+  ++packet_->next_index;
+
+  if (progressive_) {
+    if (data_callback_) {
+      data_callback_(header, payload, payload_size, last);
+    }
+  } else {
+    packet_->data.insert(packet_->data.end(), payload, payload + payload_size);
+  }
+
+  if (!last) {
+    return;
+  }
+  auto packet = std::move(*packet_);
+  packet_.reset();
+  ++stats_.packets_delivered;
+  ++stats_.packets_reassembled;
+  if (!progressive_ && data_callback_) {
+    data_callback_(header, packet.data.data(), packet.data.size(), true);
+  }
+}
+
+void FragmentReassembler::drop() {
+  if (packet_) {
+    ++stats_.packets_dropped;
+    packet_.reset();
+  }
+}
+} // namespace streaming
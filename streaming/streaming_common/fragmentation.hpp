@@ -0,0 +1,127 @@
+#pragma once
+
+#include "streaming_common/constants.hpp"
+#include "streaming_common/stream_package_header.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <vector>
+
+namespace streaming {
+
+// Wire format (4 bytes, little-endian), follows a StreamPackageHeader with the fragment flag set:
+//   [0..1] index  — uint16, position of the fragment within the packet
+//   [2..3] count  — uint16, number of fragments the packet is split into
+constexpr auto FRAGMENT_HEADER_SIZE = std::size_t{4};
+
+struct FragmentHeader {
+  std::uint16_t index{};
+  std::uint16_t count{};
+
+  [[nodiscard]] std::array<std::uint8_t, FRAGMENT_HEADER_SIZE> serialize() const noexcept {
+    std::array<std::uint8_t, FRAGMENT_HEADER_SIZE> buf{};
+    buf[0] = static_cast<std::uint8_t>(index >> 0);
+    buf[1] = static_cast<std::uint8_t>(index >> 8);
+    buf[2] = static_cast<std::uint8_t>(count >> 0);
+    buf[3] = static_cast<std::uint8_t>(count >> 8);
+    return buf;
+  }
+
+  static FragmentHeader deserialize(const std::uint8_t *buf) noexcept {
+    FragmentHeader h{};
+    h.index = static_cast<std::uint16_t>(buf[0] | (buf[1] << 8));
+    h.count = static_cast<std::uint16_t>(buf[2] | (buf[3] << 8));
+    return h;
+  }
+};
+
+/**
+ * Splits encoded packets into messages of at most `fragment_size` payload bytes for the reliable, ordered channel.
+ *
+ * Packets which fit into a single fragment are sent as one plain message without a FragmentHeader, the common case of
+ * small inter frames costs no extra bytes.
+ */
+class Fragmenter {
+public:
+  /**
+   * @param fragment_size Maximum payload bytes per message.
+   */
+  explicit Fragmenter(const std::size_t fragment_size = FRAGMENT_SIZE);
+
+  /**
+   * Calls `send` with each message of the packet, in order. Each message carries `header`, with the fragment flag set
+   * if the packet is split.
+   *
+   * @throw std::runtime_error if the packet needs more than 65535 fragments.
+   */
+  void fragment(const StreamPackageHeader &header,
+                const std::byte *data,
+                const std::size_t size,
+                const std::function<void(const std::byte *message, const std::size_t size)> &send);
+
+private:
+  const std::size_t fragment_size_;
+  std::vector<std::byte> message_{};
+};
+
+/**
+ * Reassembles packets from Fragmenter messages arriving in order, as the reliable channel delivers them.
+ *
+ * In progressive mode every fragment is handed on as soon as it arrives - a byte-stream decoder (H.264, HEVC) parses
+ * and decodes the slices at the start of a large keyframe while the rest of it is still in flight. Packetized codecs
+ * (VP9, AV1) need each packet whole, so otherwise fragments are collected and the packet is delivered with its last
+ * one.
+ */
+class FragmentReassembler {
+public:
+  struct Stats {
+    std::uint64_t packets_delivered{};
+    /**
+     * Delivered packets which arrived in more than one fragment.
+     */
+    std::uint64_t packets_reassembled{};
+    /**
+     * Packets abandoned because a fragment went missing, e.g. across a reconnect.
+     */
+    std::uint64_t packets_dropped{};
+    std::uint64_t fragments_received{};
+    std::uint64_t fragments_malformed{};
+  };
+
+  /**
+   * Receives packet data, `packet_end` is set with the last bytes of a packet.
+   */
+  using DataCallback = std::function<void(
+      const StreamPackageHeader &header, const std::byte *data, const std::size_t size, const bool packet_end)>;
+
+  FragmentReassembler(const bool progressive, DataCallback data_callback);
+
+  /**
+   * Takes one message of the channel, including its StreamPackageHeader.
+   */
+  void push(const std::byte *message, const std::size_t size);
+
+  const Stats &stats() const noexcept { return stats_; }
+
+private:
+  struct Packet {
+    std::uint64_t frame_num{};
+    std::uint16_t count{};
+    std::uint16_t next_index{};
+    std::vector<std::byte> data{};
+  };
+
+  void drop();
+
+  const bool progressive_;
+  DataCallback data_callback_;
+  /**
+   * Packet whose fragments are arriving, at most one since the channel is ordered.
+   */
+  std::optional<Packet> packet_{};
+  Stats stats_{};
+};
+} // namespace streaming
@@ -0,0 +1,59 @@
+#include "frame_pacer.hpp"
+
+#include <thread>
+
+namespace streaming {
+namespace {
+/**
+ * Sleep granularity of desktop schedulers is around a millisecond; the last stretch before a deadline is polled.
+ */
+constexpr auto WAIT_SLACK = std::chrono::milliseconds{1};
+} // namespace
+
+FramePacer::FramePacer(const std::uint16_t fps, const int max_catch_up_frames)
+    : fps_{fps}
+    , max_catch_up_frames_{max_catch_up_frames} {
+  start();
+}
+
+void FramePacer::start(const Clock::time_point now) {
+  start_ = now;
+  frame_ = 0u;
+  next_deadline_ = now;
+  last_frame_ = {};
+  last_interval_ = {};
+}
+
+bool FramePacer::frame_due(const Clock::time_point now) {
+  if (now < next_deadline_) {
+    return false;
+  }
+
+  // With max_catch_up_frames_ == 0 the schedule is re-anchored on every frame, i.e. late frames are never caught up.
+  const auto behind = now - next_deadline_;
+  if (behind >= frame_period() * max_catch_up_frames_) {
+    dropped_frames_ += static_cast<std::uint64_t>(behind / frame_period());
+    start_ = now;
+    frame_ = 0u;
+  }
+
+  if (last_frame_ != Clock::time_point{}) {
+    last_interval_ = now - last_frame_;
+  }
+  last_frame_ = now;
+  next_deadline_ = deadline(++frame_);
+  return true;
+}
+
+void FramePacer::wait() const {
+  const auto wake_up = next_deadline_ - WAIT_SLACK;
+  if (Clock::now() < wake_up) {
+    std::this_thread::sleep_until(wake_up);
+  }
+}
+
+FramePacer::Clock::time_point FramePacer::deadline(const std::uint64_t frame) const noexcept {
+  const auto offset = std::chrono::nanoseconds{static_cast<std::int64_t>(frame * 1'000'000'000ull / fps_)};
+  return start_ + std::chrono::duration_cast<Clock::duration>(offset);
+}
+} // namespace streaming
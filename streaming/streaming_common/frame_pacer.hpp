@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace streaming {
+/**
+ * Schedules frames at absolute `steady_clock` deadlines: the n-th frame is due at `start + n / fps`, so rounding of the
+ * frame period never accumulates into drift.
+ *
+ * When the caller falls behind, due frames are produced back-to-back to catch up, but at most `max_catch_up_frames`
+ * of them - beyond that the schedule is re-anchored at the current time and the missed frames are dropped.
+ */
+class FramePacer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit FramePacer(const std::uint16_t fps, const int max_catch_up_frames = 2);
+
+  /**
+   * (Re)starts the schedule - the first frame is due immediately.
+   */
+  void start(const Clock::time_point now = Clock::now());
+
+  /**
+   * Returns true if a frame is due and advances the schedule to the next deadline.
+   */
+  [[nodiscard]] bool frame_due(const Clock::time_point now = Clock::now());
+
+  /**
+   * Sleeps until shortly before the next deadline, the remaining slack is left to polling to avoid oversleeping.
+   */
+  void wait() const;
+
+  Clock::time_point next_deadline() const noexcept { return next_deadline_; }
+  Clock::duration frame_period() const noexcept { return deadline(1) - deadline(0); }
+  /**
+   * Time between the two most recent due frames, zero until the second frame.
+   */
+  Clock::duration last_interval() const noexcept { return last_interval_; }
+  /**
+   * Number of frames dropped by re-anchoring the schedule.
+   */
+  std::uint64_t dropped_frames() const noexcept { return dropped_frames_; }
+
+private:
+  Clock::time_point deadline(const std::uint64_t frame) const noexcept;
+
+  const std::uint16_t fps_;
+  const int max_catch_up_frames_;
+
+  Clock::time_point start_{};
+  std::uint64_t frame_{};
+  Clock::time_point next_deadline_{};
+  Clock::time_point last_frame_{};
+  Clock::duration last_interval_{};
+  std::uint64_t dropped_frames_{};
+};
+} // namespace streaming
@@ -0,0 +1,145 @@
+#include "jitter_buffer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace streaming {
+namespace {
+// Upper bound of the adaptive playout delay, beyond it a stream is too jittery to smooth at interactive latency.
+constexpr auto MAX_PLAYOUT_DELAY = std::chrono::milliseconds{150};
+// The delay covers this multiple of the smoothed jitter, about two standard deviations of normally distributed
+// arrival times.
+constexpr auto JITTER_DELAY_FACTOR = 2.0;
+constexpr auto JITTER_SMOOTHING = 1.0 / 16.0;
+// Share of a frame's deviation from its expected arrival the expectation moves by, follows clock drift between
+// streamer and receiver without passing on the jitter.
+constexpr auto DRIFT_GAIN = 1.0 / 32.0;
+
+std::chrono::microseconds to_us(const JitterBuffer::Clock::duration duration) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(duration);
+}
+} // namespace
+
+JitterBuffer::JitterBuffer(const std::uint16_t fps, const Mode mode, const std::size_t frame_size)
+    : mode_(mode)
+    , frame_period_(fps > 0 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / fps))
+                            : Clock::duration{})
+    , frame_size_(frame_size)
+    , max_queued_frames_(fps > 0 ? static_cast<std::size_t>(MAX_PLAYOUT_DELAY / frame_period_) + 2 : 0) {
+  if (fps == 0) {
+    throw std::runtime_error{"Jitter buffer fps must not be 0"};
+  }
+}
+
+void JitterBuffer::push(FrameData &frame, const std::uint64_t timestamp_us, const Clock::time_point now) {
+  ++stats_.frames_pushed;
+  std::optional<Clock::duration> transit{};
+  if (timestamp_us != 0) {
+    // The streamer's clock has an unrelated epoch, only differences of transit times are meaningful.
+    const auto timestamp = std::chrono::duration_cast<Clock::duration>(std::chrono::microseconds{timestamp_us});
+    transit = now - Clock::time_point{timestamp};
+  }
+
+  if (last_arrival_) {
+    const auto deviation = std::chrono::abs(now - *last_arrival_ - frame_period_);
+    ++stats_.arrival_intervals;
+    stats_.arrival_deviation += to_us(deviation);
+    const auto jitter = transit && last_transit_ ? std::chrono::abs(*transit - *last_transit_) : deviation;
+    arrival_jitter_us_ += (static_cast<double>(to_us(jitter).count()) - arrival_jitter_us_) * JITTER_SMOOTHING;
+    if (mode_ == Mode::Adaptive) {
+      const auto delay = std::chrono::duration<double, std::micro>(arrival_jitter_us_ * JITTER_DELAY_FACTOR);
+      stats_.delay = std::min<Clock::duration>(std::chrono::duration_cast<Clock::duration>(delay), MAX_PLAYOUT_DELAY);
+    }
+  }
+  last_arrival_ = now;
+  last_transit_ = transit;
+
+  auto expected = now;
+  if (transit) {
+    // Transit changes of a period or more are no jitter but a stall or a streamer with a new clock.
+    auto expected_transit = expected_transit_ ? *expected_transit_ : *transit;
+    const auto offset = *transit - expected_transit;
+    if (std::chrono::abs(offset) >= frame_period_) {
+      expected_transit = *transit;
+    } else {
+      expected_transit += std::chrono::duration_cast<Clock::duration>(offset * DRIFT_GAIN);
+    }
+    expected_transit_ = expected_transit;
+    expected = now - *transit + expected_transit;
+  } else {
+    // Deviations of a period or more are no jitter but frames the streamer skipped, or a burst after a stall.
+    expected = expected_arrival_ ? *expected_arrival_ + frame_period_ : now;
+    const auto offset = now - expected;
+    if (std::chrono::abs(offset) >= frame_period_) {
+      expected = now;
+    } else {
+      expected += std::chrono::duration_cast<Clock::duration>(offset * DRIFT_GAIN);
+    }
+  }
+  expected_arrival_ = expected;
+
+  auto entry = Entry{};
+  if (free_.empty()) {
+    entry.data.resize(frame_size_);
+  } else {
+    entry.data = std::move(free_.back());
+    free_.pop_back();
+  }
+  entry.data.swap(frame);
+  entry.present_at = expected + stats_.delay;
+  entry.timestamp_us = timestamp_us;
+  queue_.emplace_back(std::move(entry));
+
+  while (queue_.size() > max_queued_frames_) {
+    drop_front();
+  }
+}
+
+bool JitterBuffer::pop(FrameData &frame, const Clock::time_point now) {
+  if (!queue_.empty() && mode_ == Mode::ZeroDelay) {
+    while (queue_.size() > 1) {
+      drop_front();
+    }
+    present(frame, now);
+    return true;
+  }
+
+  if (!queue_.empty()) {
+    // A frame whose successor is due as well has been overtaken, showing both would add a period of latency for good.
+    while (queue_.size() > 1 && now >= queue_[1].present_at) {
+      drop_front();
+    }
+    if (now >= queue_.front().present_at) {
+      present(frame, now);
+      return true;
+    }
+  }
+
+  if (last_present_ && !underrun_ && now - *last_present_ > frame_period_ * 3 / 2) {
+    underrun_ = true;
+    ++stats_.underruns;
+  }
+  return false;
+}
+
+void JitterBuffer::drop_front() {
+  free_.emplace_back(std::move(queue_.front().data));
+  queue_.pop_front();
+  ++stats_.frames_dropped;
+}
+
+void JitterBuffer::present(FrameData &frame, const Clock::time_point now) {
+  frame.swap(queue_.front().data);
+  presented_timestamp_us_ = queue_.front().timestamp_us;
+  free_.emplace_back(std::move(queue_.front().data));
+  queue_.pop_front();
+
+  ++stats_.frames_presented;
+  if (last_present_) {
+    ++stats_.presentation_intervals;
+    stats_.presentation_deviation += to_us(std::chrono::abs(now - *last_present_ - frame_period_));
+  }
+  last_present_ = now;
+  underrun_ = false;
+}
+} // namespace streaming
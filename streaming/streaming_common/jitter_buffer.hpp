@@ -0,0 +1,120 @@
+#pragma once
+
+#include "streaming_common/frame_data.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+namespace streaming {
+/**
+ * Schedules the presentation of decoded frames.
+ *
+ * Frames are keyed on the streamer timestamp of their packet: a frame is expected at that timestamp plus the transit
+ * time, which covers the unknown offset between the two clocks and slowly follows the actual arrivals to absorb clock
+ * drift. The jitter is the variation of the transit time as in RFC 3550, so frames the streamer skipped do not count
+ * as late. Frames without a timestamp are expected one nominal frame period after their predecessor instead.
+ *
+ * In adaptive mode a frame is presented at its expected arrival plus a playout delay which follows the measured
+ * jitter, so frames arriving somewhat late keep the cadence instead of showing as stutter. Frames overtaken by an also
+ * due successor are dropped, a burst after a stall costs a skip rather than permanent latency.
+ */
+class JitterBuffer {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  enum class Mode {
+    /**
+     * The newest decoded frame is presented right away, older ones are dropped. Lowest latency, for interactive use.
+     */
+    ZeroDelay,
+    Adaptive
+  };
+
+  /**
+   * Cumulative, the deviations sum up |interval - frame period| of consecutive frames.
+   */
+  struct Stats {
+    std::uint64_t frames_pushed{};
+    std::uint64_t frames_presented{};
+    std::uint64_t frames_dropped{};
+    /**
+     * Presentation gaps of more than one and a half periods, i.e. visible stutter.
+     */
+    std::uint64_t underruns{};
+    std::uint64_t arrival_intervals{};
+    std::chrono::microseconds arrival_deviation{};
+    std::uint64_t presentation_intervals{};
+    std::chrono::microseconds presentation_deviation{};
+    Clock::duration delay{};
+  };
+
+  /**
+   * @param frame_size Size of a decoded frame, buffers are swapped with the decoder's frame.
+   */
+  JitterBuffer(const std::uint16_t fps, const Mode mode, const std::size_t frame_size);
+
+  /**
+   * Takes over the content of the decoded frame by swapping it with a free buffer of the same size.
+   *
+   * @param timestamp_us Streamer timestamp of the frame's packet, 0 if unknown. Schedules the frame and is reported
+   *                     back by presented_timestamp_us().
+   */
+  void push(FrameData &frame, const std::uint64_t timestamp_us = 0, const Clock::time_point now = Clock::now());
+  /**
+   * Swaps the frame to present now into `frame`.
+   *
+   * @return False if no frame is due.
+   */
+  bool pop(FrameData &frame, const Clock::time_point now = Clock::now());
+
+  Mode mode() const noexcept { return mode_; }
+  /**
+   * Streamer timestamp of the frame the last successful pop() returned.
+   */
+  std::uint64_t presented_timestamp_us() const noexcept { return presented_timestamp_us_; }
+  Clock::duration frame_period() const noexcept { return frame_period_; }
+  const Stats &stats() const noexcept { return stats_; }
+
+private:
+  struct Entry {
+    FrameData data{};
+    /**
+     * Expected arrival plus the playout delay at the time the frame arrived.
+     */
+    Clock::time_point present_at{};
+    std::uint64_t timestamp_us{};
+  };
+
+  void drop_front();
+  void present(FrameData &frame, const Clock::time_point now);
+
+  const Mode mode_;
+  const Clock::duration frame_period_;
+  const std::size_t frame_size_;
+  const std::size_t max_queued_frames_;
+
+  std::deque<Entry> queue_{};
+  std::vector<FrameData> free_{};
+
+  std::optional<Clock::time_point> last_arrival_{};
+  std::optional<Clock::time_point> expected_arrival_{};
+  /**
+   * Arrival minus streamer timestamp, of the last frame and as expected for the next one.
+   */
+  std::optional<Clock::duration> last_transit_{};
+  std::optional<Clock::duration> expected_transit_{};
+  std::optional<Clock::time_point> last_present_{};
+  /**
+   * Smoothed |transit time - previous transit time| as in RFC 3550, in microseconds. Without timestamps the frame
+   * period stands in for the interval between the frames' timestamps.
+   */
+  double arrival_jitter_us_{};
+  std::uint64_t presented_timestamp_us_{};
+  bool underrun_{};
+  Stats stats_{};
+};
+} // namespace streaming
@@ -0,0 +1,100 @@
+#include "mapped_file.hpp"
+
+#ifdef _WIN32
+# ifndef NOMINMAX
+#  define NOMINMAX
+# endif
+# include <windows.h>
+#else
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
+
+#include <stdexcept>
+
+namespace streaming {
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string &path) {
+  file_ = CreateFileA(path.c_str(),
+                      GENERIC_READ,
+                      FILE_SHARE_READ,
+                      nullptr,
+                      OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                      nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    file_ = nullptr;
+    throw std::runtime_error{"Cannot open file: " + path};
+  }
+
+  LARGE_INTEGER file_size{};
+  if (!GetFileSizeEx(file_, &file_size)) {
+    CloseHandle(file_);
+    throw std::runtime_error{"Cannot get size of file: " + path};
+  }
+  size_ = static_cast<std::size_t>(file_size.QuadPart);
+  if (size_ == 0u) {
+    return;
+  }
+
+  mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  const auto *view = mapping_ ? MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0) : nullptr;
+  if (!view) {
+    if (mapping_) {
+      CloseHandle(mapping_);
+    }
+    CloseHandle(file_);
+    throw std::runtime_error{"Cannot map file: " + path};
+  }
+  data_ = static_cast<const std::byte *>(view);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    UnmapViewOfFile(data_);
+  }
+  if (mapping_) {
+    CloseHandle(mapping_);
+  }
+  if (file_) {
+    CloseHandle(file_);
+  }
+}
+#else
+MappedFile::MappedFile(const std::string &path) {
+  const auto fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error{"Cannot open file: " + path};
+  }
+
+  struct stat file_stat{};
+  if (fstat(fd, &file_stat) != 0) {
+    close(fd);
+    throw std::runtime_error{"Cannot get size of file: " + path};
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  if (size_ == 0u) {
+    close(fd);
+    return;
+  }
+
+  auto *view = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference to the file.
+  close(fd);
+  if (view == MAP_FAILED) {
+    throw std::runtime_error{"Cannot map file: " + path};
+  }
+  // Packets are consumed front to back - let the kernel read ahead aggressively.
+  madvise(view, size_, MADV_SEQUENTIAL);
+  data_ = static_cast<const std::byte *>(view);
+}
+
+MappedFile::~MappedFile() {
+  if (data_) {
+    munmap(const_cast<std::byte *>(data_), size_);
+  }
+}
+#endif
+} // namespace streaming
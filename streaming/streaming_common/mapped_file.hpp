@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace streaming {
+/**
+ * Read-only memory mapping of a whole file. The contents are paged in on demand by the OS, so large recordings can be
+ * handed to the decoder without intermediate copies or chunked reads.
+ */
+class MappedFile {
+public:
+  /**
+   * @throw std::runtime_error if the file cannot be opened or mapped.
+   */
+  explicit MappedFile(const std::string &path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+  MappedFile(MappedFile &&other) noexcept = delete;
+  MappedFile &operator=(MappedFile &&other) noexcept = delete;
+
+  const std::byte *data() const noexcept { return data_; }
+  std::size_t size() const noexcept { return size_; }
+
+private:
+  const std::byte *data_{};
+  std::size_t size_{};
+#ifdef _WIN32
+  void *file_{};
+  void *mapping_{};
+#endif
+};
+} // namespace streaming
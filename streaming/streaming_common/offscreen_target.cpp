@@ -0,0 +1,27 @@
+#include "offscreen_target.hpp"
+
+#include <stdexcept>
+#include <string>
+
+namespace streaming {
+OffscreenTarget::OffscreenTarget(const int width, const int height) {
+  color_buffer_.bind();
+  color_buffer_.set_storage(GL_RGBA8, width, height);
+  depth_buffer_.bind();
+  depth_buffer_.set_storage(GL_DEPTH24_STENCIL8, width, height);
+  depth_buffer_.unbind();
+
+  fbo_.bind();
+  fbo_.attach_renderbuffer(GL_COLOR_ATTACHMENT0, color_buffer_);
+  fbo_.attach_renderbuffer(GL_DEPTH_STENCIL_ATTACHMENT, depth_buffer_);
+  const auto status = fbo_.status();
+  fbo_.unbind();
+  if (status != GL_FRAMEBUFFER_COMPLETE) {
+    throw std::runtime_error{"Offscreen framebuffer is incomplete: " + std::to_string(status)};
+  }
+}
+
+void OffscreenTarget::bind() const { fbo_.bind(); }
+
+void OffscreenTarget::unbind() const { fbo_.unbind(); }
+} // namespace streaming
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gp/gl/framebuffer_object.hpp>
+#include <gp/gl/renderbuffer_object.hpp>
+
+namespace streaming {
+/**
+ * Framebuffer with an RGBA8 color and a depth/stencil renderbuffer, for scenes that render and read back frames
+ * without presenting them.
+ */
+class OffscreenTarget {
+public:
+  /**
+   * Requires a current GL context.
+   *
+   * @throw std::runtime_error if the framebuffer is incomplete.
+   */
+  OffscreenTarget(const int width, const int height);
+
+  /**
+   * Binds the framebuffer for drawing and reading.
+   */
+  void bind() const;
+  void unbind() const;
+
+private:
+  gp::gl::RenderbufferObject color_buffer_{};
+  gp::gl::RenderbufferObject depth_buffer_{};
+  gp::gl::FramebufferObject fbo_{};
+};
+} // namespace streaming
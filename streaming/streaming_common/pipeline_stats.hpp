@@ -46,15 +46,35 @@ public:
     std::chrono::microseconds capture_us{};
     std::chrono::microseconds rgb_to_yuv_us{};
     std::chrono::microseconds encode_us{};
+    /** time since the previous frame was scheduled, zero if unknown */
+    std::chrono::microseconds interval_us{};
   };
 
   void set_output(std::FILE *out) noexcept { out_ = out; }
 
+  /**
+   * Enables the pacing report: achieved fps and jitter, i.e. deviation of frame intervals from the target period.
+   */
+  void set_frame_period(std::chrono::microseconds period) noexcept { frame_period_ = period; }
+
+  /**
+   * GPU times come from a gp::gl::GpuTimer a few frames late, they are reported with the CPU stages of the interval
+   * they arrive in.
+   */
+  void record_gpu_render(std::chrono::microseconds d) noexcept { gpu_render_.record(d); }
+
+  void record_gpu_capture(std::chrono::microseconds d) noexcept { gpu_capture_.record(d); }
+
   void record(const Frame &f) noexcept {
     render_.record(f.render_us);
     capture_.record(f.capture_us);
     rgb_to_yuv_.record(f.rgb_to_yuv_us);
     encode_.record(f.encode_us);
+    if (f.interval_us > std::chrono::microseconds::zero()) {
+      interval_sum_ += f.interval_us;
+      ++interval_count_;
+      jitter_.record(f.interval_us > frame_period_ ? f.interval_us - frame_period_ : frame_period_ - f.interval_us);
+    }
     ++frame_count_;
 
     if (frame_count_ >= PIPELINE_STATS_REPORT_INTERVAL) {
@@ -66,12 +86,26 @@ public:
 private:
   void report() const {
     fprintf(out_, "--- Encode pipeline stats (over %u frames) ---\n", frame_count_);
-    print_stage(out_, "  render      ", render_);
+    // The CPU render time only covers issuing the commands, the GPU time what executing them took.
+    print_stage(out_, "  render cpu  ", render_);
+    if (gpu_render_.count > 0) {
+      print_stage(out_, "  render gpu  ", gpu_render_);
+    }
     print_stage(out_, "  capture     ", capture_);
+    if (gpu_capture_.count > 0) {
+      print_stage(out_, "  capture gpu ", gpu_capture_);
+    }
     print_stage(out_, "  rgb->yuv    ", rgb_to_yuv_);
     print_stage(out_, "  encode      ", encode_);
     const auto total = render_.avg() + capture_.avg() + rgb_to_yuv_.avg() + encode_.avg();
     fprintf(out_, "  total (avg) : %6" PRId64 " us\n", static_cast<int64_t>(total.count()));
+    if (frame_period_ > std::chrono::microseconds::zero() && interval_count_ > 0) {
+      fprintf(out_,
+              "  fps         : target=%6.2f  achieved=%6.2f\n",
+              1e6 / static_cast<double>(frame_period_.count()),
+              1e6 * interval_count_ / static_cast<double>(interval_sum_.count()));
+      print_stage(out_, "  jitter      ", jitter_);
+    }
     fprintf(out_, "----------------------------------------------\n\n");
     std::fflush(out_);
   }
@@ -87,16 +121,27 @@ private:
 
   void reset() noexcept {
     render_.reset();
+    gpu_render_.reset();
     capture_.reset();
+    gpu_capture_.reset();
     rgb_to_yuv_.reset();
     encode_.reset();
+    jitter_.reset();
+    interval_sum_ = std::chrono::microseconds::zero();
+    interval_count_ = 0;
     frame_count_ = 0;
   }
 
   StageStats render_{};
+  StageStats gpu_render_{};
   StageStats capture_{};
+  StageStats gpu_capture_{};
   StageStats rgb_to_yuv_{};
   StageStats encode_{};
+  StageStats jitter_{};
+  std::chrono::microseconds frame_period_{};
+  std::chrono::microseconds interval_sum_{};
+  uint32_t interval_count_{0};
   uint32_t frame_count_{0};
   std::FILE *out_{stdout};
 };
@@ -175,6 +220,148 @@ private:
   std::FILE *out_{stdout};
 };
 
+class AudioStats {
+public:
+  struct Packet {
+    std::chrono::microseconds decode_us{};
+    /** audio queued for playback ahead of the packet */
+    std::chrono::microseconds queued_us{};
+    /** how much later than the video the packet is heard, negative if early */
+    std::chrono::microseconds skew_us{};
+    bool skew_known{};
+  };
+
+  void set_output(std::FILE *out) noexcept { out_ = out; }
+
+  void record(const Packet &p) noexcept {
+    decode_.record(p.decode_us);
+    queued_.record(p.queued_us);
+    if (p.skew_known) {
+      skew_.record(p.skew_us < std::chrono::microseconds::zero() ? -p.skew_us : p.skew_us);
+      skew_sum_ += p.skew_us;
+    }
+    ++packet_count_;
+
+    if (packet_count_ >= AUDIO_STATS_REPORT_INTERVAL) {
+      report();
+      reset();
+    }
+  }
+
+  void record_silence(std::chrono::microseconds d) noexcept { silence_ += d; }
+
+  void record_drop() noexcept { ++dropped_; }
+
+private:
+  // Audio packets are 10 ms, report about every 5 s.
+  static constexpr uint32_t AUDIO_STATS_REPORT_INTERVAL = 500u;
+
+  void report() const {
+    fprintf(out_, "--- Audio pipeline stats (over %u packets) ---\n", packet_count_);
+    print_stage(out_, "  decode      ", decode_);
+    print_stage(out_, "  queued      ", queued_);
+    if (skew_.count > 0) {
+      print_stage(out_, "  |a/v skew|  ", skew_);
+      fprintf(out_, "  a/v skew    : avg=%6" PRId64 " us\n", static_cast<int64_t>((skew_sum_ / skew_.count).count()));
+    }
+    fprintf(out_,
+            "  corrections : silence=%" PRId64 " us  dropped=%u packets\n",
+            static_cast<int64_t>(silence_.count()),
+            dropped_);
+    fprintf(out_, "----------------------------------------------\n\n");
+    std::fflush(out_);
+  }
+
+  static void print_stage(std::FILE *out, const char *name, const StageStats &s) {
+    fprintf(out,
+            "%s min=%6" PRId64 "  avg=%6" PRId64 "  max=%6" PRId64 " us\n",
+            name,
+            static_cast<int64_t>(s.count > 0 ? s.min.count() : 0),
+            static_cast<int64_t>(s.avg().count()),
+            static_cast<int64_t>(s.max.count()));
+  }
+
+  void reset() noexcept {
+    decode_.reset();
+    queued_.reset();
+    skew_.reset();
+    skew_sum_ = std::chrono::microseconds::zero();
+    silence_ = std::chrono::microseconds::zero();
+    dropped_ = 0;
+    packet_count_ = 0;
+  }
+
+  StageStats decode_{};
+  StageStats queued_{};
+  StageStats skew_{};
+  std::chrono::microseconds skew_sum_{};
+  std::chrono::microseconds silence_{};
+  uint32_t dropped_{0};
+  uint32_t packet_count_{0};
+  std::FILE *out_{stdout};
+};
+
+class AudioEncodeStats {
+public:
+  struct Packet {
+    std::chrono::microseconds read_us{};
+    std::chrono::microseconds encode_us{};
+  };
+
+  void set_output(std::FILE *out) noexcept { out_ = out; }
+
+  /**
+   * @param dropped_frames Frames the capture pacer has dropped so far, the report shows those of its interval.
+   */
+  void record(const Packet &p, const std::uint64_t dropped_frames) noexcept {
+    read_.record(p.read_us);
+    encode_.record(p.encode_us);
+    ++packet_count_;
+
+    if (packet_count_ >= AUDIO_ENCODE_STATS_REPORT_INTERVAL) {
+      report(dropped_frames - reported_dropped_frames_);
+      reported_dropped_frames_ = dropped_frames;
+      reset();
+    }
+  }
+
+private:
+  // Audio packets are 10 ms, report about every 5 s.
+  static constexpr uint32_t AUDIO_ENCODE_STATS_REPORT_INTERVAL = 500u;
+
+  void report(const std::uint64_t dropped_frames) const {
+    fprintf(out_, "--- Audio encode stats (over %u packets) ---\n", packet_count_);
+    print_stage(out_, "  read        ", read_);
+    print_stage(out_, "  encode      ", encode_);
+    const auto total = read_.avg() + encode_.avg();
+    fprintf(out_, "  total (avg) : %6" PRId64 " us\n", static_cast<int64_t>(total.count()));
+    fprintf(out_, "  late frames : dropped=%" PRIu64 "\n", dropped_frames);
+    fprintf(out_, "----------------------------------------------\n\n");
+    std::fflush(out_);
+  }
+
+  static void print_stage(std::FILE *out, const char *name, const StageStats &s) {
+    fprintf(out,
+            "%s min=%6" PRId64 "  avg=%6" PRId64 "  max=%6" PRId64 " us\n",
+            name,
+            static_cast<int64_t>(s.count > 0 ? s.min.count() : 0),
+            static_cast<int64_t>(s.avg().count()),
+            static_cast<int64_t>(s.max.count()));
+  }
+
+  void reset() noexcept {
+    read_.reset();
+    encode_.reset();
+    packet_count_ = 0;
+  }
+
+  StageStats read_{};
+  StageStats encode_{};
+  uint32_t packet_count_{0};
+  std::uint64_t reported_dropped_frames_{0};
+  std::FILE *out_{stdout};
+};
+
 } // namespace streaming
 
 #endif // STREAMING_PIPELINE_STATS
@@ -0,0 +1,146 @@
+#include "simulcast_encoder.hpp"
+
+#include <libyuv.h>
+
+#include <algorithm>
+#include <exception>
+#include <latch>
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+namespace streaming {
+namespace {
+constexpr auto MAX_LAYERS_NUM = std::size_t{3};
+// Each layer has a quarter of the pixels of the previous one, but lower resolutions need more bits per pixel.
+constexpr auto LAYER_BIT_RATE_DIVISOR = std::int64_t{3};
+
+static_assert(CHANNELS_NUM == 4, "libyuv::ARGBScale() scales 4-channel frames");
+
+int layer_dimension(const int dimension, const std::size_t layer) {
+  // 4:2:0 chroma subsampling needs even dimensions.
+  return std::max((dimension >> layer) & ~1, 2);
+}
+} // namespace
+
+SimulcastEncoder::SimulcastEncoder(const VideoStreamInfo &video_stream_info,
+                                   const std::size_t layers_num,
+                                   const std::int64_t bit_rate)
+    : width_(video_stream_info.width)
+    , height_(video_stream_info.height) {
+  if (layers_num == 0 || layers_num > MAX_LAYERS_NUM) {
+    throw std::runtime_error{"Simulcast supports 1 to " + std::to_string(MAX_LAYERS_NUM) + " layers"};
+  }
+
+  auto layer_bit_rate = bit_rate;
+  for (std::size_t layer = 0; layer < layers_num; ++layer) {
+    auto layer_info = video_stream_info;
+    layer_info.width = layer == 0 ? width_ : layer_dimension(width_, layer);
+    layer_info.height = layer == 0 ? height_ : layer_dimension(height_, layer);
+
+    auto encoder = std::make_shared<Encoder>(layer_info, layer_bit_rate);
+    encoder->set_video_stream_callback(
+        [this, layer, encoder = encoder.get()](const std::byte *data, const std::size_t size, const bool eof) {
+          if (video_stream_callback_) {
+            video_stream_callback_(layer, data, size, eof, encoder->keyframe_packet(), encoder->packet_frame_num());
+          }
+        });
+    layers_.push_back({std::move(encoder), layer_bit_rate, layer_info.width, layer_info.height});
+    layer_bit_rate /= LAYER_BIT_RATE_DIVISOR;
+  }
+  // Layer 0 captures directly into its encoder's frame and is encoded on the calling thread.
+  video_frame_ = layers_.front().encoder->video_frame();
+  if (layers_num > 1) {
+    task_pool_ = std::make_unique<TaskPool>(layers_num - 1);
+  }
+  stats_.layer_times.resize(layers_num);
+}
+
+SimulcastEncoder::~SimulcastEncoder() {
+  task_pool_.reset();
+  // The encoders flush on destruction, while the callback is still there to take the packets.
+  layers_.clear();
+}
+
+std::shared_ptr<FrameData> SimulcastEncoder::video_frame() { return video_frame_; }
+
+VideoStreamInfo SimulcastEncoder::video_stream_info(const std::size_t layer) const {
+  return layers_.at(layer).encoder->video_stream_info();
+}
+
+std::int64_t SimulcastEncoder::bit_rate(const std::size_t layer) const { return layers_.at(layer).bit_rate; }
+
+void SimulcastEncoder::request_keyframe(const std::size_t layer) { layers_.at(layer).encoder->request_keyframe(); }
+
+void SimulcastEncoder::set_video_stream_callback(std::function<void(const std::size_t layer,
+                                                                    const std::byte *data,
+                                                                    const std::size_t size,
+                                                                    const bool eof,
+                                                                    const bool keyframe,
+                                                                    const std::uint64_t frame_num)>
+                                                     video_stream_callback) {
+  video_stream_callback_ = std::move(video_stream_callback);
+}
+
+void SimulcastEncoder::encode() {
+  const auto start = Clock::now();
+  auto done = std::latch{static_cast<std::ptrdiff_t>(layers_.size() - 1)};
+  auto error_mutex = std::mutex{};
+  auto error = std::optional<std::string>{};
+
+  // The scaled layers only read the captured frame, which stays untouched until all of them are done.
+  for (std::size_t layer = 1; layer < layers_.size(); ++layer) {
+    task_pool_->submit([this, layer, &done, &error_mutex, &error]() {
+      try {
+        encode_layer(layer);
+      } catch (const std::exception &e) {
+        const auto lock_guard = std::lock_guard(error_mutex);
+        error = e.what();
+      }
+      done.count_down();
+    });
+  }
+  try {
+    encode_layer(0);
+  } catch (const std::exception &e) {
+    const auto lock_guard = std::lock_guard(error_mutex);
+    error = e.what();
+  }
+  done.wait();
+
+  {
+    const auto lock_guard = std::lock_guard(stats_mutex_);
+    ++stats_.frames;
+    stats_.wall_time += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+  }
+  if (error) {
+    throw std::runtime_error{"Simulcast encode failed: " + *error};
+  }
+}
+
+void SimulcastEncoder::encode_layer(const std::size_t layer) {
+  const auto start = Clock::now();
+  const auto &[encoder, bit_rate, width, height] = layers_[layer];
+  if (layer > 0) {
+    auto &frame = *encoder->video_frame();
+    libyuv::ARGBScale(video_frame_->data(),
+                      width_ * CHANNELS_NUM,
+                      width_,
+                      height_,
+                      frame.data(),
+                      width * CHANNELS_NUM,
+                      width,
+                      height,
+                      libyuv::kFilterBox);
+  }
+  encoder->encode();
+
+  const auto lock_guard = std::lock_guard(stats_mutex_);
+  stats_.layer_times[layer] += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+SimulcastEncoder::Stats SimulcastEncoder::stats() const {
+  const auto lock_guard = std::lock_guard(stats_mutex_);
+  return stats_;
+}
+} // namespace streaming
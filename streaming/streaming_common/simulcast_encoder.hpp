@@ -0,0 +1,117 @@
+#pragma once
+
+#include "streaming_common/constants.hpp"
+#include "streaming_common/encoder.hpp"
+#include "streaming_common/frame_data.hpp"
+#include "streaming_common/task_pool.hpp"
+#include "streaming_common/video_stream_info.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace streaming {
+/**
+ * Encodes one captured frame at several resolutions, so receivers on different links can each take the layer their
+ * link sustains.
+ *
+ * Layer 0 has the full resolution, every further layer half the width and height of the previous one and a third of
+ * its bit rate. Per frame the RGBA capture is downscaled once per layer with a box filter and all layers are encoded
+ * in parallel on the encoder's own TaskPool, so the frame takes about as long as its full-resolution layer.
+ */
+class SimulcastEncoder {
+public:
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Cumulative.
+   */
+  struct Stats {
+    std::uint64_t frames{};
+    /**
+     * Time encode() blocked the caller, i.e. the slowest layer including its scaling.
+     */
+    std::chrono::microseconds wall_time{};
+    /**
+     * Scaling and encoding time per layer.
+     */
+    std::vector<std::chrono::microseconds> layer_times{};
+  };
+
+  /**
+   * @param layers_num Number of layers including the full-resolution one, 1 to 3.
+   *
+   * @throw std::runtime_error if a layer's encoder cannot be opened or the layer count is out of range.
+   */
+  SimulcastEncoder(const VideoStreamInfo &video_stream_info,
+                   const std::size_t layers_num,
+                   const std::int64_t bit_rate = ENCODE_BITRATE);
+  SimulcastEncoder(const SimulcastEncoder &) = delete;
+  SimulcastEncoder &operator=(const SimulcastEncoder &) = delete;
+  SimulcastEncoder(SimulcastEncoder &&other) noexcept = delete;
+  SimulcastEncoder &operator=(SimulcastEncoder &&other) noexcept = delete;
+
+  ~SimulcastEncoder();
+
+  /**
+   * The full-resolution RGBA frame to capture into.
+   */
+  std::shared_ptr<FrameData> video_frame();
+  std::size_t layers_num() const noexcept { return layers_.size(); }
+  VideoStreamInfo video_stream_info(const std::size_t layer) const;
+  std::int64_t bit_rate(const std::size_t layer) const;
+  /**
+   * The layer's next frame becomes a keyframe, may be called from any thread.
+   */
+  void request_keyframe(const std::size_t layer);
+
+  /**
+   * Called with the packets of all layers, concurrently from the encoding threads. `keyframe` marks the packets a
+   * receiver can switch to the layer at, `frame_num` is the Encoder::packet_frame_num() shared by all layers.
+   */
+  void set_video_stream_callback(std::function<void(const std::size_t layer,
+                                                    const std::byte *data,
+                                                    const std::size_t size,
+                                                    const bool eof,
+                                                    const bool keyframe,
+                                                    const std::uint64_t frame_num)> video_stream_callback);
+  /**
+   * Scales and encodes the captured frame into every layer, returns when all layers are done.
+   *
+   * @throw std::runtime_error if a layer failed to encode.
+   */
+  void encode();
+
+  Stats stats() const;
+
+private:
+  struct Layer {
+    std::shared_ptr<Encoder> encoder{};
+    std::int64_t bit_rate{};
+    int width{};
+    int height{};
+  };
+
+  void encode_layer(const std::size_t layer);
+
+  std::shared_ptr<FrameData> video_frame_{};
+  const int width_;
+  const int height_;
+  std::vector<Layer> layers_{};
+  std::function<void(const std::size_t layer,
+                     const std::byte *data,
+                     const std::size_t size,
+                     const bool eof,
+                     const bool keyframe,
+                     const std::uint64_t frame_num)>
+      video_stream_callback_{};
+  std::unique_ptr<TaskPool> task_pool_{};
+
+  mutable std::mutex stats_mutex_{};
+  Stats stats_{};
+};
+} // namespace streaming
@@ -5,14 +5,22 @@
 
 namespace streaming {
 
-// Wire format (8 bytes, little-endian):
-//   [0..7] frame_num  — uint64, little-endian
-//   [8]    flags      — bit 0 = eof
-constexpr auto STREAM_PACKAGE_HEADER_SIZE = std::size_t{9};
+// Wire format (17 bytes, little-endian):
+//   [0..7]   frame_num     — uint64, video: the encoder's frame number, increasing, gaps are frames not sent,
+//                            audio: packet number
+//   [8..15]  timestamp_us  — uint64, streamer steady clock when the encoded packet was handed to the streamer
+//   [16]     flags         — bit 0 = eof, bit 1 = fec (an FecShardHeader and one shard of the packet follow),
+//                            bit 2 = fragment (a FragmentHeader and one fragment of the packet follow),
+//                            bit 3 = audio (one Opus packet follows)
+constexpr auto STREAM_PACKAGE_HEADER_SIZE = std::size_t{17};
 
 struct StreamPackageHeader {
   std::uint64_t frame_num{};
+  std::uint64_t timestamp_us{};
   bool eof{};
+  bool fec{};
+  bool fragment{};
+  bool audio{};
 
   [[nodiscard]] std::array<std::uint8_t, STREAM_PACKAGE_HEADER_SIZE> serialize() const noexcept {
     std::array<std::uint8_t, STREAM_PACKAGE_HEADER_SIZE> buf{};
@@ -24,7 +32,16 @@ struct StreamPackageHeader {
     buf[5] = static_cast<std::uint8_t>(frame_num >> 40);
     buf[6] = static_cast<std::uint8_t>(frame_num >> 48);
     buf[7] = static_cast<std::uint8_t>(frame_num >> 56);
-    buf[8] = eof ? std::uint8_t{1} : std::uint8_t{0};
+    buf[8] = static_cast<std::uint8_t>(timestamp_us >> 0);
+    buf[9] = static_cast<std::uint8_t>(timestamp_us >> 8);
+    buf[10] = static_cast<std::uint8_t>(timestamp_us >> 16);
+    buf[11] = static_cast<std::uint8_t>(timestamp_us >> 24);
+    buf[12] = static_cast<std::uint8_t>(timestamp_us >> 32);
+    buf[13] = static_cast<std::uint8_t>(timestamp_us >> 40);
+    buf[14] = static_cast<std::uint8_t>(timestamp_us >> 48);
+    buf[15] = static_cast<std::uint8_t>(timestamp_us >> 56);
+    buf[16] = static_cast<std::uint8_t>((eof ? 0x01u : 0x00u) | (fec ? 0x02u : 0x00u) | (fragment ? 0x04u : 0x00u) |
+                                        (audio ? 0x08u : 0x00u));
     return buf;
   }
 
@@ -34,7 +51,14 @@ struct StreamPackageHeader {
                   (static_cast<std::uint64_t>(buf[2]) << 16) | (static_cast<std::uint64_t>(buf[3]) << 24) |
                   (static_cast<std::uint64_t>(buf[4]) << 32) | (static_cast<std::uint64_t>(buf[5]) << 40) |
                   (static_cast<std::uint64_t>(buf[6]) << 48) | (static_cast<std::uint64_t>(buf[7]) << 56);
-    h.eof = (buf[8] & 0x01u) != 0u;
+    h.timestamp_us = (static_cast<std::uint64_t>(buf[8]) << 0) | (static_cast<std::uint64_t>(buf[9]) << 8) |
+                     (static_cast<std::uint64_t>(buf[10]) << 16) | (static_cast<std::uint64_t>(buf[11]) << 24) |
+                     (static_cast<std::uint64_t>(buf[12]) << 32) | (static_cast<std::uint64_t>(buf[13]) << 40) |
+                     (static_cast<std::uint64_t>(buf[14]) << 48) | (static_cast<std::uint64_t>(buf[15]) << 56);
+    h.eof = (buf[16] & 0x01u) != 0u;
+    h.fec = (buf[16] & 0x02u) != 0u;
+    h.fragment = (buf[16] & 0x04u) != 0u;
+    h.audio = (buf[16] & 0x08u) != 0u;
     return h;
   }
 };
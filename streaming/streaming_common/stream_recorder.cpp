@@ -0,0 +1,43 @@
+#include "stream_recorder.hpp"
+
+#include "streaming_common/stream_recording_format.hpp"
+
+#include <stdexcept>
+
+namespace streaming {
+StreamRecorder::StreamRecorder(const std::string &path, const VideoStreamInfo &video_stream_info)
+    : output_file_{path, std::ios::out | std::ios::binary}
+    , start_{std::chrono::steady_clock::now()} {
+  if (!output_file_) {
+    throw std::runtime_error{"Cannot create recording: " + path};
+  }
+
+  const RecordingHeader header{.width = static_cast<std::uint32_t>(video_stream_info.width),
+                               .height = static_cast<std::uint32_t>(video_stream_info.height),
+                               .fps = video_stream_info.fps,
+                               .codec_name = video_stream_info.codec_name};
+  const auto serialized = header.serialize();
+  output_file_.write(reinterpret_cast<const char *>(serialized.data()), serialized.size());
+}
+
+void StreamRecorder::record(const std::byte *data,
+                            const std::size_t size,
+                            const bool eof,
+                            const std::uint64_t frame_num) {
+  const auto timestamp_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_);
+
+  const auto lock = std::lock_guard{mutex_};
+  const RecordingPacketHeader header{.size = static_cast<std::uint32_t>(size),
+                                     .eof = eof,
+                                     .timestamp_us = static_cast<std::uint64_t>(timestamp_us.count()),
+                                     .frame_num = frame_num};
+  const auto serialized = header.serialize();
+  output_file_.write(reinterpret_cast<const char *>(serialized.data()), serialized.size());
+  output_file_.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+  ++packets_recorded_;
+  if (eof) {
+    output_file_.flush();
+  }
+}
+} // namespace streaming
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "streaming_common/video_stream_info.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+
+namespace streaming {
+/**
+ * Writes encoded packets into a recording (see stream_recording_format.hpp) together with their frame number and the
+ * time they left the encoder, so that a session can be replayed later with its original timing.
+ */
+class StreamRecorder {
+public:
+  /**
+   * @throw std::runtime_error if the file cannot be created.
+   */
+  StreamRecorder(const std::string &path, const VideoStreamInfo &video_stream_info);
+
+  StreamRecorder(const StreamRecorder &) = delete;
+  StreamRecorder &operator=(const StreamRecorder &) = delete;
+  StreamRecorder(StreamRecorder &&other) noexcept = delete;
+  StreamRecorder &operator=(StreamRecorder &&other) noexcept = delete;
+
+  /**
+   * @param frame_num The encoder's frame number of the packet, Encoder::packet_frame_num(). The streamer sends the same
+   *                  number, so recorded and streamed packets can be matched up.
+   */
+  void record(const std::byte *data, const std::size_t size, const bool eof, const std::uint64_t frame_num);
+
+  std::uint64_t packets_recorded() const noexcept { return packets_recorded_; }
+
+private:
+  std::ofstream output_file_{};
+  std::chrono::steady_clock::time_point start_{};
+  std::uint64_t packets_recorded_{};
+  std::mutex mutex_{};
+};
+} // namespace streaming
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+namespace streaming {
+
+// Recording layout (all integers little-endian):
+//
+// File header (40 bytes):
+//   [0..7]   magic        — "GPSTREAM"
+//   [8..11]  version      — uint32
+//   [12..15] width        — uint32
+//   [16..19] height       — uint32
+//   [20..21] fps          — uint16
+//   [22..23] reserved
+//   [24..39] codec_name   — NUL-padded FFmpeg codec name, e.g. "h264"
+//
+// Followed by packets, each one prefixed with its index entry (24 bytes):
+//   [0..3]   size         — uint32, payload size in bytes
+//   [4..7]   flags        — uint32, bit 0 = eof
+//   [8..15]  timestamp_us — uint64, time since the recording started
+//   [16..23] frame_num    — uint64, the encoder's frame number as in StreamPackageHeader
+constexpr auto RECORDING_MAGIC = std::array<char, 8>{'G', 'P', 'S', 'T', 'R', 'E', 'A', 'M'};
+constexpr auto RECORDING_VERSION = std::uint32_t{1};
+constexpr auto RECORDING_HEADER_SIZE = std::size_t{40};
+constexpr auto RECORDING_CODEC_NAME_SIZE = std::size_t{16};
+constexpr auto RECORDING_PACKET_HEADER_SIZE = std::size_t{24};
+
+namespace recording {
+template<typename T>
+void write_le(std::uint8_t *dst, const T value) noexcept {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    dst[i] = static_cast<std::uint8_t>(static_cast<std::uint64_t>(value) >> (8u * i));
+  }
+}
+
+template<typename T>
+T read_le(const std::uint8_t *src) noexcept {
+  std::uint64_t value{};
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    value |= static_cast<std::uint64_t>(src[i]) << (8u * i);
+  }
+  return static_cast<T>(value);
+}
+} // namespace recording
+
+struct RecordingHeader {
+  std::uint32_t version{RECORDING_VERSION};
+  std::uint32_t width{};
+  std::uint32_t height{};
+  std::uint16_t fps{};
+  std::string codec_name{};
+
+  [[nodiscard]] std::array<std::uint8_t, RECORDING_HEADER_SIZE> serialize() const noexcept {
+    std::array<std::uint8_t, RECORDING_HEADER_SIZE> buf{};
+    std::memcpy(buf.data(), RECORDING_MAGIC.data(), RECORDING_MAGIC.size());
+    recording::write_le(buf.data() + 8, version);
+    recording::write_le(buf.data() + 12, width);
+    recording::write_le(buf.data() + 16, height);
+    recording::write_le(buf.data() + 20, fps);
+    std::memcpy(buf.data() + 24, codec_name.data(), std::min(codec_name.size(), RECORDING_CODEC_NAME_SIZE - 1));
+    return buf;
+  }
+
+  /**
+   * @return false if the buffer does not start with the recording magic.
+   */
+  static bool deserialize(const std::uint8_t *buf, RecordingHeader &header) noexcept {
+    if (std::memcmp(buf, RECORDING_MAGIC.data(), RECORDING_MAGIC.size()) != 0) {
+      return false;
+    }
+    header.version = recording::read_le<std::uint32_t>(buf + 8);
+    header.width = recording::read_le<std::uint32_t>(buf + 12);
+    header.height = recording::read_le<std::uint32_t>(buf + 16);
+    header.fps = recording::read_le<std::uint16_t>(buf + 20);
+    const auto *name = reinterpret_cast<const char *>(buf + 24);
+    header.codec_name.assign(name, strnlen(name, RECORDING_CODEC_NAME_SIZE));
+    return true;
+  }
+};
+
+struct RecordingPacketHeader {
+  std::uint32_t size{};
+  bool eof{};
+  std::uint64_t timestamp_us{};
+  std::uint64_t frame_num{};
+
+  [[nodiscard]] std::array<std::uint8_t, RECORDING_PACKET_HEADER_SIZE> serialize() const noexcept {
+    std::array<std::uint8_t, RECORDING_PACKET_HEADER_SIZE> buf{};
+    recording::write_le(buf.data() + 0, size);
+    recording::write_le(buf.data() + 4, eof ? std::uint32_t{1} : std::uint32_t{0});
+    recording::write_le(buf.data() + 8, timestamp_us);
+    recording::write_le(buf.data() + 16, frame_num);
+    return buf;
+  }
+
+  static RecordingPacketHeader deserialize(const std::uint8_t *buf) noexcept {
+    RecordingPacketHeader h{};
+    h.size = recording::read_le<std::uint32_t>(buf + 0);
+    h.eof = (recording::read_le<std::uint32_t>(buf + 4) & 0x01u) != 0u;
+    h.timestamp_us = recording::read_le<std::uint64_t>(buf + 8);
+    h.frame_num = recording::read_le<std::uint64_t>(buf + 16);
+    return h;
+  }
+};
+
+} // namespace streaming
@@ -0,0 +1,112 @@
+#include "stream_replayer.hpp"
+
+#include "streaming_common/codec_presets.hpp"
+#include "streaming_common/decoder.hpp"
+#include "streaming_common/stream_recording_format.hpp"
+
+#include <gp/ffmpeg/misc.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace streaming {
+StreamReplayer::StreamReplayer(const std::string &path)
+    : file_{path} {
+  if (!read_header()) {
+    throw std::runtime_error{"Not a stream recording: " + path};
+  }
+  index();
+}
+
+StreamReplayer::StreamReplayer(const std::string &path, const VideoStreamInfo &raw_stream_info)
+    : file_{path} {
+  if (read_header()) {
+    index();
+    return;
+  }
+
+  if (codec_preset(raw_stream_info.codec_id).packetized) {
+    throw std::runtime_error{"Raw " + raw_stream_info.codec_name + " stream has no packet boundaries: " + path};
+  }
+  video_stream_info_ = raw_stream_info;
+  // The decoder's parser splits the stream into packets itself.
+  packets_.push_back({.data = file_.data(), .size = file_.size(), .eof = true});
+}
+
+bool StreamReplayer::read_header() {
+  RecordingHeader header{};
+  if (file_.size() < RECORDING_HEADER_SIZE ||
+      !RecordingHeader::deserialize(reinterpret_cast<const std::uint8_t *>(file_.data()), header)) {
+    return false;
+  }
+  if (header.version != RECORDING_VERSION) {
+    throw std::runtime_error{"Unsupported stream recording version: " + std::to_string(header.version)};
+  }
+
+  video_stream_info_ = {static_cast<int>(header.width),
+                        static_cast<int>(header.height),
+                        header.fps,
+                        gp::ffmpeg::codec_name_to_id(header.codec_name),
+                        header.codec_name};
+  return true;
+}
+
+void StreamReplayer::index() {
+  const auto *data = reinterpret_cast<const std::uint8_t *>(file_.data());
+  auto offset = RECORDING_HEADER_SIZE;
+  while (offset + RECORDING_PACKET_HEADER_SIZE <= file_.size()) {
+    const auto header = RecordingPacketHeader::deserialize(data + offset);
+    offset += RECORDING_PACKET_HEADER_SIZE;
+    if (offset + header.size > file_.size()) {
+      // A recording interrupted mid-write ends with a partial packet.
+      printf("Stream recording truncated after %zu packets\n", packets_.size());
+      break;
+    }
+    packets_.push_back({.data = file_.data() + offset,
+                        .size = header.size,
+                        .timestamp = std::chrono::microseconds{header.timestamp_us},
+                        .frame_num = header.frame_num,
+                        .eof = header.eof});
+    offset += header.size;
+  }
+}
+
+void StreamReplayer::start(const bool realtime) {
+  realtime_ = realtime;
+  next_packet_ = 0u;
+  next_offset_ = 0u;
+  eof_signaled_ = false;
+  start_ = std::chrono::steady_clock::now();
+}
+
+std::size_t StreamReplayer::feed(Decoder &decoder) {
+  const auto elapsed = std::chrono::steady_clock::now() - start_;
+  // The parser of a byte-stream codec takes the stream in any slices, a packetized decoder only whole packets.
+  const auto splittable = !codec_preset(video_stream_info_.codec_id).packetized;
+  auto fed = std::size_t{0};
+  while (!finished() && fed < FEED_SIZE) {
+    const auto &packet = packets_[next_packet_];
+    if (realtime_ && packet.timestamp > elapsed) {
+      break;
+    }
+    const auto remaining = packet.size - next_offset_;
+    const auto size = splittable ? std::min(remaining, FEED_SIZE - fed) : remaining;
+    if (size > 0) {
+      decoder.incoming_data(packet.data + next_offset_, size);
+    }
+    fed += size;
+    next_offset_ += size;
+    if (next_offset_ == packet.size) {
+      next_offset_ = 0u;
+      ++next_packet_;
+    }
+  }
+
+  if (finished() && !eof_signaled_) {
+    decoder.signal_eof();
+    eof_signaled_ = true;
+  }
+  return fed;
+}
+} // namespace streaming
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "streaming_common/mapped_file.hpp"
+#include "streaming_common/video_stream_info.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace streaming {
+class Decoder;
+
+/**
+ * Replays a recording written by StreamRecorder. The file is memory mapped and indexed on construction; packets are
+ * passed to the Decoder straight from the mapping, either at their original timing or as fast as the decoder takes
+ * them, at most FEED_SIZE bytes per feed() so the decoder never holds more than a slice of the mapping.
+ */
+class StreamReplayer {
+public:
+  struct Packet {
+    const std::byte *data{};
+    std::size_t size{};
+    std::chrono::microseconds timestamp{};
+    std::uint64_t frame_num{};
+    bool eof{};
+  };
+
+  /**
+   * Bytes passed to the decoder per feed() at most. Packets of byte-stream codecs are split to fit, packets of
+   * packetized codecs are passed whole, at least one per feed().
+   */
+  static constexpr auto FEED_SIZE = std::size_t{4 * 1024 * 1024};
+
+  /**
+   * @throw std::runtime_error if the file cannot be mapped or is not a recording.
+   */
+  explicit StreamReplayer(const std::string &path);
+  /**
+   * Opens either a recording or a raw elementary stream of a byte-stream codec (e.g. an Annex B .h264 file). A raw
+   * stream is described by `raw_stream_info` and exposed as a single packet spanning the whole file.
+   *
+   * @throw std::runtime_error if the file cannot be mapped, or it is raw and the codec needs packet boundaries.
+   */
+  StreamReplayer(const std::string &path, const VideoStreamInfo &raw_stream_info);
+
+  StreamReplayer(const StreamReplayer &) = delete;
+  StreamReplayer &operator=(const StreamReplayer &) = delete;
+  StreamReplayer(StreamReplayer &&other) noexcept = delete;
+  StreamReplayer &operator=(StreamReplayer &&other) noexcept = delete;
+
+  const VideoStreamInfo &video_stream_info() const noexcept { return video_stream_info_; }
+  const std::vector<Packet> &packets() const noexcept { return packets_; }
+
+  /**
+   * Rewinds to the first packet and restarts the replay clock.
+   *
+   * @param realtime  true: packets are released at their recorded timestamps, false: as fast as possible
+   */
+  void start(const bool realtime);
+  /**
+   * Passes up to FEED_SIZE bytes of packets to the decoder - of the packets due by now in realtime mode, otherwise of
+   * the remaining ones. Called again whenever the decoder runs out of data. Signals EOF to the decoder after the last
+   * packet.
+   *
+   * @return number of bytes passed to the decoder
+   */
+  std::size_t feed(Decoder &decoder);
+  bool finished() const noexcept { return next_packet_ >= packets_.size(); }
+
+private:
+  /**
+   * @return false if the file is not a recording.
+   */
+  [[nodiscard]] bool read_header();
+  void index();
+
+  MappedFile file_;
+  VideoStreamInfo video_stream_info_{};
+  std::vector<Packet> packets_{};
+
+  bool realtime_{};
+  std::size_t next_packet_{};
+  /**
+   * Bytes of the next packet already passed to the decoder.
+   */
+  std::size_t next_offset_{};
+  bool eof_signaled_{};
+  std::chrono::steady_clock::time_point start_{};
+};
+} // namespace streaming
@@ -0,0 +1,54 @@
+#include "task_pool.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+
+namespace streaming {
+TaskPool::TaskPool(const std::size_t threads) {
+  const auto threads_num = threads > 0 ? threads : std::max(std::thread::hardware_concurrency(), 1u);
+  workers_.reserve(threads_num);
+  for (std::size_t i = 0; i < threads_num; ++i) {
+    workers_.emplace_back([this]() { worker(); });
+  }
+}
+
+TaskPool::~TaskPool() {
+  {
+    const auto lock = std::lock_guard{mutex_};
+    stopping_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+void TaskPool::submit(std::function<void()> task) {
+  {
+    const auto lock = std::lock_guard{mutex_};
+    tasks_.push_back(std::move(task));
+  }
+  cv_.notify_one();
+}
+
+void TaskPool::worker() {
+  for (;;) {
+    std::function<void()> task;
+    {
+      auto lock = std::unique_lock{mutex_};
+      cv_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+      if (tasks_.empty()) {
+        return;
+      }
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    }
+    try {
+      task();
+    } catch (const std::exception &e) {
+      printf("Task failed: %s\n", e.what());
+    }
+  }
+}
+} // namespace streaming
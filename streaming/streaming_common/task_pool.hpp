@@ -0,0 +1,50 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace streaming {
+/**
+ * Fixed set of worker threads running tasks in submission order.
+ *
+ * All workers take tasks from a single FIFO queue. A producer that keeps at most one task in flight per client
+ * therefore gets round-robin scheduling across its clients, and no client can starve the others.
+ */
+class TaskPool {
+public:
+  /**
+   * @param threads Number of worker threads, the number of hardware threads if 0.
+   */
+  explicit TaskPool(const std::size_t threads = 0);
+  TaskPool(const TaskPool &) = delete;
+  TaskPool &operator=(const TaskPool &) = delete;
+  TaskPool(TaskPool &&other) noexcept = delete;
+  TaskPool &operator=(TaskPool &&other) noexcept = delete;
+
+  /**
+   * Runs the queued tasks to completion and joins the workers.
+   */
+  ~TaskPool();
+
+  /**
+   * Queues a task. Exceptions thrown by the task are logged and do not stop the worker.
+   */
+  void submit(std::function<void()> task);
+
+  std::size_t threads_num() const noexcept { return workers_.size(); }
+
+private:
+  void worker();
+
+  std::vector<std::thread> workers_{};
+  std::deque<std::function<void()>> tasks_{};
+  std::mutex mutex_{};
+  std::condition_variable cv_{};
+  bool stopping_{};
+};
+} // namespace streaming
@@ -4,6 +4,7 @@
 #include "streaming_common/decoder.hpp"
 
 #include <gp/gl/misc.hpp>
+#include <gp/gl/state_cache.hpp>
 #include <gp/misc/event.hpp>
 
 #include <array>
@@ -18,11 +19,13 @@ constexpr auto make_array(Ts &&...args) {
 }
 } // namespace
 
-DecodeScene::DecodeScene(const VideoStreamInfo &video_stream_info)
-    : video_stream_info_(video_stream_info)
-    , ms_per_frame_(1000 / video_stream_info.fps)
+DecodeScene::DecodeScene(std::unique_ptr<StreamReplayer> replayer, const Playback playback)
+    : replayer_{std::move(replayer)}
+    , playback_(playback)
+    , video_stream_info_(replayer_->video_stream_info())
+    , ms_per_frame_(1000 / video_stream_info_.fps)
     , decoder_{std::make_unique<Decoder>()} {
-  Scene3D::init(video_stream_info.width, video_stream_info.height, "Decoding...");
+  Scene3D::init(video_stream_info_.width, video_stream_info_.height, "Decoding...");
 }
 
 void DecodeScene::loop(const gp::misc::Event &event) {
@@ -36,8 +39,11 @@ void DecodeScene::loop(const gp::misc::Event &event) {
     break;
   case gp::misc::Event::Type::Redraw: {
     decode();
+    if (playback_ == Playback::Benchmark) {
+      break;
+    }
     const auto time_elapsed_ms = event.timestamp() - last_timestamp_ms_;
-    if (time_elapsed_ms >= ms_per_frame_) {
+    if (playback_ == Playback::Fast || time_elapsed_ms >= ms_per_frame_) {
       if (redraw()) {
         swap_buffers();
         last_timestamp_ms_ = timestamp();
@@ -71,7 +77,6 @@ void DecodeScene::finalize() {
   vao_.reset();
   display_frame_.reset();
   rgb_frame_.reset();
-  input_file_.reset();
   decoder_.reset();
   decoder_ = std::make_unique<Decoder>();
 }
@@ -90,16 +95,34 @@ void DecodeScene::decode() {
                                .yuv_to_rgb_us = dec_t.yuv_to_rgb_us};
     }
 #endif
+      ++decoded_frames_;
+      if (playback_ == Playback::Benchmark) {
+#ifdef STREAMING_PIPELINE_STATS
+        decode_stats_.record(pending_decode_frame_);
+#endif
+        break;
+      }
       rgb_frame_->swap(*display_frame_);
       frame_ready_ = true;
+      if (playback_ == Playback::Fast) {
+        // Present every frame rather than only the latest one decoded during this Redraw.
+        return;
+      }
       break;
     case Decoder::Status::Code::RETRY:
       break;
     case Decoder::Status::Code::EOS:
+      if (playback_ == Playback::Benchmark) {
+        const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - decode_start_).count();
+        printf("Decoding benchmark: %d frames in %.3f s, %.1f fps\n",
+               decoded_frames_,
+               seconds,
+               decoded_frames_ / seconds);
+      }
       request_close();
       return;
     case Decoder::Status::Code::NODATA:
-      read_some();
+      replayer_->feed(*decoder_);
       return;
     case Decoder::Status::Code::ERROR:
       request_close();
@@ -166,7 +189,7 @@ bool DecodeScene::redraw() {
 #endif
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glActiveTexture(GL_TEXTURE0);
+  gp::gl::state_cache().active_texture(GL_TEXTURE0);
   shader_program_->use();
   frame_texture_->bind();
   vao_->bind();
@@ -182,10 +205,12 @@ bool DecodeScene::redraw() {
 }
 
 void DecodeScene::init_streaming() {
-  input_file_ = std::make_unique<std::ifstream>("file.h264", std::ios::in | std::ios::binary);
+  replayer_->start(playback_ == Playback::Realtime);
   decoder_->init(video_stream_info_);
   rgb_frame_ = decoder_->rgb_frame();
   display_frame_ = std::make_shared<FrameData>(video_stream_info_.width * video_stream_info_.height * CHANNELS_NUM);
+  decoded_frames_ = 0;
+  decode_start_ = std::chrono::steady_clock::now();
 }
 
 void DecodeScene::init_scene() {
@@ -230,22 +255,4 @@ void DecodeScene::init_scene() {
   shader_program_->use();
   shader_program_->set_uniform("tex", 0);
 }
-
-void DecodeScene::read_some() {
-  constexpr std::size_t buffer_size_1_kB = 1024u;
-
-  if (input_file_->eof()) {
-    return;
-  }
-
-  static std::array<std::byte, buffer_size_1_kB> buffer{};
-  input_file_->read(reinterpret_cast<char *>(buffer.data()), buffer.size());
-
-  const auto size = static_cast<std::size_t>(input_file_->gcount());
-  decoder_->incoming_data(buffer.data(), size);
-
-  if (input_file_->eof()) {
-    decoder_->signal_eof();
-  }
-}
 } // namespace streaming
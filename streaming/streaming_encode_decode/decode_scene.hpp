@@ -2,6 +2,7 @@
 
 #include "streaming_common/decoder.hpp"
 #include "streaming_common/frame_data.hpp"
+#include "streaming_common/stream_replayer.hpp"
 #ifdef STREAMING_PIPELINE_STATS
 # include "streaming_common/pipeline_stats.hpp"
 #endif
@@ -15,15 +16,21 @@
 
 #include <array>
 
+#include <chrono>
 #include <cstdint>
-#include <fstream>
 #include <memory>
 #include <string>
 
 namespace streaming {
 class DecodeScene : public gp::sdl::Scene3D {
 public:
-  DecodeScene(const VideoStreamInfo &video_stream_info);
+  enum class Playback {
+    Realtime, /** packets are passed to the decoder at their recorded timing */
+    Fast,     /** packets are passed to the decoder as fast as it takes them and every decoded frame is presented */
+    Benchmark /** as Fast, but frames are not presented - measures decode throughput alone */
+  };
+
+  DecodeScene(std::unique_ptr<StreamReplayer> replayer, const Playback playback);
 
 private:
   void init(const int width, const int height, const std::string &title);
@@ -37,13 +44,15 @@ private:
 
   void init_streaming();
   void init_scene();
-  void read_some();
 
+  std::unique_ptr<StreamReplayer> replayer_;
+  const Playback playback_;
   const VideoStreamInfo video_stream_info_;
   const int ms_per_frame_{};
   int frame_counter_{};
   std::uint64_t last_timestamp_ms_{};
-  std::unique_ptr<std::ifstream> input_file_{};
+  int decoded_frames_{};
+  std::chrono::steady_clock::time_point decode_start_{};
   std::unique_ptr<Decoder> decoder_;
 
   std::shared_ptr<FrameData> rgb_frame_{};
@@ -21,10 +21,13 @@ constexpr auto make_array(Ts &&...args) {
 }
 } // namespace
 
-EncodeScene::EncodeScene(const VideoStreamInfo &video_stream_info, const int length_s)
+EncodeScene::EncodeScene(const VideoStreamInfo &video_stream_info,
+                         const int length_s,
+                         const std::string &recording_path)
     : video_stream_info_(video_stream_info)
     , number_of_frames_(length_s * video_stream_info.fps)
-    , ms_per_frame_(1000 / video_stream_info.fps) {
+    , ms_per_frame_(1000 / video_stream_info.fps)
+    , recording_path_(recording_path) {
   Scene3D::init(video_stream_info.width, video_stream_info.height, "Encoding...");
 }
 
@@ -58,10 +61,19 @@ void EncodeScene::loop(const gp::misc::Event &event) {
 void EncodeScene::initialize() {
   init_streaming();
   init_scene();
+
+#ifdef STREAMING_PIPELINE_STATS
+  render_timer_ = std::make_unique<gp::gl::GpuTimer>();
+  capture_timer_ = std::make_unique<gp::gl::GpuTimer>();
+#endif
 }
 
 void EncodeScene::finalize() {
   drain_pbo();
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_.reset();
+  render_timer_.reset();
+#endif
   pbo_[0].reset();
   pbo_[1].reset();
   shader_program_.reset();
@@ -70,7 +82,7 @@ void EncodeScene::finalize() {
   vao_.reset();
   video_frame_.reset();
   encoder_.reset();
-  output_file_.reset();
+  recorder_.reset();
 }
 
 void EncodeScene::animate(const std::uint64_t time_elapsed_ms) {
@@ -83,6 +95,7 @@ void EncodeScene::redraw() {
 #ifdef STREAMING_PIPELINE_STATS
   using Clock = std::chrono::steady_clock;
   const auto t0 = Clock::now();
+  render_timer_->begin();
 #endif
 
   auto camera_rot_mat = glm::rotate(glm::mat4(1.0f), glm::radians(camera_rot_.x), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -95,12 +108,13 @@ void EncodeScene::redraw() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   shader_program_->use();
-  shader_program_->set_uniform("mvp", mvp_mat);
+  shader_program_->set_uniform(mvp_uniform_, mvp_mat);
 
   vao_->bind();
   glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
 
 #ifdef STREAMING_PIPELINE_STATS
+  render_timer_->end();
   last_render_us_ = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
 #endif
 }
@@ -118,9 +132,15 @@ void EncodeScene::encode() {
   pbo_index_ = 1 - pbo_index_;
 
   // Issue async readback for this frame — returns immediately; GPU writes into PBO concurrently
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_->begin();
+#endif
   pbo_[write_idx]->bind();
   glReadPixels(0, 0, video_stream_info_.width, video_stream_info_.height, format, GL_UNSIGNED_BYTE, nullptr);
   pbo_[write_idx]->unbind();
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_->end();
+#endif
 
   auto mapped_ok = false;
   if (pbo_primed_) {
@@ -145,6 +165,12 @@ void EncodeScene::encode() {
   }
 
 #ifdef STREAMING_PIPELINE_STATS
+  while (const auto gpu_time = render_timer_->poll()) {
+    encode_stats_.record_gpu_render(std::chrono::duration_cast<std::chrono::microseconds>(*gpu_time));
+  }
+  while (const auto gpu_time = capture_timer_->poll()) {
+    encode_stats_.record_gpu_capture(std::chrono::duration_cast<std::chrono::microseconds>(*gpu_time));
+  }
   if (mapped_ok) {
     const auto &enc_t = encoder_->last_timings();
     encode_stats_.record({.render_us = last_render_us_,
@@ -173,12 +199,13 @@ void EncodeScene::drain_pbo() {
 
 void EncodeScene::init_streaming() {
   encoder_ = std::make_unique<Encoder>(video_stream_info_);
-  output_file_ = std::make_unique<std::ofstream>("file.h264", std::ios::out | std::ios::binary);
+  recorder_ = std::make_unique<StreamRecorder>(recording_path_, encoder_->video_stream_info());
   encoder_->set_video_stream_callback(
-      [&output_file = *output_file_](const std::byte *data, const std::size_t size, const bool eof) {
-        output_file.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size));
+      [&recorder = *recorder_, &encoder = *encoder_](const std::byte *data, const std::size_t size, const bool eof) {
+        recorder.record(data, size, eof, encoder.packet_frame_num());
         if (eof) {
-          printf("Encoding: end of stream\n");
+          printf("Encoding: end of stream, %llu packets recorded\n",
+                 static_cast<unsigned long long>(recorder.packets_recorded()));
         }
       });
 
@@ -250,5 +277,6 @@ void EncodeScene::init_scene() {
   indices_buffer_->set_data(indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
 
   shader_program_ = gp::gl::create_shader_program("shaders/color_cube");
+  mvp_uniform_ = shader_program_->uniform_handle("mvp");
 }
 } // namespace streaming
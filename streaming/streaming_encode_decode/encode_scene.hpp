@@ -2,12 +2,14 @@
 
 #include "streaming_common/encoder.hpp"
 #include "streaming_common/frame_data.hpp"
+#include "streaming_common/stream_recorder.hpp"
 #ifdef STREAMING_PIPELINE_STATS
 # include "streaming_common/pipeline_stats.hpp"
 #endif
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/gl/buffer_object.hpp>
+#include <gp/gl/gpu_timer.hpp>
 #include <gp/gl/shader_program.hpp>
 #include <gp/gl/vertex_array_object.hpp>
 
@@ -20,14 +22,13 @@
 # include <chrono>
 #endif
 #include <cstdint>
-#include <fstream>
 #include <memory>
 #include <string>
 
 namespace streaming {
 class EncodeScene : public gp::sdl::Scene3D {
 public:
-  EncodeScene(const VideoStreamInfo &video_stream_info, const int length_s);
+  EncodeScene(const VideoStreamInfo &video_stream_info, const int length_s, const std::string &recording_path);
 
 private:
   void init(const int width, const int height, const std::string &title);
@@ -48,7 +49,8 @@ private:
   const int number_of_frames_{};
   const int ms_per_frame_{};
   int frame_counter_{};
-  std::unique_ptr<std::ofstream> output_file_{};
+  const std::string recording_path_;
+  std::unique_ptr<StreamRecorder> recorder_{};
   std::unique_ptr<Encoder> encoder_;
 
   std::shared_ptr<FrameData> video_frame_{};
@@ -61,6 +63,7 @@ private:
   std::unique_ptr<gp::gl::BufferObject> vertex_buffer_{};
   std::unique_ptr<gp::gl::BufferObject> indices_buffer_{};
   std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
+  gp::gl::UniformHandle mvp_uniform_{};
 
   std::array<std::unique_ptr<gp::gl::BufferObject>, 2> pbo_{};
   int pbo_index_{0};
@@ -68,6 +71,11 @@ private:
 
 #ifdef STREAMING_PIPELINE_STATS
   std::chrono::microseconds last_render_us_{};
+  /**
+   * GPU time of the draw calls and of the readback, the CPU times only cover issuing them.
+   */
+  std::unique_ptr<gp::gl::GpuTimer> render_timer_{};
+  std::unique_ptr<gp::gl::GpuTimer> capture_timer_{};
   EncodeStats encode_stats_{};
 #endif
 };
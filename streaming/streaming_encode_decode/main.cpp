@@ -1,12 +1,15 @@
 #include "decode_scene.hpp"
 #include "encode_scene.hpp"
 
+#include "streaming_common/stream_replayer.hpp"
+
 #include <gp/ffmpeg/misc.hpp>
 #include <gp/utils/utils.hpp>
 
 #include <boost/program_options.hpp>
 
 #include <iostream>
+#include <string>
 
 struct ProgramSetup {
   bool exit{};
@@ -16,6 +19,8 @@ struct ProgramSetup {
   std::uint16_t fps{};
   AVCodecID codec_id{AV_CODEC_ID_NONE};
   int length_s{};
+  std::string input{};
+  streaming::DecodeScene::Playback playback{streaming::DecodeScene::Playback::Fast};
 };
 
 ProgramSetup process_args(const int argc, const char *const argv[]) {
@@ -28,10 +33,15 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
                      "Number of frames per second");
   desc.add_options()("codec",
                      boost::program_options::value<std::string>()->default_value("h264"),
-                     "Codec name, e.g. h264 or mpeg4");
+                     "Codec name: h264, hevc, av1, vp9 or mpeg4");
   desc.add_options()("length_s",
                      boost::program_options::value<int>()->default_value(3),
                      "Length of the stream in seconds");
+  desc.add_options()("input",
+                     boost::program_options::value<std::string>()->default_value(""),
+                     "Skip encoding and decode this stream recording or raw byte stream (e.g. a .h264 file) instead");
+  desc.add_options()("realtime", "Decode the stream at its recorded timing instead of as fast as possible");
+  desc.add_options()("benchmark", "Decode the stream as fast as possible without presenting frames");
 
   boost::program_options::variables_map vm;
   boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
@@ -42,12 +52,21 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
     return {true};
   }
 
+  auto playback = streaming::DecodeScene::Playback::Fast;
+  if (vm.count("benchmark") != 0U) {
+    playback = streaming::DecodeScene::Playback::Benchmark;
+  } else if (vm.count("realtime") != 0U) {
+    playback = streaming::DecodeScene::Playback::Realtime;
+  }
+
   return {false,
           vm["width"].as<int>(),
           vm["height"].as<int>(),
           vm["fps"].as<std::uint16_t>(),
           gp::ffmpeg::codec_name_to_id(vm["codec"].as<std::string>()),
-          vm["length_s"].as<int>()};
+          vm["length_s"].as<int>(),
+          vm["input"].as<std::string>(),
+          playback};
 }
 
 int main(int argc, char *argv[]) {
@@ -64,12 +83,16 @@ int main(int argc, char *argv[]) {
                                                             program_setup.codec_id,
                                                             avcodec_get_name(program_setup.codec_id)};
 
-  {
-    auto encode_scene = std::make_unique<streaming::EncodeScene>(video_stream_info, program_setup.length_s);
+  auto input_path = program_setup.input;
+  if (input_path.empty()) {
+    input_path = "file." + video_stream_info.codec_name + ".rec";
+    auto encode_scene = std::make_unique<streaming::EncodeScene>(video_stream_info, program_setup.length_s, input_path);
     encode_scene->exec();
   }
   {
-    auto decode_scene = std::make_unique<streaming::DecodeScene>(video_stream_info);
+    // Raw byte streams are described by the command line arguments, recordings carry their own stream info.
+    auto replayer = std::make_unique<streaming::StreamReplayer>(input_path, video_stream_info);
+    auto decode_scene = std::make_unique<streaming::DecodeScene>(std::move(replayer), program_setup.playback);
     decode_scene->exec();
   }
 
@@ -0,0 +1,308 @@
+#include "streaming_common/constants.hpp"
+#include "streaming_common/fec.hpp"
+#include "streaming_common/stream_package_header.hpp"
+
+#include <gp/utils/utils.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * Loopback impairment simulator: sends a synthetic video stream through a lossy link model and compares the frame
+ * latency of the reliable ordered DataChannel with the unordered, retransmission-free channel with and without FEC.
+ *
+ * The link serializes datagrams at a fixed bandwidth, delays them by a fixed one-way delay plus uniform jitter and
+ * drops each one independently. The reliable channel models SCTP: a lost datagram is fast-retransmitted once three
+ * later datagrams have been acknowledged, otherwise after the retransmission timeout, and ordered delivery holds back
+ * every later message until it arrives. The unordered channels run the real FecPacketizer and FecReassembler.
+ */
+struct ProgramSetup {
+  bool exit{};
+
+  std::vector<double> loss_percents{};
+  std::size_t group_size{};
+  int frames{};
+  int fps{};
+  double bitrate_kbps{};
+  int keyframe_interval{};
+  double keyframe_ratio{};
+  double delay_ms{};
+  double jitter_ms{};
+  double link_mbps{};
+  double rto_ms{};
+  std::uint32_t seed{};
+};
+
+/**
+ * Delivery of one channel mode at one loss rate.
+ */
+struct SimulationResult {
+  std::string mode{};
+  double overhead_percent{};
+  int delivered{};
+  std::vector<double> latencies_ms{};
+};
+
+ProgramSetup process_args(const int argc, const char *const argv[]) {
+  boost::program_options::options_description desc("Options");
+  desc.add_options()("help", "This help message");
+  desc.add_options()("loss",
+                     boost::program_options::value<std::string>()->default_value("1,2,3,4,5"),
+                     "Comma separated list of datagram loss rates in percent");
+  desc.add_options()("group_size",
+                     boost::program_options::value<std::size_t>()->default_value(4),
+                     "Data shards per FEC parity shard");
+  desc.add_options()("frames", boost::program_options::value<int>()->default_value(3000), "Number of frames");
+  desc.add_options()("fps", boost::program_options::value<int>()->default_value(30), "Frames per second");
+  desc.add_options()("bitrate",
+                     boost::program_options::value<double>()->default_value(4000.0),
+                     "Video bitrate in kbit/s");
+  desc.add_options()("keyframe_interval",
+                     boost::program_options::value<int>()->default_value(60),
+                     "Frames between keyframes");
+  desc.add_options()("keyframe_ratio",
+                     boost::program_options::value<double>()->default_value(8.0),
+                     "Size of a keyframe relative to the other frames");
+  desc.add_options()("delay_ms", boost::program_options::value<double>()->default_value(20.0), "One-way link delay");
+  desc.add_options()("jitter_ms",
+                     boost::program_options::value<double>()->default_value(2.0),
+                     "Maximum uniform jitter added to the link delay");
+  desc.add_options()("link_mbps", boost::program_options::value<double>()->default_value(20.0), "Link bandwidth");
+  desc.add_options()("rto_ms",
+                     boost::program_options::value<double>()->default_value(200.0),
+                     "Retransmission timeout of the reliable channel when fast retransmit does not apply");
+  desc.add_options()("seed", boost::program_options::value<std::uint32_t>()->default_value(1u), "Random seed");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+  boost::program_options::notify(vm);
+
+  if (vm.count("help") != 0U) {
+    desc.print(std::cout);
+    return {true};
+  }
+
+  std::vector<double> loss_percents{};
+  for (const auto &loss : gp::utils::split_by(vm["loss"].as<std::string>(), ",")) {
+    loss_percents.push_back(std::stod(loss));
+  }
+
+  return {false,
+          loss_percents,
+          vm["group_size"].as<std::size_t>(),
+          std::max(vm["frames"].as<int>(), 1),
+          std::max(vm["fps"].as<int>(), 1),
+          vm["bitrate"].as<double>(),
+          std::max(vm["keyframe_interval"].as<int>(), 1),
+          vm["keyframe_ratio"].as<double>(),
+          vm["delay_ms"].as<double>(),
+          vm["jitter_ms"].as<double>(),
+          vm["link_mbps"].as<double>(),
+          vm["rto_ms"].as<double>(),
+          vm["seed"].as<std::uint32_t>()};
+}
+
+/**
+ * Frame sizes with periodic keyframes, scaled so that the stream averages the requested bitrate.
+ */
+std::vector<std::size_t> generate_frame_sizes(const ProgramSetup &setup) {
+  const auto bytes_per_gop = setup.bitrate_kbps * 1000.0 / 8.0 * setup.keyframe_interval / setup.fps;
+  const auto frame_bytes = bytes_per_gop / (setup.keyframe_ratio + setup.keyframe_interval - 1);
+  std::vector<std::size_t> sizes(setup.frames);
+  for (int i = 0; i < setup.frames; ++i) {
+    const auto keyframe = i % setup.keyframe_interval == 0;
+    sizes[i] = static_cast<std::size_t>(std::llround(keyframe ? frame_bytes * setup.keyframe_ratio : frame_bytes));
+  }
+  return sizes;
+}
+
+class Link {
+public:
+  Link(const ProgramSetup &setup, const double loss_percent)
+      : setup_(setup)
+      , rng_(setup.seed)
+      , loss_(loss_percent / 100.0)
+      , jitter_(0.0, setup.jitter_ms) {}
+
+  /**
+   * Queues a datagram at `ready_ms` and returns the time its transmission starts.
+   */
+  double send(const double ready_ms, const std::size_t size) {
+    const auto start_ms = std::max(ready_ms, link_free_ms_);
+    link_free_ms_ = start_ms + static_cast<double>(size) * 8.0 / (setup_.link_mbps * 1000.0);
+    return start_ms;
+  }
+
+  bool lost() { return loss_(rng_); }
+  double arrival(const double sent_ms) { return sent_ms + setup_.delay_ms + jitter_(rng_); }
+
+  const ProgramSetup &setup() const noexcept { return setup_; }
+
+private:
+  const ProgramSetup &setup_;
+  std::mt19937 rng_;
+  std::bernoulli_distribution loss_;
+  std::uniform_real_distribution<double> jitter_;
+  double link_free_ms_{};
+};
+
+double capture_ms(const ProgramSetup &setup, const std::size_t frame) {
+  return static_cast<double>(frame) * 1000.0 / setup.fps;
+}
+
+SimulationResult simulate_reliable(const ProgramSetup &setup,
+                                   const std::vector<std::size_t> &frame_sizes,
+                                   const double loss_percent) {
+  // SCTP fragments a message into DATA chunks of roughly the same size as an FEC shard.
+  constexpr auto chunk_size = streaming::FEC_SHARD_SIZE;
+  struct Chunk {
+    std::size_t frame{};
+    double sent_ms{};
+  };
+
+  auto link = Link{setup, loss_percent};
+  std::vector<Chunk> chunks{};
+  for (std::size_t frame = 0; frame < frame_sizes.size(); ++frame) {
+    const auto size = streaming::STREAM_PACKAGE_HEADER_SIZE + frame_sizes[frame];
+    for (std::size_t offset = 0; offset < size; offset += chunk_size) {
+      chunks.push_back({frame, link.send(capture_ms(setup, frame), std::min(chunk_size, size - offset))});
+    }
+  }
+
+  std::vector<double> frame_arrival_ms(frame_sizes.size(), 0.0);
+  for (std::size_t i = 0; i < chunks.size(); ++i) {
+    auto arrival_ms = 0.0;
+    if (!link.lost()) {
+      arrival_ms = link.arrival(chunks[i].sent_ms);
+    } else {
+      // Three later chunks trigger a fast retransmit once their SACKs are back, further losses wait for the timeout.
+      auto retransmit_ms = i + 3 < chunks.size() ? chunks[i + 3].sent_ms + 2.0 * setup.delay_ms
+                                                 : chunks[i].sent_ms + setup.rto_ms;
+      auto rto_ms = setup.rto_ms;
+      while (link.lost()) {
+        retransmit_ms += rto_ms;
+        rto_ms *= 2.0;
+      }
+      arrival_ms = link.arrival(retransmit_ms);
+    }
+    frame_arrival_ms[chunks[i].frame] = std::max(frame_arrival_ms[chunks[i].frame], arrival_ms);
+  }
+
+  SimulationResult result{"reliable ordered"};
+  auto delivered_ms = 0.0;
+  for (std::size_t frame = 0; frame < frame_sizes.size(); ++frame) {
+    delivered_ms = std::max(delivered_ms, frame_arrival_ms[frame]);
+    result.latencies_ms.push_back(delivered_ms - capture_ms(setup, frame));
+  }
+  result.delivered = static_cast<int>(frame_sizes.size());
+  return result;
+}
+
+SimulationResult simulate_unordered(const ProgramSetup &setup,
+                                    const std::vector<std::size_t> &frame_sizes,
+                                    const double loss_percent,
+                                    const std::size_t group_size) {
+  struct Datagram {
+    double arrival_ms{};
+    std::vector<std::byte> message{};
+  };
+
+  auto link = Link{setup, loss_percent};
+  auto packetizer = streaming::FecPacketizer{group_size};
+  std::vector<Datagram> datagrams{};
+  std::vector<std::byte> payload{};
+  auto payload_bytes = std::size_t{};
+  auto sent_bytes = std::size_t{};
+  for (std::size_t frame = 0; frame < frame_sizes.size(); ++frame) {
+    payload.assign(frame_sizes[frame], std::byte{static_cast<unsigned char>(frame)});
+    payload_bytes += payload.size();
+    packetizer.packetize(streaming::StreamPackageHeader{frame},
+                         payload.data(),
+                         payload.size(),
+                         [&](const std::byte *message, const std::size_t size) {
+                           sent_bytes += size;
+                           const auto sent_ms = link.send(capture_ms(setup, frame), size);
+                           if (!link.lost()) {
+                             datagrams.push_back({link.arrival(sent_ms), {message, message + size}});
+                           }
+                         });
+  }
+  std::ranges::stable_sort(datagrams, {}, &Datagram::arrival_ms);
+
+  SimulationResult result{group_size > 0 ? "unordered + fec" : "unordered"};
+  result.overhead_percent = 100.0 * static_cast<double>(sent_bytes - payload_bytes) / payload_bytes;
+  auto arrival_ms = 0.0;
+  auto reassembler = streaming::FecReassembler{
+      [&](const streaming::StreamPackageHeader &header, const std::byte *, const std::size_t) {
+        result.latencies_ms.push_back(arrival_ms - capture_ms(setup, header.frame_num));
+      }};
+  for (const auto &datagram : datagrams) {
+    arrival_ms = datagram.arrival_ms;
+    reassembler.push(datagram.message.data(), datagram.message.size());
+  }
+  result.delivered = static_cast<int>(reassembler.stats().packets_delivered);
+  return result;
+}
+
+double percentile(std::vector<double> values, const double p) {
+  if (values.empty()) {
+    return 0.0;
+  }
+  const auto index = static_cast<std::size_t>(std::ceil(p / 100.0 * values.size())) - 1;
+  std::ranges::nth_element(values, values.begin() + std::min(index, values.size() - 1));
+  return values[std::min(index, values.size() - 1)];
+}
+
+int main(int argc, char *argv[]) {
+  const auto program_setup = process_args(argc, argv);
+  if (program_setup.exit) {
+    return 1;
+  }
+
+  const auto frame_sizes = generate_frame_sizes(program_setup);
+  printf("%d frames at %d fps, %.0f kbit/s, link %.0f Mbit/s, delay %.0f ms, jitter %.0f ms\n",
+         program_setup.frames,
+         program_setup.fps,
+         program_setup.bitrate_kbps,
+         program_setup.link_mbps,
+         program_setup.delay_ms,
+         program_setup.jitter_ms);
+  printf("%6s  %-17s  %8s  %9s  %8s  %8s  %8s  %8s\n",
+         "loss",
+         "channel",
+         "overhead",
+         "delivered",
+         "p50 ms",
+         "p95 ms",
+         "p99 ms",
+         "max ms");
+
+  for (const auto loss_percent : program_setup.loss_percents) {
+    const auto results = std::vector<SimulationResult>{
+        simulate_reliable(program_setup, frame_sizes, loss_percent),
+        simulate_unordered(program_setup, frame_sizes, loss_percent, 0),
+        simulate_unordered(program_setup, frame_sizes, loss_percent, program_setup.group_size)};
+    for (const auto &result : results) {
+      printf("%5.1f%%  %-17s  %7.1f%%  %8.2f%%  %8.1f  %8.1f  %8.1f  %8.1f\n",
+             loss_percent,
+             result.mode.c_str(),
+             result.overhead_percent,
+             100.0 * result.delivered / program_setup.frames,
+             percentile(result.latencies_ms, 50.0),
+             percentile(result.latencies_ms, 95.0),
+             percentile(result.latencies_ms, 99.0),
+             percentile(result.latencies_ms, 100.0));
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,100 @@
+#include "multi_session_scene.hpp"
+
+#include "streaming_common/video_stream_info.hpp"
+
+#include <gp/ffmpeg/misc.hpp>
+#include <gp/utils/utils.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+struct ProgramSetup {
+  bool exit{};
+
+  int width{};
+  int height{};
+  std::uint16_t fps{};
+  AVCodecID codec_id{AV_CODEC_ID_NONE};
+  streaming::MultiSessionScene::Setup scene_setup{};
+};
+
+ProgramSetup process_args(const int argc, const char *const argv[]) {
+  boost::program_options::options_description desc("Options");
+  desc.add_options()("help", "This help message");
+  desc.add_options()("ip", boost::program_options::value<std::string>()->default_value("127.0.0.1"), "Server ip");
+  desc.add_options()("port", boost::program_options::value<std::uint16_t>()->default_value(11100u), "Server port");
+  desc.add_options()("sessions", boost::program_options::value<int>()->default_value(4), "Number of sessions");
+  desc.add_options()("workers",
+                     boost::program_options::value<std::size_t>()->default_value(0),
+                     "Number of encode worker threads (0 = number of hardware threads)");
+  desc.add_options()("width", boost::program_options::value<int>()->default_value(640), "Width of each session");
+  desc.add_options()("height", boost::program_options::value<int>()->default_value(480), "Height of each session");
+  desc.add_options()("fps",
+                     boost::program_options::value<std::uint16_t>()->default_value(30u),
+                     "Number of frames per second of each session");
+  desc.add_options()("codec",
+                     boost::program_options::value<std::string>()->default_value("h264"),
+                     "Codec name: h264, hevc, av1, vp9 or mpeg4");
+  desc.add_options()("no-stun", "Disable STUN server (use for local LAN connections)");
+  desc.add_options()("headless", "Render on an EGL pbuffer without a display server");
+  desc.add_options()("stats_interval_s",
+                     boost::program_options::value<int>()->default_value(5),
+                     "Seconds between per-session stats reports");
+  desc.add_options()("benchmark", "Render and encode without connecting, then report the sessions sustained");
+  desc.add_options()("duration_s",
+                     boost::program_options::value<int>()->default_value(10),
+                     "Benchmark duration in seconds");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+  boost::program_options::notify(vm);
+
+  if (vm.count("help")) {
+    desc.print(std::cout);
+    return {true};
+  }
+
+  const auto sessions = vm["sessions"].as<int>();
+  if (sessions < 1) {
+    std::cout << "At least one session is required" << std::endl;
+    return {true};
+  }
+
+  return {false,
+          vm["width"].as<int>(),
+          vm["height"].as<int>(),
+          vm["fps"].as<std::uint16_t>(),
+          gp::ffmpeg::codec_name_to_id(vm["codec"].as<std::string>()),
+          {sessions,
+           vm["workers"].as<std::size_t>(),
+           vm["ip"].as<std::string>(),
+           vm["port"].as<std::uint16_t>(),
+           !vm.count("no-stun"),
+           vm.count("headless") > 0,
+           std::chrono::seconds{vm.count("benchmark") ? std::max(vm["duration_s"].as<int>(), 1) : 0},
+           std::chrono::seconds{std::max(vm["stats_interval_s"].as<int>(), 1)}}};
+}
+
+int main(int argc, char *argv[]) {
+  gp::utils::set_working_directory();
+
+  const auto program_setup = process_args(argc, argv);
+  if (program_setup.exit) {
+    return 1;
+  }
+
+  const auto video_stream_info = streaming::VideoStreamInfo{program_setup.width,
+                                                            program_setup.height,
+                                                            program_setup.fps,
+                                                            program_setup.codec_id,
+                                                            avcodec_get_name(program_setup.codec_id)};
+
+  auto scene = std::make_unique<streaming::MultiSessionScene>(video_stream_info, program_setup.scene_setup);
+  return scene->exec();
+}
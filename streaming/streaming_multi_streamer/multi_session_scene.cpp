@@ -0,0 +1,220 @@
+#include "multi_session_scene.hpp"
+
+#include <gp/gl/misc.hpp>
+#include <gp/misc/event.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <thread>
+
+namespace streaming {
+namespace {
+template<typename... Ts>
+constexpr auto make_array(Ts &&...args) {
+  return std::array<std::common_type_t<Ts...>, sizeof...(Ts)>{std::forward<Ts>(args)...};
+}
+
+double per_second(const std::uint64_t count, const double seconds) {
+  return seconds > 0.0 ? static_cast<double>(count) / seconds : 0.0;
+}
+
+double average_ms(const std::chrono::microseconds total, const std::uint64_t count) {
+  return count > 0 ? static_cast<double>(total.count()) / 1000.0 / static_cast<double>(count) : 0.0;
+}
+} // namespace
+
+MultiSessionScene::MultiSessionScene(const VideoStreamInfo &video_stream_info, const Setup &setup)
+    : Scene3D(setup.headless ? std::make_shared<gp::sdl::internal::SDLContext>("offscreen") : nullptr)
+    , video_stream_info_(video_stream_info)
+    , setup_(setup) {
+  set_hidden_window(true);
+  Scene3D::init(video_stream_info.width, video_stream_info.height, "Multi-session streamer");
+}
+
+void MultiSessionScene::loop(const gp::misc::Event &event) {
+  switch (event.type()) {
+  case gp::misc::Event::Type::Init:
+    initialize();
+    break;
+  case gp::misc::Event::Type::Quit:
+    finalize();
+    break;
+  case gp::misc::Event::Type::Redraw:
+    redraw();
+    break;
+  default:
+    break;
+  }
+}
+
+void MultiSessionScene::initialize() {
+  init_scene();
+
+  task_pool_ = std::make_unique<TaskPool>(setup_.workers);
+  sessions_.reserve(setup_.sessions);
+  for (auto i = 0; i < setup_.sessions; ++i) {
+    auto session = std::make_unique<Session>(i, video_stream_info_, *task_pool_);
+    session->init_gl();
+    if (setup_.benchmark_duration.count() == 0) {
+      session->connect(setup_.ip, setup_.port, setup_.use_stun);
+    }
+    sessions_.emplace_back(std::move(session));
+  }
+  printf("Multi-session streamer: %d sessions of %dx%d@%d %s on %zu workers\n",
+         setup_.sessions,
+         video_stream_info_.width,
+         video_stream_info_.height,
+         video_stream_info_.fps,
+         video_stream_info_.codec_name.c_str(),
+         task_pool_->threads_num());
+
+  // Staggered schedules spread the encodes over the frame period instead of submitting them all at once.
+  started_at_ = Session::Clock::now();
+  last_report_at_ = started_at_;
+  last_report_stats_.assign(sessions_.size(), Session::Stats{});
+  for (const auto &session : sessions_) {
+    session->start(started_at_ + session->frame_period() * session->index() / setup_.sessions);
+  }
+}
+
+void MultiSessionScene::finalize() {
+  // Draining the pool first guarantees no encode task still refers to a session.
+  task_pool_.reset();
+  sessions_.clear();
+  shader_program_.reset();
+  indices_buffer_.reset();
+  vertex_buffer_.reset();
+  vao_.reset();
+}
+
+void MultiSessionScene::redraw() {
+  for (const auto &session : sessions_) {
+    session->update();
+  }
+
+  auto next_deadline = Session::Clock::time_point::max();
+  for (const auto &session : sessions_) {
+    if (session->frame_due(Session::Clock::now())) {
+      session->render(*shader_program_, *vao_, projection_);
+      session->capture();
+    }
+    next_deadline = std::min(next_deadline, session->next_deadline());
+  }
+
+  const auto now = Session::Clock::now();
+  if (setup_.benchmark_duration.count() > 0 && now - started_at_ >= setup_.benchmark_duration) {
+    report_stats(true);
+    request_close();
+    return;
+  }
+  if (now - last_report_at_ >= setup_.stats_interval) {
+    report_stats(false);
+  }
+
+  // Leave the last millisecond to polling, sleep_until tends to oversleep.
+  const auto wake_at = next_deadline - std::chrono::milliseconds{1};
+  if (wake_at > now) {
+    std::this_thread::sleep_until(wake_at);
+  }
+}
+
+void MultiSessionScene::init_scene() {
+  glEnable(GL_DEPTH_TEST);
+  glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+  glEnable(GL_CULL_FACE);
+  glCullFace(GL_BACK);
+  glFrontFace(GL_CCW);
+
+  projection_ = glm::perspective(glm::radians(60.0f),
+                                 static_cast<float>(video_stream_info_.width) / video_stream_info_.height,
+                                 1.0f,
+                                 1024.0f);
+
+  // clang-format off
+  const auto vertices = make_array(
+    -1.0f, -1.0f, -1.0f,    1.0f, 0.0f, 0.0f,
+     1.0f, -1.0f, -1.0f,    0.0f, 1.0f, 0.0f,
+     1.0f,  1.0f, -1.0f,    0.0f, 0.0f, 1.0f,
+    -1.0f,  1.0f, -1.0f,    0.0f, 1.0f, 1.0f,
+    -1.0f, -1.0f,  1.0f,    1.0f, 1.0f, 0.0f,
+    -1.0f,  1.0f,  1.0f,    1.0f, 0.0f, 1.0f,
+     1.0f,  1.0f,  1.0f,    1.0f, 0.0f, 0.0f,
+     1.0f, -1.0f,  1.0f,    0.0f, 1.0f, 1.0f);
+  const auto indices = make_array(
+    2u, 1u, 0u,
+    0u, 3u, 2u,
+    4u, 3u, 0u,
+    5u, 3u, 4u,
+    4u, 6u, 5u,
+    4u, 7u, 6u,
+    0u, 7u, 4u,
+    1u, 7u, 0u,
+    6u, 7u, 1u,
+    1u, 2u, 6u,
+    6u, 2u, 3u,
+    3u, 5u, 6u);
+  // clang-format on
+
+  vao_ = std::make_unique<gp::gl::VertexArrayObject>();
+  vao_->bind();
+
+  vertex_buffer_ = std::make_unique<gp::gl::BufferObject>(GL_ARRAY_BUFFER);
+  vertex_buffer_->bind();
+  vertex_buffer_->set_data(vertices.size() * sizeof(vertices[0]), vertices.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), nullptr);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), reinterpret_cast<void *>(3 * sizeof(float)));
+  glEnableVertexAttribArray(1);
+
+  indices_buffer_ = std::make_unique<gp::gl::BufferObject>(GL_ELEMENT_ARRAY_BUFFER);
+  indices_buffer_->bind();
+  indices_buffer_->set_data(indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
+
+  shader_program_ = gp::gl::create_shader_program("shaders/color_cube");
+}
+
+void MultiSessionScene::report_stats(const bool final_report) {
+  const auto now = Session::Clock::now();
+  const auto since = final_report ? started_at_ : last_report_at_;
+  const auto seconds = std::chrono::duration<double>(now - since).count();
+
+  printf("%s over %.1f s:\n", final_report ? "Benchmark" : "Sessions", seconds);
+  printf("  session  render/s  encode/s  skipped/s  dropped    kbit/s  encode avg/max ms  queue avg ms\n");
+
+  auto encoded_fps_total = 0.0;
+  auto sustained_sessions = 0.0;
+  for (std::size_t i = 0; i < sessions_.size(); ++i) {
+    const auto stats = sessions_[i]->stats();
+    const auto &before = final_report ? Session::Stats{} : last_report_stats_[i];
+    const auto encoded = stats.frames_encoded - before.frames_encoded;
+    const auto encoded_fps = per_second(encoded, seconds);
+    printf("  %7zu  %8.1f  %8.1f  %9.1f  %7llu  %8.1f  %8.2f / %6.2f  %12.2f\n",
+           i,
+           per_second(stats.frames_rendered - before.frames_rendered, seconds),
+           encoded_fps,
+           per_second(stats.frames_skipped - before.frames_skipped, seconds),
+           static_cast<unsigned long long>(stats.frames_dropped - before.frames_dropped),
+           per_second((stats.bytes_encoded - before.bytes_encoded) * 8, seconds) / 1000.0,
+           average_ms(stats.encode_time - before.encode_time, encoded),
+           static_cast<double>(stats.max_encode_time.count()) / 1000.0,
+           average_ms(stats.queue_time - before.queue_time, encoded));
+
+    encoded_fps_total += encoded_fps;
+    sustained_sessions += std::min(1.0, encoded_fps / video_stream_info_.fps);
+    last_report_stats_[i] = stats;
+  }
+
+  // A session counts fully only if it keeps up with the target rate, slower ones count by the fraction they reach.
+  const auto workers = static_cast<double>(task_pool_->threads_num());
+  printf("  total %.1f of %d encoded fps, %.2f sessions sustained, %.2f sessions per worker%s\n",
+         encoded_fps_total,
+         video_stream_info_.fps * setup_.sessions,
+         sustained_sessions,
+         sustained_sessions / workers,
+         sustained_sessions >= setup_.sessions - 0.01 ? " (lower bound, add sessions to saturate)" : "");
+  last_report_at_ = now;
+}
+} // namespace streaming
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "session.hpp"
+
+#include "streaming_common/task_pool.hpp"
+#include "streaming_common/video_stream_info.hpp"
+
+#include <gp/gl/buffer_object.hpp>
+#include <gp/gl/shader_program.hpp>
+#include <gp/gl/vertex_array_object.hpp>
+#include <gp/sdl/scene_3d.hpp>
+
+#include <glm/glm.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace streaming {
+/**
+ * Renders several independent sessions offscreen on one GL context and encodes them on a shared TaskPool.
+ *
+ * The window only provides the GL context, it stays hidden (or is an EGL pbuffer when headless) and is never
+ * swapped. Per-session stats are printed every stats interval; in benchmark mode the sessions are not connected and
+ * the scene closes after the given duration with a summary of how many sessions the encode workers sustain at the
+ * target frame rate.
+ */
+class MultiSessionScene : public gp::sdl::Scene3D {
+public:
+  struct Setup {
+    int sessions{1};
+    std::size_t workers{};
+    std::string ip{};
+    std::uint16_t port{};
+    bool use_stun{true};
+    /**
+     * Use SDL's offscreen video driver (EGL pbuffer) instead of a hidden window, no display server is needed.
+     */
+    bool headless{};
+    /**
+     * Run without connections for this long, zero to stream until closed.
+     */
+    std::chrono::seconds benchmark_duration{};
+    std::chrono::seconds stats_interval{5};
+  };
+
+  MultiSessionScene(const VideoStreamInfo &video_stream_info, const Setup &setup);
+
+private:
+  void loop(const gp::misc::Event &event) override;
+
+  void initialize();
+  void finalize();
+  void redraw();
+  void init_scene();
+  void report_stats(const bool final_report);
+
+  const VideoStreamInfo video_stream_info_;
+  const Setup setup_;
+
+  std::unique_ptr<TaskPool> task_pool_{};
+  std::vector<std::unique_ptr<Session>> sessions_{};
+
+  glm::mat4 projection_{};
+  std::unique_ptr<gp::gl::VertexArrayObject> vao_{};
+  std::unique_ptr<gp::gl::BufferObject> vertex_buffer_{};
+  std::unique_ptr<gp::gl::BufferObject> indices_buffer_{};
+  std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
+
+  Session::Clock::time_point started_at_{};
+  Session::Clock::time_point last_report_at_{};
+  std::vector<Session::Stats> last_report_stats_{};
+};
+} // namespace streaming
@@ -0,0 +1,256 @@
+#include "session.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+
+namespace streaming {
+Session::Session(const int index, const VideoStreamInfo &video_stream_info, TaskPool &task_pool)
+    : index_(index)
+    , video_stream_info_(video_stream_info)
+    , task_pool_(task_pool)
+    , frame_pacer_(video_stream_info.fps)
+    , encoder_(std::make_shared<Encoder>(video_stream_info)) {
+  video_frame_ = encoder_->video_frame();
+  encoder_->set_video_stream_callback([this](const std::byte *data, const std::size_t size, const bool eof) {
+    video_stream_callback(data, size, eof, encoder_->packet_frame_num());
+  });
+  // Different starting angles make the sessions' streams tell apart at a glance.
+  camera_rot_.y = static_cast<float>(index) * 37.0f;
+}
+
+Session::~Session() {
+  // The encoder flushes on destruction and may still emit packets, drop the connection first.
+  streamer_.reset();
+  encoder_.reset();
+}
+
+void Session::init_gl() {
+  const auto width = video_stream_info_.width;
+  const auto height = video_stream_info_.height;
+
+  offscreen_target_ = std::make_unique<OffscreenTarget>(width, height);
+
+  const auto frame_size = static_cast<GLsizeiptr>(width) * height * CHANNELS_NUM;
+  for (auto &pbo : pbo_) {
+    pbo = std::make_unique<gp::gl::BufferObject>(GL_PIXEL_PACK_BUFFER);
+    pbo->bind();
+    pbo->set_data(frame_size, nullptr, GL_STREAM_READ);
+    pbo->unbind();
+  }
+}
+
+void Session::connect(const std::string &ip, const std::uint16_t port, const bool use_stun) {
+  ip_ = ip;
+  port_ = port;
+  use_stun_ = use_stun;
+
+  streamer_ = std::make_shared<Streamer>(ip_, port_, use_stun_);
+  streamer_->set_event_callback([this](const gp::misc::Event &event) { handle_event(event); });
+  streamer_->set_close_callback([this]() { reconnect_requested_.store(true); });
+  streamer_->set_feedback_callback([this](const std::uint64_t lag) { frame_lag_.store(lag); });
+  streamer_->set_congestion_callback([this](const bool congested) { congested_.store(congested); });
+  streamer_->set_bit_rate_callback([this](const std::int64_t bit_rate) { pending_bit_rate_.store(bit_rate); });
+  streamer_->start(video_stream_info_);
+}
+
+void Session::start(const Clock::time_point first_frame) { frame_pacer_.start(first_frame); }
+
+void Session::update() {
+  auto event_queue = std::vector<gp::misc::Event>{};
+  {
+    const auto lock_guard = std::lock_guard(event_queue_mutex_);
+    event_queue.swap(event_queue_);
+  }
+  for (const auto &event : event_queue) {
+    apply_event(event);
+  }
+
+  // The encode task uses the streamer, so it is only replaced between encodes. The old streamer is released here on
+  // the GL thread rather than from its own close callback.
+  if (streamer_ && reconnect_requested_.load() && !encoding_.load(std::memory_order_acquire)) {
+    printf("Session %d: receiver disconnected, reconnecting\n", index_);
+    reconnect_requested_.store(false);
+    frame_lag_.store(0);
+    congested_.store(false);
+    streamer_.reset();
+    connect(ip_, port_, use_stun_);
+  }
+}
+
+bool Session::frame_due(const Clock::time_point now) { return frame_pacer_.frame_due(now); }
+
+Session::Clock::time_point Session::next_deadline() const noexcept { return frame_pacer_.next_deadline(); }
+
+Session::Clock::duration Session::frame_period() const noexcept { return frame_pacer_.frame_period(); }
+
+void Session::render(gp::gl::ShaderProgram &shader_program,
+                     const gp::gl::VertexArrayObject &vao,
+                     const glm::mat4 &projection) {
+  if (animate_) {
+    // Animation advances by the nominal period so motion stays uniform in the encoded stream.
+    const auto speed_factor = 0.02f;
+    camera_rot_.y += std::chrono::duration<float, std::milli>(frame_pacer_.frame_period()).count() * speed_factor;
+  }
+
+  auto camera_rot_mat = glm::rotate(glm::mat4(1.0f), glm::radians(camera_rot_.x), glm::vec3(1.0f, 0.0f, 0.0f));
+  camera_rot_mat = glm::rotate(camera_rot_mat, glm::radians(camera_rot_.y), glm::vec3(0.0f, 1.0f, 0.0f));
+  camera_rot_mat = glm::rotate(camera_rot_mat, glm::radians(camera_rot_.z), glm::vec3(0.0f, 0.0f, 1.0f));
+  const auto view = glm::lookAt(camera_pos_, glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{0.0f, 1.0f, 0.0f});
+  const auto mvp_mat = projection * view * camera_rot_mat;
+
+  offscreen_target_->bind();
+  glViewport(0, 0, video_stream_info_.width, video_stream_info_.height);
+  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+  shader_program.use();
+  shader_program.set_uniform("mvp", mvp_mat);
+
+  vao.bind();
+  glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+
+  const auto lock_guard = std::lock_guard(stats_mutex_);
+  ++stats_.frames_rendered;
+}
+
+void Session::capture() {
+  constexpr auto format = CHANNELS_NUM == 4u ? GL_RGBA : GL_RGB;
+
+  const auto write_idx = pbo_index_;
+  const auto read_idx = 1 - pbo_index_;
+  pbo_index_ = 1 - pbo_index_;
+
+  // Async readback of this frame from the session's framebuffer, which render() left bound.
+  pbo_[write_idx]->bind();
+  glReadPixels(0, 0, video_stream_info_.width, video_stream_info_.height, format, GL_UNSIGNED_BYTE, nullptr);
+  pbo_[write_idx]->unbind();
+  offscreen_target_->unbind();
+
+  if (!pbo_primed_) {
+    pbo_primed_ = true;
+    return;
+  }
+
+  const auto lag = frame_lag_.load();
+  auto skip_interval = 1;
+  if (lag > LAG_THROTTLE_HEAVY) {
+    skip_interval = 4;
+  } else if (lag > LAG_THROTTLE_LIGHT) {
+    skip_interval = 2;
+  }
+  const auto throttled = skip_counter_ != 0 || congested_.load();
+  skip_counter_ = (skip_counter_ + 1) % skip_interval;
+
+  // The frame buffer is owned by the encode task until it finishes.
+  if (throttled || encoding_.load(std::memory_order_acquire)) {
+    const auto lock_guard = std::lock_guard(stats_mutex_);
+    ++stats_.frames_skipped;
+    return;
+  }
+
+  // The previous PBO's readback has had a full frame cycle to complete.
+  pbo_[read_idx]->bind();
+  const auto *src = static_cast<const FrameSubType *>(pbo_[read_idx]->map(GL_READ_ONLY));
+  if (src) {
+    std::memcpy(video_frame_->data(), src, video_frame_->size());
+    pbo_[read_idx]->unmap();
+  }
+  pbo_[read_idx]->unbind();
+
+  if (src) {
+    submit_encode();
+  }
+}
+
+void Session::handle_event(const gp::misc::Event &event) {
+  const auto lock_guard = std::lock_guard(event_queue_mutex_);
+  event_queue_.emplace_back(event);
+}
+
+Session::Stats Session::stats() const {
+  const auto lock_guard = std::lock_guard(stats_mutex_);
+  auto stats = stats_;
+  stats.frames_dropped = frame_pacer_.dropped_frames();
+  return stats;
+}
+
+void Session::apply_event(const gp::misc::Event &event) {
+  switch (event.type()) {
+  case gp::misc::Event::Type::MouseButton:
+    if (event.mouse_button().button == gp::misc::Event::MouseButton::Right &&
+        event.mouse_button().action == gp::misc::Event::Action::Released) {
+      animate_ = !animate_;
+    }
+    break;
+  case gp::misc::Event::Type::MouseMove:
+    if (event.mouse_move().left_is_down()) {
+      animate_ = false;
+      const auto speed_factor = 0.1f;
+      camera_rot_.x += event.mouse_move().y_rel * speed_factor;
+      camera_rot_.y += event.mouse_move().x_rel * speed_factor;
+    }
+    break;
+  case gp::misc::Event::Type::MouseScroll: {
+    const auto speed_factor = 0.1f;
+    const auto zoom_amount = std::fabs(event.mouse_scroll().vertical) * speed_factor;
+    const auto zoom_direction = event.mouse_scroll().vertical < 0.0f;
+    if (zoom_direction) {
+      camera_pos_ *= 1.0f + zoom_amount;
+    } else {
+      camera_pos_ *= 1.0f - zoom_amount;
+    }
+  } break;
+  default:
+    break;
+  }
+}
+
+void Session::submit_encode() {
+  encoding_.store(true, std::memory_order_release);
+  const auto submitted_at = Clock::now();
+  task_pool_.submit([this, submitted_at]() {
+    const auto started_at = Clock::now();
+    try {
+      if (const auto bit_rate = pending_bit_rate_.exchange(0); bit_rate > 0) {
+        encoder_->set_bit_rate(bit_rate);
+      }
+      encoder_->encode();
+    } catch (const std::exception &e) {
+      printf("Session %d: encode failed: %s\n", index_, e.what());
+    }
+    const auto finished_at = Clock::now();
+
+    const auto encode_time = std::chrono::duration_cast<std::chrono::microseconds>(finished_at - started_at);
+    if (streamer_) {
+      streamer_->report_encode_time(encode_time);
+    }
+    {
+      const auto lock_guard = std::lock_guard(stats_mutex_);
+      ++stats_.frames_encoded;
+      stats_.encode_time += encode_time;
+      stats_.max_encode_time = std::max(stats_.max_encode_time, encode_time);
+      stats_.queue_time += std::chrono::duration_cast<std::chrono::microseconds>(started_at - submitted_at);
+    }
+    encoding_.store(false, std::memory_order_release);
+  });
+}
+
+void Session::video_stream_callback(const std::byte *data,
+                                    const std::size_t size,
+                                    const bool eof,
+                                    const std::uint64_t frame_num) {
+  {
+    const auto lock_guard = std::lock_guard(stats_mutex_);
+    stats_.bytes_encoded += size;
+  }
+  if (streamer_) {
+    streamer_->video_stream_callback(data, size, eof, frame_num);
+  }
+}
+} // namespace streaming
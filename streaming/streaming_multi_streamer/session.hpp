@@ -0,0 +1,156 @@
+#pragma once
+
+#include "streaming_common/encoder.hpp"
+#include "streaming_common/frame_data.hpp"
+#include "streaming_common/frame_pacer.hpp"
+#include "streaming_common/offscreen_target.hpp"
+#include "streaming_common/task_pool.hpp"
+#include "streaming_common/video_stream_info.hpp"
+#include "streaming_streamer/streamer.hpp"
+
+#include <gp/gl/buffer_object.hpp>
+#include <gp/gl/shader_program.hpp>
+#include <gp/gl/vertex_array_object.hpp>
+#include <gp/misc/event.hpp>
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace streaming {
+/**
+ * One independent stream of the multi-session streamer: its own camera, offscreen framebuffer, encoder and - unless
+ * benchmarking - its own Streamer connection.
+ *
+ * Everything except handle_event() and the encode task runs on the GL thread. At most one encode per session is in
+ * flight on the shared TaskPool; a frame captured while the previous one is still being encoded is skipped, so a
+ * slow session never queues up work that delays the others.
+ */
+class Session {
+public:
+  using Clock = FramePacer::Clock;
+
+  struct Stats {
+    std::uint64_t frames_rendered{};
+    std::uint64_t frames_encoded{};
+    /**
+     * Frames skipped because the previous encode had not finished, or to throttle a lagging receiver.
+     */
+    std::uint64_t frames_skipped{};
+    /**
+     * Frames dropped by the pacer because the render thread fell behind.
+     */
+    std::uint64_t frames_dropped{};
+    std::uint64_t bytes_encoded{};
+    std::chrono::microseconds encode_time{};
+    std::chrono::microseconds max_encode_time{};
+    /**
+     * Total time encode tasks spent waiting for a free worker.
+     */
+    std::chrono::microseconds queue_time{};
+  };
+
+  Session(const int index, const VideoStreamInfo &video_stream_info, TaskPool &task_pool);
+  Session(const Session &) = delete;
+  Session &operator=(const Session &) = delete;
+  Session(Session &&other) noexcept = delete;
+  Session &operator=(Session &&other) noexcept = delete;
+
+  /**
+   * Has to be called on the GL thread, after the encode task of this session has completed.
+   */
+  ~Session();
+
+  /**
+   * Creates the framebuffer and readback buffers, requires a current GL context.
+   */
+  void init_gl();
+  /**
+   * Connects the session to the signaling server, a session without a connection only renders and encodes.
+   */
+  void connect(const std::string &ip, const std::uint16_t port, const bool use_stun);
+  /**
+   * Starts the frame schedule with the first frame due at `first_frame`, staggering the sessions spreads their
+   * encodes evenly over the frame period.
+   */
+  void start(const Clock::time_point first_frame);
+
+  /**
+   * Processes queued input events and reconnects the session if its receiver went away.
+   */
+  void update();
+  [[nodiscard]] bool frame_due(const Clock::time_point now);
+  Clock::time_point next_deadline() const noexcept;
+  Clock::duration frame_period() const noexcept;
+
+  /**
+   * Renders the next frame into the session's framebuffer.
+   */
+  void render(gp::gl::ShaderProgram &shader_program, const gp::gl::VertexArrayObject &vao, const glm::mat4 &projection);
+  /**
+   * Reads back the rendered frame and submits the previous one to the task pool.
+   */
+  void capture();
+
+  /**
+   * Thread safe, events are applied on the next update().
+   */
+  void handle_event(const gp::misc::Event &event);
+
+  int index() const noexcept { return index_; }
+  const VideoStreamInfo &video_stream_info() const noexcept { return video_stream_info_; }
+  Stats stats() const;
+
+private:
+  void apply_event(const gp::misc::Event &event);
+  void submit_encode();
+  void video_stream_callback(const std::byte *data,
+                             const std::size_t size,
+                             const bool eof,
+                             const std::uint64_t frame_num);
+
+  const int index_;
+  const VideoStreamInfo video_stream_info_;
+  TaskPool &task_pool_;
+  FramePacer frame_pacer_;
+
+  std::shared_ptr<Encoder> encoder_;
+  std::shared_ptr<FrameData> video_frame_{};
+  std::atomic<bool> encoding_{false};
+
+  std::shared_ptr<Streamer> streamer_{};
+  std::string ip_{};
+  std::uint16_t port_{};
+  bool use_stun_{true};
+  std::atomic<bool> reconnect_requested_{false};
+  std::atomic<std::uint64_t> frame_lag_{0};
+  std::atomic<bool> congested_{false};
+  /**
+   * Bit rate requested by the streamer's congestion controller, applied by the next encode task. 0 = no change.
+   */
+  std::atomic<std::int64_t> pending_bit_rate_{0};
+  int skip_counter_{0};
+
+  std::unique_ptr<OffscreenTarget> offscreen_target_{};
+  std::array<std::unique_ptr<gp::gl::BufferObject>, 2> pbo_{};
+  int pbo_index_{0};
+  bool pbo_primed_{false};
+
+  bool animate_{true};
+  glm::vec3 camera_pos_{0.0f, 2.0f, 4.0f};
+  glm::vec3 camera_rot_{};
+
+  std::vector<gp::misc::Event> event_queue_{};
+  std::mutex event_queue_mutex_{};
+
+  Stats stats_{};
+  mutable std::mutex stats_mutex_{};
+};
+} // namespace streaming
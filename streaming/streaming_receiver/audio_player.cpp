@@ -0,0 +1,84 @@
+#include "audio_player.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace streaming {
+namespace {
+// Skew tolerated before correcting, a fraction of the roughly 45 ms by which audio may lead video unnoticed.
+constexpr auto SYNC_TOLERANCE = std::chrono::milliseconds{15};
+// Largest silence inserted per packet, longer gaps become audible as dropouts.
+constexpr auto MAX_SILENCE_STEP = std::chrono::milliseconds{20};
+// Packets are only dropped while more than this is queued, so catching up never drains the device.
+constexpr auto MIN_QUEUED = std::chrono::milliseconds{20};
+constexpr auto BYTES_PER_SAMPLE = static_cast<int>(sizeof(float)) * AUDIO_CHANNELS_NUM;
+
+std::chrono::microseconds samples_to_duration(const std::int64_t samples) {
+  return std::chrono::microseconds{samples * 1'000'000 / AUDIO_SAMPLE_RATE};
+}
+} // namespace
+
+AudioPlayer::AudioPlayer(std::shared_ptr<AvSync> av_sync)
+    : av_sync_(std::move(av_sync)) {
+  if (!SDL_InitSubSystem(SDL_INIT_AUDIO)) {
+    printf("Audio: SDL_InitSubSystem failed, playing without sound: %s\n", SDL_GetError());
+    return;
+  }
+  const auto spec = SDL_AudioSpec{SDL_AUDIO_F32, AUDIO_CHANNELS_NUM, AUDIO_SAMPLE_RATE};
+  stream_ = SDL_OpenAudioDeviceStream(SDL_AUDIO_DEVICE_DEFAULT_PLAYBACK, &spec, nullptr, nullptr);
+  if (stream_ == nullptr) {
+    printf("Audio: no playback device, playing without sound: %s\n", SDL_GetError());
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    return;
+  }
+  SDL_ResumeAudioStreamDevice(stream_);
+}
+
+AudioPlayer::~AudioPlayer() {
+  if (stream_ != nullptr) {
+    SDL_DestroyAudioStream(stream_);
+    SDL_QuitSubSystem(SDL_INIT_AUDIO);
+  }
+}
+
+#ifdef STREAMING_PIPELINE_STATS
+void AudioPlayer::set_stats_log(std::FILE *const out) noexcept { audio_stats_.set_output(out); }
+#endif
+
+void AudioPlayer::play(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us) {
+  const auto &samples = decoder_.decode(data, size);
+  if (samples.empty() || stream_ == nullptr) {
+    return;
+  }
+
+  const auto queued_bytes = std::max(SDL_GetAudioStreamQueued(stream_), 0);
+  const auto queued = samples_to_duration(queued_bytes / BYTES_PER_SAMPLE);
+  const auto skew = av_sync_ ? av_sync_->audio_skew(timestamp_us, AvSync::Clock::now() + queued) : std::nullopt;
+
+#ifdef STREAMING_PIPELINE_STATS
+  audio_stats_.record({.decode_us = decoder_.last_decode_time(),
+                       .queued_us = queued,
+                       .skew_us = skew.value_or(std::chrono::microseconds{}),
+                       .skew_known = skew.has_value()});
+#endif
+
+  if (skew && *skew > SYNC_TOLERANCE && queued > MIN_QUEUED) {
+#ifdef STREAMING_PIPELINE_STATS
+    audio_stats_.record_drop();
+#endif
+    return;
+  }
+  if (skew && *skew < -SYNC_TOLERANCE) {
+    const auto silence = std::min<std::chrono::microseconds>(-*skew, MAX_SILENCE_STEP);
+    const auto silence_samples = static_cast<std::size_t>(silence.count() * AUDIO_SAMPLE_RATE / 1'000'000);
+    silence_.assign(silence_samples * AUDIO_CHANNELS_NUM, 0.0f);
+    SDL_PutAudioStreamData(stream_, silence_.data(), static_cast<int>(silence_.size() * sizeof(float)));
+#ifdef STREAMING_PIPELINE_STATS
+    audio_stats_.record_silence(silence);
+#endif
+  }
+  SDL_PutAudioStreamData(stream_, samples.data(), static_cast<int>(samples.size() * sizeof(float)));
+}
+} // namespace streaming
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "streaming_common/audio_decoder.hpp"
+#include "streaming_common/av_sync.hpp"
+#ifdef STREAMING_PIPELINE_STATS
+# include "streaming_common/pipeline_stats.hpp"
+#endif
+
+#include <SDL3/SDL.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+namespace streaming {
+/**
+ * Decodes the audio stream and plays it on the default SDL playback device, in step with the video.
+ *
+ * Audio running ahead of the video is held back by queueing silence, audio running behind catches up by dropping
+ * packets. Both only act beyond a tolerance well below the audible lip sync threshold, and in small steps so the
+ * corrections are not heard as gaps.
+ */
+class AudioPlayer {
+public:
+  /**
+   * Opens the playback device. Without one the player decodes but plays nothing, so a receiver without audio output
+   * still shows the video.
+   */
+  explicit AudioPlayer(std::shared_ptr<AvSync> av_sync);
+  ~AudioPlayer();
+
+  AudioPlayer(const AudioPlayer &) = delete;
+  AudioPlayer &operator=(const AudioPlayer &) = delete;
+  AudioPlayer(AudioPlayer &&other) noexcept = delete;
+  AudioPlayer &operator=(AudioPlayer &&other) noexcept = delete;
+
+  /**
+   * Decodes and queues one Opus packet stamped with `timestamp_us` by the streamer.
+   */
+  void play(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us);
+
+#ifdef STREAMING_PIPELINE_STATS
+  void set_stats_log(std::FILE *out) noexcept;
+#endif
+
+private:
+  std::shared_ptr<AvSync> av_sync_;
+  AudioDecoder decoder_{};
+  SDL_AudioStream *stream_{};
+  std::vector<float> silence_{};
+
+#ifdef STREAMING_PIPELINE_STATS
+  AudioStats audio_stats_{};
+#endif
+};
+} // namespace streaming
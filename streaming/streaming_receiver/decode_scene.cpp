@@ -4,14 +4,21 @@
 #include "streaming_common/decoder.hpp"
 
 #include <gp/gl/misc.hpp>
+#include <gp/gl/state_cache.hpp>
 #include <gp/misc/event.hpp>
 
 #include <array>
 #include <chrono>
-#include <cstring>
+#include <cstdio>
 
 namespace streaming {
 namespace {
+constexpr auto JITTER_REPORT_INTERVAL = std::chrono::seconds{5};
+
+double average_ms(const std::chrono::microseconds total, const std::uint64_t count) {
+  return count > 0 ? static_cast<double>(total.count()) / 1000.0 / static_cast<double>(count) : 0.0;
+}
+
 template<typename... Ts>
 constexpr auto make_array(Ts &&...args) {
   return std::array<std::common_type_t<Ts...>, sizeof...(Ts)>{std::forward<Ts>(args)...};
@@ -28,20 +35,27 @@ void DecodeScene::init(const VideoStreamInfo &video_stream_info) {
   Scene3D::init(video_stream_info.width, video_stream_info.height, "Decoding...", async);
 }
 
-void DecodeScene::consume_data(const std::byte *data, const std::size_t size, const bool eof) {
+void DecodeScene::consume_data(const std::byte *data,
+                               const std::size_t size,
+                               const bool eof,
+                               const std::uint64_t timestamp_us) {
   if (size > 0) {
     const auto async = true;
-    decoder_->incoming_data(data, size, async);
+    decoder_->incoming_data(data, size, async, timestamp_us);
   }
   if (eof) {
     decoder_->signal_eof();
   }
 }
 
+void DecodeScene::set_jitter_buffer_mode(const JitterBuffer::Mode mode) noexcept { jitter_buffer_mode_ = mode; }
+
 void DecodeScene::set_event_callback(std::function<void(const gp::misc::Event &event)> event_callback) {
   event_callback_ = std::move(event_callback);
 }
 
+void DecodeScene::set_av_sync(std::shared_ptr<AvSync> av_sync) { av_sync_ = std::move(av_sync); }
+
 #ifdef STREAMING_PIPELINE_STATS
 void DecodeScene::set_stats_log(std::FILE *const out) noexcept { decode_stats_.set_output(out); }
 
@@ -76,25 +90,25 @@ void DecodeScene::loop(const gp::misc::Event &event) {
 }
 
 void DecodeScene::initialize() {
+  // Frames become due at the jitter buffer's playout times, polling at twice the stream rate shows each within half a
+  // frame interval while waiting for events in between instead of spinning.
+  set_loop_mode(gp::sdl::internal::SDLContext::LoopMode::Paced, 2.0 * video_stream_info_.fps);
+
   init_streaming();
   init_scene();
 
   const auto frame_size = static_cast<GLsizeiptr>(video_stream_info_.width) * video_stream_info_.height * CHANNELS_NUM;
-  for (auto &pbo : pbo_) {
-    pbo = std::make_unique<gp::gl::BufferObject>(GL_PIXEL_UNPACK_BUFFER);
-    pbo->bind();
-    pbo->set_data(frame_size, nullptr, GL_STREAM_DRAW);
-    pbo->unbind();
-  }
+  upload_buffer_ = std::make_unique<gp::gl::StreamingBuffer>(
+      GL_PIXEL_UNPACK_BUFFER, gp::gl::StreamingBuffer::aligned(frame_size) * 3, gp::gl::StreamingBuffer::Access::Write);
 }
 
 void DecodeScene::finalize() {
-  pbo_[0].reset();
-  pbo_[1].reset();
+  upload_buffer_.reset();
   shader_program_.reset();
   frame_texture_.reset();
   vertex_buffer_.reset();
   vao_.reset();
+  jitter_buffer_.reset();
   display_frame_.reset();
   rgb_frame_.reset();
   decoder_.reset();
@@ -102,9 +116,8 @@ void DecodeScene::finalize() {
 }
 
 void DecodeScene::decode() {
-  // Drain all available frames per Redraw; only the latest is displayed.
-  // This prevents a growing backlog from causing the receiver to lag behind
-  // the real-time stream by an ever-increasing number of frames.
+  // Drain all available frames per Redraw into the jitter buffer, which decides what to display. In zero-delay mode
+  // that is only the latest, so a growing backlog cannot make the receiver lag behind the real-time stream.
   for (;;) {
     const auto status = decoder_->decode();
     switch (status.code) {
@@ -117,8 +130,7 @@ void DecodeScene::decode() {
                                .yuv_to_rgb_us = dec_t.yuv_to_rgb_us};
     }
 #endif
-      rgb_frame_->swap(*display_frame_);
-      frame_ready_ = true;
+      jitter_buffer_->push(*rgb_frame_, status.timestamp_us);
       break;
     case Decoder::Status::Code::RETRY:
       break;
@@ -135,9 +147,14 @@ void DecodeScene::decode() {
 }
 
 bool DecodeScene::redraw() {
-  if (!frame_ready_) {
+  const auto frame_ready = jitter_buffer_->pop(*display_frame_);
+  report_jitter_stats();
+  if (!frame_ready) {
     return false;
   }
+  if (av_sync_ && jitter_buffer_->presented_timestamp_us() != 0) {
+    av_sync_->video_presented(jitter_buffer_->presented_timestamp_us());
+  }
 
   constexpr auto format = CHANNELS_NUM == 4u ? GL_RGBA : GL_RGB;
 
@@ -146,44 +163,19 @@ bool DecodeScene::redraw() {
   const auto t0 = Clock::now();
 #endif
 
-  // Double-buffered PBO unpack: CPU fills write PBO while GPU uploads from read PBO.
-  const auto write_idx = pbo_index_;
-  const auto read_idx = 1 - pbo_index_;
-  pbo_index_ = 1 - pbo_index_;
-
-  pbo_[write_idx]->bind();
-  auto *dst = static_cast<std::byte *>(pbo_[write_idx]->map(GL_WRITE_ONLY));
-  if (dst) {
-    std::memcpy(dst, display_frame_->data(), display_frame_->size());
-    pbo_[write_idx]->unmap();
-  }
-  pbo_[write_idx]->unbind();
-
+  // The ring keeps the frames the GPU may still upload from untouched, so this frame is uploaded right away rather
+  // than one frame late.
   frame_texture_->bind();
-  if (pbo_primed_) {
-    // Kick async GPU texture upload from the previously filled PBO (returns immediately).
-    pbo_[read_idx]->bind();
-    frame_texture_->set_sub_image(0,
-                                  0,
-                                  0,
-                                  video_stream_info_.width,
-                                  video_stream_info_.height,
-                                  format,
-                                  GL_UNSIGNED_BYTE,
-                                  nullptr);
-    pbo_[read_idx]->unbind();
-  } else {
-    // First frame: read PBO not yet filled — upload directly so the first frame is visible.
-    frame_texture_->set_sub_image(0,
-                                  0,
-                                  0,
-                                  video_stream_info_.width,
-                                  video_stream_info_.height,
-                                  format,
-                                  GL_UNSIGNED_BYTE,
-                                  display_frame_->data());
-    pbo_primed_ = true;
-  }
+  frame_texture_->stream_sub_image(*upload_buffer_,
+                                   0,
+                                   0,
+                                   0,
+                                   video_stream_info_.width,
+                                   video_stream_info_.height,
+                                   format,
+                                   GL_UNSIGNED_BYTE,
+                                   display_frame_->data(),
+                                   static_cast<GLsizeiptr>(display_frame_->size()));
 
 #ifdef STREAMING_PIPELINE_STATS
   const auto t1 = Clock::now();
@@ -192,7 +184,7 @@ bool DecodeScene::redraw() {
 #endif
 
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glActiveTexture(GL_TEXTURE0);
+  gp::gl::state_cache().active_texture(GL_TEXTURE0);
   shader_program_->use();
   frame_texture_->bind();
   vao_->bind();
@@ -205,7 +197,6 @@ bool DecodeScene::redraw() {
   }
 #endif
 
-  frame_ready_ = false;
   return true;
 }
 
@@ -213,6 +204,38 @@ void DecodeScene::init_streaming() {
   decoder_->init(video_stream_info_);
   rgb_frame_ = decoder_->rgb_frame();
   display_frame_ = std::make_shared<FrameData>(video_stream_info_.width * video_stream_info_.height * CHANNELS_NUM);
+  jitter_buffer_ = std::make_unique<JitterBuffer>(video_stream_info_.fps, jitter_buffer_mode_, display_frame_->size());
+  last_jitter_stats_ = {};
+  last_jitter_report_ = JitterBuffer::Clock::now();
+}
+
+void DecodeScene::report_jitter_stats() {
+  const auto now = JitterBuffer::Clock::now();
+  if (now - last_jitter_report_ < JITTER_REPORT_INTERVAL) {
+    return;
+  }
+  last_jitter_report_ = now;
+
+  // Arrival jitter is what presenting every frame as soon as it is decoded shows, presentation jitter what the
+  // jitter buffer made of it - both as the mean deviation of frame intervals from the stream's frame period.
+  const auto &stats = jitter_buffer_->stats();
+  const auto &before = last_jitter_stats_;
+  printf("Presentation (%s): arrival jitter %.2f ms, presentation jitter %.2f ms, delay %.1f ms, dropped %llu, "
+         "underruns %llu\n",
+         jitter_buffer_->mode() == JitterBuffer::Mode::Adaptive ? "adaptive delay" : "zero delay",
+         average_ms(stats.arrival_deviation - before.arrival_deviation,
+                    stats.arrival_intervals - before.arrival_intervals),
+         average_ms(stats.presentation_deviation - before.presentation_deviation,
+                    stats.presentation_intervals - before.presentation_intervals),
+         std::chrono::duration<double, std::milli>(stats.delay).count(),
+         static_cast<unsigned long long>(stats.frames_dropped - before.frames_dropped),
+         static_cast<unsigned long long>(stats.underruns - before.underruns));
+  last_jitter_stats_ = stats;
+
+  const auto &gl_stats = gp::gl::state_cache().last_frame_stats();
+  printf("GL binds per frame: %llu, %llu redundant skipped\n",
+         static_cast<unsigned long long>(gl_stats.calls),
+         static_cast<unsigned long long>(gl_stats.calls_redundant));
 }
 
 void DecodeScene::init_scene() {
@@ -250,9 +273,9 @@ void DecodeScene::init_scene() {
   frame_texture_->set_parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
   frame_texture_->set_parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-  constexpr auto fmt = CHANNELS_NUM == 4u ? GL_RGBA : GL_RGB;
-  frame_texture_
-      ->set_image(0, fmt, video_stream_info_.width, video_stream_info_.height, 0, fmt, GL_UNSIGNED_BYTE, nullptr);
+  // Immutable, the size of the stream never changes.
+  constexpr auto internal_format = CHANNELS_NUM == 4u ? GL_RGBA8 : GL_RGB8;
+  frame_texture_->set_storage(1, internal_format, video_stream_info_.width, video_stream_info_.height);
 
   shader_program_ = gp::gl::create_shader_program("shaders/texture_screen");
   shader_program_->use();
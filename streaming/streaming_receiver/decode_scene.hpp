@@ -1,7 +1,9 @@
 #pragma once
 
+#include "streaming_common/av_sync.hpp"
 #include "streaming_common/decoder.hpp"
 #include "streaming_common/frame_data.hpp"
+#include "streaming_common/jitter_buffer.hpp"
 #ifdef STREAMING_PIPELINE_STATS
 # include "streaming_common/pipeline_stats.hpp"
 #endif
@@ -9,13 +11,14 @@
 
 #include <gp/gl/buffer_object.hpp>
 #include <gp/gl/shader_program.hpp>
+#include <gp/gl/streaming_buffer.hpp>
 #include <gp/gl/texture_object.hpp>
 #include <gp/gl/vertex_array_object.hpp>
 #include <gp/misc/event.hpp>
 #include <gp/sdl/scene_3d.hpp>
 
-#include <array>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -26,9 +29,23 @@ public:
   DecodeScene();
 
   void init(const VideoStreamInfo &video_stream_info);
-  void consume_data(const std::byte *data, const std::size_t size, const bool eof = false);
-
+  /**
+   * @param timestamp_us Streamer timestamp of the packet the data belongs to, schedules the frame decoded from it.
+   */
+  void consume_data(const std::byte *data,
+                    const std::size_t size,
+                    const bool eof = false,
+                    const std::uint64_t timestamp_us = 0);
+
+  /**
+   * Selects how decoded frames are paced, must be called before init(). Zero delay by default.
+   */
+  void set_jitter_buffer_mode(const JitterBuffer::Mode mode) noexcept;
   void set_event_callback(std::function<void(const gp::misc::Event &event)> event_callback);
+  /**
+   * Reports every presented frame, so audio playback can follow the video.
+   */
+  void set_av_sync(std::shared_ptr<AvSync> av_sync);
 
 #ifdef STREAMING_PIPELINE_STATS
   void set_stats_log(std::FILE *out) noexcept;
@@ -44,6 +61,7 @@ private:
   void finalize();
   void decode();
   bool redraw();
+  void report_jitter_stats();
 
   void init_streaming();
   void init_scene();
@@ -55,16 +73,22 @@ private:
 
   std::shared_ptr<FrameData> rgb_frame_{};
   std::shared_ptr<FrameData> display_frame_{};
-  bool frame_ready_{};
+  JitterBuffer::Mode jitter_buffer_mode_{JitterBuffer::Mode::ZeroDelay};
+  std::unique_ptr<JitterBuffer> jitter_buffer_{};
+  JitterBuffer::Stats last_jitter_stats_{};
+  JitterBuffer::Clock::time_point last_jitter_report_{};
+
+  std::shared_ptr<AvSync> av_sync_{};
 
   std::unique_ptr<gp::gl::VertexArrayObject> vao_{};
   std::unique_ptr<gp::gl::BufferObject> vertex_buffer_{};
   std::unique_ptr<gp::gl::TextureObject> frame_texture_{};
   std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
 
-  std::array<std::unique_ptr<gp::gl::BufferObject>, 2> pbo_{};
-  int pbo_index_{0};
-  bool pbo_primed_{false};
+  /**
+   * Uploads go through a ring of three frames, a frame is written while the GPU may still read the previous ones.
+   */
+  std::unique_ptr<gp::gl::StreamingBuffer> upload_buffer_{};
 
   std::function<void(const gp::misc::Event &event)> event_callback_{};
 
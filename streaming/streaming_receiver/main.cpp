@@ -1,13 +1,19 @@
+#include "audio_player.hpp"
 #include "decode_scene.hpp"
 #include "receiver.hpp"
 
+#include "streaming_common/av_sync.hpp"
+
 #include <gp/utils/utils.hpp>
 
 #include <boost/program_options.hpp>
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <exception>
 #include <iostream>
+#include <memory>
 #include <string>
 
 struct ProgramSetup {
@@ -15,6 +21,8 @@ struct ProgramSetup {
 
   std::string ip{};
   std::uint16_t port{};
+  bool jitter_buffer{};
+  std::size_t layer{};
 #ifdef STREAMING_PIPELINE_STATS
   std::string stats_log{};
   uint32_t stats_reports{20};
@@ -26,6 +34,11 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
   desc.add_options()("help", "This help message");
   desc.add_options()("ip", boost::program_options::value<std::string>()->default_value("127.0.0.1"), "Server ip");
   desc.add_options()("port", boost::program_options::value<std::uint16_t>()->default_value(11100u), "Server port");
+  desc.add_options()("jitter-buffer",
+                     "Smooth presentation to the stream fps with an adaptive playout delay (default: zero delay)");
+  desc.add_options()("layer",
+                     boost::program_options::value<std::size_t>()->default_value(0u),
+                     "Simulcast layer to subscribe to, 0 = full resolution, each one halves it");
 #ifdef STREAMING_PIPELINE_STATS
   desc.add_options()("stats-log",
                      boost::program_options::value<std::string>()->default_value(""),
@@ -48,10 +61,16 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
   return {false,
           vm["ip"].as<std::string>(),
           vm["port"].as<std::uint16_t>(),
+          vm.count("jitter-buffer") > 0,
+          vm["layer"].as<std::size_t>(),
           vm["stats-log"].as<std::string>(),
           vm["stats-reports"].as<uint32_t>()};
 #else
-  return {false, vm["ip"].as<std::string>(), vm["port"].as<std::uint16_t>()};
+  return {false,
+          vm["ip"].as<std::string>(),
+          vm["port"].as<std::uint16_t>(),
+          vm.count("jitter-buffer") > 0,
+          vm["layer"].as<std::size_t>()};
 #endif
 }
 
@@ -64,13 +83,22 @@ int main(int argc, char *argv[]) {
   }
 
   auto decode_scene = std::make_unique<streaming::DecodeScene>();
+  // The player is opened with the first audio packet, streamers without audio leave the audio device alone. Declared
+  // ahead of the receiver, which calls into it until destroyed.
+  auto av_sync = std::make_shared<streaming::AvSync>();
+  std::unique_ptr<streaming::AudioPlayer> audio_player{};
+  auto audio_failed = false;
   auto receiver = std::make_shared<streaming::Receiver>(program_setup.ip, program_setup.port);
+  if (program_setup.jitter_buffer) {
+    decode_scene->set_jitter_buffer_mode(streaming::JitterBuffer::Mode::Adaptive);
+  }
+  receiver->request_layer(program_setup.layer);
 
   receiver->set_video_stream_info_callback(
       [&decode_scene](const streaming::VideoStreamInfo &video_stream_info) { decode_scene->init(video_stream_info); });
   receiver->set_incoming_video_stream_data_callback(
-      [&decode_scene](const std::byte *data, const std::size_t size, const bool eof) {
-        decode_scene->consume_data(data, size, eof);
+      [&decode_scene](const std::byte *data, const std::size_t size, const bool eof, const std::uint64_t timestamp_us) {
+        decode_scene->consume_data(data, size, eof, timestamp_us);
       });
   decode_scene->set_event_callback([&receiver](const gp::misc::Event &event) { receiver->handle_event(event); });
 
@@ -83,6 +111,25 @@ int main(int argc, char *argv[]) {
   decode_scene->set_max_stats_reports(program_setup.stats_reports);
 #endif
 
+  decode_scene->set_av_sync(av_sync);
+  receiver->set_incoming_audio_packet_callback(
+      [&](const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us) {
+        if (!audio_player && !audio_failed) {
+          try {
+            audio_player = std::make_unique<streaming::AudioPlayer>(av_sync);
+#ifdef STREAMING_PIPELINE_STATS
+            audio_player->set_stats_log(stats_file != nullptr ? stats_file : stdout);
+#endif
+          } catch (const std::exception &e) {
+            printf("Audio disabled: %s\n", e.what());
+            audio_failed = true;
+          }
+        }
+        if (audio_player) {
+          audio_player->play(data, size, timestamp_us);
+        }
+      });
+
   receiver->connect();
 
   const auto async_init = true;
@@ -1,5 +1,6 @@
 #include "receiver.hpp"
 
+#include "streaming_common/codec_presets.hpp"
 #include "streaming_common/constants.hpp"
 #include "streaming_common/stream_package_header.hpp"
 
@@ -7,6 +8,10 @@
 #include <gp/utils/utils.hpp>
 
 namespace streaming {
+namespace {
+constexpr auto FEC_REPORT_INTERVAL = std::chrono::seconds{5};
+} // namespace
+
 Receiver::Receiver(const std::string &server_ip, const std::uint16_t server_port)
     : receiver_id_{gp::utils::generate_random_string(16u)}
     , id_{std::string{RECEIVER_ID} + ":" + receiver_id_} {
@@ -37,17 +42,28 @@ void Receiver::handle_event(const gp::misc::Event &event) {
   }
 }
 
+void Receiver::request_layer(const std::size_t layer) {
+  requested_layer_.store(layer);
+  send_layer_request();
+}
+
 void Receiver::set_video_stream_info_callback(
     std::function<void(const VideoStreamInfo &video_stream_info)> video_stream_info_callback) {
   video_stream_info_callback_ = std::move(video_stream_info_callback);
 }
 
 void Receiver::set_incoming_video_stream_data_callback(
-    std::function<void(const std::byte *data, const std::size_t size, const bool eof)>
+    std::function<void(const std::byte *data, const std::size_t size, const bool eof, const std::uint64_t timestamp_us)>
         incoming_video_stream_data_callback) {
   incoming_video_stream_data_callback_ = std::move(incoming_video_stream_data_callback);
 }
 
+void Receiver::set_incoming_audio_packet_callback(
+    std::function<void(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us)>
+        incoming_audio_packet_callback) {
+  incoming_audio_packet_callback_ = std::move(incoming_audio_packet_callback);
+}
+
 void Receiver::init_web_socket(std::shared_ptr<rtc::WebSocket> web_socket) {
   auto weak_self = weak_from_this();
   web_socket->onOpen([weak_self]() {
@@ -81,7 +97,7 @@ void Receiver::init_web_socket(std::shared_ptr<rtc::WebSocket> web_socket) {
 void Receiver::on_web_socket_open() {
   printf("Connection established\n");
   connection_open_ = true;
-  command_request_video_stream_infos();
+  command_request_stream_assignment();
 }
 
 void Receiver::on_web_socket_closed() {
@@ -105,6 +121,13 @@ void Receiver::on_web_socket_string_message(std::string message) {
       std::string sdp = json.at("sdp");
 
       if (type == "offer") {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (id != streamer_info_.streamer_id) {
+            printf("Ignoring offer from unassigned streamer '%s'\n", id.c_str());
+            return;
+          }
+        }
         auto new_peer = create_peer(id);
         std::shared_ptr<Peer> peer;
         {
@@ -116,8 +139,8 @@ void Receiver::on_web_socket_string_message(std::string message) {
         peer->connection->setRemoteDescription(description);
         return;
       }
-    } else if (json.contains("video_stream_infos")) {
-      parse_video_stream_infos(json.at("video_stream_infos"));
+    } else if (json.contains("video_stream_assignment")) {
+      parse_video_stream_assignment(json.at("video_stream_assignment"));
       return;
     }
 
@@ -219,6 +242,8 @@ void Receiver::on_peer_data_channel(std::shared_ptr<rtc::DataChannel> data_chann
     std::lock_guard<std::mutex> lock(mutex_);
     peer_->data_channel = data_channel;
   }
+  fec_reassembler_.reset();
+  fragment_reassembler_.reset();
 
   auto weak_self = weak_from_this();
   data_channel->onOpen([weak_self]() {
@@ -249,7 +274,13 @@ void Receiver::on_peer_data_channel(std::shared_ptr<rtc::DataChannel> data_chann
       });
 }
 
-void Receiver::on_data_channel_open() { printf("Data channel opened\n"); }
+void Receiver::on_data_channel_open() {
+  printf("Data channel opened\n");
+  // Without a request the streamer sends the full resolution.
+  if (requested_layer_.load() > 0) {
+    send_layer_request();
+  }
+}
 
 void Receiver::on_data_channel_closed() { printf("Data channel closed\n"); }
 
@@ -262,36 +293,137 @@ void Receiver::on_data_channel_binary_message(rtc::binary message) {
 
   StreamPackageHeader header = StreamPackageHeader::deserialize(reinterpret_cast<const std::uint8_t *>(message.data()));
 
-  const auto *payload = message.data() + STREAM_PACKAGE_HEADER_SIZE;
-  const auto payload_size = message.size() - STREAM_PACKAGE_HEADER_SIZE;
-
-  if (incoming_video_stream_data_callback_ && payload_size > 0) {
-    incoming_video_stream_data_callback_(payload, payload_size, false);
-  }
-  if (header.eof && incoming_video_stream_data_callback_) {
-    incoming_video_stream_data_callback_(nullptr, 0, true);
+  // Audio has its own numbering, it is neither part of the video's reassembly nor of its acknowledgements.
+  if (header.audio) {
+    if (incoming_audio_packet_callback_) {
+      incoming_audio_packet_callback_(message.data() + STREAM_PACKAGE_HEADER_SIZE,
+                                      message.size() - STREAM_PACKAGE_HEADER_SIZE,
+                                      header.timestamp_us);
+    }
+    return;
   }
 
-  if (++ack_counter_ >= ACK_INTERVAL) {
-    ack_counter_ = 0;
-    std::shared_ptr<Peer> peer;
-    {
-      std::lock_guard<std::mutex> lock(mutex_);
-      peer = peer_;
+  if (header.fec) {
+    if (!fec_reassembler_) {
+      auto weak_self = weak_from_this();
+      fec_reassembler_ = std::make_unique<FecReassembler>(
+          [weak_self](const StreamPackageHeader &packet_header, const std::byte *data, const std::size_t size) {
+            if (auto self = weak_self.lock()) {
+              self->on_video_stream_packet(packet_header, data, size, true);
+            }
+          });
+      last_fec_report_ = std::chrono::steady_clock::now();
     }
-    if (peer && peer->data_channel && peer->data_channel->isOpen()) {
-      const auto json = nlohmann::json{
-          {"ack", {{"frame_num", header.frame_num}}}
-      };
-      peer->data_channel->send(json.dump());
+    fec_reassembler_->push(message.data(), message.size());
+    report_fec_stats();
+  } else {
+    if (!fragment_reassembler_) {
+      AVCodecID codec_id;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        codec_id = streamer_info_.video_stream_info.codec_id;
+      }
+      // Byte-stream codecs are parsed as data comes in, so a large keyframe starts decoding with its first slices.
+      const auto progressive = !codec_preset(codec_id).packetized;
+      auto weak_self = weak_from_this();
+      fragment_reassembler_ = std::make_unique<FragmentReassembler>(
+          progressive,
+          [weak_self](const StreamPackageHeader &packet_header,
+                      const std::byte *data,
+                      const std::size_t size,
+                      const bool packet_end) {
+            if (auto self = weak_self.lock()) {
+              self->on_video_stream_packet(packet_header, data, size, packet_end);
+            }
+          });
     }
+    fragment_reassembler_->push(message.data(), message.size());
+  }
+}
+
+void Receiver::on_video_stream_packet(const StreamPackageHeader &header,
+                                      const std::byte *data,
+                                      const std::size_t size,
+                                      const bool packet_end) {
+  if (incoming_video_stream_data_callback_ && size > 0) {
+    incoming_video_stream_data_callback_(data, size, false, header.timestamp_us);
+  }
+  if (packet_end && header.eof && incoming_video_stream_data_callback_) {
+    incoming_video_stream_data_callback_(nullptr, 0, true, header.timestamp_us);
+  }
+
+  // Only whole packets are acknowledged, not the fragments or shards they arrive in, nor packets FEC cannot recover.
+  if (!packet_end || ++ack_counter_ < ACK_INTERVAL) {
+    return;
+  }
+  ack_counter_ = 0;
+  std::shared_ptr<Peer> peer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer = peer_;
+  }
+  if (peer && peer->data_channel && peer->data_channel->isOpen()) {
+    const auto json = nlohmann::json{
+        {"ack", {{"frame_num", header.frame_num}}}
+    };
+    peer->data_channel->send(json.dump());
   }
 }
 
-void Receiver::on_data_channel_string_message(std::string /* message */) {
+void Receiver::report_fec_stats() {
+  const auto now = std::chrono::steady_clock::now();
+  if (now - last_fec_report_ < FEC_REPORT_INTERVAL) {
+    return;
+  }
+  last_fec_report_ = now;
+
+  const auto &stats = fec_reassembler_->stats();
+  printf("FEC: packets delivered %llu (%llu recovered), lost %llu; shards received %llu, rebuilt %llu, missing %llu\n",
+         static_cast<unsigned long long>(stats.packets_delivered),
+         static_cast<unsigned long long>(stats.packets_recovered),
+         static_cast<unsigned long long>(stats.packets_lost),
+         static_cast<unsigned long long>(stats.shards_received),
+         static_cast<unsigned long long>(stats.shards_rebuilt),
+         static_cast<unsigned long long>(stats.shards_missing));
+}
+
+void Receiver::on_data_channel_string_message(std::string message) {
+  try {
+    const auto json = nlohmann::json::parse(message);
+    if (json.contains("simulcast")) {
+      const auto &layers = json.at("simulcast").at("layers");
+      printf("Simulcast layers:\n");
+      for (std::size_t layer = 0; layer < layers.size(); ++layer) {
+        printf("  %zu: %dx%d, %lld kbit/s%s\n",
+               layer,
+               layers.at(layer).at("width").template get<int>(),
+               layers.at(layer).at("height").template get<int>(),
+               static_cast<long long>(layers.at(layer).at("bit_rate").template get<std::int64_t>() / BITRATE_kbits_1),
+               layer == requested_layer_.load() ? " (requested)" : "");
+      }
+      return;
+    }
+  } catch (const std::exception &e) {
+    printf("Error processing data channel message: %s\n", e.what());
+    return;
+  }
   printf("Received data channel string message\n");
 }
 
+void Receiver::send_layer_request() {
+  std::shared_ptr<Peer> peer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer = peer_;
+  }
+  if (peer && peer->data_channel && peer->data_channel->isOpen()) {
+    const auto json = nlohmann::json{
+        {"layer", {{"index", requested_layer_.load()}}}
+    };
+    peer->data_channel->send(json.dump());
+  }
+}
+
 std::shared_ptr<Receiver::Peer> Receiver::create_peer(const std::string &id) {
   auto peer = std::make_shared<Peer>();
   peer->id = id;
@@ -327,21 +459,10 @@ std::shared_ptr<Receiver::Peer> Receiver::create_peer(const std::string &id) {
   return peer;
 }
 
-void Receiver::command_request_video_stream_infos() {
-  const auto command_json = nlohmann::json{
-      {"type", "request_video_stream_infos"}
-  };
-  const auto json = nlohmann::json{
-      {"command", command_json}
-  };
-  web_socket_->send(json.dump());
-}
-
-void Receiver::command_request_video_stream(const std::string &streamer_id) {
+void Receiver::command_request_stream_assignment() {
   const auto command_json = nlohmann::json{
-      {    "type", "request_video_stream"},
-      {"streamer",            streamer_id},
-      {"receiver",           receiver_id_}
+      {  "type", "request_stream_assignment"},
+      {"codecs",     decodable_codec_names()}
   };
   const auto json = nlohmann::json{
       {"command", command_json}
@@ -349,27 +470,35 @@ void Receiver::command_request_video_stream(const std::string &streamer_id) {
   web_socket_->send(json.dump());
 }
 
-void Receiver::parse_video_stream_infos(const nlohmann::json &json_video_stream_infos) {
+void Receiver::parse_video_stream_assignment(const nlohmann::json &json_video_stream_assignment) {
   try {
-    streamer_infos_.clear();
-    for (auto it = json_video_stream_infos.begin(); it != json_video_stream_infos.end(); ++it) {
-      streamer_infos_.emplace_back();
-      streamer_infos_.back().streamer_id = it->at("streamer_id");
-      streamer_infos_.back().video_stream_info.width = it->at("width");
-      streamer_infos_.back().video_stream_info.height = it->at("height");
-      streamer_infos_.back().video_stream_info.fps = it->at("fps");
-      streamer_infos_.back().video_stream_info.codec_id = it->at("codec_id");
-      streamer_infos_.back().video_stream_info.codec_name = it->at("codec_name");
-
-      if (video_stream_info_callback_) {
-        video_stream_info_callback_(streamer_infos_.back().video_stream_info);
-      } else {
+    StreamerInfo streamer_info{};
+    streamer_info.streamer_id = json_video_stream_assignment.at("streamer_id");
+    streamer_info.video_stream_info.width = json_video_stream_assignment.at("width");
+    streamer_info.video_stream_info.height = json_video_stream_assignment.at("height");
+    streamer_info.video_stream_info.fps = json_video_stream_assignment.at("fps");
+    streamer_info.video_stream_info.codec_id = json_video_stream_assignment.at("codec_id");
+    streamer_info.video_stream_info.codec_name = json_video_stream_assignment.at("codec_name");
+    printf("Assigned to streamer '%s'\n", streamer_info.streamer_id.c_str());
+
+    bool reassigned{};
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      reassigned = !streamer_info_.streamer_id.empty();
+    }
+    // After the assigned streamer went away, the server only assigns one of the same stream parameters and the
+    // decoder keeps running.
+    if (!reassigned) {
+      if (!video_stream_info_callback_) {
         throw std::runtime_error("Video stream info callback not set");
       }
-      command_request_video_stream(streamer_infos_.back().streamer_id);
+      video_stream_info_callback_(streamer_info.video_stream_info);
     }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    streamer_info_ = std::move(streamer_info);
   } catch (const std::exception &e) {
-    printf("Error parsing video stream infos: %s\n", e.what());
+    printf("Error parsing video stream assignment: %s\n", e.what());
   }
 }
 } // namespace streaming
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "streaming_common/fec.hpp"
+#include "streaming_common/fragmentation.hpp"
+#include "streaming_common/stream_package_header.hpp"
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/misc/event.hpp>
@@ -8,12 +11,12 @@
 #include <rtc/rtc.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
-#include <vector>
 
 namespace streaming {
 class Receiver : public std::enable_shared_from_this<Receiver> {
@@ -27,11 +30,27 @@ public:
 
   void connect();
   void handle_event(const gp::misc::Event &event);
+  /**
+   * Subscribes to a layer of a simulcast stream, 0 is the full resolution. Sent once the data channel is open, the
+   * streamer clamps it to the layers it encodes and may still send a lower one while the link is congested.
+   */
+  void request_layer(const std::size_t layer);
   void set_video_stream_info_callback(
       std::function<void(const VideoStreamInfo &video_stream_info)> video_stream_info_callback);
-  void set_incoming_video_stream_data_callback(
-      std::function<void(const std::byte *data, const std::size_t size, const bool eof)>
-          incoming_video_stream_data_callback);
+  /**
+   * Called with the video stream data and the streamer's timestamp of the packet it belongs to.
+   */
+  void set_incoming_video_stream_data_callback(std::function<void(const std::byte *data,
+                                                                 const std::size_t size,
+                                                                 const bool eof,
+                                                                 const std::uint64_t timestamp_us)>
+                                                   incoming_video_stream_data_callback);
+  /**
+   * Called with each Opus packet of the audio stream and the streamer's timestamp.
+   */
+  void set_incoming_audio_packet_callback(
+      std::function<void(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us)>
+          incoming_audio_packet_callback);
 
 private:
   struct Peer {
@@ -67,23 +86,49 @@ private:
 
   [[nodiscard]] std::shared_ptr<Peer> create_peer(const std::string &id);
 
-  void command_request_video_stream_infos();
-  void command_request_video_stream(const std::string &streamer_id);
-  void parse_video_stream_infos(const nlohmann::json &json_video_stream_infos);
+  /**
+   * Asks the signaling server to assign the streamer of the lowest encode time among those of a codec this receiver can
+   * decode.
+   */
+  void command_request_stream_assignment();
+  void parse_video_stream_assignment(const nlohmann::json &json_video_stream_assignment);
+  /**
+   * Passes on video stream data, `packet_end` is set with the last bytes of a packet. Every ACK_INTERVAL complete
+   * packets are acknowledged to the streamer.
+   */
+  void on_video_stream_packet(const StreamPackageHeader &header,
+                              const std::byte *data,
+                              const std::size_t size,
+                              const bool packet_end);
+  void report_fec_stats();
+  void send_layer_request();
 
   const std::string receiver_id_{};
   const std::string id_{};
   std::atomic<bool> connection_open_{false};
   std::size_t ack_counter_{0};
+  std::atomic<std::size_t> requested_layer_{0};
+  /**
+   * Created on the first FEC shard, the streamer decides whether to protect its stream.
+   */
+  std::unique_ptr<FecReassembler> fec_reassembler_{};
+  /**
+   * Created on the first message of the reliable stream, once the assigned codec tells whether the decoder can take
+   * packets piecemeal.
+   */
+  std::unique_ptr<FragmentReassembler> fragment_reassembler_{};
+  std::chrono::steady_clock::time_point last_fec_report_{};
   rtc::Configuration configuration_{};
   std::string connection_url_;
   std::shared_ptr<rtc::WebSocket> web_socket_{};
   std::shared_ptr<Peer> peer_{};
-  std::vector<StreamerInfo> streamer_infos_{};
+  StreamerInfo streamer_info_{};
   mutable std::mutex mutex_{};
 
   std::function<void(const VideoStreamInfo &video_stream_info)> video_stream_info_callback_{};
-  std::function<void(const std::byte *data, const std::size_t size, const bool eof)>
+  std::function<void(const std::byte *data, const std::size_t size, const bool eof, const std::uint64_t timestamp_us)>
       incoming_video_stream_data_callback_{};
+  std::function<void(const std::byte *data, const std::size_t size, const std::uint64_t timestamp_us)>
+      incoming_audio_packet_callback_{};
 };
 } // namespace streaming
@@ -0,0 +1,360 @@
+#include "streaming_common/constants.hpp"
+
+#include <gp/ffmpeg/ffmpeg.hpp>
+
+#include <boost/program_options.hpp>
+
+#include <nlohmann/json.hpp>
+#include <rtc/rtc.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::literals::chrono_literals;
+
+struct ProgramSetup {
+  bool exit{};
+
+  std::string ip{};
+  std::uint16_t port{};
+  int streamers{};
+  int receivers{};
+  int duration_s{};
+  bool pair{};
+  bool broker{};
+};
+
+ProgramSetup process_args(const int argc, const char *const argv[]) {
+  boost::program_options::options_description desc("Options");
+  desc.add_options()("help", "This help message");
+  desc.add_options()("ip", boost::program_options::value<std::string>()->default_value("127.0.0.1"), "Server ip");
+  desc.add_options()("port", boost::program_options::value<std::uint16_t>()->default_value(11100u), "Server port");
+  desc.add_options()("streamers",
+                     boost::program_options::value<int>()->default_value(100),
+                     "Number of simulated streamers");
+  desc.add_options()("receivers",
+                     boost::program_options::value<int>()->default_value(1000),
+                     "Number of simulated receivers");
+  desc.add_options()("duration_s",
+                     boost::program_options::value<int>()->default_value(10),
+                     "How long to keep the clients connected");
+  desc.add_options()("no-pair", "Receivers only fetch the stream info list, without requesting streams");
+  desc.add_options()("broker", "Receivers ask the session broker for a streamer instead of picking one from the list");
+
+  boost::program_options::variables_map vm;
+  boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
+  boost::program_options::notify(vm);
+
+  if (vm.count("help")) {
+    desc.print(std::cout);
+    return {true};
+  }
+
+  return {false,
+          vm["ip"].as<std::string>(),
+          vm["port"].as<std::uint16_t>(),
+          vm["streamers"].as<int>(),
+          vm["receivers"].as<int>(),
+          vm["duration_s"].as<int>(),
+          !vm.count("no-pair"),
+          vm.count("broker") != 0U};
+}
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Placeholder session description - the server relays SDP without looking into it.
+ */
+constexpr auto LOAD_SDP = "v=0";
+
+/**
+ * Latency samples in microseconds, collected from the WebSocket threads.
+ */
+class LatencyStats {
+public:
+  void record(const Clock::duration latency) {
+    const auto lock = std::lock_guard{mutex_};
+    samples_.push_back(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+  }
+
+  void report(const char *name) {
+    const auto lock = std::lock_guard{mutex_};
+    if (samples_.empty()) {
+      printf("  %-22s no samples\n", name);
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    std::int64_t sum{};
+    for (const auto sample : samples_) {
+      sum += sample;
+    }
+    printf("  %-22s n=%6zu  min=%8" PRId64 "  avg=%8" PRId64 "  p99=%8" PRId64 "  max=%8" PRId64 " us\n",
+           name,
+           samples_.size(),
+           samples_.front(),
+           sum / static_cast<std::int64_t>(samples_.size()),
+           samples_[samples_.size() * 99 / 100],
+           samples_.back());
+  }
+
+private:
+  std::vector<std::int64_t> samples_{};
+  std::mutex mutex_{};
+};
+
+struct Stats {
+  std::atomic<std::uint64_t> opened{};
+  std::atomic<std::uint64_t> errors{};
+  std::atomic<std::uint64_t> messages_received{};
+  std::atomic<std::uint64_t> bytes_received{};
+  std::atomic<std::uint64_t> stream_info_lists{};
+  std::atomic<std::uint64_t> assignments{};
+  std::atomic<std::uint64_t> offers{};
+  std::atomic<std::uint64_t> answers{};
+  LatencyStats first_stream_info_list{};
+  LatencyStats request_to_offer{};
+};
+
+/**
+ * A WebSocket client speaking just enough of the signaling protocol to act as a streamer or a receiver.
+ */
+class LoadClient : public std::enable_shared_from_this<LoadClient> {
+public:
+  LoadClient(Stats &stats, const std::string &url, const bool streamer, const bool pair, const bool broker)
+      : stats_{stats}
+      , streamer_{streamer}
+      , pair_{pair}
+      , broker_{broker}
+      , url_{url} {}
+
+  void open() {
+    auto weak_self = weak_from_this();
+    web_socket_->onOpen([weak_self]() {
+      if (auto self = weak_self.lock()) {
+        self->on_open();
+      }
+    });
+    web_socket_->onError([weak_self](std::string /* error */) {
+      if (auto self = weak_self.lock()) {
+        self->stats_.errors++;
+      }
+    });
+    web_socket_->onMessage([](rtc::binary /* message */) {},
+                           [weak_self](std::string message) {
+                             if (auto self = weak_self.lock()) {
+                               self->on_message(message);
+                             }
+                           });
+    opened_at_ = Clock::now();
+    web_socket_->open(url_);
+  }
+
+  void close() { web_socket_->close(); }
+
+private:
+  void on_open() {
+    stats_.opened++;
+    if (streamer_) {
+      const auto video_stream_info_json = nlohmann::json{
+          {     "width",            1024},
+          {    "height",             768},
+          {       "fps",              30},
+          {  "codec_id", AV_CODEC_ID_H264},
+          {"codec_name",          "h264"}
+      };
+      const auto json = nlohmann::json{
+          {"video_stream_info", video_stream_info_json}
+      };
+      web_socket_->send(json.dump());
+      // Spread the reported encode times so that the broker has a load order to follow.
+      const auto encode_us = static_cast<double>(std::hash<std::string>{}(id()) % 10000u);
+      const auto load_json = nlohmann::json{
+          {"encode_us", encode_us}
+      };
+      const auto load_message_json = nlohmann::json{
+          {"load", load_json}
+      };
+      web_socket_->send(load_message_json.dump());
+    } else if (broker_) {
+      {
+        const auto lock = std::lock_guard{mutex_};
+        requested_at_ = Clock::now();
+      }
+      const auto command_json = nlohmann::json{
+          {  "type", "request_stream_assignment"},
+          {"codecs", nlohmann::json::array({"h264"})}
+      };
+      const auto json = nlohmann::json{
+          {"command", command_json}
+      };
+      web_socket_->send(json.dump());
+    } else {
+      const auto command_json = nlohmann::json{
+          {"type", "request_video_stream_infos"}
+      };
+      const auto json = nlohmann::json{
+          {"command", command_json}
+      };
+      web_socket_->send(json.dump());
+    }
+  }
+
+  void on_message(const std::string &message) {
+    stats_.messages_received++;
+    stats_.bytes_received += message.size();
+    const auto json = nlohmann::json::parse(message, nullptr, false);
+    if (json.is_discarded()) {
+      stats_.errors++;
+      return;
+    }
+
+    if (json.contains("video_stream_infos")) {
+      stats_.stream_info_lists++;
+      const auto &infos = json.at("video_stream_infos");
+      const auto lock = std::lock_guard{mutex_};
+      if (!received_list_) {
+        received_list_ = true;
+        stats_.first_stream_info_list.record(Clock::now() - opened_at_);
+      }
+      // Every list update retries until an offer arrives, like a real receiver does; receivers spread over the
+      // listed streamers, so most requests do not collide.
+      if (pair_ && !offered_ && !infos.empty()) {
+        if (requests_ == 0u) {
+          requested_at_ = Clock::now();
+        }
+        const auto &streamer = infos[(std::hash<std::string>{}(id()) + requests_++) % infos.size()];
+        const auto command_json = nlohmann::json{
+            {    "type", "request_video_stream"},
+            {"streamer", streamer.at("streamer_id")},
+            {"receiver",                    id()}
+        };
+        const auto request_json = nlohmann::json{
+            {"command", command_json}
+        };
+        web_socket_->send(request_json.dump());
+      }
+      return;
+    }
+
+    if (json.contains("video_stream_assignment")) {
+      stats_.assignments++;
+      return;
+    }
+
+    if (json.contains("request_video_stream")) {
+      // Streamer side - answer with a dummy offer which the server relays to the receiver.
+      const auto offer_json = nlohmann::json{
+          {  "id", json.at("request_video_stream").at("receiver")},
+          {"type",                                      "offer"},
+          { "sdp",                                      LOAD_SDP}
+      };
+      web_socket_->send(offer_json.dump());
+      return;
+    }
+
+    if (json.contains("type") && json.contains("id")) {
+      const auto type = json.at("type").get<std::string>();
+      if (type == "offer") {
+        stats_.offers++;
+        {
+          const auto lock = std::lock_guard{mutex_};
+          offered_ = true;
+          stats_.request_to_offer.record(Clock::now() - requested_at_);
+        }
+        const auto answer_json = nlohmann::json{
+            {  "id", json.at("id")},
+            {"type",      "answer"},
+            { "sdp",       LOAD_SDP}
+        };
+        web_socket_->send(answer_json.dump());
+      } else if (type == "answer") {
+        stats_.answers++;
+      }
+    }
+  }
+
+  std::string id() const { return url_.substr(url_.rfind(':') + 1); }
+
+  Stats &stats_;
+  const bool streamer_;
+  const bool pair_;
+  const bool broker_;
+  const std::string url_;
+  std::shared_ptr<rtc::WebSocket> web_socket_{std::make_shared<rtc::WebSocket>()};
+
+  Clock::time_point opened_at_{};
+  Clock::time_point requested_at_{};
+  bool received_list_{};
+  bool offered_{};
+  std::size_t requests_{};
+  std::mutex mutex_{};
+};
+
+int main(int argc, char *argv[]) {
+  const auto program_setup = process_args(argc, argv);
+  if (program_setup.exit) {
+    return 1;
+  }
+
+  rtc::InitLogger(rtc::LogLevel::Warning);
+
+  const auto base_url = std::string{"ws://"} + program_setup.ip + ":" + std::to_string(program_setup.port) + "/";
+  Stats stats{};
+  std::vector<std::shared_ptr<LoadClient>> clients{};
+  clients.reserve(static_cast<std::size_t>(program_setup.streamers + program_setup.receivers));
+
+  const auto t_start = Clock::now();
+  // Streamers first, so that receivers find a populated list; connections are opened in batches so that the test
+  // measures the server rather than a SYN flood.
+  constexpr int batch_size = 100;
+  for (int i = 0; i < program_setup.streamers + program_setup.receivers; ++i) {
+    const auto streamer = i < program_setup.streamers;
+    const auto *label = streamer ? streaming::STREAMER_ID : streaming::RECEIVER_ID;
+    const auto url = base_url + label + ":load" + std::to_string(i);
+    auto client = std::make_shared<LoadClient>(stats, url, streamer, program_setup.pair, program_setup.broker);
+    client->open();
+    clients.push_back(std::move(client));
+    if ((i + 1) % batch_size == 0) {
+      std::this_thread::sleep_for(10ms);
+    }
+  }
+  printf("%zu clients started in %.3f s\n",
+         clients.size(),
+         std::chrono::duration<double>(Clock::now() - t_start).count());
+
+  std::this_thread::sleep_for(std::chrono::seconds{program_setup.duration_s});
+  const auto seconds = std::chrono::duration<double>(Clock::now() - t_start).count();
+
+  printf("--- Signaling load test (%d streamers, %d receivers, %.1f s) ---\n",
+         program_setup.streamers,
+         program_setup.receivers,
+         seconds);
+  printf("  connections opened     %" PRIu64 "\n", stats.opened.load());
+  printf("  errors                 %" PRIu64 "\n", stats.errors.load());
+  printf("  messages received      %" PRIu64 " (%.0f/s, %.1f MB)\n",
+         stats.messages_received.load(),
+         stats.messages_received.load() / seconds,
+         stats.bytes_received.load() / (1024.0 * 1024.0));
+  printf("  stream info lists      %" PRIu64 "\n", stats.stream_info_lists.load());
+  printf("  broker assignments     %" PRIu64 "\n", stats.assignments.load());
+  printf("  offers / answers       %" PRIu64 " / %" PRIu64 "\n", stats.offers.load(), stats.answers.load());
+  stats.first_stream_info_list.report("open -> first list");
+  stats.request_to_offer.report("request -> offer");
+
+  for (auto &client : clients) {
+    client->close();
+  }
+  std::this_thread::sleep_for(1s);
+  return 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <version>
+
+namespace streaming {
+/**
+ * Shared pointer which can be loaded and replaced concurrently. It publishes immutable snapshots that readers use
+ * without taking a lock.
+ *
+ * Standard libraries without std::atomic<std::shared_ptr> (libc++) use the shared_ptr atomic free functions instead.
+ */
+template<typename T>
+class AtomicSharedPtr {
+public:
+  AtomicSharedPtr(const AtomicSharedPtr &) = delete;
+  AtomicSharedPtr &operator=(const AtomicSharedPtr &) = delete;
+  AtomicSharedPtr(AtomicSharedPtr &&other) noexcept = delete;
+  AtomicSharedPtr &operator=(AtomicSharedPtr &&other) noexcept = delete;
+
+  explicit AtomicSharedPtr(std::shared_ptr<T> ptr = {})
+      : ptr_{std::move(ptr)} {}
+
+  [[nodiscard]] std::shared_ptr<T> load() const noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    return ptr_.load(std::memory_order_acquire);
+#else
+# if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wdeprecated-declarations"
+# endif
+    return std::atomic_load_explicit(&ptr_, std::memory_order_acquire);
+# if defined(__clang__)
+#  pragma clang diagnostic pop
+# endif
+#endif
+  }
+
+  void store(std::shared_ptr<T> ptr) noexcept {
+#if defined(__cpp_lib_atomic_shared_ptr)
+    ptr_.store(std::move(ptr), std::memory_order_release);
+#else
+# if defined(__clang__)
+#  pragma clang diagnostic push
+#  pragma clang diagnostic ignored "-Wdeprecated-declarations"
+# endif
+    std::atomic_store_explicit(&ptr_, std::move(ptr), std::memory_order_release);
+# if defined(__clang__)
+#  pragma clang diagnostic pop
+# endif
+#endif
+  }
+
+private:
+#if defined(__cpp_lib_atomic_shared_ptr)
+  std::atomic<std::shared_ptr<T>> ptr_;
+#else
+  std::shared_ptr<T> ptr_;
+#endif
+};
+} // namespace streaming
@@ -29,4 +29,12 @@ void Client::Info::parse(std::string path) {
 Client::Type Client::Info::type() const { return type_; }
 
 const std::string &Client::Info::id() const { return id_; }
+
+void Client::send(const std::string &message) const {
+  if (web_socket) {
+    web_socket->send(message);
+  } else if (send_function) {
+    send_function(message);
+  }
+}
 } // namespace streaming
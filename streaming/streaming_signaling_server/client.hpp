@@ -3,6 +3,7 @@
 #include <rtc/rtc.hpp>
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -33,7 +34,13 @@ struct Client {
     std::string id_{};
   };
 
+  /**
+   * Sends a text message over the WebSocket, or through send_function for in-process clients without a socket.
+   */
+  void send(const std::string &message) const;
+
   std::shared_ptr<rtc::WebSocket> web_socket{};
+  std::function<void(const std::string &message)> send_function{};
   Info info{};
 };
 } // namespace streaming
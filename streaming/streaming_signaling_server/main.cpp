@@ -1,10 +1,17 @@
+#include "relay_benchmark.hpp"
 #include "server.hpp"
 
+#include <gp/utils/utils.hpp>
+
 #include <boost/program_options.hpp>
 
+#include <rtc/rtc.hpp>
+
 #include <iostream>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <vector>
 
 using namespace std::literals::chrono_literals;
 
@@ -12,12 +19,30 @@ struct ProgramSetup {
   bool exit{};
 
   std::uint16_t port{};
+  unsigned int threads{};
+  bool benchmark{};
+  std::vector<int> benchmark_threads{};
+  int benchmark_pairs{};
+  int benchmark_duration_ms{};
 };
 
 ProgramSetup process_args(const int argc, const char *const argv[]) {
   boost::program_options::options_description desc("Options");
   desc.add_options()("help", "This help message");
   desc.add_options()("port", boost::program_options::value<std::uint16_t>()->default_value(11100u), "Listening port");
+  desc.add_options()("threads",
+                     boost::program_options::value<unsigned int>()->default_value(0u),
+                     "Number of worker threads handling client messages, 0 for the library default");
+  desc.add_options()("benchmark", "Measure in-process SDP relay throughput instead of listening");
+  desc.add_options()("benchmark_threads",
+                     boost::program_options::value<std::string>()->default_value("1,4,16"),
+                     "Comma separated list of thread counts to benchmark");
+  desc.add_options()("benchmark_pairs",
+                     boost::program_options::value<int>()->default_value(256),
+                     "Number of streamer/receiver pairs exchanging offers and answers");
+  desc.add_options()("benchmark_duration_ms",
+                     boost::program_options::value<int>()->default_value(3000),
+                     "Duration of each benchmark run");
 
   boost::program_options::variables_map vm;
   boost::program_options::store(boost::program_options::parse_command_line(argc, argv, desc), vm);
@@ -28,7 +53,18 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
     return {true};
   }
 
-  return {false, vm["port"].as<std::uint16_t>()};
+  std::vector<int> benchmark_threads{};
+  for (const auto &threads : gp::utils::split_by(vm["benchmark_threads"].as<std::string>(), ",")) {
+    benchmark_threads.push_back(std::stoi(threads));
+  }
+
+  return {false,
+          vm["port"].as<std::uint16_t>(),
+          vm["threads"].as<unsigned int>(),
+          vm.count("benchmark") != 0U,
+          benchmark_threads,
+          vm["benchmark_pairs"].as<int>(),
+          vm["benchmark_duration_ms"].as<int>()};
 }
 
 auto should_exit = std::atomic_bool{false};
@@ -44,12 +80,43 @@ void wait_for_exit() {
   }
 }
 
+void benchmark(const ProgramSetup &program_setup) {
+  printf("--- SDP relay benchmark (%d pairs, %d ms per run) ---\n",
+         program_setup.benchmark_pairs,
+         program_setup.benchmark_duration_ms);
+  printf("%8s %14s %9s %6s\n", "threads", "messages/s", "speedup", "lost");
+  double single_thread_rate{};
+  for (const auto threads : program_setup.benchmark_threads) {
+    const auto result = streaming::run_relay_benchmark(threads,
+                                                       program_setup.benchmark_pairs,
+                                                       std::chrono::milliseconds{program_setup.benchmark_duration_ms});
+    if (single_thread_rate == 0.0) {
+      single_thread_rate = result.messages_per_second;
+    }
+    printf("%8d %14.0f %8.2fx %6llu\n",
+           threads,
+           result.messages_per_second,
+           single_thread_rate > 0.0 ? result.messages_per_second / single_thread_rate : 0.0,
+           result.lost_messages);
+  }
+}
+
 int main(int argc, char *argv[]) {
   const auto program_setup = process_args(argc, argv);
   if (program_setup.exit) {
     return 1;
   }
 
+  if (program_setup.benchmark) {
+    benchmark(program_setup);
+    return 0;
+  }
+
+  if (program_setup.threads > 0) {
+    // Client callbacks, including message handling, run on the library's thread pool.
+    rtc::SetThreadPoolSize(program_setup.threads);
+  }
+
   try {
     streaming::Server server(program_setup.port);
     std::thread wait_thread(wait_for_exit);
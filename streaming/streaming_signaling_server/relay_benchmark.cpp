@@ -0,0 +1,119 @@
+#include "relay_benchmark.hpp"
+
+#include "server.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace streaming {
+namespace {
+/**
+ * Session description of the size a data channel only peer connection produces; the server relays it untouched.
+ */
+constexpr auto BENCHMARK_SDP = "v=0\r\n"
+                               "o=rtc 3767197920 0 IN IP4 127.0.0.1\r\n"
+                               "s=-\r\n"
+                               "t=0 0\r\n"
+                               "a=group:BUNDLE 0\r\n"
+                               "a=group:LS 0\r\n"
+                               "a=msid-semantic:WMS *\r\n"
+                               "a=ice-options:ice2,trickle\r\n"
+                               "a=fingerprint:sha-256 "
+                               "5E:1A:9B:3F:57:8C:0D:22:41:6E:AA:90:7B:C3:18:F4:"
+                               "2D:65:B0:E9:34:71:C8:5A:0F:96:D3:28:4B:E7:1C:80\r\n"
+                               "m=application 9 UDP/DTLS/SCTP webrtc-datachannel\r\n"
+                               "c=IN IP4 0.0.0.0\r\n"
+                               "a=mid:0\r\n"
+                               "a=sendrecv\r\n"
+                               "a=sctp-port:5000\r\n"
+                               "a=max-message-size:262144\r\n"
+                               "a=setup:actpass\r\n"
+                               "a=ice-ufrag:Zy3b\r\n"
+                               "a=ice-pwd:Vq1tP0cY8r2mJxL6wK4nH7sD\r\n";
+
+struct alignas(64) ReceivedCounter {
+  std::atomic<std::uint64_t> messages{};
+};
+
+std::shared_ptr<Client> make_client(Server &server, const std::string &path, ReceivedCounter &counter) {
+  auto client = std::make_shared<Client>();
+  client->info.parse(path);
+  client->send_function = [&counter](const std::string & /* message */) {
+    counter.messages.fetch_add(1, std::memory_order_relaxed);
+  };
+  server.add_client(client);
+  return client;
+}
+
+std::string make_sdp_message(const std::string &id, const char *type) {
+  const auto json = nlohmann::json{
+      {  "id",            id},
+      {"type",          type},
+      { "sdp", BENCHMARK_SDP}
+  };
+  return json.dump();
+}
+} // namespace
+
+RelayBenchmarkResult run_relay_benchmark(const int threads, const int pairs, const std::chrono::milliseconds duration) {
+  using Clock = std::chrono::steady_clock;
+
+  const auto threads_num = std::max(threads, 1);
+  const auto pairs_num = static_cast<std::size_t>(std::max(pairs, threads_num));
+
+  Server server{};
+  auto counters = std::make_unique<ReceivedCounter[]>(pairs_num * 2);
+  std::vector<std::shared_ptr<Client>> streamers{};
+  std::vector<std::shared_ptr<Client>> receivers{};
+  std::vector<std::string> offers{};
+  std::vector<std::string> answers{};
+  for (std::size_t i = 0; i < pairs_num; ++i) {
+    const auto streamer_id = "bench_streamer" + std::to_string(i);
+    const auto receiver_id = "bench_receiver" + std::to_string(i);
+    streamers.push_back(make_client(server, std::string{"/"} + STREAMER_ID + ":" + streamer_id, counters[i * 2]));
+    receivers.push_back(make_client(server, std::string{"/"} + RECEIVER_ID + ":" + receiver_id, counters[i * 2 + 1]));
+    offers.push_back(make_sdp_message(receiver_id, "offer"));
+    answers.push_back(make_sdp_message(streamer_id, "answer"));
+  }
+
+  std::atomic_bool running{true};
+  std::atomic<std::uint64_t> sent{};
+  std::vector<std::thread> workers{};
+  workers.reserve(static_cast<std::size_t>(threads_num));
+  const auto t_start = Clock::now();
+  for (int t = 0; t < threads_num; ++t) {
+    workers.emplace_back([&, t]() {
+      std::uint64_t thread_sent{};
+      while (running.load(std::memory_order_relaxed)) {
+        for (auto i = static_cast<std::size_t>(t); i < pairs_num; i += static_cast<std::size_t>(threads_num)) {
+          server.on_message(streamers[i], offers[i]);
+          server.on_message(receivers[i], answers[i]);
+          thread_sent += 2;
+        }
+      }
+      sent += thread_sent;
+    });
+  }
+  std::this_thread::sleep_for(duration);
+  running = false;
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  const auto seconds = std::chrono::duration<double>(Clock::now() - t_start).count();
+
+  std::uint64_t received{};
+  for (std::size_t i = 0; i < pairs_num * 2; ++i) {
+    received += counters[i].messages.load();
+  }
+  return {static_cast<double>(received) / seconds, seconds, sent.load() - received};
+}
+} // namespace streaming
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <chrono>
+
+namespace streaming {
+struct RelayBenchmarkResult {
+  double messages_per_second{};
+  double seconds{};
+  /**
+   * Number of relayed messages that did not reach their target.
+   */
+  unsigned long long lost_messages{};
+};
+
+/**
+ * Measures SDP offer/answer relay throughput of an in-process Server, without sockets. Each of `threads` threads
+ * drives its share of `pairs` streamer/receiver pairs, which send offers and answers to each other for `duration`.
+ */
+RelayBenchmarkResult run_relay_benchmark(const int threads, const int pairs, const std::chrono::milliseconds duration);
+} // namespace streaming
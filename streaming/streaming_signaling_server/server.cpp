@@ -1,16 +1,146 @@
 #include "server.hpp"
 
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
 namespace streaming {
+namespace {
+bool same_stream(const VideoStreamInfo &a, const VideoStreamInfo &b) {
+  return a.width == b.width && a.height == b.height && a.fps == b.fps && a.codec_id == b.codec_id;
+}
+} // namespace
+
 Server::Server(std::uint16_t port)
-    : server_{
-          rtc::WebSocketServer::Configuration{port, false, {}, {}, {}}
-} {
+    : server_{std::make_unique<rtc::WebSocketServer>(rtc::WebSocketServer::Configuration{port, false, {}, {}, {}})} {
   auto on_client_function =
       std::function<void(std::shared_ptr<rtc::WebSocket>)>{std::bind(&Server::on_client, this, std::placeholders::_1)};
-  server_.onClient(on_client_function);
+  server_->onClient(on_client_function);
+  static_cast<void>(rebuild_video_stream_infos_message());
   printf("Listening on port: %i\n", port);
 }
 
+Server::Server()
+    : log_connections_{false} {
+  static_cast<void>(rebuild_video_stream_infos_message());
+}
+
+void Server::add_client(const std::shared_ptr<Client> &client) {
+  const auto &id = client->info.id();
+  switch (client->info.type()) {
+  case Client::Type::unknown:
+    printf("Unknown client connected\n  ignoring... connection will be closed\n");
+    return;
+  case Client::Type::streamer:
+    if (log_connections_) {
+      printf("Streamer '%s' connected\n", id.c_str());
+    }
+    break;
+  case Client::Type::receiver:
+    if (log_connections_) {
+      printf("Receiver '%s' connected\n", id.c_str());
+    }
+    break;
+  }
+
+  {
+    auto &shard = client_shard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto clients = std::make_shared<ClientMap>(*shard.clients.load());
+    (*clients)[id] = client;
+    shard.clients.store(std::move(clients));
+  }
+
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  if (client->info.type() == Client::Type::streamer) {
+    streamers_[id].id = id;
+    unpaired_streamers_.insert(id);
+  } else {
+    receivers_[id].id = id;
+    unpaired_receivers_.insert(id);
+  }
+}
+
+void Server::remove_client(const std::shared_ptr<Client> &client) {
+  const auto &id = client->info.id();
+  std::vector<Assignment> assignments;
+  auto list_changed = false;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    switch (client->info.type()) {
+    case Client::Type::unknown:
+      printf("Unknown client disconnected\n");
+      return;
+    case Client::Type::streamer:
+      if (log_connections_) {
+        printf("Streamer '%s' disconnected\n", id.c_str());
+      }
+      remove_streamer(id);
+      break;
+    case Client::Type::receiver:
+      if (log_connections_) {
+        printf("Receiver '%s' disconnected\n", id.c_str());
+      }
+      remove_receiver(id);
+      break;
+    }
+    assignments = assign_waiting_receivers();
+    list_changed = rebuild_video_stream_infos_message();
+  }
+
+  {
+    auto &shard = client_shard(id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto clients = std::make_shared<ClientMap>(*shard.clients.load());
+    // A reconnect may have replaced the entry already.
+    auto it = clients->find(id);
+    if (it != clients->end() && it->second == client) {
+      clients->erase(it);
+      shard.clients.store(std::move(clients));
+    }
+  }
+
+  send_assignments(assignments);
+  if (list_changed) {
+    send_video_stream_infos_to_unpaired_receivers();
+  }
+}
+
+void Server::on_message(const std::shared_ptr<Client> &client, const std::string &message) {
+  try {
+    // Parsing is the bulk of the work and touches no shared state.
+    auto json = nlohmann::json::parse(message);
+
+    if (json.contains("video_stream_info")) {
+      parse_video_stream_info(client, json.at("video_stream_info"));
+      return;
+    }
+
+    if (json.contains("command")) {
+      parse_command(client, json.at("command"));
+      return;
+    }
+
+    if (json.contains("load")) {
+      parse_load(client, json.at("load"));
+      return;
+    }
+
+    if (json.contains("id") && json.contains("type") && json.contains("sdp")) {
+      const auto &type = json.at("type");
+      if (type == "offer" || type == "answer") {
+        relay(client, json);
+        return;
+      }
+    }
+
+    printf("Unknown message: %s\n", message.c_str());
+  } catch (const std::exception &e) {
+    printf("Error processing message: %s\n", e.what());
+  }
+}
+
 void Server::on_client(std::shared_ptr<rtc::WebSocket> incoming) {
   auto client = std::make_shared<Client>();
   client->web_socket = incoming;
@@ -18,7 +148,7 @@ void Server::on_client(std::shared_ptr<rtc::WebSocket> incoming) {
   if (auto remote_address = client->web_socket->remoteAddress()) {
     printf("Client connection received: %s\n", remote_address->c_str());
     init_client(client);
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(registry_mutex_);
     temporary_store_.insert(client);
   }
 }
@@ -48,7 +178,7 @@ void Server::on_client_open(std::weak_ptr<Client> weak_client) {
   }
 
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(registry_mutex_);
     temporary_store_.erase(client);
   }
 
@@ -57,53 +187,18 @@ void Server::on_client_open(std::weak_ptr<Client> weak_client) {
 
     if (auto path = client->web_socket->path()) {
       client->info.parse(*path);
-
-      std::lock_guard<std::mutex> lock(mutex_);
-      switch (client->info.type()) {
-      case Client::Type::unknown:
-        printf("Unknown client connected\n  ignoring... connection will be closed\n");
-        break;
-      case Client::Type::streamer:
-        printf("Streamer '%s' connected\n", client->info.id().c_str());
-        clients_[client->info.id()] = client;
-        streamers_[client->info.id()].id = client->info.id();
-        break;
-      case Client::Type::receiver:
-        printf("Receiver '%s' connected\n", client->info.id().c_str());
-        clients_[client->info.id()] = client;
-        receivers_[client->info.id()].id = client->info.id();
-        break;
-      }
+      add_client(client);
     }
   }
 }
 
 void Server::on_client_closed(std::weak_ptr<Client> weak_client) {
-  auto type = Client::Type::unknown;
-  std::string id;
-
   auto client = weak_client.lock();
-  if (client) {
-    type = client->info.type();
-    id = client->info.id();
-  }
-
-  std::lock_guard<std::mutex> lock(mutex_);
-  switch (type) {
-  case Client::Type::unknown:
+  if (!client) {
     printf("Unknown client disconnected\n");
-    break;
-  case Client::Type::streamer:
-    printf("Streamer '%s' disconnected\n", id.c_str());
-    streamers_.erase(id);
-    clients_.erase(id);
-    break;
-  case Client::Type::receiver:
-    printf("Receiver '%s' disconnected\n", id.c_str());
-    receivers_.erase(id);
-    clients_.erase(id);
-    break;
+    return;
   }
+  remove_client(client);
 }
 
 void Server::on_client_error(std::weak_ptr<Client> weak_client, std::string error) const {
@@ -134,91 +229,53 @@ void Server::on_client_string_message(std::weak_ptr<Client> weak_client, std::st
   if (!client) {
     return;
   }
-
-  try {
-    auto json = nlohmann::json::parse(message);
-
-    if (json.contains("video_stream_info")) {
-      parse_video_stream_info(client, json.at("video_stream_info"));
-      send_video_stream_infos_to_unpaired_receivers();
-      return;
-    }
-
-    if (json.contains("command")) {
-      parse_command(client, json.at("command"));
-      return;
-    }
-
-    if (json.contains("id") && json.contains("type") && json.contains("sdp")) {
-      std::string id = json.at("id");
-      std::string type = json.at("type");
-      std::string sdp = json.at("sdp");
-
-      if (type == "offer") {
-        std::shared_ptr<Client> target_client;
-        {
-          std::lock_guard<std::mutex> lock(mutex_);
-          auto it = clients_.find(id);
-          if (it != clients_.end()) {
-            target_client = it->second;
-          }
-        }
-        if (!target_client) {
-          printf("Unknown message: %s\n", message.c_str());
-          return;
-        }
-        auto response_json = nlohmann::json{
-            {  "id", client->info.id()},
-            {"type",              type},
-            { "sdp",               sdp}
-        };
-        target_client->web_socket->send(response_json.dump());
-        return;
-      }
-      if (type == "answer") {
-        std::shared_ptr<Client> target_client;
-        {
-          std::lock_guard<std::mutex> lock(mutex_);
-          auto it = clients_.find(id);
-          if (it != clients_.end()) {
-            target_client = it->second;
-          }
-        }
-        if (!target_client) {
-          printf("Unknown message: %s\n", message.c_str());
-          return;
-        }
-        auto response_json = nlohmann::json{
-            {  "id", client->info.id()},
-            {"type",              type},
-            { "sdp",               sdp}
-        };
-        target_client->web_socket->send(response_json.dump());
-        return;
-      }
-    }
-
-    printf("Unknown message: %s\n", message.c_str());
-  } catch (const std::exception &e) {
-    printf("Error processing message: %s\n", e.what());
-  }
+  on_message(client, message);
 }
 
-void Server::parse_video_stream_info(std::shared_ptr<Client> &client, const nlohmann::json &json_video_stream_info) {
+void Server::parse_video_stream_info(const std::shared_ptr<Client> &client,
+                                     const nlohmann::json &json_video_stream_info) {
+  VideoStreamInfo video_stream_info{};
+  nlohmann::json video_stream_info_json{};
   try {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto &video_stream_info = streamers_[client->info.id()].video_stream_info;
     video_stream_info.width = json_video_stream_info.at("width");
     video_stream_info.height = json_video_stream_info.at("height");
     video_stream_info.fps = json_video_stream_info.at("fps");
     video_stream_info.codec_id = json_video_stream_info.at("codec_id");
     video_stream_info.codec_name = json_video_stream_info.at("codec_name");
+    video_stream_info_json = nlohmann::json{
+        {"streamer_id",            client->info.id()},
+        {      "width",      video_stream_info.width},
+        {     "height",     video_stream_info.height},
+        {        "fps",        video_stream_info.fps},
+        {   "codec_id",   video_stream_info.codec_id},
+        { "codec_name", video_stream_info.codec_name}
+    };
   } catch (const std::exception &e) {
     printf("Error parsing video stream info: %s\n", e.what());
+    return;
+  }
+
+  std::vector<Assignment> assignments;
+  auto list_changed = false;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto streamer_it = streamers_.find(client->info.id());
+    if (streamer_it == streamers_.end()) {
+      printf("Video stream info from unknown streamer '%s'\n", client->info.id().c_str());
+      return;
+    }
+    streamer_it->second.video_stream_info = std::move(video_stream_info);
+    streamer_it->second.video_stream_info_json = std::move(video_stream_info_json);
+    assignments = assign_waiting_receivers();
+    list_changed = rebuild_video_stream_infos_message();
+  }
+  send_assignments(assignments);
+  if (list_changed) {
+    send_video_stream_infos_to_unpaired_receivers();
   }
 }
 
-void Server::parse_command(std::shared_ptr<Client> &client, const nlohmann::json &json_command) {
+void Server::parse_command(const std::shared_ptr<Client> &client, const nlohmann::json &json_command) {
   try {
     const auto type = std::string{json_command.at("type")};
     if (type == "request_video_stream_infos") {
@@ -229,28 +286,29 @@ void Server::parse_command(std::shared_ptr<Client> &client, const nlohmann::json
       const auto streamer = std::string{json_command.at("streamer")};
       const auto receiver = std::string{json_command.at("receiver")};
 
-      std::shared_ptr<Client> streamer_client;
-      {
-        std::lock_guard<std::mutex> lock(mutex_);
-        auto it = clients_.find(streamer);
-        if (it != clients_.end()) {
-          streamer_client = it->second;
-        }
-      }
-
+      const auto streamer_client = find_client(streamer);
       if (!streamer_client) {
         printf("Unknown message: %s\n", json_command.dump().c_str());
         return;
       }
 
-      const auto request_video_stream_json = nlohmann::json{
-          {"streamer", streamer},
-          {"receiver", receiver}
-      };
-      const auto json = nlohmann::json{
-          {"request_video_stream", request_video_stream_json}
-      };
-      streamer_client->web_socket->send(json.dump());
+      auto list_changed = false;
+      {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        if (!pair(streamer, receiver)) {
+          printf("Streamer '%s' or receiver '%s' is already paired\n", streamer.c_str(), receiver.c_str());
+          return;
+        }
+        list_changed = rebuild_video_stream_infos_message();
+      }
+      if (list_changed) {
+        send_video_stream_infos_to_unpaired_receivers();
+      }
+      send_request_video_stream(streamer_client, streamer, receiver);
+      return;
+    }
+    if (type == "request_stream_assignment") {
+      request_stream_assignment(client, json_command);
       return;
     }
     printf("Unknown command: %s\n", json_command.dump().c_str());
@@ -259,49 +317,240 @@ void Server::parse_command(std::shared_ptr<Client> &client, const nlohmann::json
   }
 }
 
+void Server::parse_load(const std::shared_ptr<Client> &client, const nlohmann::json &json_load) {
+  double encode_us{};
+  try {
+    encode_us = json_load.at("encode_us");
+  } catch (const std::exception &e) {
+    printf("Error parsing load: %s\n", e.what());
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(registry_mutex_);
+  auto streamer_it = streamers_.find(client->info.id());
+  if (streamer_it != streamers_.end()) {
+    streamer_it->second.encode_us = encode_us;
+  }
+}
+
+void Server::request_stream_assignment(const std::shared_ptr<Client> &client, const nlohmann::json &json_command) {
+  std::vector<std::string> codecs{};
+  if (json_command.contains("codecs")) {
+    codecs = json_command.at("codecs").get<std::vector<std::string>>();
+  }
+
+  std::vector<Assignment> assignments;
+  auto list_changed = false;
+  {
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    auto receiver_it = receivers_.find(client->info.id());
+    if (receiver_it == receivers_.end() || receiver_it->second.paired || receiver_it->second.waiting) {
+      printf("Receiver '%s' is unknown, paired or already waiting\n", client->info.id().c_str());
+      return;
+    }
+    receiver_it->second.waiting = true;
+    receiver_it->second.codecs = std::move(codecs);
+    waiting_receivers_.push_back(receiver_it->first);
+    assignments = assign_waiting_receivers();
+    list_changed = rebuild_video_stream_infos_message();
+  }
+  send_assignments(assignments);
+  if (list_changed) {
+    send_video_stream_infos_to_unpaired_receivers();
+  }
+}
+
+void Server::relay(const std::shared_ptr<Client> &client, nlohmann::json &json) {
+  auto &id = json.at("id");
+  const auto target_client = find_client(id.get_ref<const std::string &>());
+  if (!target_client) {
+    printf("Unknown message: %s\n", json.dump().c_str());
+    return;
+  }
+  // The parsed message is forwarded as is, only the id is swapped for the sender's.
+  id = client->info.id();
+  target_client->send(json.dump());
+}
+
 void Server::send_video_stream_infos_to_unpaired_receivers() {
-  std::vector<std::shared_ptr<Client>> clients_to_update;
+  std::vector<std::string> receiver_ids;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &receiver_pair : receivers_) {
-      const auto &receiver = receiver_pair.second;
-      if (receiver.paired) {
-        continue;
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    receiver_ids.reserve(unpaired_receivers_.size());
+    for (const auto &receiver_id : unpaired_receivers_) {
+      // Receivers waiting for the broker do not pick streamers from the list.
+      if (!receivers_.at(receiver_id).waiting) {
+        receiver_ids.push_back(receiver_id);
       }
-      auto client_it = clients_.find(receiver.id);
-      if (client_it != clients_.end()) {
-        clients_to_update.push_back(client_it->second);
+    }
+  }
+  const auto message = video_stream_infos_message_.load();
+  for (const auto &receiver_id : receiver_ids) {
+    if (auto receiver_client = find_client(receiver_id)) {
+      receiver_client->send(*message);
+    }
+  }
+}
+
+void Server::send_video_stream_infos(const std::shared_ptr<Client> &client) {
+  client->send(*video_stream_infos_message_.load());
+}
+
+void Server::send_request_video_stream(const std::shared_ptr<Client> &streamer_client,
+                                       const std::string &streamer_id,
+                                       const std::string &receiver_id) {
+  const auto request_video_stream_json = nlohmann::json{
+      {"streamer", streamer_id},
+      {"receiver", receiver_id}
+  };
+  const auto json = nlohmann::json{
+      {"request_video_stream", request_video_stream_json}
+  };
+  streamer_client->send(json.dump());
+}
+
+void Server::send_assignments(const std::vector<Assignment> &assignments) {
+  for (const auto &assignment : assignments) {
+    printf("Receiver '%s' assigned to streamer '%s'\n", assignment.receiver_id.c_str(), assignment.streamer_id.c_str());
+    // The receiver learns the stream parameters first, then the streamer starts the offer/answer exchange.
+    if (auto receiver_client = find_client(assignment.receiver_id)) {
+      const auto json = nlohmann::json{
+          {"video_stream_assignment", assignment.video_stream_info_json}
+      };
+      receiver_client->send(json.dump());
+    }
+    if (auto streamer_client = find_client(assignment.streamer_id)) {
+      send_request_video_stream(streamer_client, assignment.streamer_id, assignment.receiver_id);
+    }
+  }
+}
+
+Server::ClientShard &Server::client_shard(const std::string &id) {
+  return client_shards_[std::hash<std::string>{}(id) % CLIENT_SHARDS_NUM];
+}
+
+std::shared_ptr<Client> Server::find_client(const std::string &id) {
+  const auto clients = client_shard(id).clients.load();
+  const auto it = clients->find(id);
+  return it != clients->end() ? it->second : nullptr;
+}
+
+bool Server::pair(const std::string &streamer_id, const std::string &receiver_id) {
+  auto streamer_it = streamers_.find(streamer_id);
+  auto receiver_it = receivers_.find(receiver_id);
+  if (streamer_it == streamers_.end() || receiver_it == receivers_.end() || streamer_it->second.paired ||
+      receiver_it->second.paired) {
+    return false;
+  }
+
+  streamer_it->second.paired = true;
+  streamer_it->second.receiver_id = receiver_id;
+  receiver_it->second.paired = true;
+  receiver_it->second.streamer_id = streamer_id;
+  receiver_it->second.waiting = false;
+  unpaired_streamers_.erase(streamer_id);
+  unpaired_receivers_.erase(receiver_id);
+  return true;
+}
+
+void Server::remove_streamer(const std::string &id) {
+  auto streamer_it = streamers_.find(id);
+  if (streamer_it == streamers_.end()) {
+    return;
+  }
+  if (streamer_it->second.paired) {
+    auto receiver_it = receivers_.find(streamer_it->second.receiver_id);
+    if (receiver_it != receivers_.end()) {
+      receiver_it->second.paired = false;
+      receiver_it->second.streamer_id.clear();
+      unpaired_receivers_.insert(receiver_it->first);
+      // Brokered receivers do not pick from the stream info list, they go back to the front of the queue.
+      if (receiver_it->second.assigned_stream) {
+        receiver_it->second.waiting = true;
+        waiting_receivers_.push_front(receiver_it->first);
       }
     }
   }
-  for (auto &receiver_client : clients_to_update) {
-    send_video_stream_infos(receiver_client);
+  unpaired_streamers_.erase(id);
+  streamers_.erase(streamer_it);
+}
+
+void Server::remove_receiver(const std::string &id) {
+  auto receiver_it = receivers_.find(id);
+  if (receiver_it == receivers_.end()) {
+    return;
+  }
+  if (receiver_it->second.paired) {
+    auto streamer_it = streamers_.find(receiver_it->second.streamer_id);
+    if (streamer_it != streamers_.end()) {
+      streamer_it->second.paired = false;
+      streamer_it->second.receiver_id.clear();
+      unpaired_streamers_.insert(streamer_it->first);
+    }
   }
+  unpaired_receivers_.erase(id);
+  receivers_.erase(receiver_it);
 }
 
-void Server::send_video_stream_infos(std::shared_ptr<Client> &client) {
-  auto video_stream_infos_json = nlohmann::json::array();
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto &streamer_pair : streamers_) {
-      const auto &streamer = streamer_pair.second;
-      if (streamer.paired) {
+std::vector<Server::Assignment> Server::assign_waiting_receivers() {
+  std::vector<Assignment> assignments{};
+  std::deque<std::string> still_waiting{};
+  for (const auto &receiver_id : waiting_receivers_) {
+    const auto receiver_it = receivers_.find(receiver_id);
+    if (receiver_it == receivers_.end() || !receiver_it->second.waiting) {
+      // Disconnected or paired explicitly in the meantime.
+      continue;
+    }
+    const auto &codecs = receiver_it->second.codecs;
+    const auto &assigned_stream = receiver_it->second.assigned_stream;
+
+    const StreamerInfo *least_loaded{};
+    for (const auto &streamer_id : unpaired_streamers_) {
+      const auto &streamer = streamers_.at(streamer_id);
+      if (streamer.video_stream_info_json.is_null()) {
         continue;
       }
-      const auto video_stream_info_json = nlohmann::json{
-          {"streamer_id",                           streamer.id},
-          {      "width",      streamer.video_stream_info.width},
-          {     "height",     streamer.video_stream_info.height},
-          {        "fps",        streamer.video_stream_info.fps},
-          {   "codec_id",   streamer.video_stream_info.codec_id},
-          { "codec_name", streamer.video_stream_info.codec_name}
-      };
-      video_stream_infos_json.push_back(video_stream_info_json);
+      if (!codecs.empty() &&
+          std::find(codecs.begin(), codecs.end(), streamer.video_stream_info.codec_name) == codecs.end()) {
+        continue;
+      }
+      if (assigned_stream && !same_stream(*assigned_stream, streamer.video_stream_info)) {
+        continue;
+      }
+      if (!least_loaded || streamer.encode_us < least_loaded->encode_us) {
+        least_loaded = &streamer;
+      }
+    }
+
+    if (!least_loaded) {
+      still_waiting.push_back(receiver_id);
+      continue;
+    }
+    assignments.push_back({least_loaded->id, receiver_id, least_loaded->video_stream_info_json});
+    receiver_it->second.assigned_stream = least_loaded->video_stream_info;
+    static_cast<void>(pair(least_loaded->id, receiver_id));
+  }
+  waiting_receivers_.swap(still_waiting);
+  return assignments;
+}
+
+bool Server::rebuild_video_stream_infos_message() {
+  auto video_stream_infos_json = nlohmann::json::array();
+  for (const auto &streamer_id : unpaired_streamers_) {
+    const auto &streamer = streamers_.at(streamer_id);
+    if (!streamer.video_stream_info_json.is_null()) {
+      video_stream_infos_json.push_back(streamer.video_stream_info_json);
     }
   }
   const auto json = nlohmann::json{
       {"video_stream_infos", video_stream_infos_json}
   };
-  client->web_socket->send(json.dump());
+  auto message = std::make_shared<const std::string>(json.dump());
+  const auto current_message = video_stream_infos_message_.load();
+  if (current_message && *current_message == *message) {
+    return false;
+  }
+  video_stream_infos_message_.store(std::move(message));
+  return true;
 }
 } // namespace streaming
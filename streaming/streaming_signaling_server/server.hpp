@@ -1,5 +1,6 @@
 #pragma once
 
+#include "atomic_shared_ptr.hpp"
 #include "client.hpp"
 
 #include "streaming_common/video_stream_info.hpp"
@@ -7,20 +8,53 @@
 #include <nlohmann/json.hpp>
 #include <rtc/rtc.hpp>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace streaming {
 struct StreamerInfo {
   std::string id{};
   bool paired{false};
+  std::string receiver_id{};
   VideoStreamInfo video_stream_info{};
+  /**
+   * Entry of the serialized stream info list, null until the streamer reports its video stream info.
+   */
+  nlohmann::json video_stream_info_json{};
+  /**
+   * Average encode time reported by the streamer. A streamer serves one receiver, so every candidate of the session
+   * broker is idle and the encode time, which grows with the other sessions sharing the streamer's encode pool and
+   * machine, is what tells them apart. 0 until the first report.
+   */
+  double encode_us{};
 };
 
 struct ReceiverInfo {
   std::string id{};
   bool paired{false};
+  std::string streamer_id{};
+  /**
+   * Set while the receiver waits for the session broker to assign it a streamer.
+   */
+  bool waiting{false};
+  /**
+   * Codec names the receiver can decode, empty if any codec is accepted.
+   */
+  std::vector<std::string> codecs{};
+  /**
+   * Set once the session broker assigned the receiver a streamer. If that streamer goes away the receiver waits for
+   * another one of the same stream parameters, as it cannot re-initialise its decoder for different ones.
+   */
+  std::optional<VideoStreamInfo> assigned_stream{};
 };
 
 class Server {
@@ -31,8 +65,45 @@ public:
   Server &operator=(Server &&other) noexcept = delete;
 
   explicit Server(std::uint16_t port);
+  /**
+   * Creates a server without a listening socket, driven by in-process clients (benchmarks) through add_client(),
+   * remove_client() and on_message(). Connection events are not logged.
+   */
+  Server();
+
+  /**
+   * Registers a client whose info has been parsed.
+   */
+  void add_client(const std::shared_ptr<Client> &client);
+  void remove_client(const std::shared_ptr<Client> &client);
+  /**
+   * Handles a text message from the client. Can be called concurrently from any number of threads.
+   */
+  void on_message(const std::shared_ptr<Client> &client, const std::string &message);
 
 private:
+  using ClientMap = std::unordered_map<std::string, std::shared_ptr<Client>>;
+
+  /**
+   * Partition of the connected clients, selected by the hash of the client id. Lookups read the current snapshot
+   * without locking; connects and disconnects copy it under the shard mutex and publish the new version.
+   */
+  struct ClientShard {
+    std::mutex mutex{};
+    AtomicSharedPtr<const ClientMap> clients{std::make_shared<const ClientMap>()};
+  };
+
+  /**
+   * A receiver paired with a streamer by the session broker, to be notified once the registry lock is released.
+   */
+  struct Assignment {
+    std::string streamer_id{};
+    std::string receiver_id{};
+    nlohmann::json video_stream_info_json{};
+  };
+
+  static constexpr std::size_t CLIENT_SHARDS_NUM = 16;
+
   void on_client(std::shared_ptr<rtc::WebSocket> incoming);
 
   void init_client(std::shared_ptr<Client> &client);
@@ -43,16 +114,57 @@ private:
   void on_client_binary_message(std::weak_ptr<Client> client, rtc::binary message) const;
   void on_client_string_message(std::weak_ptr<Client> client, std::string message);
 
-  void parse_video_stream_info(std::shared_ptr<Client> &client, const nlohmann::json &json_video_stream_info);
-  void parse_command(std::shared_ptr<Client> &client, const nlohmann::json &json_command);
+  void parse_video_stream_info(const std::shared_ptr<Client> &client, const nlohmann::json &json_video_stream_info);
+  void parse_load(const std::shared_ptr<Client> &client, const nlohmann::json &json_load);
+  void parse_command(const std::shared_ptr<Client> &client, const nlohmann::json &json_command);
+  void request_stream_assignment(const std::shared_ptr<Client> &client, const nlohmann::json &json_command);
+  /**
+   * Forwards an SDP offer or answer to the client named by its "id", which is replaced by the sender's id.
+   */
+  void relay(const std::shared_ptr<Client> &client, nlohmann::json &json);
   void send_video_stream_infos_to_unpaired_receivers();
-  void send_video_stream_infos(std::shared_ptr<Client> &client);
+  void send_video_stream_infos(const std::shared_ptr<Client> &client);
+  void send_request_video_stream(const std::shared_ptr<Client> &streamer_client,
+                                 const std::string &streamer_id,
+                                 const std::string &receiver_id);
+  void send_assignments(const std::vector<Assignment> &assignments);
+
+  ClientShard &client_shard(const std::string &id);
+  [[nodiscard]] std::shared_ptr<Client> find_client(const std::string &id);
+
+  // The helpers below expect registry_mutex_ to be held by the caller.
+  [[nodiscard]] bool pair(const std::string &streamer_id, const std::string &receiver_id);
+  void remove_streamer(const std::string &id);
+  void remove_receiver(const std::string &id);
+  /**
+   * Pairs waiting receivers, in request order, with the unpaired streamer of the lowest encode time among those of a
+   * codec they can decode, and of the stream parameters of their previous streamer if they had one. Receivers without
+   * a compatible streamer keep waiting.
+   */
+  [[nodiscard]] std::vector<Assignment> assign_waiting_receivers();
+  /**
+   * @return true if the list of unpaired streamers changed and has to be broadcast to unpaired receivers.
+   */
+  [[nodiscard]] bool rebuild_video_stream_infos_message();
+
+  std::unique_ptr<rtc::WebSocketServer> server_{};
+  const bool log_connections_{true};
+  std::array<ClientShard, CLIENT_SHARDS_NUM> client_shards_{};
 
-  rtc::WebSocketServer server_{};
   std::unordered_set<std::shared_ptr<Client>> temporary_store_{};
-  std::unordered_map<std::string, std::shared_ptr<Client>> clients_{};
   std::unordered_map<std::string, StreamerInfo> streamers_{};
   std::unordered_map<std::string, ReceiverInfo> receivers_{};
-  mutable std::mutex mutex_{};
+  std::unordered_set<std::string> unpaired_streamers_{};
+  std::unordered_set<std::string> unpaired_receivers_{};
+  std::deque<std::string> waiting_receivers_{};
+  /**
+   * Serialized "video_stream_infos" message listing all unpaired streamers. It is rebuilt once per change and the
+   * same string is sent to every receiver.
+   */
+  AtomicSharedPtr<const std::string> video_stream_infos_message_{};
+  /**
+   * Guards the pairing state. Message relay and stream info requests do not take it.
+   */
+  std::mutex registry_mutex_{};
 };
 } // namespace streaming
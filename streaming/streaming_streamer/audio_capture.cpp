@@ -0,0 +1,72 @@
+#include "audio_capture.hpp"
+
+#include "streaming_common/constants.hpp"
+#include "streaming_common/frame_pacer.hpp"
+
+#ifdef STREAMING_PIPELINE_STATS
+# include <chrono>
+#endif
+#include <cstdio>
+#include <exception>
+
+namespace streaming {
+namespace {
+constexpr auto AUDIO_FRAMES_PER_SECOND = static_cast<std::uint16_t>(1000 / AUDIO_FRAME_DURATION.count());
+} // namespace
+
+AudioCapture::AudioCapture(std::unique_ptr<AudioSource> source,
+                           std::function<void(const std::byte *data, const std::size_t size)> audio_stream_callback)
+    : source_(std::move(source))
+    , samples_(static_cast<std::size_t>(AUDIO_FRAME_SAMPLES) * AUDIO_CHANNELS_NUM) {
+  encoder_.set_audio_stream_callback(std::move(audio_stream_callback));
+}
+
+AudioCapture::~AudioCapture() { stop(); }
+
+void AudioCapture::start() {
+  if (running_.exchange(true)) {
+    return;
+  }
+  thread_ = std::thread([this]() { run(); });
+}
+
+void AudioCapture::stop() {
+  running_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+#ifdef STREAMING_PIPELINE_STATS
+void AudioCapture::set_stats_log(std::FILE *const out) noexcept { audio_encode_stats_.set_output(out); }
+#endif
+
+void AudioCapture::run() {
+  // Audio is produced at its sample rate rather than as fast as possible, the receiver plays it in real time.
+  auto pacer = FramePacer{AUDIO_FRAMES_PER_SECOND};
+  pacer.start();
+  try {
+    while (running_) {
+      if (pacer.frame_due()) {
+#ifdef STREAMING_PIPELINE_STATS
+        using Clock = std::chrono::steady_clock;
+        const auto t0 = Clock::now();
+#endif
+        source_->read(samples_.data());
+#ifdef STREAMING_PIPELINE_STATS
+        const auto read_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
+#endif
+        encoder_.encode(samples_.data());
+#ifdef STREAMING_PIPELINE_STATS
+        audio_encode_stats_.record({.read_us = read_us, .encode_us = encoder_.last_encode_time()},
+                                   pacer.dropped_frames());
+#endif
+      } else {
+        pacer.wait();
+      }
+    }
+  } catch (const std::exception &e) {
+    printf("Audio capture stopped: %s\n", e.what());
+  }
+}
+} // namespace streaming
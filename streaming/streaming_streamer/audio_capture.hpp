@@ -0,0 +1,59 @@
+#pragma once
+
+#include "audio_source.hpp"
+
+#include "streaming_common/audio_encoder.hpp"
+#ifdef STREAMING_PIPELINE_STATS
+# include "streaming_common/pipeline_stats.hpp"
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace streaming {
+/**
+ * Reads an AudioSource in real time on its own thread and encodes it, one AUDIO_FRAME_DURATION frame at a time.
+ */
+class AudioCapture {
+public:
+  /**
+   * @throw std::runtime_error if the audio encoder cannot be opened.
+   */
+  AudioCapture(std::unique_ptr<AudioSource> source,
+               std::function<void(const std::byte *data, const std::size_t size)> audio_stream_callback);
+  ~AudioCapture();
+
+  AudioCapture(const AudioCapture &) = delete;
+  AudioCapture &operator=(const AudioCapture &) = delete;
+  AudioCapture(AudioCapture &&other) noexcept = delete;
+  AudioCapture &operator=(AudioCapture &&other) noexcept = delete;
+
+  void start();
+  void stop();
+
+#ifdef STREAMING_PIPELINE_STATS
+  /**
+   * Must be called before start(), the stats are recorded on the capture thread.
+   */
+  void set_stats_log(std::FILE *out) noexcept;
+#endif
+
+private:
+  void run();
+
+  std::unique_ptr<AudioSource> source_;
+  AudioEncoder encoder_{};
+  std::vector<float> samples_{};
+  std::atomic<bool> running_{false};
+  std::thread thread_{};
+
+#ifdef STREAMING_PIPELINE_STATS
+  AudioEncodeStats audio_encode_stats_{};
+#endif
+};
+} // namespace streaming
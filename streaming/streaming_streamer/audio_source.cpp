@@ -0,0 +1,54 @@
+#include "audio_source.hpp"
+
+#include "streaming_common/constants.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+#include <stdexcept>
+
+namespace streaming {
+namespace {
+constexpr auto TONE_FREQUENCY = 440.0;
+constexpr auto TONE_AMPLITUDE = 0.1;
+constexpr auto BEEP_FREQUENCY = 1000.0;
+constexpr auto BEEP_AMPLITUDE = 0.3;
+constexpr auto BEEP_SAMPLES = std::size_t{AUDIO_SAMPLE_RATE / 20};
+constexpr auto FRAME_SAMPLES = std::size_t{AUDIO_FRAME_SAMPLES};
+constexpr auto SAMPLE_RATE = std::size_t{AUDIO_SAMPLE_RATE};
+constexpr auto FRAME_VALUES = FRAME_SAMPLES * AUDIO_CHANNELS_NUM;
+} // namespace
+
+void ToneAudioSource::read(float *samples) {
+  for (std::size_t i = 0; i < FRAME_SAMPLES; ++i, ++sample_) {
+    const auto t = static_cast<double>(sample_ % SAMPLE_RATE) / AUDIO_SAMPLE_RATE;
+    const auto beep = sample_ % SAMPLE_RATE < BEEP_SAMPLES;
+    const auto value = beep ? BEEP_AMPLITUDE * std::sin(2.0 * std::numbers::pi * BEEP_FREQUENCY * t)
+                            : TONE_AMPLITUDE * std::sin(2.0 * std::numbers::pi * TONE_FREQUENCY * t);
+    for (int channel = 0; channel < AUDIO_CHANNELS_NUM; ++channel) {
+      samples[i * AUDIO_CHANNELS_NUM + channel] = static_cast<float>(value);
+    }
+  }
+}
+
+FileAudioSource::FileAudioSource(const std::string &path)
+    : file_(path)
+    , samples_num_(file_.size() / (sizeof(float) * AUDIO_CHANNELS_NUM)) {
+  if (samples_num_ == 0) {
+    throw std::runtime_error{"Audio file '" + path + "' holds no samples"};
+  }
+}
+
+void FileAudioSource::read(float *samples) {
+  const auto *values = file_.data();
+  std::size_t written = 0;
+  while (written < FRAME_VALUES) {
+    const auto available = (samples_num_ - sample_) * AUDIO_CHANNELS_NUM;
+    const auto count = std::min(available, FRAME_VALUES - written);
+    std::memcpy(samples + written, values + sample_ * AUDIO_CHANNELS_NUM * sizeof(float), count * sizeof(float));
+    written += count;
+    sample_ = (sample_ + count / AUDIO_CHANNELS_NUM) % samples_num_;
+  }
+}
+} // namespace streaming
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "streaming_common/mapped_file.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace streaming {
+/**
+ * Produces interleaved float PCM at AUDIO_SAMPLE_RATE with AUDIO_CHANNELS_NUM channels, one frame at a time.
+ */
+class AudioSource {
+public:
+  virtual ~AudioSource() = default;
+
+  /**
+   * Fills `samples` with the next AUDIO_FRAME_SAMPLES samples per channel.
+   */
+  virtual void read(float *samples) = 0;
+};
+
+/**
+ * A quiet 440 Hz tone with a 1 kHz beep at the start of every second, which makes dropouts and timing audible.
+ */
+class ToneAudioSource : public AudioSource {
+public:
+  void read(float *samples) override;
+
+private:
+  std::size_t sample_{};
+};
+
+/**
+ * Loops a file of raw interleaved 32-bit float little-endian samples at AUDIO_SAMPLE_RATE with AUDIO_CHANNELS_NUM
+ * channels, e.g. made by `ffmpeg -i input -f f32le -ar 48000 -ac 2 output.raw`.
+ */
+class FileAudioSource : public AudioSource {
+public:
+  /**
+   * @throw std::runtime_error if the file cannot be mapped or holds no whole sample.
+   */
+  explicit FileAudioSource(const std::string &path);
+
+  void read(float *samples) override;
+
+private:
+  MappedFile file_;
+  std::size_t samples_num_{};
+  std::size_t sample_{};
+};
+} // namespace streaming
@@ -4,39 +4,61 @@
 #include "streaming_common/encoder.hpp"
 
 #include <gp/gl/misc.hpp>
+#include <gp/gl/state_cache.hpp>
 #include <gp/misc/event.hpp>
+#include <gp/misc/profiler.hpp>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <array>
 #include <chrono>
+#include <cstdio>
 #include <cstring>
 
 namespace streaming {
 namespace {
+constexpr auto SIMULCAST_REPORT_INTERVAL = std::chrono::seconds{5};
+
+double to_ms(const std::chrono::microseconds time, const std::uint64_t frames) {
+  return static_cast<double>(time.count()) / 1000.0 / static_cast<double>(frames);
+}
+
 template<typename... Ts>
 constexpr auto make_array(Ts &&...args) {
   return std::array<std::common_type_t<Ts...>, sizeof...(Ts)>{std::forward<Ts>(args)...};
 }
 } // namespace
 
-EncodeScene::EncodeScene(const VideoStreamInfo &video_stream_info)
-    : encoder_(std::make_shared<Encoder>(video_stream_info))
+EncodeScene::EncodeScene(const VideoStreamInfo &video_stream_info,
+                         const OutputMode output_mode,
+                         const std::size_t simulcast_layers)
+    : Scene3D(output_mode == OutputMode::Headless ? std::make_shared<gp::sdl::internal::SDLContext>("offscreen")
+                                                   : nullptr)
+    , encoder_(simulcast_layers > 1 ? nullptr : std::make_shared<Encoder>(video_stream_info))
+    , simulcast_encoder_(simulcast_layers > 1 ? std::make_shared<SimulcastEncoder>(video_stream_info, simulcast_layers)
+                                              : nullptr)
     , video_stream_info_(video_stream_info)
-    , ms_per_frame_(1000 / video_stream_info.fps) {
+    , output_mode_(output_mode)
+    , frame_pacer_(video_stream_info.fps) {
+  set_hidden_window(output_mode_ != OutputMode::Window);
   Scene3D::init(video_stream_info.width, video_stream_info.height, "Streamer...");
+#ifdef STREAMING_PIPELINE_STATS
+  encode_stats_.set_frame_period(std::chrono::duration_cast<std::chrono::microseconds>(frame_pacer_.frame_period()));
+#endif
 }
 
 std::shared_ptr<Encoder> EncodeScene::encoder() const { return encoder_; }
 
+std::shared_ptr<SimulcastEncoder> EncodeScene::simulcast_encoder() const { return simulcast_encoder_; }
+
 void EncodeScene::close() { close_requested_.store(true); }
 
 void EncodeScene::loop(const gp::misc::Event &event) {
   switch (event.type()) {
   case gp::misc::Event::Type::Init:
     initialize();
-    last_timestamp_ms_ = timestamp();
+    frame_pacer_.start();
     break;
   case gp::misc::Event::Type::Quit:
     finalize();
@@ -47,13 +69,20 @@ void EncodeScene::loop(const gp::misc::Event &event) {
       request_close();
       break;
     }
-    const auto time_elapsed_ms = event.timestamp() - last_timestamp_ms_;
-    if (time_elapsed_ms >= ms_per_frame_) {
-      animate(time_elapsed_ms);
+    // Frames are captured at steady_clock deadlines rather than whenever a Redraw happens to land past the frame
+    // period - evenly spaced input lets the encoder's rate control work as intended.
+    if (frame_pacer_.frame_due()) {
+      // Animation advances by the nominal period so motion stays uniform in the encoded stream.
+      animate(std::chrono::duration<float, std::milli>(frame_pacer_.frame_period()).count());
       redraw();
       encode();
-      swap_buffers();
-      last_timestamp_ms_ = event.timestamp();
+      if (!offscreen_target_) {
+        swap_buffers();
+      } else {
+        gp::gl::state_cache().end_frame();
+      }
+    } else {
+      frame_pacer_.wait();
     }
   } break;
   case gp::misc::Event::Type::Resize:
@@ -90,6 +119,11 @@ void EncodeScene::loop(const gp::misc::Event &event) {
   }
 }
 
+void EncodeScene::set_encode_time_callback(
+    std::function<void(std::chrono::microseconds encode_time)> encode_time_callback) {
+  encode_time_callback_ = std::move(encode_time_callback);
+}
+
 void EncodeScene::handle_event(const gp::misc::Event &event) {
   const auto lock_guard = std::lock_guard(event_queue_mutex_);
   event_queue_.emplace_back(event);
@@ -100,27 +134,40 @@ void EncodeScene::set_stats_log(std::FILE *const out) noexcept { encode_stats_.s
 #endif
 
 void EncodeScene::initialize() {
-  video_frame_ = encoder_->video_frame();
+  video_frame_ = simulcast_encoder_ ? simulcast_encoder_->video_frame() : encoder_->video_frame();
   init_scene();
 
-  const auto frame_size = static_cast<GLsizeiptr>(width()) * height() * CHANNELS_NUM;
-  for (auto &pbo : pbo_) {
-    pbo = std::make_unique<gp::gl::BufferObject>(GL_PIXEL_PACK_BUFFER);
-    pbo->bind();
-    pbo->set_data(frame_size, nullptr, GL_STREAM_READ);
-    pbo->unbind();
+  if (output_mode_ != OutputMode::Window) {
+    // Stays bound for both drawing and the readback, the default framebuffer is never used.
+    offscreen_target_ = std::make_unique<OffscreenTarget>(video_stream_info_.width, video_stream_info_.height);
+    offscreen_target_->bind();
   }
+
+  const auto frame_size = static_cast<GLsizeiptr>(video_frame_->size());
+  readback_buffer_ = std::make_unique<gp::gl::StreamingBuffer>(
+      GL_PIXEL_PACK_BUFFER, gp::gl::StreamingBuffer::aligned(frame_size) * 2, gp::gl::StreamingBuffer::Access::Read);
+
+#ifdef STREAMING_PIPELINE_STATS
+  render_timer_ = std::make_unique<gp::gl::GpuTimer>();
+  capture_timer_ = std::make_unique<gp::gl::GpuTimer>();
+#endif
 }
 
 void EncodeScene::finalize() {
-  pbo_[0].reset();
-  pbo_[1].reset();
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_.reset();
+  render_timer_.reset();
+#endif
+  pending_readback_.reset();
+  readback_buffer_.reset();
+  offscreen_target_.reset();
   shader_program_.reset();
   indices_buffer_.reset();
   vertex_buffer_.reset();
   vao_.reset();
   video_frame_.reset();
   encoder_.reset();
+  simulcast_encoder_.reset();
 }
 
 void EncodeScene::process_event_queue() {
@@ -134,7 +181,7 @@ void EncodeScene::process_event_queue() {
   }
 }
 
-void EncodeScene::animate(const std::uint64_t time_elapsed_ms) {
+void EncodeScene::animate(const float time_elapsed_ms) {
   if (!animate_) {
     return;
   }
@@ -144,9 +191,10 @@ void EncodeScene::animate(const std::uint64_t time_elapsed_ms) {
 }
 
 void EncodeScene::redraw() {
+  GP_PROFILE_ZONE("EncodeScene::redraw");
+  render_start_ = std::chrono::steady_clock::now();
 #ifdef STREAMING_PIPELINE_STATS
-  using Clock = std::chrono::steady_clock;
-  const auto t0 = Clock::now();
+  render_timer_->begin();
 #endif
 
   auto camera_rot_mat = glm::rotate(glm::mat4(1.0f), glm::radians(camera_rot_.x), glm::vec3(1.0f, 0.0f, 0.0f));
@@ -159,17 +207,20 @@ void EncodeScene::redraw() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
   shader_program_->use();
-  shader_program_->set_uniform("mvp", mvp_mat);
+  shader_program_->set_uniform(mvp_uniform_, mvp_mat);
 
   vao_->bind();
   glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
 
 #ifdef STREAMING_PIPELINE_STATS
-  last_render_us_ = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - t0);
+  render_timer_->end();
+  last_render_us_ =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - render_start_);
 #endif
 }
 
 void EncodeScene::encode() {
+  GP_PROFILE_ZONE("EncodeScene::encode");
   constexpr auto format = CHANNELS_NUM == 4u ? GL_RGBA : GL_RGB;
 
 #ifdef STREAMING_PIPELINE_STATS
@@ -177,32 +228,35 @@ void EncodeScene::encode() {
   const auto t0 = Clock::now();
 #endif
 
-  const auto write_idx = pbo_index_;
-  const auto read_idx = 1 - pbo_index_;
-  pbo_index_ = 1 - pbo_index_;
-
-  // Issue async readback for this frame — returns immediately; GPU writes into PBO concurrently
-  pbo_[write_idx]->bind();
-  glReadPixels(0, 0, video_stream_info_.width, video_stream_info_.height, format, GL_UNSIGNED_BYTE, nullptr);
-  pbo_[write_idx]->unbind();
+  // Issue async readback for this frame — returns immediately; GPU writes into the ring concurrently
+  const auto readback = readback_buffer_->allocate(static_cast<GLsizeiptr>(video_frame_->size()));
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_->begin();
+#endif
+  readback_buffer_->bind();
+  glReadPixels(0,
+               0,
+               video_stream_info_.width,
+               video_stream_info_.height,
+               format,
+               GL_UNSIGNED_BYTE,
+               reinterpret_cast<void *>(readback.offset));
+  readback_buffer_->unbind();
+  readback_buffer_->fence();
+#ifdef STREAMING_PIPELINE_STATS
+  capture_timer_->end();
+#endif
 
   auto mapped_ok = false;
-  if (pbo_primed_) {
-    // Previous PBO's readback has had a full frame cycle to complete — map and encode
-    pbo_[read_idx]->bind();
-    const auto *src = static_cast<const FrameSubType *>(pbo_[read_idx]->map(GL_READ_ONLY));
-    if (src) {
-      std::memcpy(video_frame_->data(), src, video_frame_->size());
-      pbo_[read_idx]->unmap();
-      mapped_ok = true;
-    }
-    pbo_[read_idx]->unbind();
+  if (pending_readback_) {
+    // Previous readback has had a full frame cycle to complete — its fence has most likely signaled
+    std::memcpy(video_frame_->data(), readback_buffer_->read(*pending_readback_), video_frame_->size());
+    readback_buffer_->release(*pending_readback_);
+    mapped_ok = true;
   }
-  pbo_primed_ = true;
+  pending_readback_ = readback;
 
-#ifdef STREAMING_PIPELINE_STATS
-  const auto t1 = Clock::now();
-#endif
+  const auto captured = std::chrono::steady_clock::now();
 
   if (mapped_ok) {
     const auto lag = frame_lag_.load();
@@ -212,23 +266,90 @@ void EncodeScene::encode() {
     } else if (lag > LAG_THROTTLE_LIGHT) {
       skip_interval = 2;
     }
-    if (skip_counter_ == 0) {
-      encoder_->encode();
+    if (const auto bit_rate = pending_bit_rate_.exchange(0); bit_rate > 0 && encoder_) {
+      encoder_->set_bit_rate(bit_rate);
+    }
+    // Congestion skips the frame right away, the lag throttle only catches up once ACKs report the backlog.
+    if (skip_counter_ == 0 && !congested_.load()) {
+      const auto encode_start = std::chrono::steady_clock::now();
+      if (simulcast_encoder_) {
+        simulcast_encoder_->encode();
+      } else {
+        encoder_->encode();
+      }
+      last_encode_time_ =
+          std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - encode_start);
+      if (encode_time_callback_) {
+        encode_time_callback_(last_encode_time_);
+      }
+      if (simulcast_encoder_) {
+        report_simulcast(std::chrono::duration_cast<std::chrono::microseconds>(captured - render_start_));
+      }
     }
     skip_counter_ = (skip_counter_ + 1) % skip_interval;
   }
 
 #ifdef STREAMING_PIPELINE_STATS
+  while (const auto gpu_time = render_timer_->poll()) {
+    encode_stats_.record_gpu_render(std::chrono::duration_cast<std::chrono::microseconds>(*gpu_time));
+  }
+  while (const auto gpu_time = capture_timer_->poll()) {
+    encode_stats_.record_gpu_capture(std::chrono::duration_cast<std::chrono::microseconds>(*gpu_time));
+  }
   if (mapped_ok) {
-    const auto &enc_t = encoder_->last_timings();
+    // The layers convert and encode in parallel, their wall time counts as the encode stage.
+    const auto enc_t = simulcast_encoder_ ? Encoder::Timings{.encode_us = last_encode_time_} : encoder_->last_timings();
     encode_stats_.record({.render_us = last_render_us_,
-                          .capture_us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0),
+                          .capture_us = std::chrono::duration_cast<std::chrono::microseconds>(captured - t0),
                           .rgb_to_yuv_us = enc_t.rgb_to_yuv_us,
-                          .encode_us = enc_t.encode_us});
+                          .encode_us = enc_t.encode_us,
+                          .interval_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                              frame_pacer_.last_interval())});
   }
 #endif
 }
 
+void EncodeScene::report_simulcast(const std::chrono::microseconds render_capture_time) {
+  simulcast_render_capture_time_ += render_capture_time;
+  const auto now = std::chrono::steady_clock::now();
+  if (last_simulcast_report_ == std::chrono::steady_clock::time_point{}) {
+    last_simulcast_report_ = now;
+    return;
+  }
+  if (now - last_simulcast_report_ < SIMULCAST_REPORT_INTERVAL) {
+    return;
+  }
+  last_simulcast_report_ = now;
+
+  const auto stats = simulcast_encoder_->stats();
+  const auto frames = stats.frames - reported_simulcast_stats_.frames;
+  if (frames == 0) {
+    return;
+  }
+  const auto render_capture_ms = to_ms(simulcast_render_capture_time_ - reported_render_capture_time_, frames);
+  auto layers_ms = 0.0;
+  printf("Simulcast, per frame over %llu frames:\n", static_cast<unsigned long long>(frames));
+  for (std::size_t layer = 0; layer < stats.layer_times.size(); ++layer) {
+    const auto layer_ms = to_ms(stats.layer_times[layer] - reported_simulcast_stats_.layer_times[layer], frames);
+    const auto info = simulcast_encoder_->video_stream_info(layer);
+    printf("  layer %zu (%dx%d): %.2f ms\n", layer, info.width, info.height, layer_ms);
+    layers_ms += layer_ms;
+  }
+  const auto layers_num = static_cast<double>(stats.layer_times.size());
+  // A process per resolution renders and captures on its own, the encodes cost about the same minus the scaling.
+  printf("  encode wall %.2f ms, render + capture %.2f ms\n"
+         "  CPU cost %.2f ms vs. ~%.2f ms as %zu separate processes (estimated with full-resolution render + capture "
+         "per process)\n",
+         to_ms(stats.wall_time - reported_simulcast_stats_.wall_time, frames),
+         render_capture_ms,
+         render_capture_ms + layers_ms,
+         render_capture_ms * layers_num + layers_ms,
+         stats.layer_times.size());
+
+  reported_simulcast_stats_ = stats;
+  reported_render_capture_time_ = simulcast_render_capture_time_;
+}
+
 void EncodeScene::init_scene() {
   glEnable(GL_DEPTH_TEST);
   glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -283,5 +404,6 @@ void EncodeScene::init_scene() {
   indices_buffer_->set_data(indices.size() * sizeof(indices[0]), indices.data(), GL_STATIC_DRAW);
 
   shader_program_ = gp::gl::create_shader_program("shaders/color_cube");
+  mvp_uniform_ = shader_program_->uniform_handle("mvp");
 }
 } // namespace streaming
@@ -2,40 +2,86 @@
 
 #include "streaming_common/encoder.hpp"
 #include "streaming_common/frame_data.hpp"
+#include "streaming_common/frame_pacer.hpp"
+#include "streaming_common/offscreen_target.hpp"
+#include "streaming_common/simulcast_encoder.hpp"
 #ifdef STREAMING_PIPELINE_STATS
 # include "streaming_common/pipeline_stats.hpp"
 #endif
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/gl/buffer_object.hpp>
+#include <gp/gl/gpu_timer.hpp>
 #include <gp/gl/shader_program.hpp>
+#include <gp/gl/streaming_buffer.hpp>
 #include <gp/gl/vertex_array_object.hpp>
-
-#include <array>
 #include <gp/sdl/scene_3d.hpp>
 
 #include <glm/glm.hpp>
 
-#ifdef STREAMING_PIPELINE_STATS
-# include <chrono>
-#endif
 #include <atomic>
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <vector>
 
 namespace streaming {
 class EncodeScene : public gp::sdl::Scene3D {
 public:
-  explicit EncodeScene(const VideoStreamInfo &video_stream_info);
-
+  enum class OutputMode {
+    /**
+     * Renders to the window, presentation is throttled by vsync and the compositor.
+     */
+    Window,
+    /**
+     * Renders into a framebuffer object, the window stays hidden and is never swapped.
+     */
+    Offscreen,
+    /**
+     * Like Offscreen, but on SDL's offscreen video driver: the context lives on an EGL pbuffer and no display server
+     * is needed, e.g. on CI machines with Mesa llvmpipe.
+     */
+    Headless
+  };
+
+  /**
+   * @param simulcast_layers More than 1 encodes every frame into that many resolutions with a SimulcastEncoder, whose
+   * cost is reported periodically.
+   */
+  explicit EncodeScene(const VideoStreamInfo &video_stream_info,
+                       const OutputMode output_mode = OutputMode::Window,
+                       const std::size_t simulcast_layers = 1);
+
+  /**
+   * Null in simulcast mode.
+   */
   std::shared_ptr<Encoder> encoder() const;
+  /**
+   * Null unless in simulcast mode.
+   */
+  std::shared_ptr<SimulcastEncoder> simulcast_encoder() const;
   void handle_event(const gp::misc::Event &event);
   void close();
 
   void set_lag(std::uint64_t lag) noexcept { frame_lag_.store(lag); }
+  /**
+   * Frames are not encoded while the streamer's send buffer is congested.
+   */
+  void set_congested(bool congested) noexcept { congested_.store(congested); }
+  /**
+   * The encoder takes the new bit rate before its next frame, may be called from any thread. Ignored in simulcast
+   * mode, whose layers have fixed bit rates.
+   */
+  void set_bit_rate(std::int64_t bit_rate) noexcept { pending_bit_rate_.store(bit_rate); }
+  /**
+   * Called on the render thread with the wall time of every encoded frame.
+   */
+  void set_encode_time_callback(std::function<void(std::chrono::microseconds encode_time)> encode_time_callback);
 
 #ifdef STREAMING_PIPELINE_STATS
   void set_stats_log(std::FILE *out) noexcept;
@@ -49,16 +95,18 @@ private:
   void initialize();
   void finalize();
   void process_event_queue();
-  void animate(const std::uint64_t time_elapsed_ms);
+  void animate(const float time_elapsed_ms);
   void redraw();
   void encode();
+  void report_simulcast(const std::chrono::microseconds render_capture_time);
 
   void init_scene();
 
   std::shared_ptr<Encoder> encoder_;
+  std::shared_ptr<SimulcastEncoder> simulcast_encoder_;
   const VideoStreamInfo video_stream_info_;
-  const int ms_per_frame_{};
-  std::uint64_t last_timestamp_ms_{};
+  const OutputMode output_mode_;
+  FramePacer frame_pacer_;
 
   std::shared_ptr<FrameData> video_frame_{};
 
@@ -71,20 +119,45 @@ private:
   std::unique_ptr<gp::gl::BufferObject> vertex_buffer_{};
   std::unique_ptr<gp::gl::BufferObject> indices_buffer_{};
   std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
+  gp::gl::UniformHandle mvp_uniform_{};
+  std::unique_ptr<OffscreenTarget> offscreen_target_{};
 
-  std::array<std::unique_ptr<gp::gl::BufferObject>, 2> pbo_{};
-  int pbo_index_{0};
-  bool pbo_primed_{false};
+  /**
+   * Readbacks land in a ring of two frames, a frame is read while the next one is being captured.
+   */
+  std::unique_ptr<gp::gl::StreamingBuffer> readback_buffer_{};
+  std::optional<gp::gl::StreamingBuffer::Allocation> pending_readback_{};
 
   std::vector<gp::misc::Event> event_queue_{};
   std::mutex event_queue_mutex_{};
 
   std::atomic<bool> close_requested_{false};
   std::atomic<std::uint64_t> frame_lag_{0};
+  std::atomic<bool> congested_{false};
+  /**
+   * 0 when there is no change pending.
+   */
+  std::atomic<std::int64_t> pending_bit_rate_{0};
   int skip_counter_{0};
+  std::function<void(std::chrono::microseconds encode_time)> encode_time_callback_{};
+
+  std::chrono::steady_clock::time_point render_start_{};
+  std::chrono::microseconds last_encode_time_{};
+  /**
+   * Encoder stats and render plus capture time as of the last simulcast report.
+   */
+  SimulcastEncoder::Stats reported_simulcast_stats_{};
+  std::chrono::microseconds simulcast_render_capture_time_{};
+  std::chrono::microseconds reported_render_capture_time_{};
+  std::chrono::steady_clock::time_point last_simulcast_report_{};
 
 #ifdef STREAMING_PIPELINE_STATS
   std::chrono::microseconds last_render_us_{};
+  /**
+   * GPU time of the draw calls and of the readback, the CPU times only cover issuing them.
+   */
+  std::unique_ptr<gp::gl::GpuTimer> render_timer_{};
+  std::unique_ptr<gp::gl::GpuTimer> capture_timer_{};
   EncodeStats encode_stats_{};
 #endif
 };
@@ -1,6 +1,9 @@
+#include "audio_capture.hpp"
+#include "audio_source.hpp"
 #include "encode_scene.hpp"
 #include "streamer.hpp"
 
+#include "streaming_common/stream_recorder.hpp"
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/ffmpeg/misc.hpp>
@@ -9,9 +12,11 @@
 
 #include <boost/program_options.hpp>
 
+#include <chrono>
 #include <cstdint>
 #include <cstdio>
 #include <iostream>
+#include <memory>
 #include <string>
 
 struct ProgramSetup {
@@ -24,6 +29,12 @@ struct ProgramSetup {
   std::uint16_t fps{};
   AVCodecID codec_id{AV_CODEC_ID_NONE};
   bool use_stun{true};
+  streaming::EncodeScene::OutputMode output_mode{streaming::EncodeScene::OutputMode::Window};
+  std::string record{};
+  std::size_t fec{};
+  bool audio{};
+  std::string audio_file{};
+  std::size_t simulcast{};
 #ifdef STREAMING_PIPELINE_STATS
   std::string stats_log{};
 #endif
@@ -41,8 +52,25 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
                      "Number of frames per second");
   desc.add_options()("codec",
                      boost::program_options::value<std::string>()->default_value("h264"),
-                     "Codec name, e.g. h264 or mpeg4");
+                     "Codec name: h264, hevc, av1, vp9 or mpeg4");
   desc.add_options()("no-stun", "Disable STUN server (use for local LAN connections)");
+  desc.add_options()("offscreen", "Render into a framebuffer object with a hidden window, not throttled by vsync");
+  desc.add_options()("headless", "Render offscreen on an EGL pbuffer without a display server (implies --offscreen)");
+  desc.add_options()("record",
+                     boost::program_options::value<std::string>()->default_value(""),
+                     "File path to record the encoded stream to, for offline replay (empty = no recording)");
+  desc.add_options()("fec",
+                     boost::program_options::value<std::size_t>()->default_value(0),
+                     "Send over an unordered channel without retransmissions, protecting every N shards with one "
+                     "parity shard (0 = reliable ordered channel)");
+  desc.add_options()("audio", "Stream a test tone as Opus audio alongside the video");
+  desc.add_options()("audio-file",
+                     boost::program_options::value<std::string>()->default_value(""),
+                     "Stream a raw f32le 48 kHz stereo file in a loop as Opus audio (implies --audio)");
+  desc.add_options()("simulcast",
+                     boost::program_options::value<std::size_t>()->default_value(1),
+                     "Encode every frame into N resolutions (up to 3, each halving the previous one), the receiver "
+                     "picks one with --layer (1 = single stream)");
 #ifdef STREAMING_PIPELINE_STATS
   desc.add_options()("stats-log",
                      boost::program_options::value<std::string>()->default_value(""),
@@ -58,6 +86,13 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
     return {true};
   }
 
+  auto output_mode = streaming::EncodeScene::OutputMode::Window;
+  if (vm.count("headless")) {
+    output_mode = streaming::EncodeScene::OutputMode::Headless;
+  } else if (vm.count("offscreen")) {
+    output_mode = streaming::EncodeScene::OutputMode::Offscreen;
+  }
+
   return {false,
           vm["ip"].as<std::string>(),
           vm["port"].as<std::uint16_t>(),
@@ -65,7 +100,13 @@ ProgramSetup process_args(const int argc, const char *const argv[]) {
           vm["height"].as<int>(),
           vm["fps"].as<std::uint16_t>(),
           gp::ffmpeg::codec_name_to_id(vm["codec"].as<std::string>()),
-          !vm.count("no-stun")
+          !vm.count("no-stun"),
+          output_mode,
+          vm["record"].as<std::string>(),
+          vm["fec"].as<std::size_t>(),
+          vm.count("audio") > 0 || !vm["audio-file"].as<std::string>().empty(),
+          vm["audio-file"].as<std::string>(),
+          vm["simulcast"].as<std::size_t>()
 #ifdef STREAMING_PIPELINE_STATS
               ,
           vm["stats-log"].as<std::string>()
@@ -87,7 +128,9 @@ int main(int argc, char *argv[]) {
                                                             program_setup.codec_id,
                                                             avcodec_get_name(program_setup.codec_id)};
 
-  auto encode_scene = std::make_unique<streaming::EncodeScene>(video_stream_info);
+  auto encode_scene =
+      std::make_unique<streaming::EncodeScene>(video_stream_info, program_setup.output_mode, program_setup.simulcast);
+  const auto simulcast_encoder = encode_scene->simulcast_encoder();
   auto streamer = std::make_shared<streaming::Streamer>(program_setup.ip, program_setup.port, program_setup.use_stun);
 
 #ifdef STREAMING_PIPELINE_STATS
@@ -101,10 +144,42 @@ int main(int argc, char *argv[]) {
   streamer->set_event_callback([&encode_scene](const gp::misc::Event &event) { encode_scene->handle_event(event); });
   streamer->set_close_callback([&encode_scene]() { encode_scene->close(); });
   streamer->set_feedback_callback([&encode_scene](std::uint64_t lag) { encode_scene->set_lag(lag); });
-  streamer->start(encode_scene->encoder());
+  streamer->set_congestion_callback([&encode_scene](bool congested) { encode_scene->set_congested(congested); });
+  streamer->set_bit_rate_callback([&encode_scene](std::int64_t bit_rate) { encode_scene->set_bit_rate(bit_rate); });
+  encode_scene->set_encode_time_callback(
+      [&streamer](std::chrono::microseconds encode_time) { streamer->report_encode_time(encode_time); });
+  if (!program_setup.record.empty()) {
+    streamer->set_stream_recorder(std::make_shared<streaming::StreamRecorder>(
+        program_setup.record,
+        simulcast_encoder ? simulcast_encoder->video_stream_info(0) : encode_scene->encoder()->video_stream_info()));
+  }
+  streamer->set_fec_group_size(program_setup.fec);
+  if (simulcast_encoder) {
+    streamer->start(simulcast_encoder);
+  } else {
+    streamer->start(encode_scene->encoder());
+  }
+
+  std::unique_ptr<streaming::AudioCapture> audio_capture{};
+  if (program_setup.audio) {
+    auto audio_source = program_setup.audio_file.empty()
+                            ? std::unique_ptr<streaming::AudioSource>{std::make_unique<streaming::ToneAudioSource>()}
+                            : std::make_unique<streaming::FileAudioSource>(program_setup.audio_file);
+    audio_capture = std::make_unique<streaming::AudioCapture>(
+        std::move(audio_source),
+        [&streamer](const std::byte *data, const std::size_t size) { streamer->audio_stream_callback(data, size); });
+#ifdef STREAMING_PIPELINE_STATS
+    audio_capture->set_stats_log(stats_file != nullptr ? stats_file : stdout);
+#endif
+    audio_capture->start();
+  }
 
   const auto result = encode_scene->exec();
 
+  if (audio_capture) {
+    audio_capture->stop();
+  }
+
 #ifdef STREAMING_PIPELINE_STATS
   if (stats_file != nullptr) {
     std::fclose(stats_file);
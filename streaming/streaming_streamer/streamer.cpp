@@ -2,15 +2,22 @@
 
 #include "streaming_common/constants.hpp"
 #include "streaming_common/encoder.hpp"
-#include "streaming_common/stream_package_header.hpp"
 
 #include <gp/json/misc.hpp>
 #include <gp/utils/utils.hpp>
 
 #include <cstring>
-#include <vector>
 
 namespace streaming {
+namespace {
+// Both streams are stamped on hand-off with the streamer's steady clock, so the receiver can align them.
+std::uint64_t stream_timestamp_us() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+          .count());
+}
+} // namespace
+
 Streamer::Streamer(const std::string &server_ip, const std::uint16_t server_port, const bool use_stun)
     : id_{std::string{STREAMER_ID} + ":" + gp::utils::generate_random_string(16u)}
     , connection_url_{std::string{"ws://"} + server_ip + ":" + std::to_string(server_port) + "/" + id_} {
@@ -24,15 +31,46 @@ Streamer::Streamer(const std::string &server_ip, const std::uint16_t server_port
   printf("Connection url: %s\n", connection_url_.c_str());
 }
 
+void Streamer::set_stream_recorder(std::shared_ptr<StreamRecorder> stream_recorder) {
+  stream_recorder_ = std::move(stream_recorder);
+}
+
+void Streamer::set_fec_group_size(const std::size_t group_size) {
+  fec_packetizer_ = group_size > 0 ? std::make_unique<FecPacketizer>(group_size) : nullptr;
+}
+
 void Streamer::start(std::shared_ptr<Encoder> encoder) {
-  video_stream_info_ = encoder->video_stream_info();
-  init_web_socket(web_socket_);
   auto weak_self = weak_from_this();
-  encoder->set_video_stream_callback([weak_self](const std::byte *data, const std::size_t size, const bool eof) {
+  encoder->set_video_stream_callback(
+      [weak_self, encoder = encoder.get()](const std::byte *data, const std::size_t size, const bool eof) {
+        if (auto self = weak_self.lock()) {
+          self->video_stream_callback(data, size, eof, encoder->packet_frame_num());
+        }
+      });
+  start(encoder->video_stream_info());
+}
+
+void Streamer::start(std::shared_ptr<SimulcastEncoder> simulcast_encoder) {
+  auto weak_self = weak_from_this();
+  simulcast_encoder->set_video_stream_callback([weak_self](const std::size_t layer,
+                                                           const std::byte *data,
+                                                           const std::size_t size,
+                                                           const bool eof,
+                                                           const bool keyframe,
+                                                           const std::uint64_t frame_num) {
     if (auto self = weak_self.lock()) {
-      self->video_stream_callback(data, size, eof);
+      self->simulcast_stream_callback(layer, data, size, eof, keyframe, frame_num);
     }
   });
+  simulcast_encoder_ = simulcast_encoder;
+  layers_num_ = simulcast_encoder->layers_num();
+  // The receiver's display has the full resolution, lower layers are scaled up by its decoder.
+  start(simulcast_encoder->video_stream_info(0));
+}
+
+void Streamer::start(const VideoStreamInfo &video_stream_info) {
+  video_stream_info_ = video_stream_info;
+  init_web_socket(web_socket_);
   web_socket_->open(connection_url_);
 }
 
@@ -46,6 +84,31 @@ void Streamer::set_feedback_callback(std::function<void(std::uint64_t lag)> feed
   feedback_callback_ = std::move(feedback_callback);
 }
 
+void Streamer::set_congestion_callback(std::function<void(bool congested)> congestion_callback) {
+  congestion_callback_ = std::move(congestion_callback);
+}
+
+void Streamer::set_bit_rate_callback(std::function<void(std::int64_t bit_rate)> bit_rate_callback) {
+  bit_rate_callback_ = std::move(bit_rate_callback);
+}
+
+void Streamer::report_encode_time(const std::chrono::microseconds encode_time) {
+  using Clock = std::chrono::steady_clock;
+  const auto now = Clock::now();
+  {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    // Exponential moving average, smooths out keyframes while following sustained changes within about a second.
+    constexpr auto smoothing = 1.0 / 32.0;
+    encode_us_ = encode_us_ == 0.0 ? static_cast<double>(encode_time.count())
+                                   : encode_us_ + (static_cast<double>(encode_time.count()) - encode_us_) * smoothing;
+    if (now - last_load_report_ < LOAD_REPORT_INTERVAL) {
+      return;
+    }
+    last_load_report_ = now;
+  }
+  send_load();
+}
+
 void Streamer::init_web_socket(std::shared_ptr<rtc::WebSocket> web_socket) {
   auto weak_self = weak_from_this();
   web_socket->onOpen([weak_self]() {
@@ -141,9 +204,14 @@ void Streamer::on_web_socket_string_message(std::string message) {
   }
 }
 
-void Streamer::on_data_channel_open() { printf("Data channel opened\n"); }
+void Streamer::on_data_channel_open() {
+  printf("Data channel opened\n");
+  send_simulcast_info();
+}
 
-void Streamer::on_data_channel_closed() { printf("Data channel closed\n"); }
+void Streamer::on_data_channel_closed() {
+  printf("Data channel closed\n");
+}
 
 void Streamer::on_data_channel_error(std::string error) { printf("Data channel error: %s\n", error.c_str()); }
 
@@ -160,6 +228,15 @@ void Streamer::on_data_channel_string_message(std::string message) {
       return;
     }
 
+    if (json.contains("layer")) {
+      const auto layer = json.at("layer").at("index").template get<std::size_t>();
+      std::lock_guard<std::mutex> lock(layer_mutex_);
+      subscribed_layer_ = std::min(layer, layers_num_ - 1);
+      printf("Simulcast: receiver subscribed to layer %zu\n", subscribed_layer_);
+      select_layer();
+      return;
+    }
+
     if (json.contains("ack")) {
       const auto acked_packet_num = json.at("ack").at("frame_num").template get<std::uint64_t>();
       const auto next = frame_num_.load();
@@ -177,6 +254,54 @@ void Streamer::on_data_channel_string_message(std::string message) {
   }
 }
 
+void Streamer::on_data_channel_buffered_amount_low() {
+  congestion_controller_.on_drained();
+  report_congestion();
+}
+
+void Streamer::update_congestion(const std::shared_ptr<rtc::DataChannel> &data_channel) {
+  const auto bit_rate = congestion_controller_.on_sent(data_channel->bufferedAmount());
+  // The buffer may have drained between the two reads, after the low notification already fired.
+  if (congestion_controller_.congested() && data_channel->bufferedAmount() <= SEND_BUFFER_LOW_WATERMARK) {
+    congestion_controller_.on_drained();
+  }
+  report_congestion();
+
+  if (!bit_rate) {
+    return;
+  }
+  printf("Send buffer: target bit rate %lld kbit/s\n", static_cast<long long>(*bit_rate / BITRATE_kbits_1));
+  // The layers are encoded at fixed rates, a lower target moves the receiver to a layer which fits it.
+  if (const auto simulcast_encoder = simulcast_encoder_.lock()) {
+    auto layer = layers_num_ - 1;
+    for (std::size_t candidate = 0; candidate < layers_num_; ++candidate) {
+      if (simulcast_encoder->bit_rate(candidate) <= *bit_rate) {
+        layer = candidate;
+        break;
+      }
+    }
+    // Simulcast sends hold layer_mutex_ already.
+    congestion_layer_ = layer;
+    select_layer();
+    return;
+  }
+  if (bit_rate_callback_) {
+    bit_rate_callback_(*bit_rate);
+  }
+}
+
+void Streamer::report_congestion() {
+  std::lock_guard<std::mutex> lock(congestion_mutex_);
+  const auto congested = congestion_controller_.congested();
+  if (congested == reported_congested_) {
+    return;
+  }
+  reported_congested_ = congested;
+  if (congestion_callback_) {
+    congestion_callback_(congested);
+  }
+}
+
 void Streamer::on_peer_state_change(rtc::PeerConnection::State state) {
   switch (state) {
   case rtc::PeerConnection::State::Connecting:
@@ -249,7 +374,31 @@ std::shared_ptr<Streamer::Peer> Streamer::create_peer(const std::string &id) {
     }
   });
 
-  peer->data_channel = peer->connection->createDataChannel(DATA_CHANNEL_ID);
+  // A new receiver may sit behind a different path, start over from the full rate.
+  congestion_controller_.reset();
+  report_congestion();
+  if (bit_rate_callback_) {
+    bit_rate_callback_(congestion_controller_.bit_rate());
+  }
+  {
+    // Until it subscribes, the receiver gets the full resolution, starting with a keyframe.
+    std::lock_guard<std::mutex> lock(layer_mutex_);
+    active_layer_.reset();
+    target_layer_ = 0;
+    subscribed_layer_ = 0;
+    congestion_layer_ = 0;
+    if (const auto simulcast_encoder = simulcast_encoder_.lock()) {
+      simulcast_encoder->request_keyframe(target_layer_);
+    }
+  }
+
+  auto data_channel_init = rtc::DataChannelInit{};
+  if (fec_packetizer_) {
+    // Lost shards are rebuilt from parity or the packet is given up on, a retransmission would arrive too late.
+    data_channel_init.reliability.unordered = true;
+    data_channel_init.reliability.maxRetransmits = 0;
+  }
+  peer->data_channel = peer->connection->createDataChannel(DATA_CHANNEL_ID, data_channel_init);
 
   peer->data_channel->onOpen([weak_self]() {
     if (auto self = weak_self.lock()) {
@@ -266,6 +415,12 @@ std::shared_ptr<Streamer::Peer> Streamer::create_peer(const std::string &id) {
       self->on_data_channel_error(std::move(error));
     }
   });
+  peer->data_channel->setBufferedAmountLowThreshold(SEND_BUFFER_LOW_WATERMARK);
+  peer->data_channel->onBufferedAmountLow([weak_self]() {
+    if (auto self = weak_self.lock()) {
+      self->on_data_channel_buffered_amount_low();
+    }
+  });
   peer->data_channel->onMessage(
       [weak_self](rtc::binary message) {
         if (auto self = weak_self.lock()) {
@@ -301,20 +456,144 @@ void Streamer::send_video_stream_info() {
   web_socket_->send(json.dump());
 }
 
-void Streamer::video_stream_callback(const std::byte *data, const std::size_t size, const bool eof) {
+void Streamer::send_load() {
+  if (!connection_open_) {
+    return;
+  }
+
+  double encode_us{};
+  {
+    std::lock_guard<std::mutex> lock(load_mutex_);
+    encode_us = encode_us_;
+  }
+  const auto load_json = nlohmann::json{
+      {"encode_us", encode_us}
+  };
+  const auto json = nlohmann::json{
+      {"load", load_json}
+  };
+  web_socket_->send(json.dump());
+}
+
+void Streamer::video_stream_callback(const std::byte *data,
+                                     const std::size_t size,
+                                     const bool eof,
+                                     const std::uint64_t frame_num) {
+  if (stream_recorder_) {
+    stream_recorder_->record(data, size, eof, frame_num);
+  }
+  send_video(data, size, eof, frame_num);
+}
+
+void Streamer::simulcast_stream_callback(const std::size_t layer,
+                                         const std::byte *data,
+                                         const std::size_t size,
+                                         const bool eof,
+                                         const bool keyframe,
+                                         const std::uint64_t frame_num) {
+  if (layer == 0 && stream_recorder_) {
+    stream_recorder_->record(data, size, eof, frame_num);
+  }
+  std::lock_guard<std::mutex> lock(layer_mutex_);
+  if (layer != active_layer_) {
+    // Packets of another layer reference pictures the receiver never decoded, only a keyframe can start one.
+    if (layer != target_layer_ || !keyframe) {
+      return;
+    }
+    if (active_layer_) {
+      printf("Simulcast: switched from layer %zu to layer %zu\n", *active_layer_, layer);
+    }
+    active_layer_ = layer;
+  }
+  send_video(data, size, eof, frame_num);
+}
+
+void Streamer::send_video(const std::byte *data,
+                          const std::size_t size,
+                          const bool eof,
+                          const std::uint64_t frame_num) {
   std::shared_ptr<Peer> peer;
   {
     std::lock_guard<std::mutex> lock(mutex_);
     peer = peer_;
   }
   if (peer && peer->data_channel && peer->data_channel->isOpen()) {
-    const StreamPackageHeader header{frame_num_++, eof};
-    const auto serialized = header.serialize();
-    std::vector<std::byte> packet(STREAM_PACKAGE_HEADER_SIZE + size);
-    std::memcpy(packet.data(), serialized.data(), STREAM_PACKAGE_HEADER_SIZE);
-    std::memcpy(packet.data() + STREAM_PACKAGE_HEADER_SIZE, data, size);
-    peer->data_channel->send(packet.data(), packet.size());
+    // Numbered by the encoder rather than counted here, so the packets match a recording of the stream.
+    auto header = StreamPackageHeader{frame_num, stream_timestamp_us()};
+    frame_num_ = frame_num + 1;
+    header.eof = eof;
+    const auto send = [&peer](const std::byte *message, const std::size_t message_size) {
+      peer->data_channel->send(message, message_size);
+    };
+    if (fec_packetizer_) {
+      fec_packetizer_->packetize(header, data, size, send);
+    } else {
+      fragmenter_.fragment(header, data, size, send);
+    }
+    update_congestion(peer->data_channel);
+  }
+}
+
+void Streamer::select_layer() {
+  const auto target_layer = std::max(subscribed_layer_, congestion_layer_);
+  if (target_layer == target_layer_) {
+    return;
+  }
+  target_layer_ = target_layer;
+  if (active_layer_ == target_layer_) {
+    return;
+  }
+  // Waiting for the layer's next regular keyframe could take a whole GOP.
+  if (const auto simulcast_encoder = simulcast_encoder_.lock()) {
+    simulcast_encoder->request_keyframe(target_layer_);
+  }
+}
+
+void Streamer::send_simulcast_info() {
+  const auto simulcast_encoder = simulcast_encoder_.lock();
+  std::shared_ptr<Peer> peer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer = peer_;
+  }
+  if (!simulcast_encoder || !peer || !peer->data_channel) {
+    return;
+  }
+  auto layers_json = nlohmann::json::array();
+  for (std::size_t layer = 0; layer < simulcast_encoder->layers_num(); ++layer) {
+    const auto info = simulcast_encoder->video_stream_info(layer);
+    layers_json.push_back({
+        {   "width",                        info.width},
+        {  "height",                       info.height},
+        {"bit_rate", simulcast_encoder->bit_rate(layer)}
+    });
+  }
+  const auto json = nlohmann::json{
+      {"simulcast", {{"layers", layers_json}}}
+  };
+  peer->data_channel->send(json.dump());
+}
+
+void Streamer::audio_stream_callback(const std::byte *data, const std::size_t size) {
+  std::shared_ptr<Peer> peer;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    peer = peer_;
+  }
+  if (!peer || !peer->data_channel || !peer->data_channel->isOpen()) {
+    return;
+  }
+  auto header = StreamPackageHeader{audio_packet_num_++, stream_timestamp_us()};
+  header.audio = true;
+  const auto serialized = header.serialize();
+  // Opus packets of a 10 ms frame stay far below a fragment, and the audio is too little to matter for congestion.
+  std::lock_guard<std::mutex> lock(audio_mutex_);
+  audio_message_.resize(STREAM_PACKAGE_HEADER_SIZE + size);
+  std::memcpy(audio_message_.data(), serialized.data(), STREAM_PACKAGE_HEADER_SIZE);
+  if (size > 0) {
+    std::memcpy(audio_message_.data() + STREAM_PACKAGE_HEADER_SIZE, data, size);
   }
+  peer->data_channel->send(audio_message_.data(), audio_message_.size());
 }
 
 void Streamer::parse_event(const nlohmann::json &json_event) {
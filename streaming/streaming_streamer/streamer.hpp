@@ -1,6 +1,11 @@
 #pragma once
 
+#include "streaming_common/congestion_controller.hpp"
 #include "streaming_common/encoder.hpp"
+#include "streaming_common/fec.hpp"
+#include "streaming_common/fragmentation.hpp"
+#include "streaming_common/simulcast_encoder.hpp"
+#include "streaming_common/stream_recorder.hpp"
 #include "streaming_common/video_stream_info.hpp"
 
 #include <gp/misc/event.hpp>
@@ -9,10 +14,13 @@
 #include <rtc/rtc.hpp>
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace streaming {
 class Streamer : public std::enable_shared_from_this<Streamer> {
@@ -24,10 +32,56 @@ public:
 
   Streamer(const std::string &server_ip, const std::uint16_t server_port, const bool use_stun = true);
 
+  /**
+   * Records every encoded packet, independently of whether a receiver is connected. Must be set before start().
+   */
+  void set_stream_recorder(std::shared_ptr<StreamRecorder> stream_recorder);
+  /**
+   * Sends the stream over an unordered channel without retransmissions, with one XOR parity shard per `group_size`
+   * data shards, so a lost datagram no longer blocks every following frame. 0 keeps the reliable ordered channel.
+   * Must be set before start().
+   */
+  void set_fec_group_size(const std::size_t group_size);
   void start(std::shared_ptr<Encoder> encoder);
+  /**
+   * Streams one layer of the simulcast encoder: the one the receiver subscribed to, or a lower one while the
+   * congestion controller's target bit rate is below the subscribed layer's. Layers are switched at keyframes, which
+   * are requested from the encoder on a switch.
+   */
+  void start(std::shared_ptr<SimulcastEncoder> simulcast_encoder);
+  /**
+   * Connects without taking over an encoder's callback, encoded packets are then passed to video_stream_callback().
+   */
+  void start(const VideoStreamInfo &video_stream_info);
+  /**
+   * @param frame_num The encoder's frame number of the packet, Encoder::packet_frame_num(). Sent and recorded with it.
+   */
+  void video_stream_callback(const std::byte *data,
+                             const std::size_t size,
+                             const bool eof,
+                             const std::uint64_t frame_num);
+  /**
+   * Sends one encoded Opus packet on the stream's data channel, multiplexed with the video by the audio flag of its
+   * header. Thread-safe, audio is usually encoded on its own thread.
+   */
+  void audio_stream_callback(const std::byte *data, const std::size_t size);
   void set_event_callback(std::function<void(const gp::misc::Event &event)> event_callback);
   void set_close_callback(std::function<void()> close_callback);
   void set_feedback_callback(std::function<void(std::uint64_t lag)> feedback_callback);
+  /**
+   * Called when the data channel's send buffer becomes congested or drains again, frames should not be encoded while
+   * it is congested.
+   */
+  void set_congestion_callback(std::function<void(bool congested)> congestion_callback);
+  /**
+   * Called with a new encoder target bit rate whenever the congestion controller changes it.
+   */
+  void set_bit_rate_callback(std::function<void(std::int64_t bit_rate)> bit_rate_callback);
+  /**
+   * Adds the encode time of a frame to the load reported to the signaling server, which assigns receivers to the
+   * streamer of the lowest encode time.
+   */
+  void report_encode_time(const std::chrono::microseconds encode_time);
 
 private:
   struct Peer {
@@ -52,17 +106,41 @@ private:
   void on_data_channel_error(std::string error);
   void on_data_channel_binary_message(rtc::binary message);
   void on_data_channel_string_message(std::string message);
+  void on_data_channel_buffered_amount_low();
+
+  void simulcast_stream_callback(const std::size_t layer,
+                                 const std::byte *data,
+                                 const std::size_t size,
+                                 const bool eof,
+                                 const bool keyframe,
+                                 const std::uint64_t frame_num);
+  void send_video(const std::byte *data, const std::size_t size, const bool eof, const std::uint64_t frame_num);
+  /**
+   * Picks the layer to switch to from the subscription and the congestion state, called with `layer_mutex_` held.
+   */
+  void select_layer();
+  void send_simulcast_info();
+
+  /**
+   * Called after each video send, in simulcast mode with `layer_mutex_` held.
+   */
+  void update_congestion(const std::shared_ptr<rtc::DataChannel> &data_channel);
+  void report_congestion();
 
   [[nodiscard]] std::shared_ptr<Peer> create_peer(const std::string &id);
   void send_video_stream_info();
-  void video_stream_callback(const std::byte *data, const std::size_t size, const bool eof);
+  void send_load();
   void parse_event(const nlohmann::json &json_event);
 
   const std::string id_{};
   std::string connection_url_{};
   VideoStreamInfo video_stream_info_{};
   std::atomic<bool> connection_open_{false};
+  /**
+   * Frame number after the last video packet sent.
+   */
   std::atomic<std::uint64_t> frame_num_{0};
+  std::atomic<std::uint64_t> audio_packet_num_{0};
   rtc::Configuration configuration_{};
   std::shared_ptr<rtc::WebSocket> web_socket_{};
   std::shared_ptr<Peer> peer_{};
@@ -70,5 +148,41 @@ private:
   std::function<void(const gp::misc::Event &event)> event_callback_{};
   std::function<void()> close_callback_{};
   std::function<void(std::uint64_t lag)> feedback_callback_{};
+  std::function<void(bool congested)> congestion_callback_{};
+  std::function<void(std::int64_t bit_rate)> bit_rate_callback_{};
+  CongestionController congestion_controller_{};
+  /**
+   * Serializes congestion reports from the sending thread and the buffered-amount-low notification, so the last
+   * report always carries the current state.
+   */
+  std::mutex congestion_mutex_{};
+  bool reported_congested_{false};
+  std::shared_ptr<StreamRecorder> stream_recorder_{};
+  std::unique_ptr<FecPacketizer> fec_packetizer_{};
+  Fragmenter fragmenter_{};
+
+  /**
+   * Not owned, the encoder is torn down with the scene which drives it.
+   */
+  std::weak_ptr<SimulcastEncoder> simulcast_encoder_{};
+  std::size_t layers_num_{1};
+  /**
+   * Serializes the layers' sends, so a switch never interleaves packets of two layers.
+   */
+  std::mutex layer_mutex_{};
+  /**
+   * The layer being sent, none until the first keyframe after a receiver connected.
+   */
+  std::optional<std::size_t> active_layer_{};
+  std::size_t target_layer_{0};
+  std::size_t subscribed_layer_{0};
+  std::size_t congestion_layer_{0};
+
+  std::mutex audio_mutex_{};
+  std::vector<std::byte> audio_message_{};
+
+  double encode_us_{};
+  std::chrono::steady_clock::time_point last_load_report_{};
+  std::mutex load_mutex_{};
 };
 } // namespace streaming
@@ -19,6 +19,8 @@ PlayerState::PlayerState(const RawMap &raw_map, const float move_speed, const fl
     , rot_speed_{rot_speed}
     , orientation_{deduce_orientation(raw_map_)} {
   pos_ = glm::vec2{raw_map_.player_pos()} + glm::vec2{0.5f, 0.5f};
+  prev_orientation_ = orientation_;
+  prev_pos_ = pos_;
 }
 
 void PlayerState::set_keyboard_state(std::shared_ptr<gp::misc::KeyboardState> keyboard_state) {
@@ -31,7 +33,9 @@ void PlayerState::set_keyboard_state(std::shared_ptr<gp::misc::KeyboardState> ke
 
 void PlayerState::set_noclip(bool noclip) { noclip_ = noclip; }
 
-void PlayerState::animate(const std::uint64_t time_elapsed_ms) {
+void PlayerState::animate(const float time_elapsed_ms) {
+  prev_orientation_ = orientation_;
+  prev_pos_ = pos_;
   if (noclip_) {
     animate_move_noclip(time_elapsed_ms);
   } else {
@@ -40,17 +44,30 @@ void PlayerState::animate(const std::uint64_t time_elapsed_ms) {
   animate_rot(time_elapsed_ms);
 }
 
-float PlayerState::orientation() const { return orientation_; }
+void PlayerState::set_interpolation_alpha(const float alpha) { interpolation_alpha_ = alpha; }
 
-glm::vec2 PlayerState::pos() const { return pos_; }
+float PlayerState::orientation() const {
+  // The shorter way round, a turn across 0 must not spin the other way.
+  auto delta = orientation_ - prev_orientation_;
+  if (delta > std::numbers::pi_v<float>) {
+    delta -= 2.0f * std::numbers::pi_v<float>;
+  } else if (delta < -std::numbers::pi_v<float>) {
+    delta += 2.0f * std::numbers::pi_v<float>;
+  }
+  return gp::math::wrap_angle(prev_orientation_ + delta * interpolation_alpha_);
+}
+
+glm::vec2 PlayerState::pos() const { return glm::mix(prev_pos_, pos_, interpolation_alpha_); }
 
-glm::ivec2 PlayerState::block_pos() const {
-  auto block_pos = glm::ivec2{static_cast<int>(std::floor(pos_.x)), static_cast<int>(std::floor(pos_.y))};
+glm::ivec2 PlayerState::block_pos() const { return block_at(pos()); }
+
+glm::vec2 PlayerState::dir() const { return gp::utils::orientation_to_dir(orientation()); }
+
+glm::ivec2 PlayerState::block_at(const glm::vec2 &pos) const {
+  auto block_pos = glm::ivec2{static_cast<int>(std::floor(pos.x)), static_cast<int>(std::floor(pos.y))};
   return glm::clamp(block_pos, glm::ivec2{0, 0}, raw_map_.bounds());
 }
 
-glm::vec2 PlayerState::dir() const { return gp::utils::orientation_to_dir(orientation_); }
-
 float PlayerState::deduce_orientation(const RawMap &raw_map) const {
   const auto pos = raw_map.player_pos();
   const auto pos_type = raw_map.block(pos.x, pos.y).object;
@@ -66,12 +83,12 @@ float PlayerState::deduce_orientation(const RawMap &raw_map) const {
   return 0.0f;
 }
 
-void PlayerState::animate_move_noclip(const std::uint64_t time_elapsed_ms) {
+void PlayerState::animate_move_noclip(const float time_elapsed_ms) {
   const auto move_delta = get_move_delta(time_elapsed_ms);
   pos_ += move_delta;
 }
 
-void PlayerState::animate_move(const std::uint64_t time_elapsed_ms) {
+void PlayerState::animate_move(const float time_elapsed_ms) {
   const auto move_delta = get_move_delta(time_elapsed_ms);
   if (move_delta == glm::vec2{}) {
     return;
@@ -82,7 +99,7 @@ void PlayerState::animate_move(const std::uint64_t time_elapsed_ms) {
   pos_ += glm::vec2{new_delta_x, new_delta_y};
 }
 
-void PlayerState::animate_rot(const std::uint64_t time_elapsed_ms) {
+void PlayerState::animate_rot(const float time_elapsed_ms) {
   const auto rot_dir = rot_direction();
   if (rot_dir == 0) {
     return;
@@ -113,7 +130,7 @@ int PlayerState::rot_direction() const {
 
 float PlayerState::resolved_x_collision(const float delta_x) const {
   const auto moving_right = delta_x > 0.0f;
-  const auto player_block_pos = block_pos();
+  const auto player_block_pos = block_at(pos_);
   auto check_block_pos = moving_right ? glm::ivec2{player_block_pos.x + 1, player_block_pos.y - 1}
                                       : glm::ivec2{player_block_pos.x - 1, player_block_pos.y - 1};
 
@@ -135,7 +152,7 @@ float PlayerState::resolved_x_collision(const float delta_x) const {
 
 float PlayerState::resolved_y_collision(const float delta_y) const {
   const auto moving_down = delta_y > 0.0f;
-  const auto player_block_pos = block_pos();
+  const auto player_block_pos = block_at(pos_);
   auto check_block_pos = moving_down ? glm::ivec2{player_block_pos.x - 1, player_block_pos.y + 1}
                                      : glm::ivec2{player_block_pos.x - 1, player_block_pos.y - 1};
   auto check_rect = get_player_rect();
@@ -154,14 +171,14 @@ float PlayerState::resolved_y_collision(const float delta_y) const {
   return delta_y;
 }
 
-glm::vec2 PlayerState::get_move_delta(const std::uint64_t time_elapsed_ms) const {
+glm::vec2 PlayerState::get_move_delta(const float time_elapsed_ms) const {
   const auto move_dir = move_direction();
   if (move_dir == 0) {
     return glm::vec2{};
   }
 
   const auto time_factor = time_elapsed_ms / 1000.0f;
-  const auto oriented_dir = static_cast<float>(move_dir) * dir();
+  const auto oriented_dir = static_cast<float>(move_dir) * gp::utils::orientation_to_dir(orientation_);
   return time_factor * move_speed_ * oriented_dir;
 }
 
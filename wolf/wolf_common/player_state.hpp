@@ -16,7 +16,13 @@ public:
 
   void set_keyboard_state(std::shared_ptr<gp::misc::KeyboardState> keyboard_state);
   void set_noclip(bool noclip);
-  void animate(const std::uint64_t time_elapsed_ms);
+  void animate(const float time_elapsed_ms);
+  /**
+   * Places the rendered player between its states before and after the last animate(), 0 before and 1 after, so a
+   * player animated at a fixed tick rate moves smoothly at any frame rate. pos(), block_pos(), orientation() and dir()
+   * report the rendered player, collisions are resolved on the animated one.
+   */
+  void set_interpolation_alpha(const float alpha);
 
   float orientation() const;
   glm::vec2 pos() const;
@@ -31,23 +37,27 @@ private:
   const float rot_speed_{};
   float orientation_{};
   glm::vec2 pos_{};
+  float prev_orientation_{};
+  glm::vec2 prev_pos_{};
+  float interpolation_alpha_{1.0f};
 
   std::shared_ptr<gp::misc::KeyboardState> dummy_keyboard_state_{std::make_shared<gp::misc::KeyboardState>()};
   std::shared_ptr<gp::misc::KeyboardState> keyboard_state_{dummy_keyboard_state_};
   bool noclip_{false};
 
   float deduce_orientation(const RawMap &raw_map) const;
-  void animate_move_noclip(const std::uint64_t time_elapsed_ms);
-  void animate_move(const std::uint64_t time_elapsed_ms);
-  void animate_rot(const std::uint64_t time_elapsed_ms);
+  void animate_move_noclip(const float time_elapsed_ms);
+  void animate_move(const float time_elapsed_ms);
+  void animate_rot(const float time_elapsed_ms);
 
   int move_direction() const;
   int rot_direction() const;
 
+  glm::ivec2 block_at(const glm::vec2 &pos) const;
   float resolved_x_collision(const float delta_x) const;
   float resolved_y_collision(const float delta_y) const;
 
-  glm::vec2 get_move_delta(const std::uint64_t time_elapsed_ms) const;
+  glm::vec2 get_move_delta(const float time_elapsed_ms) const;
   SDL_FRect get_player_rect() const;
 };
 } // namespace wolf
@@ -9,6 +9,8 @@
 
 namespace wolf {
 namespace {
+constexpr auto TICK_RATE = 120.0;
+
 bool ray_aabb_intersect_2d(const glm::vec2 &ray_start,
                            const glm::vec2 &ray_dir,
                            const glm::vec2 &aabb_min,
@@ -36,8 +38,7 @@ bool ray_aabb_intersect_2d(const glm::vec2 &ray_start,
 } // namespace
 
 GeometryTestScene::GeometryTestScene(std::unique_ptr<const RawMap> raw_map)
-    : raw_map_{std::move(raw_map)}
-    , last_timestamp_ms_{timestamp()} {}
+    : raw_map_{std::move(raw_map)} {}
 
 void GeometryTestScene::loop(const gp::misc::Event &event) {
   switch (event.type()) {
@@ -50,22 +51,25 @@ void GeometryTestScene::loop(const gp::misc::Event &event) {
   case gp::misc::Event::Type::Resize:
     resize(event.resize().width, event.resize().height);
     break;
-  case gp::misc::Event::Type::Redraw: {
-    const auto time_elapsed_ms = event.timestamp() - last_timestamp_ms_;
-    player_state_.animate(time_elapsed_ms);
-    last_timestamp_ms_ = event.timestamp();
+  case gp::misc::Event::Type::Redraw:
+    player_state_.set_interpolation_alpha(interpolation_alpha());
     redraw();
-  } break;
+    break;
   default:
     break;
   }
 }
 
 void GeometryTestScene::initialize(const int width, const int height) {
+  // Moves with held keys, paced rather than spinning while idle.
+  set_loop_mode(gp::sdl::internal::SDLContext::LoopMode::Paced);
+  set_fixed_timestep(TICK_RATE);
   player_state_.set_keyboard_state(keyboard_state());
   resize(width, height);
 }
 
+void GeometryTestScene::step(const float tick_ms) { player_state_.animate(tick_ms); }
+
 void GeometryTestScene::finalize() { player_state_.set_keyboard_state(nullptr); }
 
 void GeometryTestScene::resize(const int width, const int height) {
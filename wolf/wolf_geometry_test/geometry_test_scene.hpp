@@ -16,6 +16,7 @@ public:
 
 private:
   void loop(const gp::misc::Event &event) override;
+  void step(const float tick_ms) override;
 
   void initialize(const int width, const int height);
   void finalize();
@@ -36,7 +37,6 @@ private:
   PlayerState player_state_{*raw_map_};
   float width_{};
   float height_{};
-  std::uint64_t last_timestamp_ms_{0u};
   float map_scale_{0.9f}; // percent of min(width, height)
 };
 } // namespace wolf
@@ -30,6 +30,9 @@ constexpr std::array k_levels = {
 };
 constexpr auto max_level = static_cast<int>(k_levels.size()) - 1;
 
+// Player movement ticks, independent of how fast the rays are cast and drawn.
+constexpr auto TICK_RATE = 120.0;
+
 int level_count(const int dim, const int level) {
   return std::max(1, static_cast<int>(static_cast<std::int64_t>(dim) * k_levels[level].num / k_levels[level].den));
 }
@@ -52,7 +55,7 @@ RaycasterScene::RaycasterScene(std::unique_ptr<const RawMap> raw_map,
 void RaycasterScene::loop(const gp::misc::Event &event) {
   switch (event.type()) {
   case gp::misc::Event::Type::Init:
-    last_timestamp_ms_ = event.timestamp();
+    set_fixed_timestep(TICK_RATE);
     player_state_.set_keyboard_state(keyboard_state());
     sdl_r_ = renderer()->sdl_renderer();
     map_renderer_.set_renderer(renderer());
@@ -65,13 +68,11 @@ void RaycasterScene::loop(const gp::misc::Event &event) {
   case gp::misc::Event::Type::Resize:
     resize(event.resize().width, event.resize().height);
     break;
-  case gp::misc::Event::Type::Redraw: {
-    const auto time_elapsed_ms = event.timestamp() - last_timestamp_ms_;
-    player_state_.animate(time_elapsed_ms);
+  case gp::misc::Event::Type::Redraw:
+    player_state_.set_interpolation_alpha(interpolation_alpha());
     raycaster_.cast_rays();
-    last_timestamp_ms_ = event.timestamp();
     redraw();
-  } break;
+    break;
   case gp::misc::Event::Type::Key:
     if (event.key().action == gp::misc::Event::Action::Pressed) {
       switch (event.key().scan_code) {
@@ -123,6 +124,8 @@ void RaycasterScene::loop(const gp::misc::Event &event) {
   }
 }
 
+void RaycasterScene::step(const float tick_ms) { player_state_.animate(tick_ms); }
+
 void RaycasterScene::resize(const int width, const int height) {
   width_ = width;
   height_ = height;
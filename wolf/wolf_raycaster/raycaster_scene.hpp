@@ -23,6 +23,7 @@ public:
 
 private:
   void loop(const gp::misc::Event &event) override;
+  void step(const float tick_ms) override;
 
   void resize(const int width, const int height);
   void redraw();
@@ -39,7 +40,6 @@ private:
   MapRenderer map_renderer_;
   int width_{};
   int height_{};
-  std::uint32_t last_timestamp_ms_{0u};
 
   bool show_textures_{true};
   bool show_proximity_shading_{true};
@@ -1,11 +1,13 @@
 #ifdef GL_ES
 precision mediump float;
+precision mediump sampler2DArray;
 #endif
 
 in vec2 frag_uv;
 
-uniform sampler2D tex;
+uniform sampler2DArray tex;
+uniform float layer;
 
 out vec4 color;
 
-void main() { color = texture(tex, frag_uv); }
+void main() { color = texture(tex, vec3(frag_uv, layer)); }
@@ -1,12 +1,15 @@
 #include "vswap_file_viewer_scene.hpp"
 
 #include <gp/gl/misc.hpp>
+#include <gp/gl/state_cache.hpp>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace wolf {
 namespace {
+constexpr auto PICTURE_SIZE = GLsizei{64};
+
 template<typename... Ts>
 constexpr auto make_array(Ts &&...args) {
   return std::array<std::common_type_t<Ts...>, sizeof...(Ts)>{std::forward<Ts>(args)...};
@@ -34,10 +37,11 @@ void VswapFileViewerScene::loop(const gp::misc::Event &event) {
   case gp::misc::Event::Type::MouseButton:
     if (event.mouse_button().action == gp::misc::Event::Action::Pressed) {
       if (event.mouse_button().button == gp::misc::Event::MouseButton::Left) {
-        upload_wall();
+        show_wall();
       } else if (event.mouse_button().button == gp::misc::Event::MouseButton::Right) {
-        upload_sprite();
+        show_sprite();
       }
+      request_redraw();
     }
     break;
   default:
@@ -46,6 +50,9 @@ void VswapFileViewerScene::loop(const gp::misc::Event &event) {
 }
 
 void VswapFileViewerScene::initialize(const int width, const int height) {
+  // The picture only changes on a click, resizing or exposing the window redraws it as well.
+  set_loop_mode(gp::sdl::internal::SDLContext::LoopMode::OnDemand);
+
   glEnable(GL_DEPTH_TEST);
   glFrontFace(GL_CCW);
   glEnable(GL_CULL_FACE);
@@ -73,21 +80,21 @@ void VswapFileViewerScene::initialize(const int width, const int height) {
   glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), reinterpret_cast<void *>(2 * sizeof(GLfloat)));
   glEnableVertexAttribArray(1);
 
-  frame_texture_ = std::make_unique<gp::gl::TextureObject>(GL_TEXTURE_2D);
-  frame_texture_->bind();
-  frame_texture_->set_parameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-  frame_texture_->set_parameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-  frame_texture_->set_parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-  frame_texture_->set_parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+  gp::gl::state_cache().active_texture(GL_TEXTURE0);
+  walls_texture_ = create_array_texture(vswap_file_->walls());
+  sprites_texture_ = create_array_texture(vswap_file_->sprites());
 
   shader_program_ = gp::gl::create_shader_program("shaders/texture_screen");
   shader_program_->use();
   shader_program_->set_uniform("tex", 0);
+  layer_uniform_ = shader_program_->uniform_handle("layer");
 }
 
 void VswapFileViewerScene::finalize() {
   shader_program_.reset();
-  frame_texture_.reset();
+  shown_texture_ = nullptr;
+  sprites_texture_.reset();
+  walls_texture_.reset();
   vertex_buffer_.reset();
   vao_.reset();
 }
@@ -96,14 +103,45 @@ void VswapFileViewerScene::resize(const int width, const int height) { glViewpor
 
 void VswapFileViewerScene::redraw() {
   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glActiveTexture(GL_TEXTURE0);
+  if (shown_texture_ == nullptr) {
+    return;
+  }
+  gp::gl::state_cache().active_texture(GL_TEXTURE0);
   shader_program_->use();
-  frame_texture_->bind();
+  shader_program_->set_uniform(layer_uniform_, static_cast<GLfloat>(shown_layer_));
+  shown_texture_->bind();
   vao_->bind();
   glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
 }
 
-void VswapFileViewerScene::upload_wall() {
+std::unique_ptr<gp::gl::TextureObject>
+VswapFileViewerScene::create_array_texture(const std::vector<std::array<glm::u8vec4, 4096>> &pictures) {
+  if (pictures.empty()) {
+    return nullptr;
+  }
+
+  auto texture = std::make_unique<gp::gl::TextureObject>(GL_TEXTURE_2D_ARRAY);
+  texture->bind();
+  texture->set_parameter(GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  texture->set_parameter(GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  // Mipmaps keep the pixel art from aliasing in windows smaller than the picture.
+  texture->set_parameter(GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+  texture->set_parameter(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+  const auto layers = static_cast<GLsizei>(pictures.size());
+  texture->set_storage(
+      gp::gl::TextureObject::mip_levels(PICTURE_SIZE, PICTURE_SIZE), GL_RGBA8, PICTURE_SIZE, PICTURE_SIZE, layers);
+  // The pictures are contiguous, all layers are a single upload.
+  texture->set_sub_image(
+      0, 0, 0, 0, PICTURE_SIZE, PICTURE_SIZE, layers, GL_RGBA, GL_UNSIGNED_BYTE, glm::value_ptr(pictures[0][0]));
+  texture->generate_mipmap();
+  return texture;
+}
+
+void VswapFileViewerScene::show_wall() {
+  if (!walls_texture_) {
+    return;
+  }
   auto index = wall_index_++;
 
   if (index >= vswap_file_->walls().size()) {
@@ -111,12 +149,14 @@ void VswapFileViewerScene::upload_wall() {
   }
 
   printf("Wall index: %zu\n", index);
-  const auto &data = vswap_file_->walls()[index];
-  frame_texture_->bind();
-  frame_texture_->set_image(0, GL_RGBA, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, glm::value_ptr(data[0]));
+  shown_texture_ = walls_texture_.get();
+  shown_layer_ = index;
 }
 
-void VswapFileViewerScene::upload_sprite() {
+void VswapFileViewerScene::show_sprite() {
+  if (!sprites_texture_) {
+    return;
+  }
   auto index = sprite_index_++;
 
   if (index >= vswap_file_->sprites().size()) {
@@ -124,8 +164,7 @@ void VswapFileViewerScene::upload_sprite() {
   }
 
   printf("Sprite index: %zu\n", index);
-  const auto &data = vswap_file_->sprites()[index];
-  frame_texture_->bind();
-  frame_texture_->set_image(0, GL_RGBA, 64, 64, 0, GL_RGBA, GL_UNSIGNED_BYTE, glm::value_ptr(data[0]));
+  shown_texture_ = sprites_texture_.get();
+  shown_layer_ = index;
 }
 } // namespace wolf
@@ -11,7 +11,9 @@
 
 #include <glm/glm.hpp>
 
+#include <array>
 #include <memory>
+#include <vector>
 
 namespace wolf {
 class VswapFileViewerScene : public gp::sdl::Scene3D {
@@ -26,8 +28,13 @@ private:
   void resize(const int width, const int height);
   void redraw();
 
-  void upload_wall();
-  void upload_sprite();
+  /**
+   * Uploads the pictures once into a 64x64xN array texture, showing one is selecting its layer.
+   */
+  static std::unique_ptr<gp::gl::TextureObject>
+  create_array_texture(const std::vector<std::array<glm::u8vec4, 4096>> &pictures);
+  void show_wall();
+  void show_sprite();
 
   std::shared_ptr<const VswapFile> vswap_file_{};
 
@@ -36,7 +43,14 @@ private:
 
   std::unique_ptr<gp::gl::VertexArrayObject> vao_{};
   std::unique_ptr<gp::gl::BufferObject> vertex_buffer_{};
-  std::unique_ptr<gp::gl::TextureObject> frame_texture_{};
+  std::unique_ptr<gp::gl::TextureObject> walls_texture_{};
+  std::unique_ptr<gp::gl::TextureObject> sprites_texture_{};
+  /**
+   * One of the above, null until the first picture is selected.
+   */
+  const gp::gl::TextureObject *shown_texture_{};
+  std::size_t shown_layer_{};
   std::unique_ptr<gp::gl::ShaderProgram> shader_program_{};
+  gp::gl::UniformHandle layer_uniform_{};
 };
 } // namespace wolf